@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Distribution of the blocks addressed by random operations.
+ */
+enum class AccessDistribution {
+    UNIFORM,   ///< Every block is equally likely
+    ZIPF,      ///< Block k is chosen with probability proportional to 1 / k^theta
+    PARETO,    ///< Bounded Pareto distribution concentrated at the start of the range
+    HOT_COLD,  ///< A share of the I/O goes to a hot share of the blocks
+    NORMAL,    ///< Normal distribution around a center that moves with every I/O
+    STRIDED    ///< Fixed stride through the range, wrapping at the end
+};
+
+/**
+ * @brief Parses an access distribution name ("uniform", "zipf", "pareto",
+ *        "hotcold", "normal", "strided").
+ *
+ * @param name The distribution name (case-insensitive)
+ *
+ * @return The matching distribution
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+AccessDistribution ParseAccessDistribution(const std::string& name);
+
+/**
+ * @brief Selects and parameterizes the access distribution of a workload.
+ *
+ * Only the parameters of the selected distribution are used. The most popular
+ * blocks of the skewed distributions are at the start of the addressed range.
+ */
+struct AccessPatternConfig {
+    AccessDistribution distribution = AccessDistribution::UNIFORM; ///< Selected distribution
+    double zipf_theta = 1.2;                ///< ZIPF: skew exponent (> 0)
+    double pareto_shape = 1.16;             ///< PARETO: shape parameter (> 0); 1.16 gives the 80/20 rule
+    uint32_t hot_io_percentage = 80;        ///< HOT_COLD: share of the I/O sent to the hot set (0-100)
+    uint32_t hot_space_percentage = 20;     ///< HOT_COLD: share of the blocks in the hot set (1-100)
+    double normal_stddev_percentage = 5.0;  ///< NORMAL: standard deviation as a share of the range (> 0)
+    double normal_center_step = 0.0;        ///< NORMAL: blocks the center moves after every I/O
+    uint64_t stride_blocks = 1;             ///< STRIDED: distance between consecutive blocks (> 0)
+
+    /**
+     * @brief Validates the parameters of the selected distribution.
+     *
+     * @return true if the configuration is valid, false otherwise
+     */
+    bool IsValid() const;
+};
+
+/**
+ * @brief Produces the block indices addressed by random operations.
+ *
+ * Every implementation samples in O(1) expected time with its own
+ * xoshiro256** generator, so drawing an offset costs a few tens of
+ * nanoseconds regardless of the size of the range. Generators are not
+ * thread-safe; each I/O thread owns its own.
+ */
+class OffsetGenerator {
+public:
+    virtual ~OffsetGenerator() = default;
+
+    /**
+     * @brief Draws the next block index.
+     *
+     * @return A block index in [0, num_blocks)
+     */
+    virtual uint64_t NextBlock() = 0;
+
+    /**
+     * @brief Gets the distribution implemented by this generator.
+     *
+     * @return The access distribution
+     */
+    virtual AccessDistribution GetDistribution() const = 0;
+
+    /**
+     * @brief Creates the generator for a configuration.
+     *
+     * @param config Selected distribution and its parameters
+     * @param num_blocks Number of blocks in the addressed range
+     * @param seed Seed of the generator; 0 picks a random seed
+     *
+     * @return The offset generator
+     *
+     * @throws std::invalid_argument If the configuration is invalid or the range is empty
+     */
+    static std::unique_ptr<OffsetGenerator> Create(const AccessPatternConfig& config,
+                                                   uint64_t num_blocks,
+                                                   uint64_t seed = 0);
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Distribution of the number of commands handled together.
+ *
+ * Records how many commands went out per submission pass or came back per
+ * completion poll. Sizes fall into power-of-two buckets (1, 2-3, 4-7, ...,
+ * 256 and above); the exact mean and maximum are tracked alongside. Like
+ * LatencyHistogram it never allocates and is merged once a run is over.
+ *
+ * The histogram is not thread-safe.
+ */
+class BatchHistogram {
+public:
+    static constexpr size_t kNumBuckets = 9;  ///< Buckets up to 256 commands and above
+
+    /**
+     * @brief Records one batch.
+     *
+     * @param size Number of commands in the batch; empty batches are ignored
+     */
+    void Record(uint32_t size);
+
+    /**
+     * @brief Adds the batches of another histogram to this one.
+     *
+     * @param other The histogram to merge
+     */
+    void Merge(const BatchHistogram& other);
+
+    /**
+     * @brief Gets the number of recorded batches.
+     *
+     * @return Batch count
+     */
+    uint64_t GetBatchCount() const;
+
+    /**
+     * @brief Gets the number of commands in all recorded batches.
+     *
+     * @return Command count
+     */
+    uint64_t GetCommandCount() const;
+
+    /**
+     * @brief Gets the mean batch size.
+     *
+     * @return Commands per batch, or 0 if no batch was recorded
+     */
+    double GetMean() const;
+
+    /**
+     * @brief Gets the largest recorded batch.
+     *
+     * @return Largest batch size, 0 if no batch was recorded
+     */
+    uint32_t GetMax() const;
+
+    /**
+     * @brief Gets the number of batches in a bucket.
+     *
+     * @param bucket Bucket index, below kNumBuckets
+     *
+     * @return Batches whose size is in [GetBucketLowerBound(bucket), GetBucketLowerBound(bucket + 1))
+     */
+    uint64_t GetBucketCount(size_t bucket) const;
+
+    /**
+     * @brief Gets the smallest batch size counted in a bucket.
+     *
+     * @param bucket Bucket index
+     *
+     * @return 2^bucket
+     */
+    static uint32_t GetBucketLowerBound(size_t bucket);
+
+private:
+    std::array<uint64_t, kNumBuckets> buckets_{};  ///< Batches per power-of-two size class
+    uint64_t batches_ = 0;                         ///< Number of recorded batches
+    uint64_t commands_ = 0;                        ///< Sum of the recorded sizes
+    uint32_t max_ = 0;                             ///< Largest recorded size
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
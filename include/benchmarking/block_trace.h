@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief How the records of a replayed trace are divided among the workers of a job.
+ */
+enum class TracePartition {
+    LBA,  ///< By 1 MiB stripe of the traced offset, so workers never address the same blocks
+    CPU   ///< By the CPU that issued the request, preserving each CPU's ordering
+};
+
+/**
+ * @brief Parses a trace partition name ("lba", "cpu").
+ *
+ * @param name The partition name (case-insensitive)
+ *
+ * @return The matching partition
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+TracePartition ParseTracePartition(const std::string& name);
+
+/**
+ * @brief One traced request, stored as-is in binary trace files.
+ */
+struct TraceRecord {
+    uint64_t timestamp_ns;  ///< Issue time; only differences between records are meaningful
+    uint64_t offset;        ///< Byte offset on the traced device
+    uint32_t size;          ///< Transfer size in bytes
+    uint16_t cpu;           ///< CPU the request was issued on
+    uint8_t is_write;       ///< 1 for writes, 0 for reads
+    uint8_t reserved;       ///< Zero
+};
+static_assert(sizeof(TraceRecord) == 24, "Trace records are 24 bytes on disk");
+
+/**
+ * @brief Writes a binary trace file.
+ *
+ * The file starts with a 64-byte header (magic "NVBTRACE", version, record
+ * size, record count, earliest timestamp, largest transfer) followed by
+ * fixed-size little-endian TraceRecord entries, so readers can map the file
+ * and index it directly. The header is completed by Close().
+ */
+class TraceWriter {
+public:
+    TraceWriter();
+
+    /**
+     * @brief Completes the file if it is still open.
+     */
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /**
+     * @brief Creates or truncates a trace file.
+     *
+     * @param path File to write
+     *
+     * @return true if the file was created, false otherwise
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Appends a record.
+     *
+     * @param record The request; records should be in timestamp order
+     *
+     * @return true on success, false if the file is not open or the write failed
+     */
+    bool Append(const TraceRecord& record);
+
+    /**
+     * @brief Writes the final header and closes the file.
+     *
+     * @return true if the file is complete, false if a write failed
+     */
+    bool Close();
+
+    /**
+     * @brief Gets the number of records appended.
+     *
+     * @return Record count
+     */
+    uint64_t GetRecordCount() const;
+
+private:
+    std::ofstream file_;     ///< Trace being written
+    uint64_t record_count_;  ///< Records appended
+    uint64_t start_ns_;      ///< Earliest timestamp appended
+    uint32_t max_size_;      ///< Largest transfer appended
+};
+
+/**
+ * @brief Memory-maps a binary trace file for streaming replay.
+ *
+ * Records are paged in on access and read-ahead is requested for sequential
+ * access; ReleaseBefore() drops pages that have been consumed, so traces far
+ * larger than memory can be replayed.
+ */
+class TraceReader {
+public:
+    TraceReader();
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~TraceReader();
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    /**
+     * @brief Maps a trace file and validates its header.
+     *
+     * @param path Trace written by TraceWriter
+     *
+     * @return true if the file is a valid trace, false otherwise
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+    /**
+     * @brief Gets the number of records.
+     *
+     * @return Record count, 0 if not open
+     */
+    uint64_t GetRecordCount() const;
+
+    /**
+     * @brief Gets the earliest timestamp, the time origin of a replay.
+     *
+     * @return Timestamp in nanoseconds
+     */
+    uint64_t GetStartNs() const;
+
+    /**
+     * @brief Gets the largest transfer in the trace.
+     *
+     * @return Size in bytes
+     */
+    uint32_t GetMaxSize() const;
+
+    /**
+     * @brief Gets a record.
+     *
+     * @param index Record index, less than GetRecordCount()
+     *
+     * @return The record, valid until Close()
+     */
+    const TraceRecord& GetRecord(uint64_t index) const {
+        return records_[index];
+    }
+
+    /**
+     * @brief Drops the pages holding the records before an index from memory.
+     *
+     * The records stay accessible; they are read from the file again if needed.
+     *
+     * @param index First record that is still needed
+     */
+    void ReleaseBefore(uint64_t index);
+
+private:
+    void* mapping_;               ///< Mapped file, nullptr if not open
+    size_t mapping_size_;         ///< Size of the mapping in bytes
+    const TraceRecord* records_;  ///< First record
+    uint64_t record_count_;       ///< Number of records
+    uint64_t start_ns_;           ///< Earliest timestamp
+    uint32_t max_size_;           ///< Largest transfer
+    size_t released_;             ///< Bytes at the start of the mapping already released
+};
+
+/**
+ * @brief Iterates over the records of a trace that belong to one worker.
+ */
+class TraceCursor {
+public:
+    static constexpr uint64_t kStripeBytes = 1 << 20;  ///< LBA partition granularity
+
+    /**
+     * @brief Constructs a cursor at the start of a trace.
+     *
+     * @param reader The open trace; must outlive the cursor
+     * @param partition How records are divided among workers
+     * @param worker Index of this worker
+     * @param num_workers Number of workers sharing the trace
+     *
+     * @throws std::invalid_argument If the worker index is not below the worker count
+     */
+    TraceCursor(TraceReader& reader, TracePartition partition, uint32_t worker, uint32_t num_workers);
+
+    /**
+     * @brief Checks whether another record belongs to this worker, skipping the others.
+     *
+     * @return true if Next() returns a record
+     */
+    bool HasNext();
+
+    /**
+     * @brief Takes the next record of this worker.
+     *
+     * Must only be called after HasNext() returned true.
+     *
+     * @return The record
+     */
+    const TraceRecord& Next();
+
+    /**
+     * @brief Gets how far the cursor has advanced through the whole trace.
+     *
+     * @return Index of the next record to examine
+     */
+    uint64_t GetPosition() const;
+
+private:
+    /**
+     * @brief Checks whether a record belongs to this worker.
+     */
+    bool IsOwned(const TraceRecord& record) const;
+
+    TraceReader& reader_;        ///< Trace being replayed
+    TracePartition partition_;   ///< How records are divided
+    uint32_t worker_;            ///< This worker's index
+    uint32_t num_workers_;       ///< Number of workers
+    uint64_t position_;          ///< Next record to examine
+    uint64_t released_;          ///< Records before this index have been released
+};
+
+/**
+ * @brief Converts blkparse text output into a binary trace.
+ *
+ * Lines in blkparse's default format ("8,0 3 1 0.000000000 697 Q W 223490 + 8
+ * [proc]") are parsed; only events of the chosen action whose RWBS field is a
+ * read or a write are kept, so discards, flushes, summaries and other actions
+ * are skipped. Sector numbers and counts are in 512-byte units.
+ *
+ * @param input blkparse output
+ * @param writer Open trace the records are appended to
+ * @param action Event type to import: 'Q' (queued by the application) or 'D' (issued to the device)
+ *
+ * @return Number of records imported, or -1 if a record could not be written
+ */
+int64_t ImportBlkparseTrace(std::istream& input, TraceWriter& writer, char action = 'Q');
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Why a block failed verification.
+ */
+enum class VerifyErrorType {
+    BAD_MAGIC,      ///< The block holds neither a verify header nor zeros
+    LBA_MISMATCH,   ///< The header was written for another LBA (misdirected write or read)
+    SEED_MISMATCH,  ///< The header was written by a run with another verify seed (stale data)
+    CRC_MISMATCH    ///< The checksum does not match the content (corruption or torn write)
+};
+
+/**
+ * @brief Gets the name of a verify error type.
+ *
+ * @param type The error type
+ *
+ * @return A short lower-case name, e.g. "crc_mismatch"
+ */
+std::string GetVerifyErrorTypeName(VerifyErrorType type);
+
+/**
+ * @brief One block that failed verification.
+ */
+struct VerifyError {
+    VerifyErrorType type = VerifyErrorType::BAD_MAGIC; ///< What was wrong
+    uint64_t lba = 0;            ///< LBA the block was read from
+    uint64_t header_lba = 0;     ///< LBA recorded in the block's header
+    uint64_t generation = 0;     ///< Write generation recorded in the header
+    uint64_t seed = 0;           ///< Verify seed recorded in the header
+    uint32_t expected_crc = 0;   ///< Checksum recorded in the header
+    uint32_t actual_crc = 0;     ///< Checksum of the content as read
+};
+
+/**
+ * @brief Counters of the blocks checked by one or more verifiers.
+ */
+struct VerifyStats {
+    static constexpr size_t kMaxReportedErrors = 16;  ///< Failures kept with their details
+
+    uint64_t blocks_verified = 0;   ///< Blocks whose header and checksum matched
+    uint64_t blocks_unwritten = 0;  ///< All-zero blocks that were never written with a header
+    uint64_t errors = 0;            ///< Blocks that failed verification
+    std::vector<VerifyError> failures; ///< Details of the first kMaxReportedErrors failures
+
+    /**
+     * @brief Counts a failed block, keeping its details while there is room.
+     *
+     * @param error The failure
+     */
+    void RecordError(const VerifyError& error);
+
+    /**
+     * @brief Accumulates the counters and failures of another verifier.
+     *
+     * @param other Counters to merge
+     */
+    void Merge(const VerifyStats& other);
+};
+
+/**
+ * @brief Stamps written blocks with a self-describing header and checks them on reads.
+ *
+ * Every logical block (sector) of a write begins with a 32-byte header that
+ * records a magic number, the block's LBA, a write generation and the verify
+ * seed of the run, followed by a CRC-32C over the rest of the block. A read
+ * of any sector-aligned range can therefore be checked block by block without
+ * remembering what was written where, even when transfers of different sizes
+ * overlap: the header catches misdirected and stale blocks, the checksum
+ * catches corrupted and torn ones. Blocks that are entirely zero are counted
+ * as unwritten rather than as errors, so a fresh namespace can be verified.
+ *
+ * The checksum uses the crc32 instruction where available, on several blocks
+ * at once. Stamp() with a generation and Verify() are const, so they may run
+ * on helper threads while the submitting thread takes the generations.
+ */
+class BlockVerifier {
+public:
+    static constexpr uint32_t kHeaderSize = 32;   ///< Bytes of each block taken by the header
+    static constexpr uint32_t kMagic = 0x4E564246; ///< "NVBF" in the header's first bytes
+
+    /**
+     * @brief Constructs a verifier for a block size and run seed.
+     *
+     * @param block_size Logical block size of the target in bytes
+     * @param seed Seed recorded in written headers and expected in read ones
+     *
+     * @throws std::invalid_argument If the block size is smaller than twice the header
+     */
+    BlockVerifier(uint32_t block_size, uint64_t seed);
+
+    /**
+     * @brief Stamps a header and checksum into each block of a write buffer.
+     *
+     * All blocks of one call share a new write generation.
+     *
+     * @param buffer The filled write buffer
+     * @param offset Byte offset of the write, a multiple of the block size
+     * @param size Bytes to stamp, a multiple of the block size
+     *
+     * @return The write generation stamped into the blocks
+     */
+    uint64_t Stamp(void* buffer, uint64_t offset, uint32_t size);
+
+    /**
+     * @brief Stamps a write buffer with a generation taken earlier.
+     *
+     * Does not modify the verifier, so writes can be stamped on other threads
+     * with generations drawn by NextGeneration() on the submitting thread.
+     *
+     * @param buffer The filled write buffer
+     * @param offset Byte offset of the write, a multiple of the block size
+     * @param size Bytes to stamp, a multiple of the block size
+     * @param generation Write generation to stamp into the blocks
+     */
+    void Stamp(void* buffer, uint64_t offset, uint32_t size, uint64_t generation) const;
+
+    /**
+     * @brief Takes the write generation of the next write.
+     *
+     * @return A generation no earlier write was stamped with
+     */
+    uint64_t NextGeneration();
+
+    /**
+     * @brief Checks each block of a read buffer.
+     *
+     * @param buffer The data read
+     * @param offset Byte offset of the read, a multiple of the block size
+     * @param size Bytes to check, a multiple of the block size
+     * @param stats Counters the results are added to
+     *
+     * @return The number of blocks that failed verification
+     */
+    uint32_t Verify(const void* buffer, uint64_t offset, uint32_t size, VerifyStats& stats) const;
+
+    /**
+     * @brief Gets the logical block size.
+     *
+     * @return Block size in bytes
+     */
+    uint32_t GetBlockSize() const;
+
+    /**
+     * @brief Gets the run seed.
+     *
+     * @return The seed recorded in headers
+     */
+    uint64_t GetSeed() const;
+
+private:
+    uint32_t block_size_;   ///< Logical block size in bytes
+    uint64_t seed_;         ///< Seed recorded in headers
+    uint64_t generation_;   ///< Generation of the last stamped write
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
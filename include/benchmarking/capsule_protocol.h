@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Simplified NVMe/TCP PDUs exchanged with a LoopbackTarget.
+ *
+ * The protocol keeps the structure of NVMe/TCP: a connection starts with an
+ * initialize request / response exchange, each I/O is a command capsule, write
+ * data follows its capsule in a host-to-controller data PDU, read data returns
+ * in a controller-to-host data PDU, and every command ends with a response
+ * capsule. Flow control (R2T), digests and the full 64-byte SQE are omitted.
+ * Every PDU starts with a PduHeader whose plen covers the header, the PDU
+ * specific fields and any data. Fields are in host byte order; both ends run
+ * on the same machine.
+ */
+namespace capsule {
+
+/**
+ * @brief PDU types; values match the NVMe/TCP PDU types.
+ */
+enum class PduType : uint8_t {
+    IC_REQ = 0x00,       ///< Initialize connection request (host to target)
+    IC_RESP = 0x01,      ///< Initialize connection response
+    CAPSULE_CMD = 0x04,  ///< Command capsule
+    CAPSULE_RESP = 0x05, ///< Response capsule
+    H2C_DATA = 0x06,     ///< Write data (host to controller)
+    C2H_DATA = 0x07      ///< Read data (controller to host)
+};
+
+constexpr uint16_t kProtocolVersion = 1;  ///< Value of IcReqPdu::pfv and IcRespPdu::pfv
+constexpr uint8_t kOpcodeWrite = 0x01;    ///< NVM write opcode
+constexpr uint8_t kOpcodeRead = 0x02;     ///< NVM read opcode
+
+/// Status of a response capsule: (status code type << 8) | status code
+constexpr uint16_t kStatusSuccess = 0x0000;
+constexpr uint16_t kStatusInvalidField = 0x0002;           ///< Invalid field in command
+constexpr uint16_t kStatusInternalError = 0x0006;          ///< Internal device error
+constexpr uint16_t kStatusInvalidNamespace = 0x000b;       ///< Invalid namespace or format
+
+/**
+ * @brief Common header of every PDU.
+ */
+struct PduHeader {
+    uint8_t type;   ///< PduType
+    uint8_t flags;  ///< Reserved, zero
+    uint8_t hlen;   ///< Length of the PDU header, including this common header
+    uint8_t pdo;    ///< Offset of the data from the start of the PDU, 0 without data
+    uint32_t plen;  ///< Total length of the PDU in bytes
+};
+
+/**
+ * @brief Initialize connection request.
+ */
+struct IcReqPdu {
+    PduHeader header;
+    uint16_t pfv;           ///< Protocol version
+    uint16_t queue_depth;   ///< Maximum commands the host keeps outstanding
+    uint32_t namespace_id;  ///< Namespace the connection addresses
+};
+
+/**
+ * @brief Initialize connection response.
+ */
+struct IcRespPdu {
+    PduHeader header;
+    uint16_t pfv;            ///< Protocol version
+    uint16_t status;         ///< kStatusSuccess, or why the connection is refused
+    uint32_t sector_size;    ///< Sector size of the namespace
+    uint64_t num_sectors;    ///< Capacity of the namespace in sectors
+    uint32_t max_data_size;  ///< Largest data transfer of one command in bytes
+    uint32_t reserved;
+};
+
+/**
+ * @brief Command capsule.
+ */
+struct CapsuleCmdPdu {
+    PduHeader header;
+    uint8_t opcode;         ///< kOpcodeRead or kOpcodeWrite
+    uint8_t reserved;
+    uint16_t cid;           ///< Command identifier, below the negotiated queue depth
+    uint32_t namespace_id;  ///< Namespace of the command
+    uint64_t slba;          ///< Starting LBA
+    uint32_t nlb;           ///< Number of logical blocks (not zero-based)
+    uint32_t data_length;   ///< Bytes transferred, nlb * sector size
+};
+
+/**
+ * @brief Response capsule.
+ */
+struct CapsuleRespPdu {
+    PduHeader header;
+    uint16_t cid;     ///< Command identifier
+    uint16_t status;  ///< (status code type << 8) | status code
+    uint32_t reserved;
+};
+
+/**
+ * @brief Header of an H2C or C2H data PDU; data_length bytes of data follow it.
+ */
+struct DataPdu {
+    PduHeader header;
+    uint16_t cid;          ///< Command identifier
+    uint16_t reserved;
+    uint32_t data_offset;  ///< Offset of this data within the command's transfer
+    uint32_t data_length;  ///< Bytes of data in this PDU
+    uint32_t reserved2;
+};
+
+static_assert(sizeof(PduHeader) == 8, "Unexpected PDU header layout");
+static_assert(sizeof(IcReqPdu) == 16, "Unexpected ICReq layout");
+static_assert(sizeof(IcRespPdu) == 32, "Unexpected ICResp layout");
+static_assert(sizeof(CapsuleCmdPdu) == 32, "Unexpected command capsule layout");
+static_assert(sizeof(CapsuleRespPdu) == 16, "Unexpected response capsule layout");
+static_assert(sizeof(DataPdu) == 24, "Unexpected data PDU layout");
+
+/**
+ * @brief Creates a zeroed PDU with its common header filled in.
+ *
+ * @param type The PDU type
+ * @param data_length Bytes of data following the PDU header
+ *
+ * @return The PDU
+ */
+template <typename Pdu>
+Pdu MakePdu(PduType type, uint32_t data_length = 0) {
+    Pdu pdu{};
+    pdu.header.type = static_cast<uint8_t>(type);
+    pdu.header.hlen = static_cast<uint8_t>(sizeof(Pdu));
+    pdu.header.pdo = data_length > 0 ? static_cast<uint8_t>(sizeof(Pdu)) : 0;
+    pdu.header.plen = static_cast<uint32_t>(sizeof(Pdu)) + data_length;
+    return pdu;
+}
+
+/**
+ * @brief Gets the header length a PDU type must have.
+ *
+ * @param type The PDU type
+ *
+ * @return The header length, or 0 for an unknown type
+ */
+size_t GetPduHeaderLength(uint8_t type);
+
+/**
+ * @brief Opens a listening socket.
+ *
+ * @param address "host:port" for TCP (port 0 picks a free port) or "unix:/path"
+ * @param bound_address Set to the address clients connect to, with the actual port
+ *
+ * @return Socket descriptor, or -1 after printing an error
+ */
+int ListenOnAddress(const std::string& address, std::string* bound_address);
+
+/**
+ * @brief Connects to a listening socket; TCP connections disable Nagle's algorithm.
+ *
+ * @param address "host:port" or "unix:/path"
+ *
+ * @return Socket descriptor, or -1 after printing an error
+ */
+int ConnectToAddress(const std::string& address);
+
+/**
+ * @brief Sends a whole buffer on a blocking socket.
+ *
+ * @param fd The socket
+ * @param data The bytes to send
+ * @param length Number of bytes
+ *
+ * @return true if everything was sent
+ */
+bool SendAll(int fd, const void* data, size_t length);
+
+/**
+ * @brief Receives exactly length bytes from a blocking socket.
+ *
+ * @param fd The socket
+ * @param data Destination
+ * @param length Number of bytes
+ *
+ * @return true if the bytes were received, false on error or end of stream
+ */
+bool ReceiveAll(int fd, void* data, size_t length);
+
+}  // namespace capsule
+
+}  // namespace benchmarking
+}  // namespace nvmeof
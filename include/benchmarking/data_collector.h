@@ -1,11 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <mutex>
 #include <chrono>
-#include <fstream>
 #include <memory>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include "latency_histogram.h"
+#include "metric_registry.h"
+#include "stream_compression.h"
 
 namespace nvmeof {
 namespace benchmarking {
@@ -33,45 +40,169 @@ struct DataPoint {
  * @brief Formats for data collection output.
  */
 enum class OutputFormat {
-    CSV,      ///< Comma-separated values
-    JSON,     ///< JSON format
-    PLAINTEXT ///< Plain text format
+    CSV,       ///< Comma-separated values
+    JSON,      ///< JSON format
+    PLAINTEXT, ///< Plain text format
+    BINARY     ///< Binary columnar format, read with ResultFileReader
 };
 
+/**
+ * @brief Parses an output format name ("csv", "json", "text", "binary").
+ *
+ * @param name The format name (case-insensitive)
+ *
+ * @return The matching format
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+OutputFormat ParseOutputFormat(const std::string& name);
+
+/**
+ * @brief Gets the file extension used for an output format.
+ *
+ * @param format The format
+ *
+ * @return Extension including the dot, e.g. ".csv"
+ */
+const char* GetOutputFormatExtension(OutputFormat format);
+
+/**
+ * @brief Which written data points a collector keeps in memory for live queries.
+ */
+enum class RetentionMode {
+    NONE,        ///< Keep nothing; points go only to the output file
+    LAST_N,      ///< Keep the most recent max_points points
+    TIME_WINDOW  ///< Keep the points collected within the last window
+};
+
+/**
+ * @brief In-memory retention of a DataCollector.
+ *
+ * The output file always receives the full history; retention only bounds
+ * what GetRecentDataPoints() can return.
+ */
+struct RetentionPolicy {
+    RetentionMode mode = RetentionMode::NONE;  ///< What to keep
+    size_t max_points = 0;                     ///< Points kept in LAST_N mode; in TIME_WINDOW mode an optional cap (0 = none)
+    std::chrono::milliseconds window{0};       ///< Age of the points kept in TIME_WINDOW mode
+};
+
+/**
+ * @brief Data point passed from a collecting thread to the writer thread.
+ *
+ * Names are resolved through the collector's MetricRegistry when the point is written.
+ */
+struct DataRecord {
+    int64_t timestamp_ns;  ///< Collection time, nanoseconds since the system clock's epoch
+    double value;          ///< Numeric value of the data point
+    MetricHandle metric;   ///< Label and units of the data point
+    uint32_t reserved;     ///< Padding
+};
+
+class DataPointRing;
+class ResultFileEncoder;
+
 /**
  * @brief Collects and stores benchmark data points.
  * 
- * This class is responsible for collecting data points during benchmark execution
- * and storing them in the specified output file format.
+ * Collecting a data point does not lock, allocate or format anything: metrics
+ * are registered once for a handle, each thread appends (handle, timestamp,
+ * value) records to its own single-producer ring, and a background writer
+ * thread drains all rings every few milliseconds, formats the records in
+ * timestamp order and writes them to the output file in large writes. A full
+ * ring drops the new data point rather than blocking the caller; drops are
+ * counted and reported when the collector is destroyed. Memory is bounded by
+ * kMaxRings rings of ring_capacity records; rings of threads that have exited
+ * are reused. The binary format is written in blocks of up to
+ * ResultFileEncoder::kBlockRecords points; a partial block is written on
+ * Flush(), after a second, and when the collector is destroyed. Text formats
+ * can be compressed on the writer thread (CompressionMode::LZ); compressed
+ * frames are written on the same schedule as binary blocks.
  */
 class DataCollector {
 public:
+    static constexpr size_t kDefaultRingCapacity = 4096;  ///< Records per thread by default
+    static constexpr size_t kMaxRings = 64;               ///< Threads that may collect at once
+
     /**
      * @brief Constructs a DataCollector with the specified output file and format.
      * 
      * @param output_file Path to the file where data will be stored
      * @param format Format of the output file (default: CSV)
+     * @param ring_capacity Records buffered per collecting thread, rounded up to a power of two
+     * @param compression Compression of the output file (default: none)
      * 
      * @throws std::runtime_error If the output file cannot be opened for writing
+     * @throws std::invalid_argument If ring_capacity is zero, or if compression
+     *         is requested for the binary format, which is already column-encoded
      */
-    explicit DataCollector(const std::string& output_file, OutputFormat format = OutputFormat::CSV);
+    explicit DataCollector(const std::string& output_file, OutputFormat format = OutputFormat::CSV,
+                           size_t ring_capacity = kDefaultRingCapacity,
+                           CompressionMode compression = CompressionMode::NONE);
     
     /**
-     * @brief Destroys the DataCollector, flushing any pending data to disk.
+     * @brief Destroys the DataCollector, writing all pending data to disk.
      */
     ~DataCollector();
 
+    DataCollector(const DataCollector&) = delete;
+    DataCollector& operator=(const DataCollector&) = delete;
+
+    /**
+     * @brief Registers a metric for CollectDataPoint(MetricHandle, double).
+     * 
+     * Registering the same label and units again returns the same handle.
+     * 
+     * @param label Label describing the data points
+     * @param units Units of measurement (e.g., "MB/s", "µs")
+     * 
+     * @return The metric's handle
+     */
+    MetricHandle RegisterMetric(const std::string& label, const std::string& units);
+
+    /**
+     * @brief Collects a data point of a registered metric.
+     * 
+     * Safe to call from any number of threads without contention; the point is
+     * written by the writer thread.
+     * 
+     * @param metric Handle returned by RegisterMetric()
+     * @param value Numeric value of the data point
+     * 
+     * @return true if the data point was queued, false if the handle is unknown or
+     *         the point was dropped because the calling thread's ring is full or no
+     *         ring is free
+     */
+    bool CollectDataPoint(MetricHandle metric, double value);
+
     /**
      * @brief Collects a data point with the specified value and label.
      * 
+     * The names are looked up in a per-thread cache of registered metrics, so
+     * only the first point of a metric on each thread registers it.
+     * 
      * @param label Label describing the data point
      * @param value Numeric value of the data point
      * @param units Units of measurement (e.g., "MB/s", "µs")
      * 
-     * @return true if the data point was collected successfully, false otherwise
+     * @return true if the data point was queued, false if it was dropped because
+     *         the calling thread's ring is full or no ring is free
      */
     bool CollectDataPoint(const std::string& label, double value, const std::string& units);
 
+    /**
+     * @brief Collects the standard latency percentiles of a histogram.
+     * 
+     * One data point in microseconds is collected for each of p50, p90, p99,
+     * p99.9, p99.99 and max, labelled "<label> p50" and so on.
+     * 
+     * @param label Label prefix, e.g. "Read Latency"
+     * @param histogram Histogram holding the latencies in nanoseconds
+     * 
+     * @return true if all data points were collected successfully, false otherwise
+     */
+    bool CollectLatencyPercentiles(const std::string& label, const LatencyHistogram& histogram);
+
     /**
      * @brief Collects a data point as a string.
      * 
@@ -85,49 +216,183 @@ public:
     bool CollectData(const std::string& data_point);
 
     /**
-     * @brief Flushes all collected data points to the output file.
+     * @brief Writes all data points queued so far to the output file.
+     * 
+     * Blocks until the writer thread has drained every ring and written the result.
      * 
-     * @return true if the data was flushed successfully, false otherwise
+     * @return true if all writes so far succeeded, false otherwise
      */
     bool Flush();
 
     /**
      * @brief Gets the number of data points collected.
      * 
-     * @return The number of data points collected
+     * @return The number of data points queued, excluding dropped ones
      */
     size_t GetDataPointCount() const;
 
+    /**
+     * @brief Gets the number of data points dropped because a ring was full.
+     * 
+     * @return The number of dropped data points
+     */
+    size_t GetDroppedCount() const;
+
+    /**
+     * @brief Sets which written data points are kept in memory.
+     * 
+     * Points already retained are trimmed to the new policy. Retention is off
+     * (RetentionMode::NONE) by default.
+     * 
+     * @param policy The retention policy
+     * 
+     * @throws std::invalid_argument If a LAST_N policy keeps no points or a
+     *         TIME_WINDOW policy has no window
+     */
+    void SetRetentionPolicy(const RetentionPolicy& policy);
+
+    /**
+     * @brief Gets the retention policy.
+     * 
+     * @return The policy set last
+     */
+    RetentionPolicy GetRetentionPolicy() const;
+
+    /**
+     * @brief Gets the retained data points, oldest first.
+     * 
+     * Only points the writer thread has drained are retained; call Flush()
+     * first to include everything collected so far.
+     * 
+     * @return The retained data points
+     */
+    std::vector<DataPoint> GetRecentDataPoints() const;
+
+    /**
+     * @brief Gets the retained data points of one metric, oldest first.
+     * 
+     * @param metric Handle of the metric
+     * 
+     * @return The retained data points of the metric
+     */
+    std::vector<DataPoint> GetRecentDataPoints(MetricHandle metric) const;
+
+    /**
+     * @brief Gets the registry resolving the handles of the collected data points.
+     * 
+     * @return The registry
+     */
+    const MetricRegistry& GetMetricRegistry() const;
+
 private:
     /**
-     * @brief Writes the header to the output file based on the selected format.
+     * @brief Gets the calling thread's ring, registering one on first use.
      * 
-     * @return true if the header was written successfully, false otherwise
+     * @return The ring, or nullptr if kMaxRings rings are in use
      */
-    bool WriteHeader();
+    DataPointRing* GetThreadRing();
 
     /**
-     * @brief Writes a data point to the output file based on the selected format.
+     * @brief Drains the rings and writes the data until the collector is destroyed.
+     */
+    void WriterLoop();
+
+    /**
+     * @brief Moves all queued records to the output buffer in timestamp order.
+     */
+    void DrainRings();
+
+    /**
+     * @brief Adds the drained batch to the retained points and trims them.
+     */
+    void RetainBatch();
+
+    /**
+     * @brief Drops retained points the policy no longer keeps; needs retained_mutex_.
+     */
+    void TrimRetained();
+
+    /**
+     * @brief Copies retained points of a metric, or of all metrics, as data points.
+     */
+    std::vector<DataPoint> CopyRetained(bool all_metrics, MetricHandle metric) const;
+
+    /**
+     * @brief Formats the header into the output buffer based on the selected format.
+     */
+    void WriteHeader();
+
+    /**
+     * @brief Resolves a record's metric, caching it for the writer thread.
+     * 
+     * @param handle Metric handle
+     * 
+     * @return The metric
+     */
+    const Metric& ResolveMetric(MetricHandle handle);
+
+    /**
+     * @brief Formats a record into the output buffer based on the selected format.
      * 
-     * @param data_point The data point to write
+     * @param record The record to format
+     */
+    void WriteRecord(const DataRecord& record);
+
+    /**
+     * @brief Formats the footer into the output buffer based on the selected format.
+     */
+    void WriteFooter();
+
+    /**
+     * @brief Writes the output buffer to the file, compressed if requested, and empties it.
      * 
-     * @return true if the data point was written successfully, false otherwise
+     * @return true if the data was written, false otherwise
      */
-    bool WriteDataPoint(const DataPoint& data_point);
+    bool WriteBuffer();
 
     /**
-     * @brief Writes the footer to the output file based on the selected format.
+     * @brief Writes bytes to the file.
+     * 
+     * @param data Bytes to write
      * 
-     * @return true if the footer was written successfully, false otherwise
+     * @return true if the data was written, false otherwise
      */
-    bool WriteFooter();
+    bool WriteAll(const std::string& data);
 
     std::string output_file_;             ///< Path to the output file
     OutputFormat format_;                 ///< Format of the output file
-    std::vector<DataPoint> data_points_;  ///< Collected data points
-    std::ofstream file_stream_;           ///< Output file stream
-    mutable std::mutex mutex_;            ///< Mutex for thread safety
-    bool header_written_;                 ///< Flag indicating whether the header has been written
+    size_t ring_capacity_;                ///< Records per ring
+    uint64_t id_;                         ///< Distinguishes this collector in the per-thread ring lists
+    int fd_;                              ///< Output file descriptor
+    MetricRegistry registry_;             ///< Names of the collected metrics
+
+    mutable std::mutex rings_mutex_;                     ///< Guards rings_
+    std::vector<std::shared_ptr<DataPointRing>> rings_;  ///< One ring per collecting thread
+    std::atomic<uint64_t> unregistered_drops_;           ///< Points dropped for lack of a ring
+
+    std::thread writer_thread_;           ///< Drains the rings
+    std::mutex writer_mutex_;             ///< Guards the writer state below
+    std::condition_variable writer_cv_;   ///< Wakes the writer early
+    std::condition_variable flushed_cv_;  ///< Signals completed flushes
+    bool stop_;                           ///< Set when the writer should exit
+    uint64_t flush_requested_;            ///< Flush requests made
+    uint64_t flush_completed_;            ///< Flush requests served
+    std::atomic<bool> write_failed_;      ///< Set if a write to the file failed
+
+    mutable std::mutex retained_mutex_;   ///< Guards the retention state below
+    RetentionPolicy retention_;           ///< Points kept in memory
+    std::deque<DataRecord> retained_;     ///< Written points kept for live queries, oldest first
+
+    // Writer thread only
+    std::unique_ptr<ResultFileEncoder> encoder_;           ///< Block encoder for OutputFormat::BINARY
+    std::unique_ptr<CompressedStreamEncoder> compressor_;  ///< Frame encoder for CompressionMode::LZ
+    std::string compressed_;                               ///< Compressed frame awaiting a write
+    std::vector<DataRecord> batch_;                        ///< Records drained in one pass
+    std::vector<const Metric*> metrics_;                   ///< Metrics resolved so far, by handle
+    std::string buffer_;                                   ///< Formatted output awaiting a write
+    uint64_t written_;                                     ///< Data points formatted
+    int64_t cached_second_;                                ///< Second of cached_timestamp_
+    char cached_timestamp_[32];                            ///< Formatted local time of cached_second_
 };
 
 }  // namespace benchmarking
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Fixed-size pool of pre-allocated, aligned DMA buffers.
+ *
+ * All buffers are carved from a single DMA allocation made at construction,
+ * so the I/O path never calls into the DMA allocator. Acquire() and Release()
+ * are lock-free and may be called concurrently from any thread, which lets
+ * several I/O engines share one pool.
+ */
+class DmaBufferPool {
+public:
+    /**
+     * @brief Allocates a pool of buffers.
+     *
+     * @param buffer_size Size of each buffer in bytes (rounded up to the alignment)
+     * @param buffer_count Number of buffers in the pool
+     * @param alignment Alignment of each buffer in bytes (power of two)
+     *
+     * @throws std::invalid_argument If a parameter is zero or the alignment is not a power of two
+     * @throws std::runtime_error If the DMA memory cannot be allocated
+     */
+    DmaBufferPool(size_t buffer_size, uint32_t buffer_count, size_t alignment = 4096);
+
+    /**
+     * @brief Frees the DMA memory backing the pool.
+     *
+     * All buffers must have been released before the pool is destroyed.
+     */
+    ~DmaBufferPool();
+
+    DmaBufferPool(const DmaBufferPool&) = delete;
+    DmaBufferPool& operator=(const DmaBufferPool&) = delete;
+
+    /**
+     * @brief Takes a buffer from the pool.
+     *
+     * @return Pointer to a buffer of GetBufferSize() bytes, or nullptr if the pool is empty
+     */
+    void* Acquire();
+
+    /**
+     * @brief Returns a buffer to the pool.
+     *
+     * @param buffer A buffer previously obtained from Acquire() on this pool
+     */
+    void Release(void* buffer);
+
+    /**
+     * @brief Checks whether a pointer is a buffer of this pool.
+     *
+     * @param buffer The pointer to check
+     *
+     * @return true if the pointer is the start of one of the pool's buffers
+     */
+    bool Owns(const void* buffer) const;
+
+    /**
+     * @brief Gets the usable size of each buffer.
+     *
+     * @return Buffer size in bytes
+     */
+    size_t GetBufferSize() const;
+
+    /**
+     * @brief Gets the total number of buffers in the pool.
+     *
+     * @return Number of buffers
+     */
+    uint32_t GetBufferCount() const;
+
+    /**
+     * @brief Gets the number of buffers currently available.
+     *
+     * @return Number of buffers that can be acquired (a snapshot under concurrency)
+     */
+    uint32_t GetAvailableCount() const;
+
+    /**
+     * @brief Gets the single allocation all buffers are carved from.
+     *
+     * Lets I/O engines register the whole pool with the kernel at once.
+     *
+     * @return Start of the region
+     */
+    const void* GetRegion() const;
+
+    /**
+     * @brief Gets the size of the region returned by GetRegion().
+     *
+     * @return Region size in bytes
+     */
+    size_t GetRegionSize() const;
+
+private:
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;  ///< Free-list terminator
+
+    uint8_t* region_;                               ///< Single DMA allocation holding all buffers
+    size_t buffer_size_;                            ///< Stride between buffers
+    uint32_t buffer_count_;                         ///< Number of buffers
+    std::unique_ptr<std::atomic<uint32_t>[]> next_; ///< Free-list links by buffer index
+    std::atomic<uint64_t> head_;                    ///< Free-list head: ABA tag (high) | index (low)
+    std::atomic<uint32_t> available_;               ///< Number of free buffers
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
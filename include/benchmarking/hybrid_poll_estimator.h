@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Estimates how long a hybrid-polling thread may sleep before it polls.
+ *
+ * The expected service time is an exponentially weighted moving average of
+ * the service times of completed commands. While commands are in flight the
+ * thread sleeps until a fraction of that time has passed since the oldest
+ * submission, then busy-polls. The fraction adapts to how each sleep ended:
+ * finding a completion on the first poll after waking suggests the thread
+ * overslept and shortens later sleeps, while a long spin lengthens them.
+ * Timer slack makes the thread wake later than asked; the average overshoot
+ * is tracked as well and subtracted from each sleep.
+ */
+class HybridPollEstimator {
+public:
+    /**
+     * @brief Constructs an estimator with no service time history.
+     *
+     * @param initial_fraction Share of the expected service time slept at first
+     * @param smoothing Weight of each new sample in the moving average
+     *
+     * @throws std::invalid_argument If a parameter is not in (0, 1]
+     */
+    explicit HybridPollEstimator(double initial_fraction = 0.5, double smoothing = 0.125);
+
+    /**
+     * @brief Adds the service time of a completed command to the average.
+     *
+     * @param service_ns Time from submission to completion in nanoseconds
+     */
+    void RecordServiceTime(uint64_t service_ns);
+
+    /**
+     * @brief Adapts the sleep fraction to the outcome of a sleep.
+     *
+     * @param empty_polls Polls after waking that found no completion
+     * @param spin_ns Time spent polling after waking until the first completion
+     */
+    void RecordWakeup(uint32_t empty_polls, uint64_t spin_ns);
+
+    /**
+     * @brief Adds how much a sleep overran the requested time to its average.
+     *
+     * @param requested_ns Time the thread asked to sleep
+     * @param actual_ns Time the thread was actually asleep
+     */
+    void RecordSleep(uint64_t requested_ns, uint64_t actual_ns);
+
+    /**
+     * @brief Gets how long to sleep before polling.
+     *
+     * @param oldest_submit_ns Submission time of the oldest command in flight
+     * @param now_ns Current time on the same clock
+     *
+     * @return Sleep time in nanoseconds; 0 if polling should start right away
+     */
+    uint64_t GetSleepNs(uint64_t oldest_submit_ns, uint64_t now_ns) const;
+
+    /**
+     * @brief Gets the moving average of the service time.
+     *
+     * @return Expected service time in nanoseconds, 0 before the first sample
+     */
+    uint64_t GetExpectedServiceNs() const;
+
+    /**
+     * @brief Gets the current share of the expected service time that is slept.
+     *
+     * @return The sleep fraction
+     */
+    double GetSleepFraction() const;
+
+private:
+    double fraction_;        ///< Share of the expected service time slept
+    double smoothing_;       ///< Weight of a new sample in the average
+    double expected_ns_;     ///< Moving average of the service time, 0 without samples
+    double oversleep_ns_;    ///< Moving average of the time slept past a requested wakeup
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
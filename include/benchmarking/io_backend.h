@@ -0,0 +1,245 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <memory>
+
+namespace nvmeof {
+namespace benchmarking {
+
+class DmaBufferPool;
+
+/**
+ * @brief I/O engine used to reach the target.
+ */
+enum class IoEngine {
+    SPDK,      ///< User-space NVMe driver (or the SPDK mock) through an I/O queue pair
+    IO_URING,  ///< Kernel block layer through io_uring, e.g. /dev/nvmeXnY over nvme-tcp/rdma
+    LIBAIO,    ///< Kernel block layer through Linux native AIO (io_submit / io_getevents)
+    PSYNC,     ///< Blocking pread / pwrite, one command at a time per worker thread
+    TCP        ///< Capsule protocol over TCP or a Unix socket to a LoopbackTarget
+};
+
+/**
+ * @brief Parses an I/O engine name.
+ *
+ * @param name "spdk", "io_uring", "libaio", "psync" or "tcp" (case-insensitive)
+ *
+ * @return The engine
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+IoEngine ParseIoEngine(const std::string& name);
+
+/**
+ * @brief Gets the name of an I/O engine.
+ *
+ * @param engine The engine
+ *
+ * @return The name accepted by ParseIoEngine()
+ */
+std::string GetIoEngineName(IoEngine engine);
+
+/**
+ * @brief Selects and configures the I/O engine of a job.
+ *
+ * The SPDK and TCP engines address WorkloadProfile::namespace_id on the
+ * controller or the target at address; kernel engines open filename instead.
+ */
+struct IoBackendOptions {
+    IoEngine engine = IoEngine::SPDK;  ///< Engine used by the workers
+    std::string filename;              ///< File or block device opened by kernel engines
+    std::string address;               ///< tcp: target address, "host:port" or "unix:/path"
+    bool direct = true;                ///< Open with O_DIRECT, bypassing the page cache
+    uint64_t file_size = 0;            ///< Size a regular file is created or grown to; 0 keeps its size
+    uint32_t sector_size = 0;          ///< Logical block size; 0 detects it (512 for regular files)
+    bool registered_buffers = false;   ///< io_uring: register the buffer pool (READ_FIXED/WRITE_FIXED)
+    bool registered_files = false;     ///< io_uring: register the file descriptor
+    bool sqpoll = false;               ///< io_uring: kernel thread polls the submission queue
+    uint32_t sqpoll_idle_ms = 1000;    ///< io_uring: idle time before the SQPOLL thread sleeps
+    bool iopoll = false;               ///< io_uring: busy-poll the device for completions (needs direct)
+    uint32_t submit_batch = 1;         ///< io_uring, libaio, tcp: queued commands per submission system call
+
+    /**
+     * @brief Validates the options.
+     *
+     * @return true if the options are consistent, false otherwise
+     */
+    bool IsValid() const {
+        if (engine == IoEngine::SPDK) {
+            return true;
+        }
+        if (engine == IoEngine::TCP) {
+            return !address.empty() && submit_batch > 0;
+        }
+        return !filename.empty() &&
+               submit_batch > 0 &&
+               (sector_size == 0 || (sector_size >= 512 && (sector_size & (sector_size - 1)) == 0)) &&
+               (!iopoll || direct);
+    }
+};
+
+/**
+ * @brief Opens the file or block device of a kernel-path backend.
+ *
+ * Regular files are created if missing and grown to options.file_size. The
+ * block size is options.sector_size, else the logical block size of a block
+ * device, else 512 bytes.
+ *
+ * @param options Target settings (filename, direct, file_size, sector_size)
+ * @param size Set to the capacity in bytes, rounded down to whole blocks
+ * @param sector_size Set to the block size
+ *
+ * @return File descriptor, or -1 after printing an error
+ */
+int OpenBackendFile(const IoBackendOptions& options, uint64_t* size, uint32_t* sector_size);
+
+/**
+ * @brief Completion callback of a backend command.
+ *
+ * @param cb_arg Argument given at submission
+ * @param status 0 on success; an NVMe status code or a negative errno on failure
+ */
+using IoBackendCallback = void (*)(void* cb_arg, int status);
+
+/**
+ * @brief Asynchronous block I/O path driven by a WorkloadGenerator.
+ *
+ * A backend owns one submission/completion queue and is used from a single
+ * thread. Commands are submitted with a sector-aligned byte offset and length
+ * and complete from ProcessCompletions(), which invokes their callbacks; a
+ * callback may submit again.
+ */
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    /**
+     * @brief Creates a kernel-path or fabric backend.
+     *
+     * SPDK backends are bound to a queue pair and constructed directly.
+     *
+     * @param options Engine and its settings
+     * @param queue_depth Number of commands that may be outstanding
+     * @param namespace_id Namespace addressed by a TCP backend
+     *
+     * @return The backend, not yet opened
+     *
+     * @throws std::invalid_argument If the options are invalid or select the SPDK engine
+     */
+    static std::unique_ptr<IoBackend> Create(const IoBackendOptions& options, uint32_t queue_depth,
+                                             uint32_t namespace_id = 1);
+
+    /**
+     * @brief Opens the target; calling it again on an open backend does nothing.
+     *
+     * @return true if the backend is ready for I/O, false otherwise
+     */
+    virtual bool Open() = 0;
+
+    /**
+     * @brief Closes the target, first waiting for or cancelling the commands still outstanding.
+     *
+     * Callbacks of those commands are not invoked. Calling it again, or on a
+     * backend that was never opened, does nothing; Open() may be called again.
+     *
+     * @return true if no command remains outstanding, false if some may still
+     *         access their buffers
+     */
+    virtual bool Close() = 0;
+
+    /**
+     * @brief Gets the engine name for reports.
+     *
+     * @return The engine name
+     */
+    virtual std::string GetName() const = 0;
+
+    /**
+     * @brief Gets the logical block size of the open target.
+     *
+     * @return Block size in bytes; offsets and lengths must be multiples of it
+     */
+    virtual uint32_t GetSectorSize() const = 0;
+
+    /**
+     * @brief Gets the capacity of the open target.
+     *
+     * @return Size in bytes
+     */
+    virtual uint64_t GetSize() const = 0;
+
+    /**
+     * @brief Lets the backend pre-register the buffers it will be given.
+     *
+     * @param pool The pool the I/O buffers come from
+     */
+    virtual void RegisterBuffers(const DmaBufferPool& pool) {
+        (void)pool;
+    }
+
+    /**
+     * @brief Submits a read.
+     *
+     * @param buffer Destination of length bytes
+     * @param offset Byte offset on the target
+     * @param length Number of bytes
+     * @param cb Completion callback
+     * @param cb_arg Argument passed to the callback
+     *
+     * @return 0 if submitted, -ENOMEM if the queue is full, negative errno otherwise
+     */
+    virtual int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                           IoBackendCallback cb, void* cb_arg) = 0;
+
+    /**
+     * @brief Submits a write.
+     *
+     * @param buffer Source of length bytes
+     * @param offset Byte offset on the target
+     * @param length Number of bytes
+     * @param cb Completion callback
+     * @param cb_arg Argument passed to the callback
+     *
+     * @return 0 if submitted, -ENOMEM if the queue is full, negative errno otherwise
+     */
+    virtual int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                            IoBackendCallback cb, void* cb_arg) = 0;
+
+    /**
+     * @brief Reaps completed commands and invokes their callbacks.
+     *
+     * @param max_completions Maximum number of completions to reap, or 0 for no limit
+     *
+     * @return Number of completions reaped, or negative errno on failure
+     */
+    virtual int32_t ProcessCompletions(uint32_t max_completions) = 0;
+
+    /**
+     * @brief Waits until a command completes or the timeout elapses, then reaps like ProcessCompletions().
+     *
+     * Kernel and socket engines sleep in the kernel until a completion is
+     * signalled. The default polls with short sleeps in between, which is the
+     * closest a polled-mode driver such as SPDK comes to interrupts.
+     *
+     * @param max_completions Maximum number of completions to reap, or 0 for no limit
+     * @param timeout_ns Longest time to wait in nanoseconds
+     *
+     * @return Number of completions reaped (0 on timeout), or negative errno on failure
+     */
+    virtual int32_t WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns);
+
+    /**
+     * @brief Gets the number of doorbell writes or submission system calls made.
+     *
+     * Set against the number of commands, this shows what batching saves.
+     *
+     * @return Submission calls since Open(), 0 if the backend does not count them
+     */
+    virtual uint64_t GetSubmitCalls() const {
+        return 0;
+    }
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <deque>
+#include <vector>
+#include "io_backend.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief I/O backend that drives a file or block device through io_uring.
+ *
+ * The ring is set up with the raw system calls, so no liburing is needed. It
+ * supports registered buffers (the whole DmaBufferPool is registered as one
+ * fixed buffer), a registered file descriptor, kernel-side submission polling
+ * (SQPOLL), completion polling (IOPOLL, which requires O_DIRECT and a polled
+ * device queue) and fixed-size submission batches. Only available on Linux;
+ * elsewhere Open() fails.
+ */
+class IoUringBackend : public IoBackend {
+public:
+    /**
+     * @brief Constructs an io_uring backend.
+     *
+     * @param options Target file and io_uring settings
+     * @param queue_depth Number of commands that may be outstanding
+     *
+     * @throws std::invalid_argument If the options are invalid or the queue depth is zero
+     */
+    IoUringBackend(const IoBackendOptions& options, uint32_t queue_depth);
+
+    /**
+     * @brief Tears down the ring and closes the target.
+     *
+     * Outstanding commands must have completed.
+     */
+    ~IoUringBackend() override;
+
+    IoUringBackend(const IoUringBackend&) = delete;
+    IoUringBackend& operator=(const IoUringBackend&) = delete;
+
+    bool Open() override;
+    bool Close() override;
+    std::string GetName() const override;
+    uint32_t GetSectorSize() const override;
+    uint64_t GetSize() const override;
+    void RegisterBuffers(const DmaBufferPool& pool) override;
+    int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                   IoBackendCallback cb, void* cb_arg) override;
+    int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                    IoBackendCallback cb, void* cb_arg) override;
+    int32_t ProcessCompletions(uint32_t max_completions) override;
+
+    /**
+     * @brief Sleeps on an eventfd registered with the ring until a command completes.
+     *
+     * IOPOLL rings wait in io_uring_enter() instead, which polls the device.
+     */
+    int32_t WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) override;
+
+    /**
+     * @brief Gets the number of io_uring_enter() calls made to submit commands.
+     *
+     * @return Submission system calls since Open()
+     */
+    uint64_t GetSubmitCalls() const override;
+
+    /**
+     * @brief Checks whether I/O buffers are registered with the ring.
+     *
+     * @return true if commands on pool buffers use READ_FIXED / WRITE_FIXED
+     */
+    bool HasRegisteredBuffers() const;
+
+private:
+    /**
+     * @brief Callback and argument of a command in flight; its address is the SQE user_data.
+     */
+    struct PendingIo {
+        IoBackendCallback cb;  ///< Caller's callback
+        void* cb_arg;          ///< Caller's argument
+        uint32_t length;       ///< Expected transfer size, to detect short I/O
+    };
+
+    /**
+     * @brief Opens the target file and determines its size and block size.
+     *
+     * @return true on success
+     */
+    bool OpenFile();
+
+    /**
+     * @brief Creates the ring and maps its queues.
+     *
+     * @return true on success
+     */
+    bool SetupRing();
+
+    /**
+     * @brief Waits for every command handed to the ring, without invoking callbacks.
+     *
+     * @return true once nothing is in flight, false if the ring failed first
+     */
+    bool Drain();
+
+    /**
+     * @brief Queues one read or write SQE, submitting once a batch is full.
+     *
+     * A submission failure is reported by the next ProcessCompletions().
+     *
+     * @return 0 if queued, -ENOMEM if the queue is full, negative errno otherwise
+     */
+    int Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+               IoBackendCallback cb, void* cb_arg);
+
+    /**
+     * @brief Passes queued SQEs to the kernel.
+     *
+     * @return 0 on success (including a transient refusal), negative errno otherwise
+     */
+    int Flush();
+
+    IoBackendOptions options_;      ///< Target and io_uring settings
+    uint32_t queue_depth_;          ///< Requested queue depth
+    int fd_;                        ///< Target file
+    int ring_fd_;                   ///< io_uring instance
+    uint32_t sector_size_;          ///< Logical block size of the target
+    uint64_t size_;                 ///< Capacity of the target in bytes
+
+    // Shared ring memory
+    void* sq_ring_;                 ///< Submission ring mapping
+    size_t sq_ring_size_;           ///< Size of the submission ring mapping
+    void* cq_ring_;                 ///< Completion ring mapping (may alias sq_ring_)
+    size_t cq_ring_size_;           ///< Size of the completion ring mapping
+    struct io_uring_sqe* sqes_;     ///< Submission queue entries
+    size_t sqes_size_;              ///< Size of the SQE mapping
+    unsigned* sq_head_;             ///< Kernel-owned submission head
+    unsigned* sq_tail_;             ///< Submission tail
+    unsigned* sq_flags_;            ///< Submission ring flags (SQPOLL wakeup)
+    unsigned* sq_array_;            ///< Submission index array
+    unsigned sq_mask_;              ///< Submission ring mask
+    unsigned* cq_head_;             ///< Completion head
+    unsigned* cq_tail_;             ///< Kernel-owned completion tail
+    struct io_uring_cqe* cqes_;     ///< Completion queue entries
+    unsigned cq_mask_;              ///< Completion ring mask
+    uint32_t sq_entries_;           ///< Submission ring size
+
+    uint32_t in_flight_;            ///< Commands queued or outstanding
+    uint32_t unsubmitted_;          ///< SQEs queued but not yet passed to the kernel
+    uint64_t submit_calls_;         ///< Submission system calls
+    const void* registered_region_; ///< Buffer region registered as fixed buffer 0
+    size_t registered_size_;        ///< Size of the registered region
+    int event_fd_;                  ///< Completion eventfd, registered on the first blocking wait
+
+    std::deque<PendingIo> pending_;        ///< All PendingIo entries; a deque keeps their addresses stable
+    std::vector<PendingIo*> free_pending_; ///< Entries available for new commands
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include "workload_generator.h"
+#include "job_runner.h"
+#include "../utils/json_parser.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Parses a workload profile from a JSON object.
+ *
+ * Keys are the WorkloadProfile field names. Sizes (total_size, block_size)
+ * accept numbers or strings with a binary suffix ("4k", "1GiB"); durations
+ * (runtime_seconds, ramp_time_seconds) accept numbers or strings with an s, m
+ * or h suffix. fio-style "offset" and "size" set the addressed range in bytes.
+ * payload_pattern, arrival_mode, completion_mode, trace_partition and
+ * access_pattern take names; access_pattern may also be an object with a "distribution" and its
+ * parameters. "use_polling_mode" is a boolean shorthand for completion_mode
+ * "poll" (true) or "block" (false). "verify" is a boolean or fio's "crc32c"
+ * or "none"; "verify_seed" and "verify_async" are numbers. Block-size
+ * mixes (read_block_sizes, write_block_sizes, or block_sizes for both) are
+ * arrays of {"block_size", "weight"} objects or fio bssplit strings such as
+ * "4k/60:64k/30:1m/10". When only one of read_percentage and write_percentage
+ * is given the other is derived; when only one of total_size and num_blocks is
+ * given the other covers the same range. "name" and "description" are ignored.
+ *
+ * @param json The profile object
+ *
+ * @return The validated workload profile
+ *
+ * @throws std::invalid_argument If a key is unknown, a value has the wrong type
+ *         or the resulting profile is invalid
+ */
+WorkloadProfile ParseWorkloadProfile(const utils::JsonValue& json);
+
+/**
+ * @brief Loads a workload profile from a JSON file.
+ *
+ * @param filename Path of the profile file
+ *
+ * @return The validated workload profile
+ *
+ * @throws std::runtime_error If the file cannot be read or is not valid JSON
+ * @throws std::invalid_argument If the profile is invalid
+ */
+WorkloadProfile LoadWorkloadProfile(const std::string& filename);
+
+/**
+ * @brief How the jobs of a job file are scheduled.
+ */
+enum class JobExecutionMode {
+    SEQUENTIAL,  ///< Jobs run one after another, in file order
+    CONCURRENT   ///< All jobs run at the same time
+};
+
+/**
+ * @brief One job of a job file.
+ */
+struct JobDefinition {
+    std::string name;         ///< Job name used in reports
+    WorkloadProfile profile;  ///< Workload of the job
+    JobOptions options;       ///< Threads, core mask and range mode of the job
+};
+
+/**
+ * @brief A set of jobs and how to run them.
+ */
+struct JobFile {
+    JobExecutionMode execution = JobExecutionMode::SEQUENTIAL; ///< Scheduling of the jobs
+    std::vector<JobDefinition> jobs;                           ///< Jobs in file order
+};
+
+/**
+ * @brief Parses a job file from a JSON document.
+ *
+ * A document with a "jobs" array is a job file: "execution" selects
+ * "sequential" or "concurrent" scheduling, and "defaults" holds settings
+ * shared by all jobs. Each job may name a "profile" file, whose settings are
+ * applied over the defaults and under the job's own keys. Besides the profile
+ * keys, defaults and jobs accept "threads", "core_mask" and "range_mode"
+ * ("shared" or "disjoint"), and select the I/O engine with the fio names
+ * "ioengine" ("spdk", "io_uring", "libaio", "psync" or "tcp"), "filename",
+ * "address" (tcp), "direct",
+ * "filesize", "sector_size", "fixedbufs", "registerfiles", "sqthread_poll",
+ * "sqthread_poll_idle" (ms), "hipri" (IOPOLL), "iodepth_batch_submit" (sets
+ * both the engine's and the profile's submit_batch) and
+ * "iodepth_batch_complete_max" (the profile's reap_batch).
+ * Any other document is read as a single profile and becomes a one-job file.
+ *
+ * @param json The document root
+ * @param base_dir Directory that relative profile paths are resolved against
+ *
+ * @return The parsed job file
+ *
+ * @throws std::invalid_argument If the document or one of its jobs is invalid
+ * @throws std::runtime_error If a referenced profile file cannot be loaded
+ */
+JobFile ParseJobFile(const utils::JsonValue& json, const std::string& base_dir = "");
+
+/**
+ * @brief Loads a job file, or a single workload profile, from a JSON file.
+ *
+ * @param filename Path of the job or profile file
+ *
+ * @return The parsed job file
+ *
+ * @throws std::runtime_error If a file cannot be read or is not valid JSON
+ * @throws std::invalid_argument If the document or one of its jobs is invalid
+ */
+JobFile LoadJobFile(const std::string& filename);
+
+/**
+ * @brief Runs the jobs of a job file on a controller.
+ *
+ * Every job is driven by its own JobRunner, so each job gets its own worker
+ * threads and queue pairs. Sequential files run the jobs back to back;
+ * concurrent files start all of them together.
+ */
+class JobFileRunner {
+public:
+    /**
+     * @brief Constructs a JobFileRunner for the specified controller and jobs.
+     *
+     * @param ctrlr Pointer to the NVMe controller; may be null if no job uses the SPDK engine
+     * @param job_file The jobs to run
+     *
+     * @throws std::invalid_argument If the controller is null for an SPDK job, there
+     *         are no jobs or a job cannot be run
+     */
+    JobFileRunner(struct spdk_nvme_ctrlr *ctrlr, const JobFile& job_file);
+
+    /**
+     * @brief Destroys the JobFileRunner, stopping any running jobs.
+     */
+    ~JobFileRunner();
+
+    /**
+     * @brief Runs all jobs and blocks until they have finished.
+     *
+     * @return true if every job completed successfully, false otherwise
+     */
+    bool Run();
+
+    /**
+     * @brief Requests the running jobs to stop; sequential jobs not yet started are skipped.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the progress of the current run.
+     *
+     * @return The progress over all jobs, between 0.0 and 1.0
+     */
+    double GetProgress() const;
+
+    /**
+     * @brief Gets the merged statistics of each job of the most recent run.
+     *
+     * @return One entry per job, in job order
+     */
+    std::vector<WorkloadStats> GetResults() const;
+
+    /**
+     * @brief Gets the jobs being run.
+     *
+     * @return The job file
+     */
+    const JobFile& GetJobFile() const;
+
+private:
+    /**
+     * @brief Runs one job and records its outcome.
+     *
+     * @param job_index Index of the job (0-based)
+     */
+    void RunJob(size_t job_index);
+
+    JobFile job_file_;                                ///< Jobs to run
+    std::vector<std::unique_ptr<JobRunner>> runners_; ///< One runner per job
+    std::vector<uint8_t> job_success_;                ///< Outcome per job (written concurrently)
+    std::atomic<bool> stop_requested_;                ///< Set by Stop()
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
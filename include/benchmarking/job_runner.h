@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "workload_generator.h"
+#include "io_backend.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief How the logical block range of a job is divided among its workers.
+ */
+enum class LbaRangeMode {
+    SHARED,   ///< Every worker addresses the full block range of the profile
+    DISJOINT  ///< Each worker addresses its own contiguous slice of the range
+};
+
+/**
+ * @brief Execution parameters for a multi-threaded job.
+ */
+struct JobOptions {
+    uint32_t num_threads = 1;                       ///< Number of worker threads (one qpair each)
+    std::string core_mask;                          ///< CPUs to pin workers to; empty disables pinning
+    LbaRangeMode range_mode = LbaRangeMode::DISJOINT; ///< LBA range assignment across workers
+    IoBackendOptions backend;                       ///< I/O engine; kernel engines open one file per worker
+};
+
+/**
+ * @brief Runs a workload on several worker threads, each with its own I/O queue pair.
+ *
+ * Each worker allocates a dedicated queue pair on the controller (or, with a
+ * kernel I/O engine, opens its own handle and ring on the file), pins itself to
+ * the next CPU of the core mask and drives a WorkloadGenerator with its share of
+ * the profile. The total size of the profile is divided evenly among the
+ * workers; per-worker statistics are merged once all workers have finished.
+ */
+class JobRunner {
+public:
+    /**
+     * @brief Constructs a JobRunner for the specified controller and profile.
+     *
+     * @param ctrlr Pointer to the NVMe controller; may be null with a kernel I/O engine
+     * @param profile Workload profile shared by all workers
+     * @param options Thread count, core mask, range mode and I/O engine
+     *
+     * @throws std::invalid_argument If the controller is null for the SPDK engine, the
+     *         profile or backend options are invalid, the thread count is zero or the
+     *         core mask cannot be parsed
+     */
+    JobRunner(struct spdk_nvme_ctrlr *ctrlr,
+              const WorkloadProfile& profile,
+              const JobOptions& options);
+
+    /**
+     * @brief Destroys the JobRunner, stopping any running workers.
+     */
+    ~JobRunner();
+
+    /**
+     * @brief Runs all workers and blocks until they have finished.
+     *
+     * @return true if every worker completed successfully, false otherwise
+     */
+    bool Run();
+
+    /**
+     * @brief Requests all running workers to stop.
+     *
+     * The request is sticky: workers that have not started yet do not run,
+     * and later calls to Run() return without issuing I/O.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the progress of the current run.
+     *
+     * @return The mean progress of all workers, between 0.0 and 1.0
+     */
+    double GetProgress() const;
+
+    /**
+     * @brief Gets the statistics of all workers merged into one.
+     *
+     * @return Merged statistics of the most recent run
+     */
+    WorkloadStats GetResults() const;
+
+    /**
+     * @brief Gets the statistics of each worker of the most recent run.
+     *
+     * @return One entry per worker, in worker order
+     */
+    std::vector<WorkloadStats> GetWorkerResults() const;
+
+    /**
+     * @brief Gets the workload profile assigned to a worker.
+     *
+     * @param worker_index Index of the worker (0-based)
+     *
+     * @return The profile with the worker's share of the size, block range (or of the
+     *         replayed trace), rate caps and arrival rate
+     *
+     * @throws std::out_of_range If the worker index is out of range
+     */
+    WorkloadProfile GetWorkerProfile(uint32_t worker_index) const;
+
+    /**
+     * @brief Parses a CPU core mask.
+     *
+     * Accepts a hexadecimal bit mask ("0xF0") or a comma-separated list of CPUs
+     * and ranges ("0-3,8,10-11").
+     *
+     * @param core_mask The core mask string
+     *
+     * @return The selected CPU indices in ascending order
+     *
+     * @throws std::invalid_argument If the mask is malformed or selects no CPU
+     */
+    static std::vector<int> ParseCoreMask(const std::string& core_mask);
+
+private:
+    /**
+     * @brief Body of a worker thread.
+     *
+     * @param worker_index Index of the worker (0-based)
+     */
+    void RunWorker(uint32_t worker_index);
+
+    /**
+     * @brief Pins the calling thread to a CPU.
+     *
+     * @param cpu The CPU index
+     *
+     * @return true if the thread was pinned, false otherwise
+     */
+    static bool PinCurrentThread(int cpu);
+
+    struct spdk_nvme_ctrlr *ctrlr_;            ///< Controller the queue pairs are allocated on (SPDK engine)
+    WorkloadProfile profile_;                  ///< Profile of the whole job
+    JobOptions options_;                       ///< Execution parameters
+    std::vector<int> cores_;                   ///< CPUs parsed from the core mask
+    std::vector<WorkloadStats> worker_stats_;  ///< Statistics per worker
+    std::vector<uint8_t> worker_success_;      ///< Outcome per worker (not vector<bool>: written concurrently)
+    std::vector<WorkloadGenerator*> generators_; ///< Active generators, for Stop()
+    mutable std::mutex mutex_;                 ///< Protects generators_
+    std::atomic<bool> stop_requested_;         ///< Set by Stop(), never cleared
+    std::atomic<uint32_t> finished_workers_;   ///< Workers that have returned, for GetProgress()
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
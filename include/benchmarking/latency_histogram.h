@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Latency percentiles extracted from a histogram, in nanoseconds.
+ */
+struct LatencySummary {
+    uint64_t count = 0;  ///< Number of recorded samples
+    double mean = 0.0;   ///< Mean latency
+    uint64_t min = 0;    ///< Smallest recorded latency
+    uint64_t p50 = 0;    ///< Median latency
+    uint64_t p90 = 0;    ///< 90th percentile
+    uint64_t p99 = 0;    ///< 99th percentile
+    uint64_t p999 = 0;   ///< 99.9th percentile
+    uint64_t p9999 = 0;  ///< 99.99th percentile
+    uint64_t max = 0;    ///< Largest recorded latency
+};
+
+/**
+ * @brief Log-linear latency histogram with mergeable buckets.
+ *
+ * Values below 2^kSubBucketBits nanoseconds are counted exactly; larger values
+ * fall into buckets whose width grows with the magnitude of the value, keeping
+ * the relative error of any reported percentile below 2^(1 - kSubBucketBits)
+ * (under 1%). Recording is a handful of integer operations and never
+ * allocates, so each I/O thread records into its own histogram and the
+ * histograms are merged once the run is over.
+ *
+ * The histogram is not thread-safe.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Records one sample.
+     *
+     * Values beyond the highest bucket (about 4.9 hours) are counted in the
+     * highest bucket; the exact maximum is still tracked.
+     *
+     * @param value_ns The latency in nanoseconds
+     */
+    void Record(uint64_t value_ns);
+
+    /**
+     * @brief Adds the samples of another histogram to this one.
+     *
+     * @param other The histogram to merge
+     */
+    void Merge(const LatencyHistogram& other);
+
+    /**
+     * @brief Removes all samples.
+     */
+    void Reset();
+
+    /**
+     * @brief Gets the number of recorded samples.
+     *
+     * @return The sample count
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * @brief Gets the smallest recorded sample.
+     *
+     * @return The minimum in nanoseconds, or 0 if the histogram is empty
+     */
+    uint64_t GetMin() const;
+
+    /**
+     * @brief Gets the largest recorded sample.
+     *
+     * @return The maximum in nanoseconds, or 0 if the histogram is empty
+     */
+    uint64_t GetMax() const;
+
+    /**
+     * @brief Gets the mean of the recorded samples.
+     *
+     * @return The mean in nanoseconds, or 0 if the histogram is empty
+     */
+    double GetMean() const;
+
+    /**
+     * @brief Gets the value below which a given share of the samples fall.
+     *
+     * @param percentile The percentile (0-100)
+     *
+     * @return The highest value equivalent to the percentile's bucket, capped at
+     *         the recorded maximum, or 0 if the histogram is empty
+     */
+    uint64_t GetValueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Extracts the standard percentiles.
+     *
+     * @return Count, mean, min, p50, p90, p99, p99.9, p99.99 and max
+     */
+    LatencySummary GetSummary() const;
+
+private:
+    static constexpr int kSubBucketBits = 8;                          ///< Precision of each bucket group
+    static constexpr uint64_t kSubBucketCount = 1ULL << kSubBucketBits; ///< Exact buckets below this value
+    static constexpr int kMaxValueBits = 44;                          ///< Largest bucketed value is 2^44 - 1 ns
+
+    /**
+     * @brief Maps a value to its bucket.
+     *
+     * @param value The value in nanoseconds
+     *
+     * @return Index into counts_
+     */
+    static size_t BucketIndex(uint64_t value);
+
+    /**
+     * @brief Gets the highest value that maps to a bucket.
+     *
+     * @param index Index into counts_
+     *
+     * @return The largest value in the bucket
+     */
+    static uint64_t BucketHighestValue(size_t index);
+
+    std::vector<uint64_t> counts_;  ///< Number of samples per bucket
+    uint64_t total_count_;          ///< Total number of samples
+    uint64_t min_;                  ///< Smallest sample
+    uint64_t max_;                  ///< Largest sample
+    double sum_;                    ///< Sum of all samples, for the mean
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <memory>
+#include "io_backend.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief I/O backend that drives a file or block device through Linux native AIO.
+ *
+ * The AIO context is managed with the raw io_setup / io_submit / io_getevents
+ * system calls, so libaio itself is not needed. Commands are queued and passed
+ * to the kernel options.submit_batch at a time; partial batches go out when
+ * completions are reaped. Without O_DIRECT the kernel completes commands
+ * inside io_submit(). Only available on Linux; elsewhere Open() fails.
+ */
+class LibaioBackend : public IoBackend {
+public:
+    /**
+     * @brief Constructs a Linux AIO backend.
+     *
+     * @param options Target file and batching settings
+     * @param queue_depth Number of commands that may be outstanding
+     *
+     * @throws std::invalid_argument If the options are invalid or the queue depth is zero
+     */
+    LibaioBackend(const IoBackendOptions& options, uint32_t queue_depth);
+
+    /**
+     * @brief Destroys the AIO context and closes the target.
+     *
+     * Outstanding commands must have completed.
+     */
+    ~LibaioBackend() override;
+
+    LibaioBackend(const LibaioBackend&) = delete;
+    LibaioBackend& operator=(const LibaioBackend&) = delete;
+
+    bool Open() override;
+    bool Close() override;
+    std::string GetName() const override;
+    uint32_t GetSectorSize() const override;
+    uint64_t GetSize() const override;
+    int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                   IoBackendCallback cb, void* cb_arg) override;
+    int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                    IoBackendCallback cb, void* cb_arg) override;
+    int32_t ProcessCompletions(uint32_t max_completions) override;
+
+    /**
+     * @brief Sleeps in io_getevents() until a command completes or the timeout elapses.
+     */
+    int32_t WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) override;
+
+    /**
+     * @brief Gets the number of io_submit() calls made.
+     *
+     * @return Submission system calls since Open()
+     */
+    uint64_t GetSubmitCalls() const override;
+
+private:
+    /**
+     * @brief Control blocks, free list and completion buffer; defined with the system headers.
+     */
+    struct AioState;
+
+    /**
+     * @brief Queues one read or write, submitting once a batch is full.
+     *
+     * A submission failure is reported by the next ProcessCompletions().
+     *
+     * @return 0 if queued, -ENOMEM if the queue is full, negative errno otherwise
+     */
+    int Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+               IoBackendCallback cb, void* cb_arg);
+
+    /**
+     * @brief Submits queued commands and reaps completed ones.
+     *
+     * @param max_completions Maximum number of completions to reap, or 0 for no limit
+     * @param timeout_ns Longest time to wait for the first completion; 0 does not wait
+     *
+     * @return Number of completions reaped, or negative errno on failure
+     */
+    int32_t Reap(uint32_t max_completions, uint64_t timeout_ns);
+
+    /**
+     * @brief Passes queued commands to the kernel.
+     *
+     * @return 0 on success (including a transient refusal), negative errno otherwise
+     */
+    int Flush();
+
+    IoBackendOptions options_;       ///< Target and batching settings
+    uint32_t queue_depth_;           ///< Maximum number of outstanding commands
+    int fd_;                         ///< Target file
+    unsigned long context_;          ///< AIO context (aio_context_t), 0 if not open
+    uint32_t sector_size_;           ///< Logical block size of the target
+    uint64_t size_;                  ///< Capacity of the target in bytes
+    uint32_t in_flight_;             ///< Commands queued or outstanding
+    uint64_t submit_calls_;          ///< Submission system calls
+
+    std::unique_ptr<AioState> state_; ///< Per-command control blocks
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
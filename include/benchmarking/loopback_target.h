@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+// #include <spdk/nvme.h>
+#include "../../third_party/spdk_mock/include/nvme.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief In-process fabric target that exports the namespaces of a controller.
+ *
+ * The target listens on a TCP port or a Unix socket and speaks the simplified
+ * capsule protocol of capsule_protocol.h, so a TcpBackend can reach a memory
+ * or file backed mock namespace the way a host reaches an NVMe/TCP subsystem.
+ * Each connection is served by its own thread with its own I/O queue pair and
+ * buffer pool: command capsules are executed on the namespace, read data is
+ * returned in a C2H data PDU and every command ends with a response capsule.
+ */
+class LoopbackTarget {
+public:
+    /**
+     * @brief Constructs a target for a controller; nothing listens until Start().
+     *
+     * @param ctrlr Pointer to the NVMe controller whose namespaces are exported
+     * @param address "host:port" (port 0 picks a free port) or "unix:/path"
+     * @param max_data_size Largest transfer of one command in bytes
+     *
+     * @throws std::invalid_argument If the controller is null, the address is empty
+     *         or the transfer size is zero
+     */
+    LoopbackTarget(struct spdk_nvme_ctrlr *ctrlr,
+                   const std::string& address,
+                   uint32_t max_data_size = 1024 * 1024);
+
+    /**
+     * @brief Destroys the target, stopping it if it is running.
+     */
+    ~LoopbackTarget();
+
+    LoopbackTarget(const LoopbackTarget&) = delete;
+    LoopbackTarget& operator=(const LoopbackTarget&) = delete;
+
+    /**
+     * @brief Starts listening and accepting connections.
+     *
+     * @return true if the target is listening, false otherwise
+     */
+    bool Start();
+
+    /**
+     * @brief Closes the listening socket and all connections.
+     *
+     * Commands in flight are completed before their queue pairs are freed.
+     */
+    void Stop();
+
+    /**
+     * @brief Gets the address clients connect to.
+     *
+     * @return The bound address, with the actual port once started
+     */
+    std::string GetAddress() const;
+
+    /**
+     * @brief Gets the number of connections accepted so far.
+     *
+     * @return Accepted connections since Start()
+     */
+    uint64_t GetConnectionCount() const;
+
+    /**
+     * @brief Gets the number of connections whose threads have not been reaped.
+     *
+     * The thread of a closed connection is joined by the accept thread within
+     * one accept poll, so a long-lived target does not accumulate them.
+     *
+     * @return Connections being served or just closed
+     */
+    size_t GetOpenConnectionCount() const;
+
+private:
+    /**
+     * @brief Accepts connections until the target is stopped.
+     */
+    void AcceptLoop();
+
+    /**
+     * @brief Serves one connection until the peer disconnects or the target is stopped.
+     *
+     * @param fd The connected socket, closed on return
+     */
+    void ServeConnection(int fd);
+
+    /**
+     * @brief Joins the threads of connections that have closed.
+     */
+    void ReapConnections();
+
+    struct spdk_nvme_ctrlr *ctrlr_;     ///< Controller whose namespaces are exported
+    std::string address_;               ///< Requested, then bound address
+    uint32_t max_data_size_;            ///< Largest transfer of one command
+    int listen_fd_;                     ///< Listening socket, -1 when stopped
+    std::atomic<bool> stop_;            ///< Set to stop all threads
+    std::atomic<uint64_t> connections_; ///< Connections accepted
+    std::thread accept_thread_;         ///< Thread running AcceptLoop()
+    mutable std::mutex mutex_;          ///< Protects the connection thread lists
+    std::vector<std::thread> connection_threads_; ///< One thread per connection not yet reaped
+    std::vector<std::thread::id> finished_connections_; ///< Threads whose connection has closed
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Small integer naming a registered metric (label and units).
+ *
+ * Handles are dense, starting at 0, in registration order.
+ */
+using MetricHandle = uint32_t;
+
+/**
+ * @brief A registered metric.
+ */
+struct Metric {
+    std::string label;  ///< Label describing the metric
+    std::string units;  ///< Units of measurement (e.g., "MB/s", "µs")
+};
+
+/**
+ * @brief Interns metric labels and units, handing out a handle for each pair.
+ *
+ * Registration takes a lock and is meant to happen once per metric; data
+ * points then carry only the handle, and names are looked up when the points
+ * are written. Registered metrics are never removed, so references returned
+ * by Get() stay valid for the lifetime of the registry.
+ */
+class MetricRegistry {
+public:
+    MetricRegistry();
+
+    MetricRegistry(const MetricRegistry&) = delete;
+    MetricRegistry& operator=(const MetricRegistry&) = delete;
+
+    /**
+     * @brief Registers a metric, or finds the one already registered with the same names.
+     *
+     * @param label Label describing the metric
+     * @param units Units of measurement
+     *
+     * @return The metric's handle
+     */
+    MetricHandle Register(const std::string& label, const std::string& units);
+
+    /**
+     * @brief Gets a registered metric.
+     *
+     * @param handle Handle returned by Register()
+     *
+     * @return The metric
+     *
+     * @throws std::out_of_range If the handle was not registered
+     */
+    const Metric& Get(MetricHandle handle) const;
+
+    /**
+     * @brief Gets the number of registered metrics, without locking.
+     *
+     * @return Metric count; every handle below it is valid
+     */
+    size_t GetCount() const;
+
+private:
+    mutable std::mutex mutex_;                             ///< Guards the members below
+    std::deque<Metric> metrics_;                           ///< Metrics by handle; a deque keeps references stable
+    std::unordered_map<std::string, MetricHandle> index_;  ///< Label, NUL and units to handle
+    std::atomic<uint32_t> count_;                          ///< Size of metrics_, readable without the lock
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
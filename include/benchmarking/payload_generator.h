@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Content written by write operations.
+ */
+enum class PayloadPattern {
+    RANDOM,       ///< Incompressible pseudo-random bytes
+    ZEROS,        ///< All-zero blocks
+    REPEATING,    ///< A short byte pattern repeated over the whole block
+    COMPRESSIBLE  ///< Random bytes padded with zeros to reach a target compression ratio
+};
+
+/**
+ * @brief Parses a payload pattern name ("random", "zeros", "repeating", "compressible").
+ *
+ * @param name The pattern name (case-insensitive)
+ *
+ * @return The matching pattern
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+PayloadPattern ParsePayloadPattern(const std::string& name);
+
+/**
+ * @brief Produces write payloads from a pattern buffer generated once at startup.
+ *
+ * The pattern buffer is filled when the generator is constructed; afterwards
+ * each write only copies a slice of it. For RANDOM and COMPRESSIBLE payloads,
+ * blocks are made unique by stamping a sequence number into their first bytes,
+ * except for the requested share of blocks that are emitted as exact
+ * duplicates to exercise target-side deduplication.
+ */
+class PayloadGenerator {
+public:
+    /**
+     * @brief Generates the pattern buffer.
+     *
+     * @param pattern Content of the generated payloads
+     * @param max_block_size Largest payload that will be requested, in bytes
+     * @param compress_percentage Share of each 4 KiB chunk that is zero-filled (COMPRESSIBLE)
+     * @param dedupe_percentage Share of payloads that repeat an earlier block (0-100)
+     * @param seed Seed for the pseudo-random content; 0 picks a random seed
+     *
+     * @throws std::invalid_argument If the block size is zero or a percentage exceeds 100
+     */
+    PayloadGenerator(PayloadPattern pattern,
+                     size_t max_block_size,
+                     uint32_t compress_percentage = 0,
+                     uint32_t dedupe_percentage = 0,
+                     uint64_t seed = 0);
+
+    /**
+     * @brief Fills a buffer with the next payload.
+     *
+     * @param buffer Destination buffer
+     * @param size Number of bytes to fill (at most the maximum block size)
+     */
+    void Fill(void* buffer, size_t size);
+
+    /**
+     * @brief Gets the pattern of the generated payloads.
+     *
+     * @return The payload pattern
+     */
+    PayloadPattern GetPattern() const;
+
+    /**
+     * @brief Fills a buffer with pseudo-random bytes using xoshiro256**.
+     *
+     * Four independent generator lanes are interleaved so the loop can be
+     * vectorized by the compiler.
+     *
+     * @param buffer Destination buffer
+     * @param size Number of bytes to fill
+     * @param seed Seed of the generator; equal seeds produce equal output
+     */
+    static void FillRandom(void* buffer, size_t size, uint64_t seed);
+
+private:
+    static constexpr size_t kChunkSize = 4096;            ///< Granularity of slices and compression
+    static constexpr size_t kMinPatternSize = 1 << 20;    ///< Minimum size of the pattern buffer
+
+    PayloadPattern pattern_;        ///< Content of the generated payloads
+    size_t max_block_size_;         ///< Largest payload that can be requested
+    uint32_t dedupe_percentage_;    ///< Share of duplicated payloads
+    std::vector<uint8_t> pattern_buffer_; ///< Pre-generated content
+    size_t next_offset_;            ///< Offset of the next slice in the pattern buffer
+    uint64_t sequence_;             ///< Sequence number stamped into unique blocks
+    uint64_t rng_state_;            ///< State of the dedupe selection generator
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Token bucket used to pace I/O submission.
+ *
+ * Tokens accrue at a fixed rate up to a burst capacity. The caller refills the
+ * bucket with the current time once per polling pass and then consumes tokens
+ * for each command it submits, so a single clock read covers a whole batch of
+ * submissions. The bucket never sleeps; callers keep polling for completions
+ * while they wait for tokens.
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief Constructs a full token bucket.
+     *
+     * @param rate Tokens added per second
+     * @param burst Maximum number of tokens the bucket can hold
+     *
+     * @throws std::invalid_argument If the rate or burst is not positive
+     */
+    TokenBucket(double rate, double burst);
+
+    /**
+     * @brief Adds the tokens accrued since the previous refill.
+     *
+     * @param now_ns Current time in nanoseconds of a monotonic clock
+     */
+    void Refill(uint64_t now_ns);
+
+    /**
+     * @brief Consumes tokens if enough are available.
+     *
+     * @param tokens Number of tokens to consume
+     *
+     * @return true if the tokens were consumed, false if the bucket holds too few
+     */
+    bool TryConsume(double tokens);
+
+    /**
+     * @brief Gets the number of tokens currently in the bucket.
+     *
+     * @return The available tokens
+     */
+    double GetAvailable() const;
+
+    /**
+     * @brief Gets the refill rate.
+     *
+     * @return Tokens added per second
+     */
+    double GetRate() const;
+
+    /**
+     * @brief Gets the burst capacity.
+     *
+     * @return Maximum number of tokens the bucket can hold
+     */
+    double GetBurst() const;
+
+private:
+    double rate_;            ///< Tokens added per second
+    double burst_;           ///< Capacity of the bucket
+    double tokens_;          ///< Tokens currently available
+    uint64_t last_refill_ns_; ///< Time of the previous refill, 0 before the first one
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
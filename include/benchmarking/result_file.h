@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "data_collector.h"
+#include "metric_registry.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Storage type of a block's value column.
+ */
+enum class ResultValueType : uint8_t {
+    DOUBLE = 0,  ///< 8-byte doubles
+    FLOAT = 1    ///< 4-byte floats, used when every value of the block is exact as a float
+};
+
+/**
+ * @brief Encodes data points into the binary columnar result format.
+ *
+ * A result file is a 32-byte header (magic "NVBRESLT", version) followed by
+ * 8-byte aligned blocks of up to kBlockRecords points and a footer. Dictionary
+ * ids are the metric handles of the registry. Each block holds the dictionary
+ * entries (label and units) not yet written by an earlier block and three
+ * columns: values (float or double), label ids (1, 2 or 4 bytes) and
+ * timestamps as zigzag varint deltas. The footer repeats the whole dictionary
+ * and indexes every block, and the file ends with the footer offset and the
+ * magic. Files cut short without a footer can still be read block by block.
+ * Labels and units are stored with 16-bit lengths; longer names are cut to
+ * kMaxNameBytes at a UTF-8 character boundary.
+ */
+class ResultFileEncoder {
+public:
+    static constexpr size_t kBlockRecords = 4096;  ///< Points per full block
+    static constexpr size_t kMaxNameBytes = 65535; ///< Longest label or units stored
+
+    /**
+     * @brief Constructor
+     *
+     * @param registry Registry resolving the handles of appended points
+     */
+    explicit ResultFileEncoder(const MetricRegistry& registry);
+
+    /**
+     * @brief Appends the file header.
+     *
+     * @param out Buffer the encoded bytes are appended to
+     */
+    void WriteHeader(std::string& out);
+
+    /**
+     * @brief Adds a data point, appending a block once kBlockRecords are pending.
+     *
+     * @param record The data point
+     * @param out Buffer the encoded bytes are appended to
+     */
+    void Append(const DataRecord& record, std::string& out);
+
+    /**
+     * @brief Appends the pending points as a block, if there are any.
+     *
+     * @param out Buffer the encoded bytes are appended to
+     */
+    void FlushBlock(std::string& out);
+
+    /**
+     * @brief Flushes the pending points and appends the footer.
+     *
+     * @param out Buffer the encoded bytes are appended to
+     */
+    void Finish(std::string& out);
+
+    /**
+     * @brief Gets the number of points waiting for the next block.
+     *
+     * @return Pending point count
+     */
+    size_t GetPendingCount() const;
+
+private:
+    /**
+     * @brief Block index entry written to the footer.
+     */
+    struct BlockIndexEntry {
+        uint64_t offset;        ///< Offset of the block in the file
+        uint32_t record_count;  ///< Points in the block
+        int64_t first_ns;       ///< Earliest timestamp
+        int64_t last_ns;        ///< Latest timestamp
+    };
+
+    /**
+     * @brief Appends bytes, keeping track of the file offset.
+     */
+    void Emit(std::string& out, const void* data, size_t size);
+
+    /**
+     * @brief Pads the output to a multiple of 8 bytes.
+     */
+    void Align(std::string& out);
+
+    const MetricRegistry& registry_;      ///< Names of the dictionary ids
+    uint32_t dictionary_written_;         ///< Entries already stored in a block
+    std::vector<DataRecord> pending_;     ///< Points of the next block
+    std::vector<BlockIndexEntry> index_;  ///< Blocks written
+    uint64_t offset_;                     ///< Bytes emitted so far
+};
+
+/**
+ * @brief One block of a result file, pointing into the mapped file.
+ */
+struct ResultBlock {
+    uint32_t record_count;       ///< Points in the block
+    int64_t first_ns;            ///< Earliest timestamp, nanoseconds since the epoch
+    int64_t last_ns;             ///< Latest timestamp
+    ResultValueType value_type;  ///< Type of the value column
+    uint8_t id_width;            ///< Bytes per label id
+    const void* values;          ///< Value column
+    const uint8_t* ids;          ///< Label id column
+    const uint8_t* timestamps;   ///< Timestamp deltas
+    size_t timestamps_size;      ///< Bytes of timestamp deltas
+
+    /**
+     * @brief Gets a value.
+     *
+     * @param index Point index, less than record_count
+     *
+     * @return The value
+     */
+    double GetValue(size_t index) const;
+
+    /**
+     * @brief Gets a label id.
+     *
+     * @param index Point index, less than record_count
+     *
+     * @return Dictionary id of the point's label and units
+     */
+    uint32_t GetLabelId(size_t index) const;
+
+    /**
+     * @brief Decodes the timestamp column.
+     *
+     * @param timestamps Receives record_count timestamps in nanoseconds
+     *
+     * @return true if the column is intact, false otherwise
+     */
+    bool DecodeTimestamps(std::vector<int64_t>& timestamps) const;
+};
+
+/**
+ * @brief Memory-maps a binary result file.
+ *
+ * Value and label id columns are read in place; only timestamps are decoded.
+ */
+class ResultFileReader {
+public:
+    ResultFileReader();
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~ResultFileReader();
+
+    ResultFileReader(const ResultFileReader&) = delete;
+    ResultFileReader& operator=(const ResultFileReader&) = delete;
+
+    /**
+     * @brief Checks whether a file starts with the result file magic.
+     *
+     * @param path File to check
+     *
+     * @return true if the file is a binary result file
+     */
+    static bool IsResultFile(const std::string& path);
+
+    /**
+     * @brief Maps a result file and reads its dictionary and block index.
+     *
+     * A file without a footer, e.g. from an interrupted run, is scanned block
+     * by block up to the first incomplete one.
+     *
+     * @param path File written with OutputFormat::BINARY
+     *
+     * @return true if the file is a valid result file, false otherwise
+     */
+    bool Open(const std::string& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void Close();
+
+    /**
+     * @brief Checks whether the file had no footer and was recovered by scanning.
+     *
+     * @return true if the footer was missing
+     */
+    bool IsRecovered() const;
+
+    /**
+     * @brief Gets the number of dictionary entries.
+     *
+     * @return Entry count
+     */
+    size_t GetLabelCount() const;
+
+    /**
+     * @brief Gets the label of a dictionary entry.
+     *
+     * @param id Dictionary id, less than GetLabelCount()
+     *
+     * @return The label
+     */
+    const std::string& GetLabel(uint32_t id) const;
+
+    /**
+     * @brief Gets the units of a dictionary entry.
+     *
+     * @param id Dictionary id, less than GetLabelCount()
+     *
+     * @return The units
+     */
+    const std::string& GetUnits(uint32_t id) const;
+
+    /**
+     * @brief Gets the number of blocks.
+     *
+     * @return Block count
+     */
+    size_t GetBlockCount() const;
+
+    /**
+     * @brief Gets a block.
+     *
+     * @param index Block index, less than GetBlockCount()
+     *
+     * @return The block, valid until Close()
+     */
+    const ResultBlock& GetBlock(size_t index) const;
+
+    /**
+     * @brief Gets the total number of data points.
+     *
+     * @return Point count
+     */
+    uint64_t GetPointCount() const;
+
+    /**
+     * @brief Calls a function for every data point in file order.
+     *
+     * @param callback Called as callback(timestamp_ns, label_id, value)
+     *
+     * @return true if every block was intact, false otherwise
+     */
+    template <typename Callback>
+    bool ForEachPoint(Callback&& callback) const {
+        std::vector<int64_t> timestamps;
+        for (const ResultBlock& block : blocks_) {
+            if (!block.DecodeTimestamps(timestamps)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < block.record_count; ++i) {
+                callback(timestamps[i], block.GetLabelId(i), block.GetValue(i));
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * @brief Reads the footer's dictionary and block index.
+     */
+    bool ReadFooter();
+
+    /**
+     * @brief Reads the blocks in sequence when there is no footer.
+     */
+    bool ScanBlocks();
+
+    /**
+     * @brief Parses the block at an offset, adding its dictionary entries if requested.
+     */
+    bool ParseBlock(uint64_t offset, bool read_dictionary, uint64_t* next_offset);
+
+    const uint8_t* data_;                 ///< Mapped file, nullptr if not open
+    size_t size_;                         ///< Size of the mapping
+    bool recovered_;                      ///< The footer was missing
+    std::vector<std::string> labels_;     ///< Labels by dictionary id
+    std::vector<std::string> units_;      ///< Units by dictionary id
+    std::vector<ResultBlock> blocks_;     ///< Blocks in file order
+    uint64_t point_count_;                ///< Points in all blocks
+};
+
+/**
+ * @brief Formats a timestamp as local time, the way text result files show it.
+ *
+ * @param timestamp_ns Nanoseconds since the epoch
+ *
+ * @return "YYYY-MM-DD HH:MM:SS"
+ */
+std::string FormatResultTimestamp(int64_t timestamp_ns);
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -12,6 +12,8 @@ public:
     void Visualize();
 
 private:
+    void VisualizeBinary();
+
     std::string input_file_;
 };
 
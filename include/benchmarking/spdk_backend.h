@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <deque>
+#include <vector>
+// #include <spdk/nvme.h>
+#include "../../third_party/spdk_mock/include/nvme.h"
+#include "io_backend.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief I/O backend that submits NVMe commands on an SPDK queue pair.
+ *
+ * The queue pair is owned by the caller and must only be used from the thread
+ * driving the backend. A queue pair allocated with delay_cmd_submit rings its
+ * submission doorbell once per poll for all commands queued since the last
+ * one; the backend must be told so to count the doorbells.
+ */
+class SpdkBackend : public IoBackend {
+public:
+    static constexpr uint32_t kCloseTimeoutMs = 5000;  ///< Longest wait for outstanding commands in Close()
+
+    /**
+     * @brief Constructs a backend for a namespace of a controller.
+     *
+     * @param ctrlr Pointer to the NVMe controller
+     * @param qpair Pointer to the NVMe queue pair
+     * @param namespace_id Namespace addressed by the commands
+     * @param delay_cmd_submit Whether the queue pair was allocated with delay_cmd_submit
+     *
+     * @throws std::invalid_argument If the controller or queue pair is null
+     */
+    SpdkBackend(const struct spdk_nvme_ctrlr *ctrlr,
+                const struct spdk_nvme_qpair *qpair,
+                uint32_t namespace_id = 1,
+                bool delay_cmd_submit = false);
+
+    bool Open() override;
+
+    /**
+     * @brief Polls the queue pair until outstanding commands have completed, dropping their callbacks.
+     *
+     * The queue pair stays allocated. Commands still outstanding after
+     * kCloseTimeoutMs are left to be aborted when the caller frees the queue
+     * pair, which must happen before the backend is destroyed.
+     *
+     * @return true if no command remains outstanding
+     */
+    bool Close() override;
+
+    std::string GetName() const override;
+    uint32_t GetSectorSize() const override;
+    uint64_t GetSize() const override;
+    int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                   IoBackendCallback cb, void* cb_arg) override;
+    int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                    IoBackendCallback cb, void* cb_arg) override;
+    int32_t ProcessCompletions(uint32_t max_completions) override;
+
+    /**
+     * @brief Gets the number of submission doorbell writes.
+     *
+     * @return One per command, or one per poll that found queued commands with delay_cmd_submit
+     */
+    uint64_t GetSubmitCalls() const override;
+
+private:
+    /**
+     * @brief Callback and argument of a command in flight, passed to SPDK as cb_arg.
+     */
+    struct PendingIo {
+        SpdkBackend* backend;   ///< Owning backend
+        IoBackendCallback cb;   ///< Caller's callback, nullptr once dropped by Close()
+        void* cb_arg;           ///< Caller's argument
+    };
+
+    /**
+     * @brief Takes a free PendingIo, growing the set if needed.
+     *
+     * @return A PendingIo owned by the backend
+     */
+    PendingIo* AcquirePending();
+
+    /**
+     * @brief Completion callback registered with SPDK.
+     *
+     * @param arg The PendingIo of the command
+     * @param completion The NVMe completion structure
+     */
+    static void CompletionCallback(void* arg, const struct spdk_nvme_cpl* completion);
+
+    const struct spdk_nvme_ctrlr *ctrlr_;  ///< Controller of the namespace
+    struct spdk_nvme_qpair *qpair_;        ///< Queue pair the commands are submitted on
+    uint32_t namespace_id_;                ///< Namespace addressed by the commands
+    struct spdk_nvme_ns *ns_;              ///< Namespace, resolved by Open()
+    uint32_t sector_size_;                 ///< Sector size of the namespace
+    bool delay_cmd_submit_;                ///< Doorbell rung by the next poll rather than per command
+    uint32_t unrung_;                      ///< Commands queued since the last doorbell
+    uint64_t doorbells_;                   ///< Submission doorbell writes
+    std::deque<PendingIo> pending_;        ///< All PendingIo entries; a deque keeps their addresses stable
+    std::vector<PendingIo*> free_pending_; ///< Entries available for new commands
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
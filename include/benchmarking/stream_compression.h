@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Compression applied to a result file as it is written.
+ */
+enum class CompressionMode {
+    NONE,  ///< Write the file as is
+    LZ     ///< Built-in LZ77 codec in independent, checksummed frames
+};
+
+/**
+ * @brief Parses a compression mode name ("none", "lz").
+ *
+ * @param name The mode name (case-insensitive)
+ *
+ * @return The matching mode
+ *
+ * @throws std::invalid_argument If the name is unknown
+ */
+CompressionMode ParseCompressionMode(const std::string& name);
+
+/**
+ * @brief Gets the suffix appended to the names of files written with a compression mode.
+ *
+ * @param mode The mode
+ *
+ * @return ".nvlz" for CompressionMode::LZ, "" for CompressionMode::NONE
+ */
+const char* GetCompressionExtension(CompressionMode mode);
+
+/**
+ * @brief LZ77 block codec with a 64 KiB window.
+ *
+ * A block is a sequence of (literal run, back-reference) pairs, each starting
+ * with a token byte holding the literal length and the match length minus 4
+ * in its two nibbles, extended by 255-valued bytes when a nibble is 15. A
+ * 16-bit offset follows the literals; the last pair of a block has literals
+ * only. Matches are found with a single-entry hash table, which favors speed
+ * over ratio; repetitive result text still compresses several times.
+ */
+class LzCodec {
+public:
+    static constexpr size_t kMinMatch = 4;         ///< Shortest match encoded
+    static constexpr size_t kMaxOffset = 65535;    ///< Largest back-reference distance
+
+    LzCodec();
+
+    /**
+     * @brief Compresses a block.
+     *
+     * @param data Bytes to compress
+     * @param size Number of bytes
+     * @param out Buffer the compressed block is appended to
+     */
+    void Compress(const char* data, size_t size, std::string& out);
+
+    /**
+     * @brief Decompresses a block.
+     *
+     * @param data Compressed block
+     * @param size Bytes in the compressed block
+     * @param raw_size Size of the block before compression
+     * @param out Receives raw_size bytes
+     *
+     * @return true if the block is intact and decodes to exactly raw_size bytes
+     */
+    static bool Decompress(const char* data, size_t size, size_t raw_size, char* out);
+
+private:
+    std::vector<uint32_t> table_;  ///< Last position + 1 of each 4-byte hash, reused between blocks
+};
+
+/**
+ * @brief Writes the compressed stream format of result files.
+ *
+ * A stream is a 16-byte header (magic "NVLZSTRM", version) followed by
+ * frames, each a 16-byte header (magic, raw size, stored size, CRC-32C of the
+ * raw bytes) and the compressed bytes. Frames that do not shrink are stored
+ * raw. Frames are independent, so a file cut short still decompresses up to
+ * its last complete frame.
+ */
+class CompressedStreamEncoder {
+public:
+    static constexpr size_t kMaxFrameBytes = 64 * 1024 * 1024;  ///< Largest raw frame readers accept
+
+    /**
+     * @brief Appends the stream header.
+     *
+     * @param out Buffer the encoded bytes are appended to
+     */
+    static void WriteHeader(std::string& out);
+
+    /**
+     * @brief Compresses bytes into one frame.
+     *
+     * @param data Bytes of the frame, at most kMaxFrameBytes
+     * @param size Number of bytes
+     * @param out Buffer the encoded frame is appended to
+     */
+    void EncodeFrame(const char* data, size_t size, std::string& out);
+
+private:
+    LzCodec codec_;        ///< Frame compressor
+    std::string scratch_;  ///< Compressed bytes of the current frame
+};
+
+/**
+ * @brief Input stream decompressing a compressed result file frame by frame.
+ *
+ * Reading stops at the end of the last intact frame; a warning is printed if
+ * the file ends with an incomplete or corrupt frame.
+ */
+class CompressedFileStream : public std::istream {
+public:
+    /**
+     * @brief Opens a compressed file.
+     *
+     * @param path File written with CompressionMode::LZ
+     */
+    explicit CompressedFileStream(const std::string& path);
+
+    /**
+     * @brief Checks whether reading stopped at an incomplete or corrupt frame.
+     *
+     * @return true if the file is truncated or corrupt
+     */
+    bool IsTruncated() const;
+
+private:
+    /**
+     * @brief Stream buffer holding one decompressed frame at a time.
+     */
+    class FrameBuffer : public std::streambuf {
+    public:
+        explicit FrameBuffer(const std::string& path);
+
+        bool IsOpen() const;
+        bool IsTruncated() const;
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        /**
+         * @brief Reads and decompresses the next frame; false at the end of the stream.
+         */
+        bool ReadFrame();
+
+        /**
+         * @brief Marks the stream as truncated, warning once.
+         */
+        bool Truncate(const char* reason);
+
+        std::string path_;         ///< File being read
+        std::ifstream file_;       ///< Compressed file
+        bool open_;                ///< The file has a valid stream header
+        bool truncated_;           ///< Stopped at an incomplete or corrupt frame
+        std::string compressed_;   ///< Stored bytes of the current frame
+        std::vector<char> frame_;  ///< Decompressed bytes of the current frame
+    };
+
+    FrameBuffer buffer_;  ///< Decompressed data source
+};
+
+/**
+ * @brief Checks whether a file starts with the compressed stream magic.
+ *
+ * @param path File to check
+ *
+ * @return true if the file was written with CompressionMode::LZ
+ */
+bool IsCompressedFile(const std::string& path);
+
+/**
+ * @brief Opens a text result file, decompressing it transparently if needed.
+ *
+ * @param path CSV, JSON or plain text result file, compressed or not
+ *
+ * @return The stream; it is in a failed state if the file cannot be opened
+ */
+std::unique_ptr<std::istream> OpenResultStream(const std::string& path);
+
+}  // namespace benchmarking
+}  // namespace nvmeof
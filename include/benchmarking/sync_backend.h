@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <deque>
+#include "io_backend.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Baseline I/O backend that transfers each command with a blocking pread / pwrite.
+ *
+ * The transfer happens inside SubmitRead() / SubmitWrite(), so a worker has at
+ * most one command on the device at a time and concurrency comes from the
+ * number of worker threads, like fio's psync engine. Completions are still
+ * delivered from ProcessCompletions() so the generator sees the same contract
+ * as with the asynchronous engines.
+ */
+class SyncBackend : public IoBackend {
+public:
+    /**
+     * @brief Constructs a synchronous backend.
+     *
+     * @param options Target file settings
+     * @param queue_depth Number of completed commands that may await ProcessCompletions()
+     *
+     * @throws std::invalid_argument If the options are invalid or the queue depth is zero
+     */
+    SyncBackend(const IoBackendOptions& options, uint32_t queue_depth);
+
+    /**
+     * @brief Closes the target.
+     */
+    ~SyncBackend() override;
+
+    SyncBackend(const SyncBackend&) = delete;
+    SyncBackend& operator=(const SyncBackend&) = delete;
+
+    bool Open() override;
+    bool Close() override;
+    std::string GetName() const override;
+    uint32_t GetSectorSize() const override;
+    uint64_t GetSize() const override;
+    int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                   IoBackendCallback cb, void* cb_arg) override;
+    int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                    IoBackendCallback cb, void* cb_arg) override;
+    int32_t ProcessCompletions(uint32_t max_completions) override;
+
+private:
+    /**
+     * @brief A command whose transfer has finished.
+     */
+    struct CompletedIo {
+        IoBackendCallback cb;  ///< Caller's callback
+        void* cb_arg;          ///< Caller's argument
+        int status;            ///< 0 or negative errno
+    };
+
+    /**
+     * @brief Transfers one command and queues its completion.
+     *
+     * @return 0 if the command was executed, -ENOMEM if too many completions are pending
+     */
+    int Execute(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+                IoBackendCallback cb, void* cb_arg);
+
+    IoBackendOptions options_;          ///< Target settings
+    uint32_t queue_depth_;              ///< Maximum number of undelivered completions
+    int fd_;                            ///< Target file
+    uint32_t sector_size_;              ///< Logical block size of the target
+    uint64_t size_;                     ///< Capacity of the target in bytes
+    std::deque<CompletedIo> completed_; ///< Completions awaiting ProcessCompletions()
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "io_backend.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Byte and system call counters of a fabric transport.
+ */
+struct TransportStats {
+    uint64_t pdus_sent = 0;       ///< PDUs serialized into the send buffer
+    uint64_t pdus_received = 0;   ///< PDUs parsed from the receive buffer
+    uint64_t bytes_sent = 0;      ///< Bytes accepted by send()
+    uint64_t bytes_received = 0;  ///< Bytes returned by recv()
+    uint64_t send_calls = 0;      ///< send() system calls
+    uint64_t recv_calls = 0;      ///< recv() system calls, including those that found no data
+};
+
+/**
+ * @brief I/O backend that sends commands to a LoopbackTarget over TCP or a Unix socket.
+ *
+ * Each command is serialized as a capsule PDU into a send buffer; write data
+ * is copied behind it in a data PDU. The buffer is written to the socket once
+ * options.submit_batch commands are queued and whenever completions are
+ * reaped. ProcessCompletions() never blocks: it drains the socket into a
+ * receive buffer, copies read data into the caller's buffers and completes
+ * commands on their response capsules. The transport counters expose the
+ * serialization, copy and system call costs of the path.
+ */
+class TcpBackend : public IoBackend {
+public:
+    /**
+     * @brief Constructs a backend for a namespace exported by a target.
+     *
+     * @param options Target address and batching settings
+     * @param queue_depth Number of commands that may be outstanding, at most 65535
+     * @param namespace_id Namespace addressed by the commands
+     *
+     * @throws std::invalid_argument If the options are invalid or the queue depth is out of range
+     */
+    TcpBackend(const IoBackendOptions& options, uint32_t queue_depth, uint32_t namespace_id = 1);
+
+    /**
+     * @brief Closes the connection.
+     *
+     * Outstanding commands must have completed.
+     */
+    ~TcpBackend() override;
+
+    TcpBackend(const TcpBackend&) = delete;
+    TcpBackend& operator=(const TcpBackend&) = delete;
+
+    /**
+     * @brief Connects and negotiates the queue depth, namespace and transfer size.
+     *
+     * @return true if the target accepted the connection, false otherwise
+     */
+    bool Open() override;
+    bool Close() override;
+    std::string GetName() const override;
+    uint32_t GetSectorSize() const override;
+    uint64_t GetSize() const override;
+    int SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                   IoBackendCallback cb, void* cb_arg) override;
+    int SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                    IoBackendCallback cb, void* cb_arg) override;
+    int32_t ProcessCompletions(uint32_t max_completions) override;
+
+    /**
+     * @brief Sleeps in ppoll() on the socket until the target answers or the timeout elapses.
+     */
+    int32_t WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) override;
+
+    /**
+     * @brief Gets the number of send() calls made.
+     *
+     * @return Send system calls since Open()
+     */
+    uint64_t GetSubmitCalls() const override;
+
+    /**
+     * @brief Gets the largest transfer the target accepts in one command.
+     *
+     * @return Size in bytes, 0 before Open()
+     */
+    uint32_t GetMaxDataSize() const;
+
+    /**
+     * @brief Gets the transport counters.
+     *
+     * @return Counters since Open()
+     */
+    const TransportStats& GetTransportStats() const;
+
+private:
+    /**
+     * @brief A command slot, indexed by command identifier.
+     */
+    struct Command {
+        bool active = false;           ///< Submitted and not yet completed
+        bool is_write = false;         ///< Write rather than read
+        void* buffer = nullptr;        ///< Caller's data buffer
+        uint32_t length = 0;           ///< Bytes transferred
+        uint32_t received = 0;         ///< Read data bytes received so far
+        IoBackendCallback cb = nullptr; ///< Caller's callback
+        void* cb_arg = nullptr;        ///< Caller's argument
+    };
+
+    /**
+     * @brief Serializes one read or write, sending once a batch is full.
+     *
+     * A send failure is reported by the next ProcessCompletions().
+     *
+     * @return 0 if queued, -ENOMEM if the queue is full, negative errno otherwise
+     */
+    int Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+               IoBackendCallback cb, void* cb_arg);
+
+    /**
+     * @brief Writes as much of the send buffer as the socket takes.
+     *
+     * @return 0 on success (including a full socket buffer), negative errno otherwise
+     */
+    int Flush();
+
+    /**
+     * @brief Handles one received PDU.
+     *
+     * @param pdu Start of the PDU; its full plen bytes are in the receive buffer
+     * @param completed Incremented if the PDU completed a command
+     *
+     * @return 0 on success, -EPROTO for a malformed PDU
+     */
+    int HandlePdu(const uint8_t* pdu, int32_t* completed);
+
+    IoBackendOptions options_;           ///< Target address and batching settings
+    uint32_t queue_depth_;               ///< Maximum number of outstanding commands
+    uint32_t namespace_id_;              ///< Namespace addressed by the commands
+    int fd_;                             ///< Connected socket, -1 if not open
+    uint32_t sector_size_;               ///< Sector size reported by the target
+    uint64_t size_;                      ///< Capacity reported by the target in bytes
+    uint32_t max_data_size_;             ///< Largest transfer reported by the target
+    uint32_t unsent_commands_;           ///< Commands serialized since the last send
+    std::vector<Command> commands_;      ///< Command slots, one per identifier
+    std::vector<uint16_t> free_cids_;    ///< Identifiers available for new commands
+    std::vector<uint8_t> tx_;            ///< Serialized PDUs not yet accepted by the socket
+    size_t tx_offset_;                   ///< Bytes of tx_ already sent
+    std::vector<uint8_t> rx_;            ///< Receive buffer, large enough for the biggest PDU
+    size_t rx_start_;                    ///< Start of the first unparsed PDU in rx_
+    size_t rx_end_;                      ///< End of the received bytes in rx_
+    TransportStats stats_;               ///< Transport counters
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "block_verifier.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+/**
+ * @brief Stamps write buffers and checks read buffers on helper threads.
+ *
+ * The submitting thread pushes a task for each write before it is submitted
+ * and for each read once it has completed, flushes the pushed tasks to the
+ * helper threads once per poll and collects finished tasks on later polls, so
+ * the hand-off costs one lock per poll rather than per command. The buffer of
+ * a task must stay untouched until it is collected. Push(), Flush(),
+ * Collect(), WaitForDone() and GetPending() are called from one thread.
+ * Verify results are accumulated by the pipeline and handed over by
+ * TakeStats(). This is fio's verify_async: the checksums move off the thread
+ * whose CPU time bounds the IOPS per core.
+ */
+class VerifyPipeline {
+public:
+    static constexpr uint32_t kMaxThreads = 64;  ///< Most helper threads one pipeline runs
+
+    /**
+     * @brief A buffer to stamp or check.
+     */
+    struct Task {
+        void* tag = nullptr;       ///< Caller's handle, returned unchanged
+        void* buffer = nullptr;    ///< Write buffer to stamp or read buffer to check
+        uint64_t offset = 0;       ///< Byte offset of the command
+        uint32_t size = 0;         ///< Bytes to stamp or check, a multiple of the block size
+        bool is_write = false;     ///< true to stamp, false to check
+        uint64_t generation = 0;   ///< Write generation to stamp
+        uint32_t failed = 0;       ///< Set on collection: blocks of a read that failed verification
+    };
+
+    /**
+     * @brief Starts the helper threads.
+     *
+     * @param verifier Verifier used by every thread; must outlive the pipeline
+     * @param threads Number of helper threads
+     *
+     * @throws std::invalid_argument If threads is 0 or more than kMaxThreads
+     */
+    VerifyPipeline(const BlockVerifier& verifier, uint32_t threads);
+
+    /**
+     * @brief Stops the helper threads; tasks not yet started are dropped.
+     */
+    ~VerifyPipeline();
+
+    VerifyPipeline(const VerifyPipeline&) = delete;
+    VerifyPipeline& operator=(const VerifyPipeline&) = delete;
+
+    /**
+     * @brief Stages a task for the next Flush().
+     *
+     * @param task The task
+     */
+    void Push(const Task& task);
+
+    /**
+     * @brief Hands the staged tasks to the helper threads.
+     */
+    void Flush();
+
+    /**
+     * @brief Takes the finished tasks without waiting.
+     *
+     * @param done Vector the finished tasks are appended to
+     *
+     * @return Number of tasks appended
+     */
+    size_t Collect(std::vector<Task>& done);
+
+    /**
+     * @brief Flushes the staged tasks and waits until a task is finished and not yet collected.
+     *
+     * @param timeout_ns Longest wait in nanoseconds
+     *
+     * @return true if a finished task is waiting to be collected
+     */
+    bool WaitForDone(uint64_t timeout_ns);
+
+    /**
+     * @brief Gets the number of tasks pushed and not yet collected.
+     *
+     * @return Staged, queued, running and finished tasks
+     */
+    uint32_t GetPending() const;
+
+    /**
+     * @brief Takes the verify counters of the reads checked so far.
+     *
+     * @return The counters; the pipeline's own start again from zero
+     */
+    VerifyStats TakeStats();
+
+private:
+    /**
+     * @brief Stops and joins the helper threads started so far.
+     */
+    void StopThreads();
+
+    /**
+     * @brief Runs tasks until the pipeline is stopped.
+     */
+    void WorkerLoop();
+
+    const BlockVerifier& verifier_;       ///< Stamps and checks the buffers
+    std::mutex mutex_;                    ///< Guards the queues, stop_ and stats_
+    std::condition_variable work_cv_;     ///< Wakes helper threads when tasks are queued
+    std::condition_variable done_cv_;     ///< Wakes the collector when tasks finish
+    std::deque<Task> queue_;              ///< Tasks not yet started
+    std::vector<Task> done_;              ///< Finished tasks not yet collected
+    uint32_t idle_;                       ///< Helper threads waiting for tasks
+    bool stop_;                           ///< Set by the destructor
+    VerifyStats stats_;                   ///< Counters of the checked reads
+    std::vector<std::thread> threads_;    ///< Helper threads
+
+    // Submitting thread only
+    std::vector<Task> staged_;            ///< Tasks pushed since the last Flush()
+    uint32_t pending_;                    ///< Tasks pushed and not yet collected
+};
+
+}  // namespace benchmarking
+}  // namespace nvmeof
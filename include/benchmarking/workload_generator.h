@@ -4,13 +4,86 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <atomic>
+#include <vector>
+#include <random>
 // #include <spdk/nvme.h>
 #include "../../third_party/spdk_mock/include/nvme.h"
+#include "dma_buffer_pool.h"
+#include "payload_generator.h"
+#include "rate_limiter.h"
+#include "latency_histogram.h"
+#include "batch_histogram.h"
+#include "block_verifier.h"
+#include "verify_pipeline.h"
+#include "block_trace.h"
+#include "access_pattern.h"
+#include "io_backend.h"
+#include "hybrid_poll_estimator.h"
 #include <cassert>
 
 namespace nvmeof {
 namespace benchmarking {
 
+/**
+ * @brief How the generator decides when to issue the next command.
+ */
+enum class ArrivalMode {
+    CLOSED_LOOP,  ///< Issue a new command whenever a queue slot frees up
+    CONSTANT,     ///< Open loop: arrivals at fixed intervals of 1 / arrival_rate
+    POISSON       ///< Open loop: exponentially distributed inter-arrival times
+};
+
+/**
+ * @brief Parses an arrival mode name ("closed", "constant", "poisson").
+ * 
+ * @param name The mode name (case-insensitive)
+ * 
+ * @return The matching arrival mode
+ * 
+ * @throws std::invalid_argument If the name is unknown
+ */
+ArrivalMode ParseArrivalMode(const std::string& name);
+
+/**
+ * @brief How the generator waits for completions while commands are in flight.
+ */
+enum class CompletionMode {
+    POLL,   ///< Busy-poll the backend; lowest latency, one core fully busy
+    BLOCK,  ///< Sleep in the backend until a completion arrives (eventfd, io_getevents, ppoll)
+    HYBRID  ///< Sleep for an estimated share of the expected service time, then busy-poll
+};
+
+/**
+ * @brief Parses a completion mode name ("poll", "block", "hybrid").
+ * 
+ * "polling" and "interrupt" are accepted as aliases of "poll" and "block".
+ * 
+ * @param name The mode name (case-insensitive)
+ * 
+ * @return The matching completion mode
+ * 
+ * @throws std::invalid_argument If the name is unknown
+ */
+CompletionMode ParseCompletionMode(const std::string& name);
+
+/**
+ * @brief Gets the name of a completion mode.
+ * 
+ * @param mode The completion mode
+ * 
+ * @return The name accepted by ParseCompletionMode()
+ */
+std::string GetCompletionModeName(CompletionMode mode);
+
+/**
+ * @brief One entry of a weighted block-size distribution.
+ */
+struct BlockSizeWeight {
+    uint32_t block_size;  ///< Transfer size in bytes
+    uint32_t weight;      ///< Relative frequency of this size
+};
+
 /**
  * @brief Defines the characteristics of a workload to be generated.
  * 
@@ -21,10 +94,36 @@ struct WorkloadProfile {
     uint64_t total_size;       ///< Total size of the workload in bytes
     uint32_t block_size;       ///< Size of each block in bytes
     uint32_t num_blocks;       ///< Number of blocks to be generated
-    uint32_t interval_us;      ///< Interval between operations in microseconds
+    uint32_t interval_us;      ///< Minimum interval between operations in microseconds (IOPS cap of 10^6 / interval_us)
     uint32_t read_percentage;  ///< Percentage of read operations (0-100)
     uint32_t write_percentage; ///< Percentage of write operations (0-100)
     uint32_t random_percentage; ///< Percentage of random operations (0-100)
+    uint32_t queue_depth = 1;  ///< Number of commands kept in flight on the queue pair
+    uint64_t start_block = 0;  ///< First block of the addressed range (in block_size units)
+    uint32_t namespace_id = 1; ///< Namespace addressed on the controller
+    PayloadPattern payload_pattern = PayloadPattern::RANDOM; ///< Content of written blocks
+    uint32_t compress_percentage = 0; ///< Zero-filled share of each chunk for COMPRESSIBLE (0-100)
+    uint32_t dedupe_percentage = 0;   ///< Share of written blocks that are duplicates (0-100)
+    uint32_t runtime_seconds = 0;     ///< Measured run duration; 0 runs until total_size bytes are transferred
+    uint32_t ramp_time_seconds = 0;   ///< Warm-up period excluded from the statistics
+    uint64_t rate_iops = 0;           ///< Submission rate cap in IOPS; 0 falls back to interval_us
+    double rate_mbps = 0.0;           ///< Throughput cap in MB/s (10^6 bytes per second); 0 is uncapped
+    ArrivalMode arrival_mode = ArrivalMode::CLOSED_LOOP; ///< Closed loop or open-loop arrival schedule
+    double arrival_rate = 0.0;        ///< Arrivals per second in the open-loop modes
+    CompletionMode completion_mode = CompletionMode::POLL; ///< How completions are waited for
+    uint32_t submit_batch = 1;        ///< Closed loop: commands issued back to back before the next poll
+    uint32_t reap_batch = 0;          ///< Completions reaped per poll (max_completions); 0 reaps all available
+    bool verify = false;              ///< Stamp written blocks with a checksummed header and check reads
+    uint64_t verify_seed = 0;         ///< Seed recorded in verify headers; reads expect the same seed
+    uint32_t verify_async = 0;        ///< Helper threads stamping and checking verify blocks; 0 does it inline
+    std::string trace_file;           ///< Binary trace to replay instead of generating operations
+    double replay_speed = 0.0;        ///< Replay at the recorded timing sped up by this factor; 0 is as fast as possible
+    TracePartition trace_partition = TracePartition::LBA; ///< How a job's workers divide the trace
+    uint32_t trace_worker = 0;        ///< Share of the trace replayed by this generator
+    uint32_t trace_workers = 1;       ///< Number of generators sharing the trace
+    AccessPatternConfig access_pattern; ///< Distribution of the blocks addressed by random operations
+    std::vector<BlockSizeWeight> read_block_sizes;  ///< Weighted read sizes; empty reads block_size bytes
+    std::vector<BlockSizeWeight> write_block_sizes; ///< Weighted write sizes; empty writes block_size bytes
     
     /**
      * @brief Validates the workload profile parameters.
@@ -32,15 +131,153 @@ struct WorkloadProfile {
      * @return true if the profile is valid, false otherwise.
      */
     bool IsValid() const {
+        // Every transfer must fit in the addressed range
+        uint64_t range_size = static_cast<uint64_t>(block_size) * num_blocks;
+        for (const auto* sizes : {&read_block_sizes, &write_block_sizes}) {
+            for (const auto& entry : *sizes) {
+                if (entry.block_size == 0 || entry.weight == 0 || entry.block_size > range_size) {
+                    return false;
+                }
+            }
+        }
+        
         // Basic validation
         return (total_size > 0 && 
                 block_size > 0 && 
                 num_blocks > 0 && 
                 read_percentage + write_percentage == 100 &&
-                random_percentage <= 100);
+                random_percentage <= 100 &&
+                queue_depth > 0 &&
+                submit_batch > 0 &&
+                replay_speed >= 0.0 &&
+                trace_worker < trace_workers &&
+                namespace_id > 0 &&
+                compress_percentage <= 100 &&
+                dedupe_percentage <= 100 &&
+                verify_async <= VerifyPipeline::kMaxThreads &&
+                rate_mbps >= 0.0 &&
+                (arrival_mode == ArrivalMode::CLOSED_LOOP || arrival_rate > 0.0) &&
+                access_pattern.IsValid());
     }
 };
 
+/**
+ * @brief Counters of the commands of one transfer size.
+ */
+struct BlockSizeStats {
+    uint32_t block_size = 0;   ///< Transfer size of the bucket in bytes
+    uint64_t read_ops = 0;     ///< Number of completed reads of this size
+    uint64_t write_ops = 0;    ///< Number of completed writes of this size
+    uint64_t bytes = 0;        ///< Bytes transferred by completed commands of this size
+    LatencyHistogram latency;  ///< Latencies of this size from the intended issue time, in nanoseconds
+};
+
+/**
+ * @brief Counters describing the I/O completed by one or more generators.
+ */
+struct WorkloadStats {
+    uint64_t read_ops = 0;         ///< Number of completed read commands
+    uint64_t write_ops = 0;        ///< Number of completed write commands
+    uint64_t read_bytes = 0;       ///< Bytes transferred by completed reads
+    uint64_t write_bytes = 0;      ///< Bytes transferred by completed writes
+    uint64_t errors = 0;           ///< Commands that failed to submit or complete
+    double elapsed_seconds = 0.0;  ///< Wall-clock duration of the run
+    double cpu_seconds = 0.0;      ///< CPU time (user + system) of the submitting threads
+    uint64_t latency_ns_sum = 0;   ///< Sum of latencies measured from the intended issue time
+    uint64_t latency_ns_max = 0;   ///< Largest latency measured from the intended issue time
+    uint64_t service_ns_sum = 0;   ///< Sum of service times measured from the actual submission
+    uint64_t service_ns_max = 0;   ///< Largest service time measured from the actual submission
+    uint64_t completion_waits = 0; ///< Times the thread slept or blocked waiting for completions
+    uint64_t submit_calls = 0;     ///< Doorbell writes or submission system calls reported by the backend
+    BatchHistogram submit_batches; ///< Commands submitted per pass between two polls
+    BatchHistogram reap_batches;   ///< Completions reaped per poll that found any
+    VerifyStats verify;            ///< Blocks checked by reads in verify mode
+    LatencyHistogram read_latency;  ///< Read latencies from the intended issue time, in nanoseconds
+    LatencyHistogram write_latency; ///< Write latencies from the intended issue time, in nanoseconds
+    std::vector<BlockSizeStats> size_buckets; ///< Per transfer size counters, ordered by size
+
+    /**
+     * @brief Accumulates the counters of another run into this one.
+     * 
+     * Counters, CPU time, latency histograms and verify results are summed, size buckets are
+     * matched by transfer size; the elapsed time is the longest of the two, since merged
+     * runs execute concurrently.
+     * 
+     * @param other Statistics to merge
+     */
+    void Merge(const WorkloadStats& other);
+
+    /**
+     * @brief Gets the total number of completed commands per second.
+     * 
+     * @return IOPS, or 0 if no time has elapsed
+     */
+    double GetIops() const;
+
+    /**
+     * @brief Gets the completed commands per second of CPU time.
+     * 
+     * This is the IOPS one fully busy core sustains on the engine. Only the
+     * submitting threads are charged: an io_uring SQPOLL thread and interrupt
+     * handling are not included.
+     * 
+     * @return IOPS per core, or 0 if no CPU time was recorded
+     */
+    double GetIopsPerCore() const;
+
+    /**
+     * @brief Gets the CPU cycles the submitting threads spent per completed command.
+     * 
+     * Cycles are counted at the TSC rate, the nominal clock of the core, so
+     * runs on different completion modes compare directly. Without an
+     * invariant TSC the rate falls back to 1 GHz and the result is nanoseconds.
+     * 
+     * @return Cycles per I/O, or 0 if no command completed
+     */
+    double GetCyclesPerIo() const;
+
+    /**
+     * @brief Gets the doorbell writes or submission system calls per completed command.
+     * 
+     * @return Submission calls per I/O, or 0 if none were counted or no command completed
+     */
+    double GetSubmitCallsPerIo() const;
+
+    /**
+     * @brief Gets the total throughput in MB/s (10^6 bytes per second).
+     * 
+     * @return Throughput, or 0 if no time has elapsed
+     */
+    double GetThroughputMBps() const;
+
+    /**
+     * @brief Gets the bucket of a transfer size, adding it if needed.
+     * 
+     * @param block_size The transfer size in bytes
+     * 
+     * @return The bucket, kept in size order
+     */
+    BlockSizeStats& GetSizeBucket(uint32_t block_size);
+
+    /**
+     * @brief Gets the mean latency from the intended issue time.
+     * 
+     * In the open-loop modes this includes the time a command waited for a free
+     * queue slot, so stalls of the target are not hidden by the generator
+     * issuing fewer commands. In closed-loop runs it equals the service time.
+     * 
+     * @return Mean latency in microseconds, or 0 if no command completed
+     */
+    double GetMeanLatencyUs() const;
+
+    /**
+     * @brief Gets the mean service time from submission to completion.
+     * 
+     * @return Mean service time in microseconds, or 0 if no command completed
+     */
+    double GetMeanServiceTimeUs() const;
+};
+
 /**
  * @brief Callback type for I/O completion notifications.
  */
@@ -50,7 +287,7 @@ using IoCompletionCallback = std::function<void(bool success, uint32_t bytes_pro
  * @brief Generator for NVMe-oF benchmarking workloads.
  * 
  * This class is responsible for generating workloads based on a specified profile
- * and executing them against an NVMe controller.
+ * and executing them against an NVMe controller or another I/O backend.
  */
 class WorkloadGenerator {
 public:
@@ -69,14 +306,75 @@ public:
                       const WorkloadProfile& profile,
                       IoCompletionCallback completion_callback = nullptr);
 
+    /**
+     * @brief Constructs a WorkloadGenerator that drives an I/O backend.
+     * 
+     * The backend is opened by Generate(); WorkloadProfile::namespace_id only
+     * applies to SPDK backends, which are bound to it when constructed.
+     * 
+     * @param backend The I/O path, used only from the thread running Generate()
+     * @param profile Workload profile defining the characteristics of the workload
+     * @param completion_callback Optional callback to be invoked upon workload completion
+     * 
+     * @throws std::invalid_argument If the profile is invalid or the backend is null
+     */
+    WorkloadGenerator(std::shared_ptr<IoBackend> backend,
+                      const WorkloadProfile& profile,
+                      IoCompletionCallback completion_callback = nullptr);
+
     /**
      * @brief Destroys the WorkloadGenerator, cleaning up any allocated resources.
+     *
+     * If commands the backend could not cancel are still outstanding, the
+     * buffer pool is leaked rather than freed under them.
      */
     ~WorkloadGenerator();
 
     /**
      * @brief Generates and executes the workload according to the specified profile.
      * 
+     * Up to WorkloadProfile::queue_depth commands are kept in flight on the
+     * backend; each completion frees its slot and the next command is submitted from
+     * the completion path. When an IOPS or throughput cap is set, submissions are
+     * instead paced by token buckets: the generator busy-polls for completions and
+     * submits as many commands as the buckets allow on each pass.
+     * 
+     * With a submit_batch above 1, closed-loop runs hold freed slots until a
+     * whole batch can be issued and submit it back to back, so the backend can
+     * pass it to the device with one doorbell write or system call. Each poll
+     * reaps at most reap_batch completions.
+     * 
+     * Between submissions the thread waits for completions as set by
+     * WorkloadProfile::completion_mode: it busy-polls, blocks in the backend
+     * until the next completion or the next scheduled submission, or sleeps for
+     * an adaptively estimated share of the expected service time before polling.
+     * 
+     * With WorkloadProfile::verify set, every block a write transfers carries a
+     * header with its LBA, write generation and verify_seed plus a CRC-32C of
+     * its content, and every completed read is checked block by block. Failed
+     * blocks are counted in WorkloadStats::verify with their details; they do
+     * not fail the run or count as I/O errors. With verify_async helper threads
+     * the headers are stamped and the reads checked off this thread: a write is
+     * submitted once its buffer is stamped, and a read's slot is freed once it
+     * has been checked.
+     * 
+     * With a trace_file, operations are replayed from the trace instead: the
+     * type and size of each record are kept and its offset is wrapped into the
+     * addressed range. With a replay_speed the records are issued open loop
+     * at their recorded times divided by the speed; otherwise they are issued
+     * closed loop as fast as the queue allows. The run ends when this
+     * generator's share of the trace (see trace_worker) is exhausted or the
+     * runtime elapses; total_size does not apply.
+     * 
+     * In the open-loop arrival modes, commands are issued on a schedule of
+     * intended issue times instead; arrivals that find the queue full are issued
+     * late and their latency is still measured from the scheduled time. Rate caps
+     * do not apply to open-loop runs, whose load is set by arrival_rate.
+     * 
+     * The run ends once total_size bytes have been transferred, or after
+     * ramp_time_seconds + runtime_seconds when a runtime is set. Statistics only
+     * cover the period after the ramp-up.
+     * 
      * @return true if the workload was generated and executed successfully, false otherwise.
      * 
      * @throws std::runtime_error If the workload generation fails
@@ -85,63 +383,260 @@ public:
 
     /**
      * @brief Stops the workload generation if it's in progress.
+     *
+     * The request is sticky: a Stop() that arrives before or during the setup
+     * of Generate() ends the run before any command is issued.
      */
     void Stop();
 
     /**
      * @brief Gets the current progress of the workload generation.
      * 
+     * Progress is measured in bytes, or in elapsed time for runs with a runtime.
+     * 
      * @return A value between 0.0 and 1.0 indicating the progress.
      */
     double GetProgress() const;
 
+    /**
+     * @brief Gets the statistics of the most recent run.
+     * 
+     * @return Completed operation counters and elapsed time
+     */
+    WorkloadStats GetStats() const;
+
+    /**
+     * @brief Sets the pool the generator draws its I/O buffers from.
+     * 
+     * The pool may be shared with other generators or engines. Without an
+     * explicit pool, Generate() allocates a private pool of queue_depth buffers
+     * on its first run. The pool's buffers must be at least block_size bytes
+     * (rounded up to the sector size).
+     * 
+     * @param pool The buffer pool to use
+     */
+    void SetBufferPool(std::shared_ptr<DmaBufferPool> pool);
+
 private:
+    /**
+     * @brief Per-command state for a request that is in flight on the backend.
+     *
+     * One context exists per queue slot; the context pointer is passed to the
+     * backend as the completion argument so each completion can be matched to its request.
+     */
+    struct IoContext {
+        WorkloadGenerator* generator;  ///< Owning generator
+        void* buffer;                  ///< DMA buffer used by the command, owned by the pool
+        uint64_t offset;               ///< Byte offset of the command
+        uint32_t size;                 ///< Number of bytes transferred by the command
+        bool is_read;                  ///< true for reads, false for writes
+        uint64_t intended_ns;          ///< Time the command was scheduled to be issued
+        uint64_t submit_ns;            ///< Time the command was actually submitted
+        size_t size_bucket;            ///< Index of the command's transfer size in stats_.size_buckets
+    };
+
+    /**
+     * @brief Picks the next operation and submits it using a free context.
+     *
+     * @param intended_ns Scheduled issue time of the command; 0 means now
+     *
+     * @return true if a command was submitted, false if no command could be issued
+     */
+    bool SubmitNext(uint64_t intended_ns = 0);
+
+    /**
+     * @brief One entry of a cumulative block-size table.
+     */
+    struct SizeChoice {
+        uint32_t block_size;         ///< Transfer size in bytes
+        uint64_t cumulative_weight;  ///< Sum of the weights up to and including this entry
+        size_t bucket;               ///< Index of the size in stats_.size_buckets
+    };
+
+    /**
+     * @brief Builds the cumulative table of a weighted block-size distribution.
+     *
+     * @param sizes The weighted sizes; empty means block_size only
+     *
+     * @return The cumulative table
+     */
+    std::vector<SizeChoice> BuildSizeTable(const std::vector<BlockSizeWeight>& sizes) const;
+
+    /**
+     * @brief Draws the type and transfer size of the next command.
+     */
+    void PickNextOperation();
+
+    /**
+     * @brief Gets the scheduled issue time of the next trace record.
+     *
+     * @param start_ns Start of the replay, the time of the trace's earliest record
+     *
+     * @return Issue time of the record, scaled by the replay speed
+     */
+    uint64_t GetReplayArrivalNs(uint64_t start_ns);
+
+    /**
+     * @brief Clears the statistics and creates one bucket per configured transfer size.
+     */
+    void ResetStats();
+
+    /**
+     * @brief Draws the time until the next open-loop arrival.
+     *
+     * @return Inter-arrival time in nanoseconds
+     */
+    uint64_t NextInterarrivalNs();
+
+    /**
+     * @brief Waits for completions as set by the completion mode and reaps them.
+     *
+     * @param now_ns Current time
+     * @param wake_by_ns Time by which the loop must run again to submit or stop
+     *
+     * @return Number of completions reaped, negative errno on failure
+     */
+    int32_t ReapCompletions(uint64_t now_ns, uint64_t wake_by_ns);
+
+    /**
+     * @brief Gets the submission time of the oldest command in flight.
+     *
+     * @return Submission time, or now if nothing is in flight
+     */
+    uint64_t GetOldestSubmitNs() const;
+
+    /**
+     * @brief Checks whether more commands should be submitted.
+     *
+     * @return true while the run is active and its byte or time budget is not used up
+     */
+    bool HasWorkRemaining() const;
+
+    /**
+     * @brief Takes the pacing tokens needed to submit one command.
+     *
+     * @param size Size of the command in bytes
+     *
+     * @return true if the command may be submitted now
+     */
+    bool ConsumePacingTokens(uint32_t size);
+
     /**
      * @brief Writes a block of data to the NVMe device.
      * 
+     * @param ctx Context that tracks the command until it completes
      * @param offset Offset in bytes where the write should start
      * @param size Size of the block to write in bytes
      * 
-     * @return true if the write operation was submitted successfully, false otherwise.
+     * @return 0 if the write was submitted, negative errno otherwise
      */
-    bool WriteBlock(uint64_t offset, uint32_t size);
+    int WriteBlock(IoContext* ctx, uint64_t offset, uint32_t size);
 
     /**
      * @brief Reads a block of data from the NVMe device.
      * 
+     * @param ctx Context that tracks the command until it completes
      * @param offset Offset in bytes where the read should start
      * @param size Size of the block to read in bytes
      * 
-     * @return true if the read operation was submitted successfully, false otherwise.
+     * @return 0 if the read was submitted, negative errno otherwise
      */
-    bool ReadBlock(uint64_t offset, uint32_t size);
+    int ReadBlock(IoContext* ctx, uint64_t offset, uint32_t size);
 
     /**
-     * @brief Callback function for write completion.
-     * 
-     * @param arg User-provided argument (this WorkloadGenerator instance)
-     * @param completion The NVMe completion structure
+     * @brief Releases a completed context and refills the freed queue slot.
+     *
+     * @param ctx The context of the completed command
+     * @param success Whether the command completed without error
+     */
+    void OnCompletion(IoContext* ctx, bool success);
+
+    /**
+     * @brief Releases a context's buffer and slot and refills the slot.
+     *
+     * @param ctx The context of the finished command
+     */
+    void FinishCommand(IoContext* ctx);
+
+    /**
+     * @brief Submits the writes the verify pipeline has stamped and finishes the reads it has checked.
      */
-    static void WriteCompletionCallback(void *arg, const struct spdk_nvme_cpl *completion);
+    void CollectVerified();
 
     /**
-     * @brief Callback function for read completion.
+     * @brief Callback function for read and write completions.
      * 
-     * @param arg User-provided argument (this WorkloadGenerator instance)
-     * @param completion The NVMe completion structure
+     * @param arg User-provided argument (the IoContext of the command)
+     * @param status 0 on success, an NVMe status code or negative errno on failure
      */
-    static void ReadCompletionCallback(void *arg, const struct spdk_nvme_cpl *completion);
+    static void CompletionCallback(void *arg, int status);
 
-    // NVMe controller and queue pair
-    const struct spdk_nvme_ctrlr *ctrlr_;
-    const struct spdk_nvme_qpair *qpair_;
+    // I/O path
+    std::shared_ptr<IoBackend> backend_;
+    uint32_t sector_size_;
     
     // Workload profile and state
     WorkloadProfile profile_;
-    bool write_completed_;
-    bool read_completed_;
-    uint64_t total_bytes_processed_;
-    bool is_running_;
+    std::atomic<uint64_t> total_bytes_processed_;
+    uint64_t bytes_submitted_;
+    std::atomic<bool> is_running_;
+    std::atomic<bool> stop_requested_;            ///< Set by Stop(), never cleared
+    WorkloadStats stats_;
+    
+    // Run duration and pacing
+    std::atomic<uint64_t> run_start_ns_;          ///< Start of the current run, 0 if none has started
+    bool time_expired_;                           ///< Set once the runtime has elapsed
+    std::unique_ptr<TokenBucket> iops_limiter_;      ///< Paces commands per second, if capped
+    std::unique_ptr<TokenBucket> bandwidth_limiter_; ///< Paces bytes per second, if capped
+    std::exponential_distribution<double> interarrival_dist_; ///< Poisson inter-arrival times in seconds
+    
+    // Hybrid polling
+    HybridPollEstimator hybrid_estimator_;  ///< Sleep time before polling
+    bool hybrid_spinning_;                  ///< Polling after a sleep, no completion seen yet
+    uint64_t hybrid_wake_ns_;               ///< End of the last sleep
+    uint32_t hybrid_empty_polls_;           ///< Empty polls since the last sleep
+    
+    // Pre-allocated DMA buffers for the I/O path
+    std::shared_ptr<DmaBufferPool> buffer_pool_;
+    
+    // Pre-generated write payloads
+    std::unique_ptr<PayloadGenerator> payload_;
+    
+    // Header stamping and read checks in verify mode
+    std::unique_ptr<BlockVerifier> verifier_;
+    std::unique_ptr<VerifyPipeline> verify_pipeline_;   ///< Helper threads, with verify_async only
+    std::vector<VerifyPipeline::Task> verified_;        ///< Collected tasks not yet acted on
+    
+    // Trace replay
+    std::unique_ptr<TraceReader> trace_;          ///< Mapped trace, if replaying
+    std::unique_ptr<TraceCursor> trace_cursor_;   ///< This generator's position in the trace
+    std::atomic<uint64_t> replay_position_;       ///< Records of the trace examined so far
+    std::atomic<uint64_t> replay_record_count_;   ///< Records in the trace
+    
+    // In-flight request tracking
+    std::vector<IoContext> contexts_;        ///< One context per queue slot
+    std::vector<IoContext*> free_contexts_;  ///< Contexts available for submission
+    uint32_t in_flight_;                     ///< Number of commands currently outstanding
+    bool submitting_;                        ///< Set while a command is being submitted
+    bool refill_on_completion_;              ///< Closed loop, unpaced and unbatched: completions refill their slot
+    
+    // Random number generation for offset and operation selection
+    std::mt19937 rng_;
+    std::unique_ptr<OffsetGenerator> offset_generator_;
+    std::vector<SizeChoice> read_sizes_;   ///< Cumulative read size table
+    std::vector<SizeChoice> write_sizes_;  ///< Cumulative write size table
+    std::vector<uint32_t> bucket_sizes_;   ///< Distinct transfer sizes in ascending order
+    uint32_t max_io_size_;                 ///< Largest configured transfer size
+    
+    // Operation drawn but not yet submitted; kept until it can be issued so that
+    // pacing does not bias the size mix towards small transfers
+    bool has_next_op_;
+    bool next_is_read_;
+    uint32_t next_size_;
+    size_t next_bucket_;
+    uint64_t next_range_offset_;  ///< Offset within the range of a replayed record
+    uint64_t next_trace_ns_;      ///< Recorded time of a replayed record
+    std::uniform_int_distribution<uint32_t> percent_dist_;
     
     // Completion callback
     IoCompletionCallback completion_callback_;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nvmeof {
+namespace utils {
+
+/**
+ * @brief CRC-32C (Castagnoli) checksums, as used by NVMe-oF and iSCSI digests.
+ *
+ * On x86 CPUs with SSE4.2 the checksum is computed with the crc32 instruction
+ * on three interleaved streams, which hides the instruction's latency and
+ * reaches several bytes per cycle; the partial checksums are combined with
+ * precomputed shift tables. Other CPUs use a slicing-by-8 table
+ * implementation. Both produce the same result.
+ */
+class Crc32c {
+public:
+    /**
+     * @brief Computes or extends a checksum with the fastest available implementation.
+     *
+     * @param data Bytes to checksum
+     * @param size Number of bytes
+     * @param crc Checksum of the preceding bytes, 0 to start a new checksum
+     *
+     * @return The checksum of the preceding bytes followed by data
+     */
+    static uint32_t Compute(const void* data, size_t size, uint32_t crc = 0);
+
+    /**
+     * @brief Computes the checksums of several buffers of the same size laid out at a fixed stride.
+     *
+     * With the crc32 instruction, three buffers are checksummed on interleaved
+     * streams, so buffers too short for Compute() to split, such as the
+     * sectors of one transfer, still reach its throughput.
+     *
+     * @param data Start of the first buffer
+     * @param size Bytes of each buffer
+     * @param stride Distance between the starts of consecutive buffers
+     * @param count Number of buffers
+     * @param crcs Receives the count checksums
+     */
+    static void ComputeStrided(const void* data, size_t size, size_t stride, size_t count, uint32_t* crcs);
+
+    /**
+     * @brief Computes or extends a checksum with the table implementation.
+     *
+     * @param data Bytes to checksum
+     * @param size Number of bytes
+     * @param crc Checksum of the preceding bytes, 0 to start a new checksum
+     *
+     * @return The checksum of the preceding bytes followed by data
+     */
+    static uint32_t ComputeSoftware(const void* data, size_t size, uint32_t crc = 0);
+
+    /**
+     * @brief Checks whether Compute() uses the crc32 instruction.
+     *
+     * @return true if SSE4.2 is available, false if the table implementation is used
+     */
+    static bool IsHardwareAccelerated();
+};
+
+}  // namespace utils
+}  // namespace nvmeof
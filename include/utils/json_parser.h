@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nvmeof {
+namespace utils {
+
+/**
+ * @brief An immutable JSON document node.
+ *
+ * Objects keep their members in document order. Non-negative integers are
+ * stored exactly, so 64-bit sizes survive the round trip through the parser.
+ */
+class JsonValue {
+public:
+    /**
+     * @brief Kind of a JSON value.
+     */
+    enum class Type {
+        NUL,      ///< null
+        BOOLEAN,  ///< true or false
+        NUMBER,   ///< Integer or floating-point number
+        STRING,   ///< UTF-8 string
+        ARRAY,    ///< Ordered list of values
+        OBJECT    ///< Ordered list of key/value members
+    };
+
+    /**
+     * @brief Constructs a null value.
+     */
+    JsonValue();
+
+    /**
+     * @brief Parses a JSON document.
+     *
+     * The parser is a single recursive-descent pass over the input and does not
+     * copy the text except for string contents.
+     *
+     * @param text The JSON text (RFC 8259)
+     *
+     * @return The root value of the document
+     *
+     * @throws std::runtime_error If the text is not valid JSON; the message
+     *         includes the line and column of the error
+     */
+    static JsonValue Parse(const std::string& text);
+
+    /**
+     * @brief Gets the kind of the value.
+     *
+     * @return The value type
+     */
+    Type GetType() const;
+
+    bool IsNull() const { return type_ == Type::NUL; }         ///< @return true for null
+    bool IsBool() const { return type_ == Type::BOOLEAN; }     ///< @return true for booleans
+    bool IsNumber() const { return type_ == Type::NUMBER; }    ///< @return true for numbers
+    bool IsString() const { return type_ == Type::STRING; }    ///< @return true for strings
+    bool IsArray() const { return type_ == Type::ARRAY; }      ///< @return true for arrays
+    bool IsObject() const { return type_ == Type::OBJECT; }    ///< @return true for objects
+
+    /**
+     * @brief Gets a boolean value.
+     *
+     * @return The boolean
+     *
+     * @throws std::runtime_error If the value is not a boolean
+     */
+    bool AsBool() const;
+
+    /**
+     * @brief Gets a number as a double.
+     *
+     * @return The number
+     *
+     * @throws std::runtime_error If the value is not a number
+     */
+    double AsDouble() const;
+
+    /**
+     * @brief Gets a number as an unsigned 64-bit integer.
+     *
+     * @return The integer
+     *
+     * @throws std::runtime_error If the value is not a non-negative integer that fits in 64 bits
+     */
+    uint64_t AsUint64() const;
+
+    /**
+     * @brief Gets a string value.
+     *
+     * @return The string
+     *
+     * @throws std::runtime_error If the value is not a string
+     */
+    const std::string& AsString() const;
+
+    /**
+     * @brief Gets the number of elements of an array or members of an object.
+     *
+     * @return The size, or 0 for scalar values
+     */
+    size_t Size() const;
+
+    /**
+     * @brief Gets an array element.
+     *
+     * @param index Index of the element
+     *
+     * @return The element
+     *
+     * @throws std::runtime_error If the value is not an array
+     * @throws std::out_of_range If the index is out of range
+     */
+    const JsonValue& operator[](size_t index) const;
+
+    /**
+     * @brief Gets the key of an object member.
+     *
+     * @param index Index of the member in document order
+     *
+     * @return The key
+     *
+     * @throws std::runtime_error If the value is not an object
+     * @throws std::out_of_range If the index is out of range
+     */
+    const std::string& KeyAt(size_t index) const;
+
+    /**
+     * @brief Gets the value of an object member.
+     *
+     * @param index Index of the member in document order
+     *
+     * @return The member value
+     *
+     * @throws std::runtime_error If the value is not an object
+     * @throws std::out_of_range If the index is out of range
+     */
+    const JsonValue& ValueAt(size_t index) const;
+
+    /**
+     * @brief Looks up an object member by key.
+     *
+     * @param key The member key
+     *
+     * @return The member value, or nullptr if the value is not an object or has no such member
+     */
+    const JsonValue* Find(const std::string& key) const;
+
+private:
+    friend class JsonParser;
+
+    Type type_;                      ///< Kind of the value
+    bool bool_value_;                ///< Value of a boolean
+    bool is_uint_;                   ///< Whether a number is a non-negative integer held exactly
+    uint64_t uint_value_;            ///< Exact value of a non-negative integer
+    double number_value_;            ///< Value of a number
+    std::string string_value_;       ///< Value of a string
+    std::vector<std::string> keys_;  ///< Keys of an object's members
+    std::vector<JsonValue> items_;   ///< Elements of an array, or values of an object's members
+};
+
+}  // namespace utils
+}  // namespace nvmeof
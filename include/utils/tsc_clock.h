@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace nvmeof {
+namespace utils {
+
+/**
+ * @brief Cheap monotonic clock for per-I/O timestamps.
+ *
+ * On x86 CPUs with an invariant TSC the clock reads the time-stamp counter,
+ * which costs a few nanoseconds instead of a clock_gettime() call. The tick
+ * rate is calibrated against std::chrono::steady_clock the first time the
+ * clock is used. On other CPUs the clock falls back to steady_clock, in which
+ * case one tick is one nanosecond.
+ */
+class TscClock {
+public:
+    /**
+     * @brief Reads the raw clock.
+     *
+     * @return Current time in ticks
+     */
+    static uint64_t NowTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (GetCalibration().use_tsc) {
+            return __rdtsc();
+        }
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Converts a number of ticks to nanoseconds.
+     *
+     * @param ticks Duration or timestamp in ticks
+     *
+     * @return The same duration in nanoseconds
+     */
+    static uint64_t TicksToNs(uint64_t ticks) {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * GetCalibration().ns_per_tick);
+    }
+
+    /**
+     * @brief Reads the clock in nanoseconds.
+     *
+     * The epoch is unspecified; only differences between readings are meaningful.
+     *
+     * @return Current time in nanoseconds
+     */
+    static uint64_t NowNs() {
+        return TicksToNs(NowTicks());
+    }
+
+    /**
+     * @brief Checks whether the clock reads the time-stamp counter.
+     *
+     * @return true if the TSC is used, false if the clock falls back to steady_clock
+     */
+    static bool IsTscEnabled();
+
+    /**
+     * @brief Gets the calibrated tick rate.
+     *
+     * @return Ticks per second
+     */
+    static double GetTicksPerSecond();
+
+private:
+    struct Calibration {
+        bool use_tsc;        ///< Whether the time-stamp counter is read
+        double ns_per_tick;  ///< Conversion factor from ticks to nanoseconds
+    };
+
+    /**
+     * @brief Calibrates the clock on first use.
+     *
+     * @return The calibration shared by all threads
+     */
+    static const Calibration& GetCalibration();
+
+    /**
+     * @brief Measures the TSC rate against steady_clock.
+     *
+     * @return The calibration to use
+     */
+    static Calibration Calibrate();
+};
+
+}  // namespace utils
+}  // namespace nvmeof
@@ -16,6 +16,8 @@
 
 #include "../include/benchmarking/data_collector.h"
 #include "../include/benchmarking/result_visualizer.h"
+#include "../include/benchmarking/result_file.h"
+#include "../include/benchmarking/stream_compression.h"
 #include "../include/bottleneck_analysis/bottleneck_detector.h"
 #include "../include/bottleneck_analysis/system_profiler.h"
 #include "../include/optimization_engine/config_knowledge_base.h"
@@ -94,7 +96,9 @@ bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
                         std::filesystem::path latest_file;
                         
                         for (const auto& entry : std::filesystem::directory_iterator(dir_path)) {
-                            if (entry.is_regular_file() && entry.path().extension() == ".csv" &&
+                            if (entry.is_regular_file() &&
+                                (entry.path().extension() == ".csv" || entry.path().extension() == ".nvbr" ||
+                                 entry.path().extension() == ".nvlz") &&
                                 entry.path().filename().string().find("benchmark_") != std::string::npos) {
                                 auto file_time = std::filesystem::last_write_time(entry.path());
                                 if (latest_file.empty() || file_time > latest_time) {
@@ -168,12 +172,31 @@ bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
     return true;
 }
 
-// Parse a CSV file containing benchmark results
+// Parse a CSV or binary file containing benchmark results
 std::vector<std::pair<std::string, double>> parseBenchmarkResults(const std::string& filename) {
     std::vector<std::pair<std::string, double>> results;
-    std::ifstream file(filename);
     
-    if (!file.is_open()) {
+    // Binary results are read from the mapped columns without parsing text
+    if (nvmeof::benchmarking::ResultFileReader::IsResultFile(filename)) {
+        nvmeof::benchmarking::ResultFileReader reader;
+        if (reader.Open(filename)) {
+            if (reader.IsRecovered()) {
+                std::cerr << "Warning: " << filename << " is incomplete; read "
+                          << reader.GetBlockCount() << " blocks" << std::endl;
+            }
+            results.reserve(reader.GetPointCount());
+            reader.ForEachPoint([&](int64_t, uint32_t id, double value) {
+                results.emplace_back(reader.GetLabel(id), value);
+            });
+        }
+        return results;
+    }
+    
+    // Compressed CSV is decompressed frame by frame as it is read
+    std::unique_ptr<std::istream> stream = nvmeof::benchmarking::OpenResultStream(filename);
+    std::istream& file = *stream;
+    
+    if (!file) {
         std::cerr << "Error: Unable to open file: " << filename << std::endl;
         return results;
     }
@@ -0,0 +1,381 @@
+#include "../../include/benchmarking/access_pattern.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// Both GCC and Clang provide 128-bit integers; __extension__ keeps -Wpedantic quiet
+__extension__ typedef unsigned __int128 Uint128;
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief xoshiro256** generator with helpers for bounded integers and doubles.
+ */
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed) {
+        for (auto& word : state_) {
+            word = SplitMix64(seed);
+        }
+    }
+
+    uint64_t Next() {
+        uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = Rotl(state_[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, bound) using a multiply-shift instead of a division
+    uint64_t NextBelow(uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<Uint128>(Next()) * bound) >> 64);
+    }
+
+    // Uniform in [0, 1) with 53 bits of precision
+    double NextDouble() {
+        return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    static uint64_t Rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state_[4];
+};
+
+class UniformOffsetGenerator : public OffsetGenerator {
+public:
+    UniformOffsetGenerator(uint64_t num_blocks, uint64_t seed)
+        : num_blocks_(num_blocks), rng_(seed) {}
+
+    uint64_t NextBlock() override {
+        return rng_.NextBelow(num_blocks_);
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::UNIFORM;
+    }
+
+private:
+    uint64_t num_blocks_;
+    Xoshiro256 rng_;
+};
+
+/**
+ * Rejection-inversion sampling (Hoermann and Derflinger, 1996). Needs no
+ * table of harmonic numbers, so construction is O(1) for any range size, and
+ * accepts on the first attempt for the vast majority of samples.
+ */
+class ZipfOffsetGenerator : public OffsetGenerator {
+public:
+    ZipfOffsetGenerator(uint64_t num_blocks, double theta, uint64_t seed)
+        : num_blocks_(num_blocks)
+        , theta_(theta)
+        , rng_(seed) {
+        h_integral_x1_ = HIntegral(1.5) - 1.0;
+        h_integral_n_ = HIntegral(static_cast<double>(num_blocks_) + 0.5);
+        s_ = 2.0 - HIntegralInverse(HIntegral(2.5) - H(2.0));
+    }
+
+    uint64_t NextBlock() override {
+        for (;;) {
+            double u = h_integral_n_ + rng_.NextDouble() * (h_integral_x1_ - h_integral_n_);
+            double x = HIntegralInverse(u);
+            double k = std::floor(x + 0.5);
+            k = std::min(std::max(k, 1.0), static_cast<double>(num_blocks_));
+
+            if (k - x <= s_ || u >= HIntegral(k + 0.5) - H(k)) {
+                // Ranks start at 1
+                return static_cast<uint64_t>(k) - 1;
+            }
+        }
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::ZIPF;
+    }
+
+private:
+    double H(double x) const {
+        return std::exp(-theta_ * std::log(x));
+    }
+
+    double HIntegral(double x) const {
+        double log_x = std::log(x);
+        return Helper2((1.0 - theta_) * log_x) * log_x;
+    }
+
+    double HIntegralInverse(double x) const {
+        double t = x * (1.0 - theta_);
+        if (t < -1.0) {
+            t = -1.0;
+        }
+        return std::exp(Helper1(t) * x);
+    }
+
+    // log1p(x) / x, stable around 0
+    static double Helper1(double x) {
+        if (std::fabs(x) > 1e-8) {
+            return std::log1p(x) / x;
+        }
+        return 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    // expm1(x) / x, stable around 0
+    static double Helper2(double x) {
+        if (std::fabs(x) > 1e-8) {
+            return std::expm1(x) / x;
+        }
+        return 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+    uint64_t num_blocks_;
+    double theta_;
+    double h_integral_x1_;
+    double h_integral_n_;
+    double s_;
+    Xoshiro256 rng_;
+};
+
+/**
+ * Bounded Pareto distribution on [1, num_blocks + 1), sampled by inverting
+ * its CDF.
+ */
+class ParetoOffsetGenerator : public OffsetGenerator {
+public:
+    ParetoOffsetGenerator(uint64_t num_blocks, double shape, uint64_t seed)
+        : num_blocks_(num_blocks)
+        , inverse_shape_(1.0 / shape)
+        , range_factor_(1.0 - std::pow(1.0 / (static_cast<double>(num_blocks) + 1.0), shape))
+        , rng_(seed) {}
+
+    uint64_t NextBlock() override {
+        double u = rng_.NextDouble();
+        double x = 1.0 / std::pow(1.0 - u * range_factor_, inverse_shape_);
+        uint64_t block = static_cast<uint64_t>(x) - 1;
+        return std::min(block, num_blocks_ - 1);
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::PARETO;
+    }
+
+private:
+    uint64_t num_blocks_;
+    double inverse_shape_;
+    double range_factor_;
+    Xoshiro256 rng_;
+};
+
+class HotColdOffsetGenerator : public OffsetGenerator {
+public:
+    HotColdOffsetGenerator(uint64_t num_blocks, uint32_t hot_io_percentage,
+                           uint32_t hot_space_percentage, uint64_t seed)
+        : num_blocks_(num_blocks)
+        , hot_threshold_(hot_io_percentage >= 100
+                             ? UINT64_MAX
+                             : static_cast<uint64_t>(std::ldexp(hot_io_percentage / 100.0, 64)))
+        , hot_blocks_(std::max<uint64_t>(1, num_blocks * hot_space_percentage / 100))
+        , rng_(seed) {}
+
+    uint64_t NextBlock() override {
+        // The cold set is empty when the hot set covers the whole range
+        if (rng_.Next() < hot_threshold_ || hot_blocks_ >= num_blocks_) {
+            return rng_.NextBelow(hot_blocks_);
+        }
+        return hot_blocks_ + rng_.NextBelow(num_blocks_ - hot_blocks_);
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::HOT_COLD;
+    }
+
+private:
+    uint64_t num_blocks_;
+    uint64_t hot_threshold_;
+    uint64_t hot_blocks_;
+    Xoshiro256 rng_;
+};
+
+class NormalOffsetGenerator : public OffsetGenerator {
+public:
+    NormalOffsetGenerator(uint64_t num_blocks, double stddev_percentage,
+                          double center_step, uint64_t seed)
+        : num_blocks_(static_cast<double>(num_blocks))
+        , center_(static_cast<double>(num_blocks) / 2.0)
+        , center_step_(center_step)
+        , stddev_(std::max(1.0, static_cast<double>(num_blocks) * stddev_percentage / 100.0))
+        , spare_(0.0)
+        , has_spare_(false)
+        , rng_(seed) {}
+
+    uint64_t NextBlock() override {
+        double offset = center_ + stddev_ * NextGaussian();
+        center_ = Wrap(center_ + center_step_);
+        return std::min(static_cast<uint64_t>(Wrap(offset)),
+                        static_cast<uint64_t>(num_blocks_) - 1);
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::NORMAL;
+    }
+
+private:
+    double Wrap(double value) const {
+        value = std::fmod(value, num_blocks_);
+        return value < 0.0 ? value + num_blocks_ : value;
+    }
+
+    // Marsaglia polar method; every accepted pair yields two samples
+    double NextGaussian() {
+        if (has_spare_) {
+            has_spare_ = false;
+            return spare_;
+        }
+
+        double u, v, s;
+        do {
+            u = 2.0 * rng_.NextDouble() - 1.0;
+            v = 2.0 * rng_.NextDouble() - 1.0;
+            s = u * u + v * v;
+        } while (s >= 1.0 || s == 0.0);
+
+        double scale = std::sqrt(-2.0 * std::log(s) / s);
+        spare_ = v * scale;
+        has_spare_ = true;
+        return u * scale;
+    }
+
+    double num_blocks_;
+    double center_;
+    double center_step_;
+    double stddev_;
+    double spare_;
+    bool has_spare_;
+    Xoshiro256 rng_;
+};
+
+class StridedOffsetGenerator : public OffsetGenerator {
+public:
+    StridedOffsetGenerator(uint64_t num_blocks, uint64_t stride_blocks)
+        : num_blocks_(num_blocks)
+        , stride_blocks_(stride_blocks % num_blocks)
+        , next_block_(0) {}
+
+    uint64_t NextBlock() override {
+        uint64_t block = next_block_;
+        next_block_ += stride_blocks_;
+        if (next_block_ >= num_blocks_) {
+            next_block_ -= num_blocks_;
+        }
+        return block;
+    }
+
+    AccessDistribution GetDistribution() const override {
+        return AccessDistribution::STRIDED;
+    }
+
+private:
+    uint64_t num_blocks_;
+    uint64_t stride_blocks_;
+    uint64_t next_block_;
+};
+
+}  // namespace
+
+AccessDistribution ParseAccessDistribution(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "uniform" || lower == "random") {
+        return AccessDistribution::UNIFORM;
+    } else if (lower == "zipf" || lower == "zipfian") {
+        return AccessDistribution::ZIPF;
+    } else if (lower == "pareto") {
+        return AccessDistribution::PARETO;
+    } else if (lower == "hotcold" || lower == "hot_cold" || lower == "hotset") {
+        return AccessDistribution::HOT_COLD;
+    } else if (lower == "normal" || lower == "gauss") {
+        return AccessDistribution::NORMAL;
+    } else if (lower == "strided" || lower == "stride") {
+        return AccessDistribution::STRIDED;
+    }
+
+    throw std::invalid_argument("Unknown access distribution: " + name);
+}
+
+bool AccessPatternConfig::IsValid() const {
+    switch (distribution) {
+        case AccessDistribution::UNIFORM:
+            return true;
+        case AccessDistribution::ZIPF:
+            return zipf_theta > 0.0;
+        case AccessDistribution::PARETO:
+            return pareto_shape > 0.0;
+        case AccessDistribution::HOT_COLD:
+            return hot_io_percentage <= 100 &&
+                   hot_space_percentage > 0 && hot_space_percentage <= 100;
+        case AccessDistribution::NORMAL:
+            return normal_stddev_percentage > 0.0 && std::isfinite(normal_center_step);
+        case AccessDistribution::STRIDED:
+            return stride_blocks > 0;
+    }
+    return false;
+}
+
+std::unique_ptr<OffsetGenerator> OffsetGenerator::Create(const AccessPatternConfig& config,
+                                                         uint64_t num_blocks,
+                                                         uint64_t seed) {
+    if (num_blocks == 0) {
+        throw std::invalid_argument("Offset generator range cannot be empty");
+    }
+
+    if (!config.IsValid()) {
+        throw std::invalid_argument("Invalid access pattern configuration");
+    }
+
+    if (seed == 0) {
+        seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+    }
+
+    switch (config.distribution) {
+        case AccessDistribution::UNIFORM:
+            return std::make_unique<UniformOffsetGenerator>(num_blocks, seed);
+        case AccessDistribution::ZIPF:
+            return std::make_unique<ZipfOffsetGenerator>(num_blocks, config.zipf_theta, seed);
+        case AccessDistribution::PARETO:
+            return std::make_unique<ParetoOffsetGenerator>(num_blocks, config.pareto_shape, seed);
+        case AccessDistribution::HOT_COLD:
+            return std::make_unique<HotColdOffsetGenerator>(
+                num_blocks, config.hot_io_percentage, config.hot_space_percentage, seed);
+        case AccessDistribution::NORMAL:
+            return std::make_unique<NormalOffsetGenerator>(
+                num_blocks, config.normal_stddev_percentage, config.normal_center_step, seed);
+        case AccessDistribution::STRIDED:
+            return std::make_unique<StridedOffsetGenerator>(num_blocks, config.stride_blocks);
+    }
+
+    throw std::invalid_argument("Unknown access distribution");
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
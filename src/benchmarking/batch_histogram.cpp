@@ -0,0 +1,61 @@
+#include "../../include/benchmarking/batch_histogram.h"
+#include <algorithm>
+
+namespace nvmeof {
+namespace benchmarking {
+
+void BatchHistogram::Record(uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // Index of the highest set bit, capped at the last bucket
+    size_t bucket = 0;
+    while (bucket + 1 < kNumBuckets && (size >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+
+    ++buckets_[bucket];
+    ++batches_;
+    commands_ += size;
+    max_ = std::max(max_, size);
+}
+
+void BatchHistogram::Merge(const BatchHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    batches_ += other.batches_;
+    commands_ += other.commands_;
+    max_ = std::max(max_, other.max_);
+}
+
+uint64_t BatchHistogram::GetBatchCount() const {
+    return batches_;
+}
+
+uint64_t BatchHistogram::GetCommandCount() const {
+    return commands_;
+}
+
+double BatchHistogram::GetMean() const {
+    if (batches_ == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(commands_) / batches_;
+}
+
+uint32_t BatchHistogram::GetMax() const {
+    return max_;
+}
+
+uint64_t BatchHistogram::GetBucketCount(size_t bucket) const {
+    return bucket < kNumBuckets ? buckets_[bucket] : 0;
+}
+
+uint32_t BatchHistogram::GetBucketLowerBound(size_t bucket) {
+    return uint32_t{1} << bucket;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,338 @@
+#include "../../include/benchmarking/block_trace.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'V', 'B', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 64;
+
+// Records examined between two releases of consumed pages
+constexpr uint64_t kReleaseInterval = 1 << 16;
+
+// blkparse sectors are always 512 bytes, whatever the device's block size
+constexpr uint64_t kBlkparseSectorSize = 512;
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t record_count;
+    uint64_t start_ns;
+    uint32_t max_size;
+    uint8_t reserved[28];
+};
+static_assert(sizeof(TraceFileHeader) == kHeaderSize, "Unexpected trace header size");
+
+// Parses blkparse's "seconds.nanoseconds" time stamp
+bool ParseBlkparseTime(const std::string& text, uint64_t* ns) {
+    size_t dot = text.find('.');
+    if (dot == std::string::npos || dot == 0 || text.size() - dot - 1 != 9) {
+        return false;
+    }
+    uint64_t seconds = 0;
+    uint64_t fraction = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (i == dot) {
+            continue;
+        }
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) {
+            return false;
+        }
+        uint64_t& part = i < dot ? seconds : fraction;
+        part = part * 10 + static_cast<uint64_t>(text[i] - '0');
+    }
+    *ns = seconds * 1000000000ULL + fraction;
+    return true;
+}
+
+}  // namespace
+
+TracePartition ParseTracePartition(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "lba") {
+        return TracePartition::LBA;
+    } else if (lower == "cpu") {
+        return TracePartition::CPU;
+    }
+
+    throw std::invalid_argument("Unknown trace partition: " + name);
+}
+
+TraceWriter::TraceWriter()
+    : record_count_(0)
+    , start_ns_(std::numeric_limits<uint64_t>::max())
+    , max_size_(0) {
+}
+
+TraceWriter::~TraceWriter() {
+    if (file_.is_open()) {
+        Close();
+    }
+}
+
+bool TraceWriter::Open(const std::string& path) {
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        std::cerr << "Error: Failed to create trace file " << path << std::endl;
+        return false;
+    }
+
+    record_count_ = 0;
+    start_ns_ = std::numeric_limits<uint64_t>::max();
+    max_size_ = 0;
+
+    // Reserve the header; Close() fills it in
+    char header[kHeaderSize] = {};
+    file_.write(header, sizeof(header));
+    return static_cast<bool>(file_);
+}
+
+bool TraceWriter::Append(const TraceRecord& record) {
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    file_.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (!file_) {
+        std::cerr << "Error: Failed to write trace record" << std::endl;
+        return false;
+    }
+    ++record_count_;
+    start_ns_ = std::min(start_ns_, record.timestamp_ns);
+    max_size_ = std::max(max_size_, record.size);
+    return true;
+}
+
+bool TraceWriter::Close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+
+    TraceFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_size = sizeof(TraceRecord);
+    header.record_count = record_count_;
+    header.start_ns = record_count_ > 0 ? start_ns_ : 0;
+    header.max_size = max_size_;
+
+    file_.seekp(0);
+    file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    bool ok = static_cast<bool>(file_);
+    file_.close();
+    if (!ok) {
+        std::cerr << "Error: Failed to complete trace file" << std::endl;
+    }
+    return ok;
+}
+
+uint64_t TraceWriter::GetRecordCount() const {
+    return record_count_;
+}
+
+TraceReader::TraceReader()
+    : mapping_(nullptr)
+    , mapping_size_(0)
+    , records_(nullptr)
+    , record_count_(0)
+    , start_ns_(0)
+    , max_size_(0)
+    , released_(0) {
+}
+
+TraceReader::~TraceReader() {
+    Close();
+}
+
+bool TraceReader::Open(const std::string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open trace file " << path << ": "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+        std::cerr << "Error: " << path << " is not a trace file" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Failed to map trace file " << path << ": "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    TraceFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    uint64_t records_size = header.record_count * sizeof(TraceRecord);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.record_size != sizeof(TraceRecord) ||
+        header.record_count > (size - kHeaderSize) / sizeof(TraceRecord) ||
+        kHeaderSize + records_size > size) {
+        std::cerr << "Error: " << path << " is not a valid trace file" << std::endl;
+        munmap(mapping, size);
+        return false;
+    }
+
+    // Replay reads the records front to back
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    mapping_ = mapping;
+    mapping_size_ = size;
+    records_ = reinterpret_cast<const TraceRecord*>(static_cast<const char*>(mapping) + kHeaderSize);
+    record_count_ = header.record_count;
+    start_ns_ = header.start_ns;
+    max_size_ = header.max_size;
+    released_ = 0;
+    return true;
+}
+
+void TraceReader::Close() {
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    records_ = nullptr;
+    record_count_ = 0;
+    start_ns_ = 0;
+    max_size_ = 0;
+    released_ = 0;
+}
+
+uint64_t TraceReader::GetRecordCount() const {
+    return record_count_;
+}
+
+uint64_t TraceReader::GetStartNs() const {
+    return start_ns_;
+}
+
+uint32_t TraceReader::GetMaxSize() const {
+    return max_size_;
+}
+
+void TraceReader::ReleaseBefore(uint64_t index) {
+    if (mapping_ == nullptr) {
+        return;
+    }
+
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = kHeaderSize + std::min(index, record_count_) * sizeof(TraceRecord);
+    end = end / page_size * page_size;
+    if (end > released_) {
+        // The mapping is read-only, so dropped pages are simply read again on access
+        madvise(static_cast<char*>(mapping_) + released_, end - released_, MADV_DONTNEED);
+        released_ = end;
+    }
+}
+
+TraceCursor::TraceCursor(TraceReader& reader, TracePartition partition,
+                         uint32_t worker, uint32_t num_workers)
+    : reader_(reader)
+    , partition_(partition)
+    , worker_(worker)
+    , num_workers_(num_workers)
+    , position_(0)
+    , released_(0) {
+
+    if (num_workers_ == 0 || worker_ >= num_workers_) {
+        throw std::invalid_argument("Trace worker index must be less than the number of workers");
+    }
+}
+
+bool TraceCursor::HasNext() {
+    uint64_t count = reader_.GetRecordCount();
+    while (position_ < count && !IsOwned(reader_.GetRecord(position_))) {
+        ++position_;
+    }
+
+    if (position_ - released_ >= kReleaseInterval) {
+        reader_.ReleaseBefore(position_);
+        released_ = position_;
+    }
+    return position_ < count;
+}
+
+const TraceRecord& TraceCursor::Next() {
+    return reader_.GetRecord(position_++);
+}
+
+uint64_t TraceCursor::GetPosition() const {
+    return position_;
+}
+
+bool TraceCursor::IsOwned(const TraceRecord& record) const {
+    if (num_workers_ == 1) {
+        return true;
+    }
+    uint64_t key = partition_ == TracePartition::LBA ? record.offset / kStripeBytes : record.cpu;
+    return key % num_workers_ == worker_;
+}
+
+int64_t ImportBlkparseTrace(std::istream& input, TraceWriter& writer, char action) {
+    int64_t imported = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        // dev cpu sequence time pid action rwbs sector + count [process]
+        std::istringstream fields(line);
+        std::string device, time, event, rwbs, plus;
+        uint64_t cpu = 0, sequence = 0, pid = 0, sector = 0, count = 0;
+        if (!(fields >> device >> cpu >> sequence >> time >> pid >> event >> rwbs >> sector >> plus >> count) ||
+            device.find(',') == std::string::npos || plus != "+" ||
+            event.size() != 1 || event[0] != action || count == 0) {
+            continue;
+        }
+
+        // Discards and flushes carry D and F; everything else is a read or a write
+        bool is_read = rwbs.find('R') != std::string::npos;
+        bool is_write = rwbs.find('W') != std::string::npos;
+        if (is_read == is_write || rwbs.find('D') != std::string::npos) {
+            continue;
+        }
+
+        TraceRecord record{};
+        if (!ParseBlkparseTime(time, &record.timestamp_ns)) {
+            continue;
+        }
+        record.offset = sector * kBlkparseSectorSize;
+        record.size = static_cast<uint32_t>(std::min<uint64_t>(
+            count * kBlkparseSectorSize, std::numeric_limits<uint32_t>::max()));
+        record.cpu = static_cast<uint16_t>(cpu);
+        record.is_write = is_write ? 1 : 0;
+        if (!writer.Append(record)) {
+            return -1;
+        }
+        ++imported;
+    }
+    return imported;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,167 @@
+#include "../../include/benchmarking/block_verifier.h"
+#include "../../include/utils/crc32c.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// Header layout; the checksum covers everything from the LBA to the end of the block
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t crc;
+    uint64_t lba;
+    uint64_t generation;
+    uint64_t seed;
+};
+static_assert(sizeof(BlockHeader) == BlockVerifier::kHeaderSize, "Unexpected verify header size");
+
+constexpr size_t kCrcStart = offsetof(BlockHeader, lba);
+
+// Blocks whose checksums are computed together, a multiple of the three CRC streams
+constexpr uint32_t kCrcBatch = 24;
+
+bool IsZero(const uint8_t* block, size_t size) {
+    return block[0] == 0 && std::memcmp(block, block + 1, size - 1) == 0;
+}
+
+}  // namespace
+
+std::string GetVerifyErrorTypeName(VerifyErrorType type) {
+    switch (type) {
+        case VerifyErrorType::BAD_MAGIC:
+            return "bad_magic";
+        case VerifyErrorType::LBA_MISMATCH:
+            return "lba_mismatch";
+        case VerifyErrorType::SEED_MISMATCH:
+            return "seed_mismatch";
+        case VerifyErrorType::CRC_MISMATCH:
+            return "crc_mismatch";
+    }
+    return "unknown";
+}
+
+void VerifyStats::RecordError(const VerifyError& error) {
+    ++errors;
+    if (failures.size() < kMaxReportedErrors) {
+        failures.push_back(error);
+    }
+}
+
+void VerifyStats::Merge(const VerifyStats& other) {
+    blocks_verified += other.blocks_verified;
+    blocks_unwritten += other.blocks_unwritten;
+    errors += other.errors;
+    size_t room = kMaxReportedErrors - std::min(kMaxReportedErrors, failures.size());
+    size_t count = std::min(room, other.failures.size());
+    failures.insert(failures.end(), other.failures.begin(), other.failures.begin() + count);
+}
+
+BlockVerifier::BlockVerifier(uint32_t block_size, uint64_t seed)
+    : block_size_(block_size)
+    , seed_(seed)
+    , generation_(0) {
+
+    if (block_size_ < 2 * kHeaderSize) {
+        throw std::invalid_argument("Verify block size must be at least " +
+                                    std::to_string(2 * kHeaderSize) + " bytes");
+    }
+}
+
+uint64_t BlockVerifier::Stamp(void* buffer, uint64_t offset, uint32_t size) {
+    uint64_t generation = NextGeneration();
+    Stamp(buffer, offset, size, generation);
+    return generation;
+}
+
+void BlockVerifier::Stamp(void* buffer, uint64_t offset, uint32_t size, uint64_t generation) const {
+    auto* block = static_cast<uint8_t*>(buffer);
+    uint64_t lba = offset / block_size_;
+    uint32_t remaining = size / block_size_;
+    uint32_t crcs[kCrcBatch];
+    while (remaining > 0) {
+        uint32_t count = std::min(remaining, kCrcBatch);
+        for (uint32_t i = 0; i < count; ++i) {
+            BlockHeader header{kMagic, 0, lba + i, generation, seed_};
+            std::memcpy(block + i * block_size_, &header, sizeof(header));
+        }
+        utils::Crc32c::ComputeStrided(block + kCrcStart, block_size_ - kCrcStart, block_size_, count, crcs);
+        for (uint32_t i = 0; i < count; ++i) {
+            std::memcpy(block + i * block_size_ + offsetof(BlockHeader, crc), &crcs[i], sizeof(crcs[i]));
+        }
+        block += count * block_size_;
+        lba += count;
+        remaining -= count;
+    }
+}
+
+uint64_t BlockVerifier::NextGeneration() {
+    return ++generation_;
+}
+
+uint32_t BlockVerifier::Verify(const void* buffer, uint64_t offset, uint32_t size,
+                               VerifyStats& stats) const {
+    const auto* block = static_cast<const uint8_t*>(buffer);
+    uint64_t lba = offset / block_size_;
+    uint32_t failed = 0;
+    uint32_t remaining = size / block_size_;
+    uint32_t crcs[kCrcBatch];
+    uint32_t batch_index = kCrcBatch;
+    for (; remaining > 0; --remaining, block += block_size_, ++lba, ++batch_index) {
+        // Checksums are computed a batch ahead; blocks without a header waste theirs
+        if (batch_index == kCrcBatch) {
+            utils::Crc32c::ComputeStrided(block + kCrcStart, block_size_ - kCrcStart, block_size_,
+                                          std::min(remaining, kCrcBatch), crcs);
+            batch_index = 0;
+        }
+
+        BlockHeader header;
+        std::memcpy(&header, block, sizeof(header));
+
+        VerifyError error;
+        error.lba = lba;
+        error.header_lba = header.lba;
+        error.generation = header.generation;
+        error.seed = header.seed;
+        error.expected_crc = header.crc;
+
+        if (header.magic != kMagic) {
+            if (IsZero(block, block_size_)) {
+                ++stats.blocks_unwritten;
+                continue;
+            }
+            error.type = VerifyErrorType::BAD_MAGIC;
+        } else {
+            error.actual_crc = crcs[batch_index];
+            if (error.actual_crc != header.crc) {
+                error.type = VerifyErrorType::CRC_MISMATCH;
+            } else if (header.lba != lba) {
+                error.type = VerifyErrorType::LBA_MISMATCH;
+            } else if (header.seed != seed_) {
+                error.type = VerifyErrorType::SEED_MISMATCH;
+            } else {
+                ++stats.blocks_verified;
+                continue;
+            }
+        }
+
+        stats.RecordError(error);
+        ++failed;
+    }
+    return failed;
+}
+
+uint32_t BlockVerifier::GetBlockSize() const {
+    return block_size_;
+}
+
+uint64_t BlockVerifier::GetSeed() const {
+    return seed_;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,224 @@
+#include "../../include/benchmarking/capsule_protocol.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace nvmeof {
+namespace benchmarking {
+namespace capsule {
+
+namespace {
+
+const char kUnixPrefix[] = "unix:";
+
+bool IsUnixAddress(const std::string& address) {
+    return address.compare(0, sizeof(kUnixPrefix) - 1, kUnixPrefix) == 0;
+}
+
+bool MakeUnixAddress(const std::string& address, struct sockaddr_un* addr) {
+    std::string path = address.substr(sizeof(kUnixPrefix) - 1);
+    if (path.empty() || path.size() >= sizeof(addr->sun_path)) {
+        std::cerr << "Error: Invalid Unix socket path: " << address << std::endl;
+        return false;
+    }
+    std::memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    std::memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Resolve "host:port"; an empty host is the loopback address
+struct addrinfo* ResolveTcpAddress(const std::string& address, bool passive) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "Error: Address must be host:port or unix:/path: " << address << std::endl;
+        return nullptr;
+    }
+    std::string host = address.substr(0, colon);
+    std::string port = address.substr(colon + 1);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    struct addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    struct addrinfo* result = nullptr;
+    int rc = getaddrinfo(host.empty() ? "127.0.0.1" : host.c_str(), port.c_str(), &hints, &result);
+    if (rc != 0) {
+        std::cerr << "Error: Failed to resolve " << address << ": " << gai_strerror(rc) << std::endl;
+        return nullptr;
+    }
+    return result;
+}
+
+}  // namespace
+
+size_t GetPduHeaderLength(uint8_t type) {
+    switch (static_cast<PduType>(type)) {
+        case PduType::IC_REQ:
+            return sizeof(IcReqPdu);
+        case PduType::IC_RESP:
+            return sizeof(IcRespPdu);
+        case PduType::CAPSULE_CMD:
+            return sizeof(CapsuleCmdPdu);
+        case PduType::CAPSULE_RESP:
+            return sizeof(CapsuleRespPdu);
+        case PduType::H2C_DATA:
+        case PduType::C2H_DATA:
+            return sizeof(DataPdu);
+    }
+    return 0;
+}
+
+int ListenOnAddress(const std::string& address, std::string* bound_address) {
+    if (IsUnixAddress(address)) {
+        struct sockaddr_un addr;
+        if (!MakeUnixAddress(address, &addr)) {
+            return -1;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            std::cerr << "Error: Failed to create socket: " << std::strerror(errno) << std::endl;
+            return -1;
+        }
+
+        // A stale socket file from an earlier run would make bind() fail
+        unlink(addr.sun_path);
+        if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(fd, SOMAXCONN) != 0) {
+            std::cerr << "Error: Failed to listen on " << address << ": "
+                     << std::strerror(errno) << std::endl;
+            close(fd);
+            return -1;
+        }
+        *bound_address = address;
+        return fd;
+    }
+
+    struct addrinfo* result = ResolveTcpAddress(address, true);
+    if (result == nullptr) {
+        return -1;
+    }
+
+    int fd = socket(result->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int one = 1;
+    if (fd < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        bind(fd, result->ai_addr, result->ai_addrlen) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        std::cerr << "Error: Failed to listen on " << address << ": "
+                 << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        freeaddrinfo(result);
+        return -1;
+    }
+    freeaddrinfo(result);
+
+    // Report the port the kernel picked
+    struct sockaddr_storage local;
+    socklen_t local_len = sizeof(local);
+    char host[INET6_ADDRSTRLEN] = {0};
+    char port[16] = {0};
+    if (getsockname(fd, reinterpret_cast<struct sockaddr*>(&local), &local_len) != 0 ||
+        getnameinfo(reinterpret_cast<struct sockaddr*>(&local), local_len, host, sizeof(host),
+                    port, sizeof(port), NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+        std::cerr << "Error: Failed to get the address of " << address << std::endl;
+        close(fd);
+        return -1;
+    }
+    bool ipv6 = local.ss_family == AF_INET6;
+    *bound_address = (ipv6 ? "[" : "") + std::string(host) + (ipv6 ? "]:" : ":") + port;
+    return fd;
+}
+
+int ConnectToAddress(const std::string& address) {
+    if (IsUnixAddress(address)) {
+        struct sockaddr_un addr;
+        if (!MakeUnixAddress(address, &addr)) {
+            return -1;
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0) {
+            std::cerr << "Error: Failed to connect to " << address << ": "
+                     << std::strerror(errno) << std::endl;
+            if (fd >= 0) {
+                close(fd);
+            }
+            return -1;
+        }
+        return fd;
+    }
+
+    struct addrinfo* result = ResolveTcpAddress(address, false);
+    if (result == nullptr) {
+        return -1;
+    }
+
+    int fd = socket(result->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+        std::cerr << "Error: Failed to connect to " << address << ": "
+                 << std::strerror(errno) << std::endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        freeaddrinfo(result);
+        return -1;
+    }
+    freeaddrinfo(result);
+
+    // Capsules are small; do not hold them back waiting for more data
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+bool SendAll(int fd, const void* data, size_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        ssize_t sent = send(fd, bytes, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool ReceiveAll(int fd, void* data, size_t length) {
+    auto* bytes = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        ssize_t received = recv(fd, bytes, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        length -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+}  // namespace capsule
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -1,15 +1,187 @@
 #include "../../include/benchmarking/data_collector.h"
+#include "../../include/benchmarking/result_file.h"
 #include <iostream>
-#include <fstream>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <cctype>
 #include <stdexcept>
-#include <cassert>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
 
 namespace nvmeof {
 namespace benchmarking {
 
+namespace {
+
+// How long the writer sleeps between drains unless a flush wakes it
+constexpr std::chrono::milliseconds kDrainInterval(10);
+
+// Formatted output is written once this much has accumulated
+constexpr size_t kWriteChunkBytes = 256 * 1024;
+
+// Longest a partial binary block or compressed frame waits before it is written
+constexpr std::chrono::seconds kBlockInterval(1);
+
+// Source of collector ids; ids are never reused, unlike addresses
+std::atomic<uint64_t> next_collector_id{1};
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+/**
+ * @brief Single-producer, single-consumer ring of records owned by one thread at a time.
+ */
+class DataPointRing {
+public:
+    explicit DataPointRing(size_t capacity)
+        : records_(capacity)
+        , mask_(capacity - 1)
+        , head_(0)
+        , cached_tail_(0)
+        , collected_(0)
+        , dropped_(0)
+        , in_use_(true)
+        , orphaned_(false)
+        , tail_(0) {
+    }
+
+    // Producer side; metrics this ring has seen resolve without locking or allocating
+    MetricHandle LookupMetric(const std::string& label, const std::string& units,
+                              MetricRegistry& registry) {
+        auto& candidates = metric_cache_[label];
+        for (const auto& candidate : candidates) {
+            if (candidate.first == units) {
+                return candidate.second;
+            }
+        }
+        MetricHandle handle = registry.Register(label, units);
+        candidates.emplace_back(units, handle);
+        return handle;
+    }
+
+    // Producer side; wake_writer is set when the ring has just become half full
+    bool Push(MetricHandle metric, double value, bool& wake_writer) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) {
+                // Only this thread writes the counters, so no read-modify-write is needed
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        DataRecord& record = records_[head & mask_];
+        record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.value = value;
+        record.metric = metric;
+
+        head_.store(head + 1, std::memory_order_release);
+        collected_.store(collected_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        wake_writer = head + 1 - cached_tail_ == (mask_ + 1) / 2;
+        return true;
+    }
+
+    // Consumer side
+    void Drain(std::vector<DataRecord>& out) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            out.push_back(records_[tail & mask_]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    uint64_t GetCollected() const { return collected_.load(std::memory_order_relaxed); }
+    uint64_t GetDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Ownership: a thread acquires a ring under the collector's ring mutex and
+    // releases it when the thread exits; the collector orphans its rings when destroyed
+    bool TryAcquire() {
+        bool expected = false;
+        return in_use_.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+    void Release() { in_use_.store(false, std::memory_order_release); }
+    void Orphan() { orphaned_.store(true, std::memory_order_relaxed); }
+    bool IsOrphaned() const { return orphaned_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<DataRecord> records_;            ///< Ring storage
+    const uint64_t mask_;                        ///< Capacity - 1
+    alignas(64) std::atomic<uint64_t> head_;     ///< Next slot to fill, written by the producer
+    uint64_t cached_tail_;                       ///< Producer's last view of tail_
+    std::atomic<uint64_t> collected_;            ///< Records pushed
+    std::atomic<uint64_t> dropped_;              ///< Records dropped because the ring was full
+    std::atomic<bool> in_use_;                   ///< Owned by a live thread
+    std::atomic<bool> orphaned_;                 ///< The collector has been destroyed
+    std::unordered_map<std::string, std::vector<std::pair<std::string, MetricHandle>>>
+        metric_cache_;                           ///< Label to units and handle, used by the producer
+    alignas(64) std::atomic<uint64_t> tail_;     ///< Next slot to drain, written by the writer
+};
+
+namespace {
+
+// The rings the current thread has registered, released when the thread exits
+struct ThreadRings {
+    std::vector<std::pair<uint64_t, std::shared_ptr<DataPointRing>>> rings;
+
+    ~ThreadRings() {
+        for (auto& entry : rings) {
+            entry.second->Release();
+        }
+    }
+};
+
+thread_local ThreadRings thread_rings;
+
+}  // namespace
+
+OutputFormat ParseOutputFormat(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "csv") {
+        return OutputFormat::CSV;
+    } else if (lower == "json") {
+        return OutputFormat::JSON;
+    } else if (lower == "text" || lower == "plaintext") {
+        return OutputFormat::PLAINTEXT;
+    } else if (lower == "binary") {
+        return OutputFormat::BINARY;
+    }
+
+    throw std::invalid_argument("Unknown output format: " + name);
+}
+
+const char* GetOutputFormatExtension(OutputFormat format) {
+    switch (format) {
+        case OutputFormat::JSON:
+            return ".json";
+        case OutputFormat::PLAINTEXT:
+            return ".txt";
+        case OutputFormat::BINARY:
+            return ".nvbr";
+        case OutputFormat::CSV:
+        default:
+            return ".csv";
+    }
+}
+
 DataPoint::DataPoint(const std::string& label, double value, const std::string& units)
     : timestamp(std::chrono::system_clock::now())
     , label(label)
@@ -17,197 +189,527 @@ DataPoint::DataPoint(const std::string& label, double value, const std::string&
     , units(units) {
 }
 
-DataCollector::DataCollector(const std::string& output_file, OutputFormat format)
+DataCollector::DataCollector(const std::string& output_file, OutputFormat format, size_t ring_capacity,
+                             CompressionMode compression)
     : output_file_(output_file)
     , format_(format)
-    , header_written_(false) {
-    
+    , ring_capacity_(RoundUpToPowerOfTwo(ring_capacity))
+    , id_(next_collector_id.fetch_add(1))
+    , fd_(-1)
+    , unregistered_drops_(0)
+    , stop_(false)
+    , flush_requested_(0)
+    , flush_completed_(0)
+    , write_failed_(false)
+    , written_(0)
+    , cached_second_(-1)
+    , cached_timestamp_() {
+
+    if (ring_capacity == 0) {
+        throw std::invalid_argument("Ring capacity must be greater than zero");
+    }
+    if (compression != CompressionMode::NONE && format_ == OutputFormat::BINARY) {
+        throw std::invalid_argument("Binary result files cannot be compressed");
+    }
+
     // Open the file for writing
-    file_stream_.open(output_file_, std::ios::out | std::ios::trunc);
-    if (!file_stream_.is_open()) {
+    fd_ = open(output_file_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
         throw std::runtime_error("Failed to open output file: " + output_file_);
     }
-    
+
+    if (format_ == OutputFormat::BINARY) {
+        encoder_ = std::make_unique<ResultFileEncoder>(registry_);
+    }
+    if (compression == CompressionMode::LZ) {
+        compressor_ = std::make_unique<CompressedStreamEncoder>();
+        CompressedStreamEncoder::WriteHeader(compressed_);
+        WriteAll(compressed_);
+    }
+
     // Write header based on format
     WriteHeader();
+    WriteBuffer();
+
+    writer_thread_ = std::thread(&DataCollector::WriterLoop, this);
 }
 
 DataCollector::~DataCollector() {
-    try {
-        // Write footer and close file
-        if (file_stream_.is_open()) {
-            WriteFooter();
-            file_stream_.close();
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        stop_ = true;
+    }
+    writer_cv_.notify_one();
+    writer_thread_.join();
+
+    // The writer has drained everything; write footer and close file
+    WriteFooter();
+    WriteBuffer();
+    close(fd_);
+
+    size_t dropped = GetDroppedCount();
+    if (dropped > 0) {
+        std::cerr << "Warning: Dropped " << dropped << " data points for " << output_file_
+                  << " (collection rings full)" << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    for (auto& ring : rings_) {
+        ring->Orphan();
+    }
+}
+
+DataPointRing* DataCollector::GetThreadRing() {
+    auto& entries = thread_rings.rings;
+    if (!entries.empty() && entries.back().first == id_) {
+        return entries.back().second.get();
+    }
+    for (auto& entry : entries) {
+        if (entry.first == id_) {
+            return entry.second.get();
+        }
+    }
+
+    // First point from this thread: forget rings of destroyed collectors
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const auto& entry) { return entry.second->IsOrphaned(); }),
+                  entries.end());
+
+    std::shared_ptr<DataPointRing> ring;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (auto& candidate : rings_) {
+            if (candidate->TryAcquire()) {
+                ring = candidate;
+                break;
+            }
+        }
+        if (!ring) {
+            if (rings_.size() >= kMaxRings) {
+                return nullptr;
+            }
+            ring = std::make_shared<DataPointRing>(ring_capacity_);
+            rings_.push_back(ring);
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Error in DataCollector destructor: " << e.what() << std::endl;
     }
+
+    entries.emplace_back(id_, ring);
+    return ring.get();
 }
 
-bool DataCollector::CollectDataPoint(const std::string& label, double value, const std::string& units) {
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        // Create data point
-        DataPoint data_point(label, value, units);
-        
-        // Add to collection
-        data_points_.push_back(data_point);
-        
-        // Write to file
-        return WriteDataPoint(data_point);
-    } catch (const std::exception& e) {
-        std::cerr << "Error collecting data point: " << e.what() << std::endl;
+MetricHandle DataCollector::RegisterMetric(const std::string& label, const std::string& units) {
+    return registry_.Register(label, units);
+}
+
+bool DataCollector::CollectDataPoint(MetricHandle metric, double value) {
+    if (metric >= registry_.GetCount()) {
+        return false;
+    }
+    DataPointRing* ring = GetThreadRing();
+    if (ring == nullptr) {
+        unregistered_drops_.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
+
+    // Bursts wake the writer instead of waiting for its next drain
+    bool wake_writer = false;
+    bool queued = ring->Push(metric, value, wake_writer);
+    if (wake_writer) {
+        writer_cv_.notify_one();
+    }
+    return queued;
 }
 
-bool DataCollector::CollectData(const std::string& data_point) {
-    // Legacy method - parse the string and delegate to the new method
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        // Create a simple data point with the raw string
-        DataPoint point("raw_data", 0.0, "");
-        point.label = data_point;
-        
-        // Add to collection
-        data_points_.push_back(point);
-        
-        // Write to file
-        return WriteDataPoint(point);
-    } catch (const std::exception& e) {
-        std::cerr << "Error collecting data: " << e.what() << std::endl;
+bool DataCollector::CollectDataPoint(const std::string& label, double value, const std::string& units) {
+    DataPointRing* ring = GetThreadRing();
+    if (ring == nullptr) {
+        unregistered_drops_.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
+
+    bool wake_writer = false;
+    bool queued = ring->Push(ring->LookupMetric(label, units, registry_), value, wake_writer);
+    if (wake_writer) {
+        writer_cv_.notify_one();
+    }
+    return queued;
+}
+
+bool DataCollector::CollectLatencyPercentiles(const std::string& label,
+                                              const LatencyHistogram& histogram) {
+    LatencySummary summary = histogram.GetSummary();
+    const std::pair<const char*, uint64_t> percentiles[] = {
+        {"p50", summary.p50},
+        {"p90", summary.p90},
+        {"p99", summary.p99},
+        {"p99.9", summary.p999},
+        {"p99.99", summary.p9999},
+        {"max", summary.max},
+    };
+
+    bool success = true;
+    for (const auto& percentile : percentiles) {
+        success &= CollectDataPoint(label + " " + percentile.first,
+                                    static_cast<double>(percentile.second) / 1e3, "µs");
+    }
+    return success;
+}
+
+bool DataCollector::CollectData(const std::string& data_point) {
+    // Legacy method - the raw string becomes the label
+    return CollectDataPoint(data_point, 0.0, "");
 }
 
 bool DataCollector::Flush() {
-    try {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        // Flush the file stream
-        file_stream_.flush();
-        
-        return !file_stream_.fail();
-    } catch (const std::exception& e) {
-        std::cerr << "Error flushing data: " << e.what() << std::endl;
-        return false;
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    uint64_t ticket = ++flush_requested_;
+    writer_cv_.notify_one();
+    while (flush_completed_ < ticket) {
+        flushed_cv_.wait_for(lock, kDrainInterval);
     }
+    return !write_failed_.load();
 }
 
 size_t DataCollector::GetDataPointCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return data_points_.size();
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    size_t count = 0;
+    for (const auto& ring : rings_) {
+        count += ring->GetCollected();
+    }
+    return count;
 }
 
-bool DataCollector::WriteHeader() {
-    if (header_written_) {
-        return true;
+size_t DataCollector::GetDroppedCount() const {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    size_t count = unregistered_drops_.load(std::memory_order_relaxed);
+    for (const auto& ring : rings_) {
+        count += ring->GetDropped();
     }
-    
-    try {
-        switch (format_) {
-            case OutputFormat::CSV:
-                file_stream_ << "Timestamp,Label,Value,Units\n";
-                break;
-                
-            case OutputFormat::JSON:
-                file_stream_ << "{\n  \"data_points\": [\n";
-                break;
-                
-            case OutputFormat::PLAINTEXT:
-                file_stream_ << "=== NVMe-oF Benchmark Data ===\n\n";
-                file_stream_ << std::left << std::setw(25) << "Timestamp" 
-                           << std::setw(30) << "Label" 
-                           << std::setw(15) << "Value" 
-                           << "Units\n";
-                file_stream_ << std::string(80, '-') << "\n";
-                break;
+    return count;
+}
+
+void DataCollector::SetRetentionPolicy(const RetentionPolicy& policy) {
+    if (policy.mode == RetentionMode::LAST_N && policy.max_points == 0) {
+        throw std::invalid_argument("LAST_N retention must keep at least one data point");
+    }
+    if (policy.mode == RetentionMode::TIME_WINDOW && policy.window.count() <= 0) {
+        throw std::invalid_argument("TIME_WINDOW retention needs a positive window");
+    }
+
+    std::lock_guard<std::mutex> lock(retained_mutex_);
+    retention_ = policy;
+    TrimRetained();
+}
+
+RetentionPolicy DataCollector::GetRetentionPolicy() const {
+    std::lock_guard<std::mutex> lock(retained_mutex_);
+    return retention_;
+}
+
+std::vector<DataPoint> DataCollector::GetRecentDataPoints() const {
+    return CopyRetained(true, 0);
+}
+
+std::vector<DataPoint> DataCollector::GetRecentDataPoints(MetricHandle metric) const {
+    return CopyRetained(false, metric);
+}
+
+const MetricRegistry& DataCollector::GetMetricRegistry() const {
+    return registry_;
+}
+
+void DataCollector::WriterLoop() {
+    auto block_start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    while (true) {
+        writer_cv_.wait_for(lock, kDrainInterval,
+                            [this]() { return stop_ || flush_requested_ != flush_completed_; });
+        bool stopping = stop_;
+        uint64_t flush_target = flush_requested_;
+        lock.unlock();
+
+        DrainRings();
+
+        // Binary blocks and compressed frames are completed on request and at least once a second
+        auto now = std::chrono::steady_clock::now();
+        bool complete = stopping || flush_target != flush_completed_ || now - block_start >= kBlockInterval;
+        if (encoder_) {
+            if (encoder_->GetPendingCount() == 0) {
+                block_start = now;
+            } else if (complete) {
+                encoder_->FlushBlock(buffer_);
+                block_start = now;
+            }
+            WriteBuffer();
+        } else if (!compressor_) {
+            WriteBuffer();
+        } else if (buffer_.empty()) {
+            block_start = now;
+        } else if (complete) {
+            WriteBuffer();
+            block_start = now;
+        }
+
+        lock.lock();
+        if (flush_completed_ != flush_target) {
+            flush_completed_ = flush_target;
+            flushed_cv_.notify_all();
+        }
+        if (stopping) {
+            break;
         }
-        
-        header_written_ = true;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error writing header: " << e.what() << std::endl;
-        return false;
     }
 }
 
-bool DataCollector::WriteDataPoint(const DataPoint& data_point) {
-    if (!header_written_) {
-        if (!WriteHeader()) {
-            return false;
+void DataCollector::DrainRings() {
+    std::vector<std::shared_ptr<DataPointRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    batch_.clear();
+    for (auto& ring : rings) {
+        ring->Drain(batch_);
+    }
+
+    // Each ring is in order; merge them by collection time
+    std::stable_sort(batch_.begin(), batch_.end(), [](const DataRecord& a, const DataRecord& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    for (const DataRecord& record : batch_) {
+        WriteRecord(record);
+        if (buffer_.size() >= kWriteChunkBytes) {
+            WriteBuffer();
         }
     }
-    
-    try {
-        // Format timestamp
-        auto time_t = std::chrono::system_clock::to_time_t(data_point.timestamp);
-        std::stringstream timestamp_ss;
-        timestamp_ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        
-        switch (format_) {
-            case OutputFormat::CSV:
-                file_stream_ << timestamp_ss.str() << ","
-                           << data_point.label << ","
-                           << data_point.value << ","
-                           << data_point.units << "\n";
-                break;
-                
-            case OutputFormat::JSON: {
-                // Check if this isn't the first data point (need a comma)
-                if (data_points_.size() > 1) {
-                    file_stream_ << ",\n";
-                }
-                
-                file_stream_ << "    {\n"
-                           << "      \"timestamp\": \"" << timestamp_ss.str() << "\",\n"
-                           << "      \"label\": \"" << data_point.label << "\",\n"
-                           << "      \"value\": " << data_point.value << ",\n"
-                           << "      \"units\": \"" << data_point.units << "\"\n"
-                           << "    }";
-                break;
+
+    RetainBatch();
+}
+
+void DataCollector::RetainBatch() {
+    std::lock_guard<std::mutex> lock(retained_mutex_);
+    if (retention_.mode == RetentionMode::NONE || batch_.empty()) {
+        return;
+    }
+
+    // Only the tail of a batch larger than the point limit can survive the trim
+    size_t first = 0;
+    if (retention_.max_points > 0 && batch_.size() > retention_.max_points) {
+        first = batch_.size() - retention_.max_points;
+    }
+    retained_.insert(retained_.end(), batch_.begin() + static_cast<std::ptrdiff_t>(first), batch_.end());
+    TrimRetained();
+}
+
+void DataCollector::TrimRetained() {
+    if (retention_.mode == RetentionMode::NONE) {
+        retained_.clear();
+        retained_.shrink_to_fit();
+        return;
+    }
+
+    if (retention_.mode == RetentionMode::TIME_WINDOW) {
+        int64_t cutoff_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (std::chrono::system_clock::now() - retention_.window).time_since_epoch()).count();
+        while (!retained_.empty() && retained_.front().timestamp_ns < cutoff_ns) {
+            retained_.pop_front();
+        }
+    }
+    if (retention_.max_points > 0) {
+        while (retained_.size() > retention_.max_points) {
+            retained_.pop_front();
+        }
+    }
+}
+
+std::vector<DataPoint> DataCollector::CopyRetained(bool all_metrics, MetricHandle metric) const {
+    std::lock_guard<std::mutex> lock(retained_mutex_);
+
+    // The writer trims on each drain; points that aged out since then are skipped here
+    int64_t cutoff_ns = std::numeric_limits<int64_t>::min();
+    if (retention_.mode == RetentionMode::TIME_WINDOW) {
+        cutoff_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (std::chrono::system_clock::now() - retention_.window).time_since_epoch()).count();
+    }
+
+    std::vector<DataPoint> points;
+    for (const DataRecord& record : retained_) {
+        if (record.timestamp_ns < cutoff_ns || (!all_metrics && record.metric != metric)) {
+            continue;
+        }
+        const Metric& resolved = registry_.Get(record.metric);
+        DataPoint point(resolved.label, record.value, resolved.units);
+        point.timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(record.timestamp_ns)));
+        points.push_back(std::move(point));
+    }
+    return points;
+}
+
+void DataCollector::WriteHeader() {
+    switch (format_) {
+        case OutputFormat::CSV:
+            buffer_ += "Timestamp,Label,Value,Units\n";
+            break;
+
+        case OutputFormat::JSON:
+            buffer_ += "{\n  \"data_points\": [\n";
+            break;
+
+        case OutputFormat::BINARY:
+            encoder_->WriteHeader(buffer_);
+            break;
+
+        case OutputFormat::PLAINTEXT: {
+            char line[128];
+            std::snprintf(line, sizeof(line), "%-25s%-30s%-15s%s\n", "Timestamp", "Label", "Value", "Units");
+            buffer_ += "=== NVMe-oF Benchmark Data ===\n\n";
+            buffer_ += line;
+            buffer_ += std::string(80, '-') + "\n";
+            break;
+        }
+    }
+}
+
+const Metric& DataCollector::ResolveMetric(MetricHandle handle) {
+    if (handle >= metrics_.size()) {
+        metrics_.resize(handle + 1, nullptr);
+    }
+    if (metrics_[handle] == nullptr) {
+        metrics_[handle] = &registry_.Get(handle);
+    }
+    return *metrics_[handle];
+}
+
+void DataCollector::WriteRecord(const DataRecord& record) {
+    if (encoder_) {
+        encoder_->Append(record, buffer_);
+        ++written_;
+        return;
+    }
+
+    // Local time is formatted once per second rather than once per point
+    int64_t second = record.timestamp_ns / 1000000000;
+    if (second != cached_second_) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm local_time;
+        localtime_r(&time, &local_time);
+        std::strftime(cached_timestamp_, sizeof(cached_timestamp_), "%Y-%m-%d %H:%M:%S", &local_time);
+        cached_second_ = second;
+    }
+
+    const Metric& metric = ResolveMetric(record.metric);
+    const std::string& label = metric.label;
+    const std::string& units = metric.units;
+    char value[32];
+    std::snprintf(value, sizeof(value), "%g", record.value);
+
+    switch (format_) {
+        case OutputFormat::CSV:
+            buffer_ += cached_timestamp_;
+            buffer_ += ',';
+            buffer_ += label;
+            buffer_ += ',';
+            buffer_ += value;
+            buffer_ += ',';
+            buffer_ += units;
+            buffer_ += '\n';
+            break;
+
+        case OutputFormat::JSON:
+            // Every point after the first is preceded by a comma
+            if (written_ > 0) {
+                buffer_ += ",\n";
             }
-                
-            case OutputFormat::PLAINTEXT:
-                file_stream_ << std::left << std::setw(25) << timestamp_ss.str()
-                           << std::setw(30) << data_point.label
-                           << std::setw(15) << data_point.value
-                           << data_point.units << "\n";
-                break;
+            buffer_ += "    {\n      \"timestamp\": \"";
+            buffer_ += cached_timestamp_;
+            buffer_ += "\",\n      \"label\": \"";
+            buffer_ += label;
+            buffer_ += "\",\n      \"value\": ";
+            buffer_ += value;
+            buffer_ += ",\n      \"units\": \"";
+            buffer_ += units;
+            buffer_ += "\"\n    }";
+            break;
+
+        case OutputFormat::PLAINTEXT: {
+            char line[256];
+            std::snprintf(line, sizeof(line), "%-25s%-30s%-15s", cached_timestamp_, label.c_str(), value);
+            buffer_ += line;
+            buffer_ += units;
+            buffer_ += '\n';
+            break;
         }
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error writing data point: " << e.what() << std::endl;
-        return false;
+
+        case OutputFormat::BINARY:
+            // Encoded above
+            break;
     }
+    ++written_;
 }
 
-bool DataCollector::WriteFooter() {
-    try {
-        switch (format_) {
-            case OutputFormat::CSV:
-                // CSV doesn't need a footer
-                break;
-                
-            case OutputFormat::JSON:
-                file_stream_ << "\n  ]\n}\n";
-                break;
-                
-            case OutputFormat::PLAINTEXT:
-                file_stream_ << std::string(80, '-') << "\n";
-                file_stream_ << "Total data points: " << data_points_.size() << "\n";
-                break;
+void DataCollector::WriteFooter() {
+    switch (format_) {
+        case OutputFormat::CSV:
+            // CSV doesn't need a footer
+            break;
+
+        case OutputFormat::JSON:
+            buffer_ += "\n  ]\n}\n";
+            break;
+
+        case OutputFormat::BINARY:
+            encoder_->Finish(buffer_);
+            break;
+
+        case OutputFormat::PLAINTEXT: {
+            buffer_ += std::string(80, '-') + "\n";
+            buffer_ += "Total data points: " + std::to_string(written_) + "\n";
+            size_t dropped = GetDroppedCount();
+            if (dropped > 0) {
+                buffer_ += "Dropped data points: " + std::to_string(dropped) + "\n";
+            }
+            break;
         }
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Error writing footer: " << e.what() << std::endl;
-        return false;
     }
 }
 
+bool DataCollector::WriteBuffer() {
+    bool success;
+    if (compressor_) {
+        compressed_.clear();
+        if (!buffer_.empty()) {
+            compressor_->EncodeFrame(buffer_.data(), buffer_.size(), compressed_);
+        }
+        success = WriteAll(compressed_);
+    } else {
+        success = WriteAll(buffer_);
+    }
+    buffer_.clear();
+    return success;
+}
+
+bool DataCollector::WriteAll(const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t written = write(fd_, data.data() + offset, data.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (!write_failed_.exchange(true)) {
+                std::cerr << "Error: Failed to write " << output_file_ << ": "
+                         << std::strerror(errno) << std::endl;
+            }
+            break;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return offset == data.size();
+}
+
 }  // namespace benchmarking
-}  // namespace nvmeof
\ No newline at end of file
+}  // namespace nvmeof
@@ -0,0 +1,129 @@
+#include "../../include/benchmarking/dma_buffer_pool.h"
+#include <stdexcept>
+#include <cassert>
+#include "../../third_party/spdk_mock/include/nvme.h"
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+uint64_t PackHead(uint32_t tag, uint32_t index) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+}
+
+uint32_t HeadIndex(uint64_t head) {
+    return static_cast<uint32_t>(head);
+}
+
+uint32_t HeadTag(uint64_t head) {
+    return static_cast<uint32_t>(head >> 32);
+}
+
+}  // namespace
+
+DmaBufferPool::DmaBufferPool(size_t buffer_size, uint32_t buffer_count, size_t alignment)
+    : region_(nullptr)
+    , buffer_size_(0)
+    , buffer_count_(buffer_count)
+    , head_(PackHead(0, kEmpty))
+    , available_(0) {
+
+    if (buffer_size == 0 || buffer_count == 0 || buffer_count == kEmpty) {
+        throw std::invalid_argument("Buffer size and count must be greater than zero");
+    }
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        throw std::invalid_argument("Buffer alignment must be a power of two");
+    }
+
+    // Round each buffer up so every buffer in the region starts aligned
+    buffer_size_ = (buffer_size + alignment - 1) / alignment * alignment;
+
+    region_ = static_cast<uint8_t*>(
+        spdk_dma_malloc(buffer_size_ * buffer_count_, alignment, nullptr));
+    if (region_ == nullptr) {
+        throw std::runtime_error("Failed to allocate DMA buffer pool");
+    }
+
+    // Thread all buffers onto the free list in address order
+    next_.reset(new std::atomic<uint32_t>[buffer_count_]);
+    for (uint32_t i = 0; i < buffer_count_; ++i) {
+        next_[i].store(i + 1 < buffer_count_ ? i + 1 : kEmpty, std::memory_order_relaxed);
+    }
+    head_.store(PackHead(0, 0), std::memory_order_release);
+    available_.store(buffer_count_, std::memory_order_relaxed);
+}
+
+DmaBufferPool::~DmaBufferPool() {
+    spdk_dma_free(region_);
+}
+
+void* DmaBufferPool::Acquire() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t index = HeadIndex(head);
+        if (index == kEmpty) {
+            return nullptr;
+        }
+
+        // The tag changes on every successful pop, so a head that was popped and
+        // pushed back in between is not mistaken for the one we read
+        uint32_t next = next_[index].load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, PackHead(HeadTag(head) + 1, next),
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            available_.fetch_sub(1, std::memory_order_relaxed);
+            return region_ + static_cast<size_t>(index) * buffer_size_;
+        }
+    }
+}
+
+void DmaBufferPool::Release(void* buffer) {
+    assert(Owns(buffer));
+
+    uint32_t index = static_cast<uint32_t>(
+        (static_cast<uint8_t*>(buffer) - region_) / static_cast<ptrdiff_t>(buffer_size_));
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    for (;;) {
+        next_[index].store(HeadIndex(head), std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, PackHead(HeadTag(head), index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+            available_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+bool DmaBufferPool::Owns(const void* buffer) const {
+    const uint8_t* ptr = static_cast<const uint8_t*>(buffer);
+    if (ptr < region_ || ptr >= region_ + buffer_size_ * buffer_count_) {
+        return false;
+    }
+    return static_cast<size_t>(ptr - region_) % buffer_size_ == 0;
+}
+
+size_t DmaBufferPool::GetBufferSize() const {
+    return buffer_size_;
+}
+
+uint32_t DmaBufferPool::GetBufferCount() const {
+    return buffer_count_;
+}
+
+uint32_t DmaBufferPool::GetAvailableCount() const {
+    return available_.load(std::memory_order_relaxed);
+}
+
+const void* DmaBufferPool::GetRegion() const {
+    return region_;
+}
+
+size_t DmaBufferPool::GetRegionSize() const {
+    return buffer_size_ * buffer_count_;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
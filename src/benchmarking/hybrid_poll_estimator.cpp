@@ -0,0 +1,80 @@
+#include "../../include/benchmarking/hybrid_poll_estimator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// Bounds and step of the sleep fraction
+constexpr double kMinFraction = 0.05;
+constexpr double kMaxFraction = 0.95;
+constexpr double kFractionStep = 0.02;
+
+// A spin longer than this share of the expected service time means the sleep was too short
+constexpr double kSpinTolerance = 0.1;
+
+// Shorter sleeps cost more in timer and wakeup overhead than the polling they save
+constexpr uint64_t kMinSleepNs = 2000;
+
+}  // namespace
+
+HybridPollEstimator::HybridPollEstimator(double initial_fraction, double smoothing)
+    : fraction_(initial_fraction)
+    , smoothing_(smoothing)
+    , expected_ns_(0.0)
+    , oversleep_ns_(0.0) {
+
+    if (!(fraction_ > 0.0 && fraction_ <= 1.0) || !(smoothing_ > 0.0 && smoothing_ <= 1.0)) {
+        throw std::invalid_argument("Sleep fraction and smoothing must be in (0, 1]");
+    }
+    fraction_ = std::clamp(fraction_, kMinFraction, kMaxFraction);
+}
+
+void HybridPollEstimator::RecordServiceTime(uint64_t service_ns) {
+    double sample = static_cast<double>(service_ns);
+    if (expected_ns_ == 0.0) {
+        expected_ns_ = sample;
+    } else {
+        expected_ns_ += smoothing_ * (sample - expected_ns_);
+    }
+}
+
+void HybridPollEstimator::RecordWakeup(uint32_t empty_polls, uint64_t spin_ns) {
+    if (empty_polls == 0) {
+        // The command may have completed long before the thread woke up
+        fraction_ = std::max(kMinFraction, fraction_ - kFractionStep);
+    } else if (static_cast<double>(spin_ns) > kSpinTolerance * expected_ns_) {
+        fraction_ = std::min(kMaxFraction, fraction_ + kFractionStep);
+    }
+}
+
+void HybridPollEstimator::RecordSleep(uint64_t requested_ns, uint64_t actual_ns) {
+    double overshoot = actual_ns > requested_ns ? static_cast<double>(actual_ns - requested_ns) : 0.0;
+    oversleep_ns_ += smoothing_ * (overshoot - oversleep_ns_);
+}
+
+uint64_t HybridPollEstimator::GetSleepNs(uint64_t oldest_submit_ns, uint64_t now_ns) const {
+    // Ask to wake up early by the usual overshoot so the thread is back on time
+    double target = fraction_ * expected_ns_ - oversleep_ns_;
+    if (target <= 0.0) {
+        return 0;
+    }
+    uint64_t wake_ns = oldest_submit_ns + static_cast<uint64_t>(target);
+    if (wake_ns <= now_ns || wake_ns - now_ns < kMinSleepNs) {
+        return 0;
+    }
+    return wake_ns - now_ns;
+}
+
+uint64_t HybridPollEstimator::GetExpectedServiceNs() const {
+    return static_cast<uint64_t>(expected_ns_);
+}
+
+double HybridPollEstimator::GetSleepFraction() const {
+    return fraction_;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,172 @@
+#include "../../include/benchmarking/io_backend.h"
+#include "../../include/benchmarking/io_uring_backend.h"
+#include "../../include/benchmarking/libaio_backend.h"
+#include "../../include/benchmarking/sync_backend.h"
+#include "../../include/benchmarking/tcp_backend.h"
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace nvmeof {
+namespace benchmarking {
+
+IoEngine ParseIoEngine(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "spdk") {
+        return IoEngine::SPDK;
+    } else if (lower == "io_uring") {
+        return IoEngine::IO_URING;
+    } else if (lower == "libaio") {
+        return IoEngine::LIBAIO;
+    } else if (lower == "psync") {
+        return IoEngine::PSYNC;
+    } else if (lower == "tcp") {
+        return IoEngine::TCP;
+    }
+
+    throw std::invalid_argument("Unknown I/O engine: " + name);
+}
+
+std::string GetIoEngineName(IoEngine engine) {
+    switch (engine) {
+        case IoEngine::SPDK:
+            return "spdk";
+        case IoEngine::IO_URING:
+            return "io_uring";
+        case IoEngine::LIBAIO:
+            return "libaio";
+        case IoEngine::PSYNC:
+            return "psync";
+        case IoEngine::TCP:
+            return "tcp";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<IoBackend> IoBackend::Create(const IoBackendOptions& options, uint32_t queue_depth,
+                                             uint32_t namespace_id) {
+    switch (options.engine) {
+        case IoEngine::IO_URING:
+            return std::make_unique<IoUringBackend>(options, queue_depth);
+        case IoEngine::LIBAIO:
+            return std::make_unique<LibaioBackend>(options, queue_depth);
+        case IoEngine::PSYNC:
+            return std::make_unique<SyncBackend>(options, queue_depth);
+        case IoEngine::TCP:
+            return std::make_unique<TcpBackend>(options, queue_depth, namespace_id);
+        case IoEngine::SPDK:
+            break;
+    }
+    throw std::invalid_argument("The " + GetIoEngineName(options.engine) +
+                                " engine is bound to a queue pair and cannot be created from options");
+}
+
+int32_t IoBackend::WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) {
+    // Sleep granularity of the emulated interrupt; short enough not to dominate device latency
+    constexpr uint64_t kPollIntervalNs = 20000;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(timeout_ns);
+    while (true) {
+        int32_t rc = ProcessCompletions(max_completions);
+        auto now = std::chrono::steady_clock::now();
+        if (rc != 0 || now >= deadline) {
+            return rc;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(
+            deadline - now, std::chrono::nanoseconds(kPollIntervalNs)));
+    }
+}
+
+int OpenBackendFile(const IoBackendOptions& options, uint64_t* size, uint32_t* sector_size) {
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (options.direct) {
+        flags |= O_DIRECT;
+    }
+#endif
+
+    int fd = open(options.filename.c_str(), flags, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open " << options.filename << ": "
+                 << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+#if !defined(O_DIRECT) && defined(F_NOCACHE)
+    if (options.direct) {
+        fcntl(fd, F_NOCACHE, 1);
+    }
+#endif
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: Failed to stat " << options.filename << ": "
+                 << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    uint64_t bytes = 0;
+    uint32_t block_size = options.sector_size;
+    if (S_ISBLK(st.st_mode)) {
+#ifdef __linux__
+        int logical_block_size = 0;
+        if (block_size == 0 && ioctl(fd, BLKSSZGET, &logical_block_size) == 0) {
+            block_size = static_cast<uint32_t>(logical_block_size);
+        }
+        if (ioctl(fd, BLKGETSIZE64, &bytes) != 0) {
+            bytes = 0;
+        }
+#endif
+        if (bytes == 0) {
+            off_t end = lseek(fd, 0, SEEK_END);
+            bytes = end > 0 ? static_cast<uint64_t>(end) : 0;
+        }
+    } else {
+        bytes = static_cast<uint64_t>(st.st_size);
+        if (options.file_size > bytes) {
+            // The new space is sparse until written
+            if (ftruncate(fd, static_cast<off_t>(options.file_size)) != 0) {
+                std::cerr << "Error: Failed to resize " << options.filename << ": "
+                         << std::strerror(errno) << std::endl;
+                close(fd);
+                return -1;
+            }
+            bytes = options.file_size;
+        }
+    }
+
+    if (block_size == 0) {
+        block_size = 512;
+    }
+
+    bytes = bytes / block_size * block_size;
+    if (bytes == 0) {
+        std::cerr << "Error: " << options.filename << " is empty; set a file size" << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    *size = bytes;
+    *sector_size = block_size;
+    return fd;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
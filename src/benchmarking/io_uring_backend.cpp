@@ -0,0 +1,570 @@
+#include "../../include/benchmarking/io_uring_backend.h"
+#include "../../include/benchmarking/dma_buffer_pool.h"
+#include <iostream>
+#include <stdexcept>
+#include <atomic>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define NVMEOF_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef NVMEOF_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#endif
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+#ifdef NVMEOF_HAVE_IO_URING
+
+int IoUringSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                                    flags, nullptr, 0));
+}
+
+int IoUringRegister(int ring_fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+// Ring indices are shared with the kernel; only the owning side stores to each
+unsigned LoadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(unsigned* p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+#endif
+
+uint32_t RoundUpPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+IoUringBackend::IoUringBackend(const IoBackendOptions& options, uint32_t queue_depth)
+    : options_(options)
+    , queue_depth_(queue_depth)
+    , fd_(-1)
+    , ring_fd_(-1)
+    , sector_size_(0)
+    , size_(0)
+    , sq_ring_(nullptr)
+    , sq_ring_size_(0)
+    , cq_ring_(nullptr)
+    , cq_ring_size_(0)
+    , sqes_(nullptr)
+    , sqes_size_(0)
+    , sq_head_(nullptr)
+    , sq_tail_(nullptr)
+    , sq_flags_(nullptr)
+    , sq_array_(nullptr)
+    , sq_mask_(0)
+    , cq_head_(nullptr)
+    , cq_tail_(nullptr)
+    , cqes_(nullptr)
+    , cq_mask_(0)
+    , sq_entries_(0)
+    , in_flight_(0)
+    , unsubmitted_(0)
+    , submit_calls_(0)
+    , registered_region_(nullptr)
+    , registered_size_(0)
+    , event_fd_(-1) {
+
+    if (options_.engine != IoEngine::IO_URING || !options_.IsValid()) {
+        throw std::invalid_argument("Invalid io_uring backend options");
+    }
+
+    if (queue_depth_ == 0) {
+        throw std::invalid_argument("Queue depth must be greater than zero");
+    }
+}
+
+IoUringBackend::~IoUringBackend() {
+    Close();
+}
+
+bool IoUringBackend::Open() {
+    if (ring_fd_ >= 0) {
+        return true;
+    }
+
+#ifdef NVMEOF_HAVE_IO_URING
+    if (!OpenFile() || !SetupRing()) {
+        Close();
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Error: io_uring is not available on this platform" << std::endl;
+    return false;
+#endif
+}
+
+bool IoUringBackend::OpenFile() {
+    fd_ = OpenBackendFile(options_, &size_, &sector_size_);
+    return fd_ >= 0;
+}
+
+bool IoUringBackend::SetupRing() {
+#ifdef NVMEOF_HAVE_IO_URING
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    if (options_.sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = options_.sqpoll_idle_ms;
+    }
+    if (options_.iopoll) {
+        params.flags |= IORING_SETUP_IOPOLL;
+    }
+
+    ring_fd_ = IoUringSetup(RoundUpPowerOfTwo(queue_depth_), &params);
+    if (ring_fd_ < 0) {
+        std::cerr << "Error: Failed to set up io_uring: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    sq_entries_ = params.sq_entries;
+
+    // Map the submission ring, the completion ring (often the same mapping) and the SQEs
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    void* sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        std::cerr << "Error: Failed to map the io_uring submission ring: "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+    sq_ring_ = sq_ring;
+
+    if (single_mmap) {
+        cq_ring_ = sq_ring_;
+    } else {
+        void* cq_ring = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            std::cerr << "Error: Failed to map the io_uring completion ring: "
+                     << std::strerror(errno) << std::endl;
+            return false;
+        }
+        cq_ring_ = cq_ring;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        std::cerr << "Error: Failed to map the io_uring submission entries: "
+                 << std::strerror(errno) << std::endl;
+        sqes_size_ = 0;
+        return false;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<uint8_t*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_flags_ = reinterpret_cast<unsigned*>(sq + params.sq_off.flags);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+
+    auto* cq = static_cast<uint8_t*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+
+    if (options_.registered_files &&
+        IoUringRegister(ring_fd_, IORING_REGISTER_FILES, &fd_, 1) != 0) {
+        std::cerr << "Error: Failed to register " << options_.filename << " with io_uring: "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    in_flight_ = 0;
+    unsubmitted_ = 0;
+    submit_calls_ = 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IoUringBackend::Drain() {
+#ifdef NVMEOF_HAVE_IO_URING
+    if (ring_fd_ < 0 || cq_head_ == nullptr) {
+        return true;
+    }
+
+    // Queued entries are handed over too, so that every command ends with a completion
+    while (in_flight_ > 0) {
+        if (Flush() < 0) {
+            return false;
+        }
+
+        unsigned head = *cq_head_;
+        unsigned tail = LoadAcquire(cq_tail_);
+        if (head == tail) {
+            if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+                errno != EAGAIN && errno != EBUSY && errno != EINTR) {
+                return false;
+            }
+            continue;
+        }
+        while (head != tail) {
+            free_pending_.push_back(reinterpret_cast<PendingIo*>(cqes_[head & cq_mask_].user_data));
+            ++head;
+            --in_flight_;
+        }
+        StoreRelease(cq_head_, head);
+    }
+#endif
+    return true;
+}
+
+bool IoUringBackend::Close() {
+    // Unmapping or closing the ring does not stop the kernel from writing into
+    // registered buffers, so commands in flight are waited for first
+    bool drained = Drain();
+    if (!drained) {
+        std::cerr << "Error: " << in_flight_ << " io_uring commands still outstanding" << std::endl;
+    }
+    in_flight_ = 0;
+    unsubmitted_ = 0;
+
+#ifdef NVMEOF_HAVE_IO_URING
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+        munmap(sq_ring_, sq_ring_size_);
+    }
+#endif
+    sqes_ = nullptr;
+    cq_ring_ = nullptr;
+    sq_ring_ = nullptr;
+    cq_head_ = nullptr;
+
+    // Closing the ring also drops its registered buffers, files and eventfd
+    if (event_fd_ >= 0) {
+        close(event_fd_);
+        event_fd_ = -1;
+    }
+    if (ring_fd_ >= 0) {
+        close(ring_fd_);
+        ring_fd_ = -1;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    registered_region_ = nullptr;
+    registered_size_ = 0;
+    return drained;
+}
+
+std::string IoUringBackend::GetName() const {
+    return "io_uring";
+}
+
+uint32_t IoUringBackend::GetSectorSize() const {
+    return sector_size_;
+}
+
+uint64_t IoUringBackend::GetSize() const {
+    return size_;
+}
+
+void IoUringBackend::RegisterBuffers(const DmaBufferPool& pool) {
+#ifdef NVMEOF_HAVE_IO_URING
+    if (!options_.registered_buffers || ring_fd_ < 0 || registered_region_ == pool.GetRegion()) {
+        return;
+    }
+
+    if (registered_region_ != nullptr) {
+        IoUringRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        registered_region_ = nullptr;
+        registered_size_ = 0;
+    }
+
+    // The whole pool is one fixed buffer; commands address it by pointer
+    struct iovec iov;
+    iov.iov_base = const_cast<void*>(pool.GetRegion());
+    iov.iov_len = pool.GetRegionSize();
+    if (IoUringRegister(ring_fd_, IORING_REGISTER_BUFFERS, &iov, 1) != 0) {
+        std::cerr << "Warning: Failed to register I/O buffers with io_uring ("
+                 << std::strerror(errno) << "); using unregistered buffers" << std::endl;
+        return;
+    }
+    registered_region_ = pool.GetRegion();
+    registered_size_ = pool.GetRegionSize();
+#else
+    (void)pool;
+#endif
+}
+
+bool IoUringBackend::HasRegisteredBuffers() const {
+    return registered_region_ != nullptr;
+}
+
+uint64_t IoUringBackend::GetSubmitCalls() const {
+    return submit_calls_;
+}
+
+int IoUringBackend::SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                               IoBackendCallback cb, void* cb_arg) {
+    return Submit(false, buffer, offset, length, cb, cb_arg);
+}
+
+int IoUringBackend::SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                                IoBackendCallback cb, void* cb_arg) {
+    return Submit(true, buffer, offset, length, cb, cb_arg);
+}
+
+int IoUringBackend::Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+                           IoBackendCallback cb, void* cb_arg) {
+#ifdef NVMEOF_HAVE_IO_URING
+    if (ring_fd_ < 0) {
+        return -EBADF;
+    }
+
+    // Outstanding commands never exceed the SQ size, so the CQ (twice as large) cannot overflow
+    if (in_flight_ >= sq_entries_) {
+        return -ENOMEM;
+    }
+
+    PendingIo* pending;
+    if (free_pending_.empty()) {
+        pending_.push_back(PendingIo{nullptr, nullptr, 0});
+        pending = &pending_.back();
+    } else {
+        pending = free_pending_.back();
+        free_pending_.pop_back();
+    }
+    pending->cb = cb;
+    pending->cb_arg = cb_arg;
+    pending->length = length;
+
+    unsigned tail = *sq_tail_;
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    const auto* data = static_cast<const uint8_t*>(buffer);
+    const auto* region = static_cast<const uint8_t*>(registered_region_);
+    if (region != nullptr && data >= region && data + length <= region + registered_size_) {
+        sqe->opcode = is_write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->buf_index = 0;
+    } else {
+        sqe->opcode = is_write ? IORING_OP_WRITE : IORING_OP_READ;
+    }
+    if (options_.registered_files) {
+        sqe->fd = 0;
+        sqe->flags |= IOSQE_FIXED_FILE;
+    } else {
+        sqe->fd = fd_;
+    }
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = length;
+    sqe->user_data = reinterpret_cast<uint64_t>(pending);
+
+    sq_array_[index] = index;
+    StoreRelease(sq_tail_, tail + 1);
+    ++in_flight_;
+    ++unsubmitted_;
+
+    // The command is queued either way; a failed flush is reported by ProcessCompletions()
+    if (unsubmitted_ >= options_.submit_batch) {
+        Flush();
+    }
+    return 0;
+#else
+    (void)is_write;
+    (void)buffer;
+    (void)offset;
+    (void)length;
+    (void)cb;
+    (void)cb_arg;
+    return -ENOSYS;
+#endif
+}
+
+int IoUringBackend::Flush() {
+#ifdef NVMEOF_HAVE_IO_URING
+    if (unsubmitted_ == 0) {
+        return 0;
+    }
+
+    if (options_.sqpoll) {
+        // The kernel thread picks up new entries by itself unless it went to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) {
+            ++submit_calls_;
+            if (IoUringEnter(ring_fd_, unsubmitted_, 0, IORING_ENTER_SQ_WAKEUP) < 0 &&
+                errno != EAGAIN && errno != EBUSY && errno != EINTR) {
+                return -errno;
+            }
+        }
+        unsubmitted_ = 0;
+        return 0;
+    }
+
+    ++submit_calls_;
+    int submitted = IoUringEnter(ring_fd_, unsubmitted_, 0, 0);
+    if (submitted < 0) {
+        // Out of kernel resources: retry on the next flush once completions are reaped
+        if (errno == EAGAIN || errno == EBUSY || errno == EINTR) {
+            return 0;
+        }
+        return -errno;
+    }
+    unsubmitted_ -= std::min(unsubmitted_, static_cast<uint32_t>(submitted));
+    return 0;
+#else
+    return -ENOSYS;
+#endif
+}
+
+int32_t IoUringBackend::ProcessCompletions(uint32_t max_completions) {
+#ifdef NVMEOF_HAVE_IO_URING
+    if (ring_fd_ < 0) {
+        return -EBADF;
+    }
+
+    // Partial batches are submitted here so they never wait for more commands
+    int rc = Flush();
+    if (rc < 0) {
+        return rc;
+    }
+
+    // Polled rings only complete commands when asked to
+    if (options_.iopoll && in_flight_ > 0) {
+        if (IoUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS) < 0 &&
+            errno != EAGAIN && errno != EBUSY && errno != EINTR) {
+            return -errno;
+        }
+    }
+
+    int32_t completed = 0;
+    unsigned head = *cq_head_;
+    unsigned tail = LoadAcquire(cq_tail_);
+    while (head != tail && (max_completions == 0 || static_cast<uint32_t>(completed) < max_completions)) {
+        const struct io_uring_cqe* cqe = &cqes_[head & cq_mask_];
+        auto* pending = reinterpret_cast<PendingIo*>(cqe->user_data);
+        int result = cqe->res;
+        ++head;
+        StoreRelease(cq_head_, head);
+        --in_flight_;
+        ++completed;
+
+        // Recycle the entry first: the callback may submit again
+        IoBackendCallback cb = pending->cb;
+        void* cb_arg = pending->cb_arg;
+        uint32_t length = pending->length;
+        free_pending_.push_back(pending);
+
+        int status = 0;
+        if (result < 0) {
+            status = result;
+        } else if (static_cast<uint32_t>(result) != length) {
+            status = -EIO;  // Short transfer, e.g. past the end of the file
+        }
+        cb(cb_arg, status);
+    }
+    return completed;
+#else
+    (void)max_completions;
+    return -ENOSYS;
+#endif
+}
+
+int32_t IoUringBackend::WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) {
+#ifdef NVMEOF_HAVE_IO_URING
+    int32_t completed = ProcessCompletions(max_completions);
+    if (completed != 0 || in_flight_ == 0 || timeout_ns == 0) {
+        return completed;
+    }
+
+    // Polled rings have no completion interrupt; the kernel spins on the device instead
+    if (options_.iopoll) {
+        if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+            errno != EAGAIN && errno != EBUSY && errno != EINTR) {
+            return -errno;
+        }
+        return ProcessCompletions(max_completions);
+    }
+
+    // The ring signals an eventfd for every completion it posts
+    if (event_fd_ < 0) {
+        int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (fd < 0 || IoUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &fd, 1) != 0) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return IoBackend::WaitForCompletions(max_completions, timeout_ns);
+        }
+        event_fd_ = fd;
+    }
+
+    // Reset the counter, then look at the ring again: a completion posted in
+    // between has either been seen here or will signal the eventfd again
+    uint64_t count;
+    if (read(event_fd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        return -errno;
+    }
+    if (*cq_head_ == LoadAcquire(cq_tail_)) {
+        struct pollfd pfd;
+        pfd.fd = event_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        struct timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(timeout_ns / 1000000000ULL);
+        timeout.tv_nsec = static_cast<long>(timeout_ns % 1000000000ULL);
+        if (ppoll(&pfd, 1, &timeout, nullptr) < 0 && errno != EINTR) {
+            return -errno;
+        }
+    }
+    return ProcessCompletions(max_completions);
+#else
+    (void)max_completions;
+    (void)timeout_ns;
+    return -ENOSYS;
+#endif
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,729 @@
+#include "../../include/benchmarking/job_file.h"
+#include "../../include/utils/nvmeof_utils.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+using utils::JsonValue;
+
+/**
+ * @brief A profile being assembled from layered JSON objects.
+ *
+ * The fio-style byte range depends on block_size, which a later layer may
+ * still change, so it is resolved only once all layers have been applied.
+ */
+struct ProfileDraft {
+    WorkloadProfile profile{};     ///< Profile fields set so far
+    JobOptions options;            ///< Job options set so far
+    bool has_offset = false;       ///< Whether "offset" was given
+    uint64_t offset_bytes = 0;     ///< Start of the range in bytes
+    bool has_range = false;        ///< Whether "size" was given
+    uint64_t range_bytes = 0;      ///< Length of the range in bytes
+    bool has_total_size = false;   ///< Whether total_size was given
+    bool has_num_blocks = false;   ///< Whether num_blocks was given
+};
+
+[[noreturn]] void ThrowInvalid(const std::string& key, const std::string& reason) {
+    throw std::invalid_argument("Invalid value for '" + key + "': " + reason);
+}
+
+std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+uint64_t ParseSizeString(const std::string& key, const std::string& text) {
+    std::string trimmed = utils::TrimString(text);
+    size_t pos = 0;
+    while (pos < trimmed.size() && std::isdigit(static_cast<unsigned char>(trimmed[pos]))) {
+        ++pos;
+    }
+    if (pos == 0) {
+        ThrowInvalid(key, "expected a size such as 4096, \"4k\" or \"1GiB\"");
+    }
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < pos; ++i) {
+        uint64_t digit = static_cast<uint64_t>(trimmed[i] - '0');
+        if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+            ThrowInvalid(key, "size is out of range");
+        }
+        value = value * 10 + digit;
+    }
+
+    // Binary multipliers, as in fio: k = 1024; a trailing "b" or "ib" is optional
+    std::string suffix = ToLower(trimmed.substr(pos));
+    if (suffix.empty() || suffix == "b") {
+        return value;
+    }
+
+    int shift;
+    switch (suffix[0]) {
+        case 'k': shift = 10; break;
+        case 'm': shift = 20; break;
+        case 'g': shift = 30; break;
+        case 't': shift = 40; break;
+        default: ThrowInvalid(key, "unknown size suffix '" + suffix + "'");
+    }
+
+    std::string rest = suffix.substr(1);
+    if (!rest.empty() && rest != "b" && rest != "ib") {
+        ThrowInvalid(key, "unknown size suffix '" + suffix + "'");
+    }
+    if (value > (std::numeric_limits<uint64_t>::max() >> shift)) {
+        ThrowInvalid(key, "size is out of range");
+    }
+    return value << shift;
+}
+
+uint64_t GetUint64(const std::string& key, const JsonValue& value) {
+    try {
+        return value.AsUint64();
+    } catch (const std::runtime_error&) {
+        ThrowInvalid(key, "expected a non-negative integer");
+    }
+}
+
+uint32_t GetUint32(const std::string& key, const JsonValue& value) {
+    uint64_t result = GetUint64(key, value);
+    if (result > std::numeric_limits<uint32_t>::max()) {
+        ThrowInvalid(key, "value is out of range");
+    }
+    return static_cast<uint32_t>(result);
+}
+
+double GetDouble(const std::string& key, const JsonValue& value) {
+    try {
+        return value.AsDouble();
+    } catch (const std::runtime_error&) {
+        ThrowInvalid(key, "expected a number");
+    }
+}
+
+const std::string& GetString(const std::string& key, const JsonValue& value) {
+    try {
+        return value.AsString();
+    } catch (const std::runtime_error&) {
+        ThrowInvalid(key, "expected a string");
+    }
+}
+
+bool GetBool(const std::string& key, const JsonValue& value) {
+    // fio writes flags as 0 or 1
+    if (value.IsBool()) {
+        return value.AsBool();
+    }
+    uint64_t flag = 0;
+    try {
+        flag = value.AsUint64();
+    } catch (const std::runtime_error&) {
+        ThrowInvalid(key, "expected true, false, 0 or 1");
+    }
+    if (flag > 1) {
+        ThrowInvalid(key, "expected true, false, 0 or 1");
+    }
+    return flag == 1;
+}
+
+bool GetVerify(const std::string& key, const JsonValue& value) {
+    // fio names the checksum; CRC-32C is the only one implemented
+    if (!value.IsString()) {
+        return GetBool(key, value);
+    }
+    const std::string& name = value.AsString();
+    if (name == "crc32c") {
+        return true;
+    } else if (name == "none") {
+        return false;
+    }
+    ThrowInvalid(key, "expected true, false, \"crc32c\" or \"none\"");
+}
+
+uint64_t GetSize(const std::string& key, const JsonValue& value) {
+    return value.IsString() ? ParseSizeString(key, value.AsString()) : GetUint64(key, value);
+}
+
+uint32_t GetSize32(const std::string& key, const JsonValue& value) {
+    uint64_t result = GetSize(key, value);
+    if (result > std::numeric_limits<uint32_t>::max()) {
+        ThrowInvalid(key, "value is out of range");
+    }
+    return static_cast<uint32_t>(result);
+}
+
+uint32_t GetDurationSeconds(const std::string& key, const JsonValue& value) {
+    if (!value.IsString()) {
+        return GetUint32(key, value);
+    }
+
+    std::string text = ToLower(utils::TrimString(value.AsString()));
+    uint64_t multiplier = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 's': multiplier = 1; text.pop_back(); break;
+            case 'm': multiplier = 60; text.pop_back(); break;
+            case 'h': multiplier = 3600; text.pop_back(); break;
+            default: break;
+        }
+    }
+    if (text.empty() || !std::all_of(text.begin(), text.end(),
+                                     [](unsigned char c) { return std::isdigit(c) != 0; })) {
+        ThrowInvalid(key, "expected a duration such as 30, \"30s\" or \"5m\"");
+    }
+    if (text.size() > 9) {
+        ThrowInvalid(key, "duration is out of range");
+    }
+
+    uint64_t seconds = std::stoull(text) * multiplier;
+    if (seconds > std::numeric_limits<uint32_t>::max()) {
+        ThrowInvalid(key, "duration is out of range");
+    }
+    return static_cast<uint32_t>(seconds);
+}
+
+uint32_t GetPercentage(const std::string& key, const JsonValue& value) {
+    uint32_t percentage = GetUint32(key, value);
+    if (percentage > 100) {
+        ThrowInvalid(key, "expected a percentage between 0 and 100");
+    }
+    return percentage;
+}
+
+template <typename Parser>
+auto ParseName(const std::string& key, const JsonValue& value, Parser parser)
+    -> decltype(parser(std::string())) {
+    const std::string& name = GetString(key, value);
+    try {
+        return parser(name);
+    } catch (const std::invalid_argument&) {
+        ThrowInvalid(key, "unknown name '" + name + "'");
+    }
+}
+
+std::vector<BlockSizeWeight> ParseBlockSizes(const std::string& key, const JsonValue& value) {
+    std::vector<BlockSizeWeight> sizes;
+
+    if (value.IsString()) {
+        // fio bssplit syntax: size/weight pairs separated by colons
+        for (const auto& item : utils::SplitString(value.AsString(), ':')) {
+            std::vector<std::string> parts = utils::SplitString(item, '/');
+            if (parts.size() != 2) {
+                ThrowInvalid(key, "expected entries of the form size/weight");
+            }
+            uint64_t block_size = ParseSizeString(key, parts[0]);
+            std::string weight = utils::TrimString(parts[1]);
+            if (block_size > std::numeric_limits<uint32_t>::max() || weight.empty() ||
+                weight.size() > 9 || !std::all_of(weight.begin(), weight.end(), [](unsigned char c) {
+                    return std::isdigit(c) != 0;
+                })) {
+                ThrowInvalid(key, "expected entries of the form size/weight");
+            }
+            BlockSizeWeight entry;
+            entry.block_size = static_cast<uint32_t>(block_size);
+            entry.weight = static_cast<uint32_t>(std::stoul(weight));
+            sizes.push_back(entry);
+        }
+        return sizes;
+    }
+
+    if (!value.IsArray()) {
+        ThrowInvalid(key, "expected an array or a bssplit string");
+    }
+
+    for (size_t i = 0; i < value.Size(); ++i) {
+        const JsonValue& item = value[i];
+        const JsonValue* block_size = item.Find("block_size");
+        const JsonValue* weight = item.Find("weight");
+        if (block_size == nullptr || weight == nullptr || item.Size() != 2) {
+            ThrowInvalid(key, "expected objects with 'block_size' and 'weight'");
+        }
+        BlockSizeWeight entry;
+        entry.block_size = GetSize32(key, *block_size);
+        entry.weight = GetUint32(key, *weight);
+        sizes.push_back(entry);
+    }
+    return sizes;
+}
+
+AccessPatternConfig ParseAccessPattern(const std::string& key, const JsonValue& value) {
+    AccessPatternConfig config;
+
+    if (value.IsString()) {
+        config.distribution = ParseName(key, value, ParseAccessDistribution);
+        return config;
+    }
+
+    if (!value.IsObject()) {
+        ThrowInvalid(key, "expected a distribution name or object");
+    }
+
+    for (size_t i = 0; i < value.Size(); ++i) {
+        const std::string& name = value.KeyAt(i);
+        const JsonValue& item = value.ValueAt(i);
+        const std::string item_key = key + "." + name;
+
+        if (name == "distribution") {
+            config.distribution = ParseName(item_key, item, ParseAccessDistribution);
+        } else if (name == "zipf_theta") {
+            config.zipf_theta = GetDouble(item_key, item);
+        } else if (name == "pareto_shape") {
+            config.pareto_shape = GetDouble(item_key, item);
+        } else if (name == "hot_io_percentage") {
+            config.hot_io_percentage = GetPercentage(item_key, item);
+        } else if (name == "hot_space_percentage") {
+            config.hot_space_percentage = GetPercentage(item_key, item);
+        } else if (name == "normal_stddev_percentage") {
+            config.normal_stddev_percentage = GetDouble(item_key, item);
+        } else if (name == "normal_center_step") {
+            config.normal_center_step = GetDouble(item_key, item);
+        } else if (name == "stride_blocks") {
+            config.stride_blocks = GetUint64(item_key, item);
+        } else {
+            throw std::invalid_argument("Unknown access pattern key: " + item_key);
+        }
+    }
+    return config;
+}
+
+IoEngine ParseEngine(const std::string& key, const JsonValue& value) {
+    try {
+        return ParseIoEngine(GetString(key, value));
+    } catch (const std::invalid_argument&) {
+        ThrowInvalid(key, "expected \"spdk\", \"io_uring\", \"libaio\", \"psync\" or \"tcp\"");
+    }
+}
+
+LbaRangeMode ParseRangeMode(const std::string& key, const JsonValue& value) {
+    std::string name = ToLower(GetString(key, value));
+    if (name == "shared") {
+        return LbaRangeMode::SHARED;
+    }
+    if (name == "disjoint") {
+        return LbaRangeMode::DISJOINT;
+    }
+    ThrowInvalid(key, "expected \"shared\" or \"disjoint\"");
+}
+
+/**
+ * @brief Applies the keys of one JSON object over a draft profile.
+ *
+ * @param object The profile, defaults or job object
+ * @param draft The draft to update
+ * @param allow_job_keys Whether job options are accepted
+ * @param extra_keys Keys handled by the caller that are skipped here
+ */
+void ApplySettings(const JsonValue& object, ProfileDraft& draft, bool allow_job_keys,
+                   const std::vector<std::string>& extra_keys) {
+    if (!object.IsObject()) {
+        throw std::invalid_argument("Workload profile must be a JSON object");
+    }
+
+    WorkloadProfile& profile = draft.profile;
+    for (size_t i = 0; i < object.Size(); ++i) {
+        const std::string& key = object.KeyAt(i);
+        const JsonValue& value = object.ValueAt(i);
+
+        if (key == "name" || key == "description" ||
+            std::find(extra_keys.begin(), extra_keys.end(), key) != extra_keys.end()) {
+            continue;
+        } else if (key == "total_size") {
+            profile.total_size = GetSize(key, value);
+            draft.has_total_size = true;
+        } else if (key == "block_size") {
+            profile.block_size = GetSize32(key, value);
+        } else if (key == "num_blocks") {
+            profile.num_blocks = GetUint32(key, value);
+            draft.has_num_blocks = true;
+        } else if (key == "start_block") {
+            profile.start_block = GetUint64(key, value);
+            draft.has_offset = false;
+        } else if (key == "namespace_id") {
+            profile.namespace_id = GetUint32(key, value);
+        } else if (key == "offset") {
+            draft.offset_bytes = GetSize(key, value);
+            draft.has_offset = true;
+        } else if (key == "size") {
+            draft.range_bytes = GetSize(key, value);
+            draft.has_range = true;
+        } else if (key == "interval_us") {
+            profile.interval_us = GetUint32(key, value);
+        } else if (key == "read_percentage") {
+            profile.read_percentage = GetPercentage(key, value);
+            if (object.Find("write_percentage") == nullptr) {
+                profile.write_percentage = 100 - profile.read_percentage;
+            }
+        } else if (key == "write_percentage") {
+            profile.write_percentage = GetPercentage(key, value);
+            if (object.Find("read_percentage") == nullptr) {
+                profile.read_percentage = 100 - profile.write_percentage;
+            }
+        } else if (key == "random_percentage") {
+            profile.random_percentage = GetPercentage(key, value);
+        } else if (key == "queue_depth") {
+            profile.queue_depth = GetUint32(key, value);
+        } else if (key == "payload_pattern") {
+            profile.payload_pattern = ParseName(key, value, ParsePayloadPattern);
+        } else if (key == "compress_percentage") {
+            profile.compress_percentage = GetPercentage(key, value);
+        } else if (key == "dedupe_percentage") {
+            profile.dedupe_percentage = GetPercentage(key, value);
+        } else if (key == "runtime_seconds") {
+            profile.runtime_seconds = GetDurationSeconds(key, value);
+        } else if (key == "ramp_time_seconds") {
+            profile.ramp_time_seconds = GetDurationSeconds(key, value);
+        } else if (key == "rate_iops") {
+            profile.rate_iops = GetUint64(key, value);
+        } else if (key == "rate_mbps") {
+            profile.rate_mbps = GetDouble(key, value);
+        } else if (key == "arrival_mode") {
+            profile.arrival_mode = ParseName(key, value, ParseArrivalMode);
+        } else if (key == "arrival_rate") {
+            profile.arrival_rate = GetDouble(key, value);
+        } else if (key == "completion_mode") {
+            profile.completion_mode = ParseName(key, value, ParseCompletionMode);
+        } else if (key == "submit_batch") {
+            profile.submit_batch = GetUint32(key, value);
+        } else if (key == "reap_batch") {
+            profile.reap_batch = GetUint32(key, value);
+        } else if (key == "use_polling_mode") {
+            profile.completion_mode = GetBool(key, value) ? CompletionMode::POLL : CompletionMode::BLOCK;
+        } else if (key == "verify") {
+            profile.verify = GetVerify(key, value);
+        } else if (key == "verify_seed") {
+            profile.verify_seed = GetUint64(key, value);
+        } else if (key == "verify_async") {
+            profile.verify_async = GetUint32(key, value);
+        } else if (key == "trace_file") {
+            profile.trace_file = GetString(key, value);
+        } else if (key == "replay_speed") {
+            profile.replay_speed = GetDouble(key, value);
+        } else if (key == "trace_partition") {
+            profile.trace_partition = ParseName(key, value, ParseTracePartition);
+        } else if (key == "access_pattern") {
+            profile.access_pattern = ParseAccessPattern(key, value);
+        } else if (key == "read_block_sizes") {
+            profile.read_block_sizes = ParseBlockSizes(key, value);
+        } else if (key == "write_block_sizes") {
+            profile.write_block_sizes = ParseBlockSizes(key, value);
+        } else if (key == "block_sizes") {
+            profile.read_block_sizes = ParseBlockSizes(key, value);
+            profile.write_block_sizes = profile.read_block_sizes;
+        } else if (allow_job_keys && key == "threads") {
+            draft.options.num_threads = GetUint32(key, value);
+        } else if (allow_job_keys && key == "core_mask") {
+            draft.options.core_mask = GetString(key, value);
+        } else if (allow_job_keys && key == "range_mode") {
+            draft.options.range_mode = ParseRangeMode(key, value);
+        } else if (allow_job_keys && key == "ioengine") {
+            draft.options.backend.engine = ParseEngine(key, value);
+        } else if (allow_job_keys && key == "filename") {
+            draft.options.backend.filename = GetString(key, value);
+        } else if (allow_job_keys && key == "address") {
+            draft.options.backend.address = GetString(key, value);
+        } else if (allow_job_keys && key == "direct") {
+            draft.options.backend.direct = GetBool(key, value);
+        } else if (allow_job_keys && key == "filesize") {
+            draft.options.backend.file_size = GetSize(key, value);
+        } else if (allow_job_keys && key == "sector_size") {
+            draft.options.backend.sector_size = GetSize32(key, value);
+        } else if (allow_job_keys && key == "fixedbufs") {
+            draft.options.backend.registered_buffers = GetBool(key, value);
+        } else if (allow_job_keys && key == "registerfiles") {
+            draft.options.backend.registered_files = GetBool(key, value);
+        } else if (allow_job_keys && key == "sqthread_poll") {
+            draft.options.backend.sqpoll = GetBool(key, value);
+        } else if (allow_job_keys && key == "sqthread_poll_idle") {
+            draft.options.backend.sqpoll_idle_ms = GetUint32(key, value);
+        } else if (allow_job_keys && key == "hipri") {
+            draft.options.backend.iopoll = GetBool(key, value);
+        } else if (allow_job_keys && key == "iodepth_batch_submit") {
+            draft.options.backend.submit_batch = GetUint32(key, value);
+            profile.submit_batch = draft.options.backend.submit_batch;
+        } else if (allow_job_keys && key == "iodepth_batch_complete_max") {
+            profile.reap_batch = GetUint32(key, value);
+        } else {
+            throw std::invalid_argument("Unknown workload profile key: " + key);
+        }
+    }
+}
+
+/**
+ * @brief Resolves derived fields of a draft and validates the profile.
+ *
+ * @param draft The completed draft
+ * @param context Description of the profile for error messages
+ *
+ * @return The validated profile
+ */
+WorkloadProfile FinishProfile(ProfileDraft& draft, const std::string& context) {
+    WorkloadProfile& profile = draft.profile;
+
+    if (profile.block_size == 0) {
+        throw std::invalid_argument(context + ": block_size must be set");
+    }
+
+    if (draft.has_offset) {
+        if (draft.offset_bytes % profile.block_size != 0) {
+            throw std::invalid_argument(context + ": offset must be a multiple of block_size");
+        }
+        profile.start_block = draft.offset_bytes / profile.block_size;
+    }
+
+    if (draft.has_range) {
+        uint64_t blocks = draft.range_bytes / profile.block_size;
+        if (blocks == 0 || blocks > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument(context + ": size does not fit the block size");
+        }
+        profile.num_blocks = static_cast<uint32_t>(blocks);
+        draft.has_num_blocks = true;
+    }
+
+    // Either of total_size and the range implies the other
+    uint64_t range_bytes = static_cast<uint64_t>(profile.block_size) * profile.num_blocks;
+    if (!draft.has_total_size && profile.total_size == 0 && draft.has_num_blocks) {
+        profile.total_size = range_bytes;
+    } else if (!draft.has_num_blocks && profile.num_blocks == 0) {
+        uint64_t blocks = profile.total_size / profile.block_size;
+        profile.num_blocks = static_cast<uint32_t>(
+            std::min<uint64_t>(blocks, std::numeric_limits<uint32_t>::max()));
+    }
+
+    if (!profile.IsValid()) {
+        throw std::invalid_argument(context + ": invalid workload profile");
+    }
+    if (!draft.options.backend.IsValid()) {
+        throw std::invalid_argument(context + ": invalid I/O engine options");
+    }
+    return profile;
+}
+
+JsonValue ParseJsonFile(const std::string& filename) {
+    if (!utils::FileExists(filename)) {
+        throw std::runtime_error("Failed to read file: " + filename);
+    }
+
+    try {
+        return JsonValue::Parse(utils::ReadFileToString(filename));
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(filename + ": " + e.what());
+    }
+}
+
+std::string DirectoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash);
+}
+
+std::string ResolvePath(const std::string& base_dir, const std::string& path) {
+    if (base_dir.empty() || path.empty() || path[0] == '/') {
+        return path;
+    }
+    return base_dir + "/" + path;
+}
+
+}  // namespace
+
+WorkloadProfile ParseWorkloadProfile(const utils::JsonValue& json) {
+    ProfileDraft draft;
+    ApplySettings(json, draft, false, {});
+    return FinishProfile(draft, "Workload profile");
+}
+
+WorkloadProfile LoadWorkloadProfile(const std::string& filename) {
+    try {
+        return ParseWorkloadProfile(ParseJsonFile(filename));
+    } catch (const std::invalid_argument& e) {
+        throw std::invalid_argument(filename + ": " + e.what());
+    }
+}
+
+JobFile ParseJobFile(const utils::JsonValue& json, const std::string& base_dir) {
+    JobFile job_file;
+
+    if (!json.IsObject()) {
+        throw std::invalid_argument("Job file must be a JSON object");
+    }
+
+    const JsonValue* jobs = json.Find("jobs");
+    if (jobs == nullptr) {
+        // A plain profile is a job file with a single job
+        ProfileDraft draft;
+        ApplySettings(json, draft, true, {});
+        JobDefinition job;
+        const JsonValue* name = json.Find("name");
+        job.name = (name != nullptr && name->IsString()) ? name->AsString() : "job0";
+        job.profile = FinishProfile(draft, job.name);
+        job.options = draft.options;
+        job_file.jobs.push_back(job);
+        return job_file;
+    }
+
+    for (size_t i = 0; i < json.Size(); ++i) {
+        const std::string& key = json.KeyAt(i);
+        if (key != "name" && key != "description" && key != "execution" &&
+            key != "defaults" && key != "jobs") {
+            throw std::invalid_argument("Unknown job file key: " + key);
+        }
+    }
+
+    if (const JsonValue* execution = json.Find("execution")) {
+        std::string mode = ToLower(GetString("execution", *execution));
+        if (mode == "sequential") {
+            job_file.execution = JobExecutionMode::SEQUENTIAL;
+        } else if (mode == "concurrent") {
+            job_file.execution = JobExecutionMode::CONCURRENT;
+        } else {
+            ThrowInvalid("execution", "expected \"sequential\" or \"concurrent\"");
+        }
+    }
+
+    if (!jobs->IsArray() || jobs->Size() == 0) {
+        ThrowInvalid("jobs", "expected a non-empty array of jobs");
+    }
+
+    const JsonValue* defaults = json.Find("defaults");
+    for (size_t i = 0; i < jobs->Size(); ++i) {
+        const JsonValue& job_json = (*jobs)[i];
+        if (!job_json.IsObject()) {
+            throw std::invalid_argument("Job " + std::to_string(i) + " must be a JSON object");
+        }
+
+        JobDefinition job;
+        job.name = "job" + std::to_string(i);
+
+        // Layers in increasing precedence: defaults, profile file, job keys
+        ProfileDraft draft;
+        if (defaults != nullptr) {
+            ApplySettings(*defaults, draft, true, {});
+        }
+
+        if (const JsonValue* profile_path = job_json.Find("profile")) {
+            std::string path = ResolvePath(base_dir, GetString("profile", *profile_path));
+            JsonValue profile_json = ParseJsonFile(path);
+            try {
+                ApplySettings(profile_json, draft, false, {});
+            } catch (const std::invalid_argument& e) {
+                throw std::invalid_argument(path + ": " + e.what());
+            }
+            const JsonValue* name = profile_json.Find("name");
+            if (name != nullptr && name->IsString()) {
+                job.name = name->AsString();
+            }
+        }
+
+        ApplySettings(job_json, draft, true, {"profile"});
+        const JsonValue* name = job_json.Find("name");
+        if (name != nullptr) {
+            job.name = GetString("name", *name);
+        }
+
+        job.profile = FinishProfile(draft, "Job '" + job.name + "'");
+        job.options = draft.options;
+        job_file.jobs.push_back(job);
+    }
+
+    return job_file;
+}
+
+JobFile LoadJobFile(const std::string& filename) {
+    JsonValue json = ParseJsonFile(filename);
+    try {
+        return ParseJobFile(json, DirectoryOf(filename));
+    } catch (const std::invalid_argument& e) {
+        throw std::invalid_argument(filename + ": " + e.what());
+    }
+}
+
+JobFileRunner::JobFileRunner(struct spdk_nvme_ctrlr *ctrlr, const JobFile& job_file)
+    : job_file_(job_file)
+    , stop_requested_(false) {
+
+    if (job_file_.jobs.empty()) {
+        throw std::invalid_argument("Job file contains no jobs");
+    }
+
+    // JobRunner validates the controller, profile and options of each job
+    for (const auto& job : job_file_.jobs) {
+        try {
+            runners_.push_back(std::make_unique<JobRunner>(ctrlr, job.profile, job.options));
+        } catch (const std::invalid_argument& e) {
+            throw std::invalid_argument("Job '" + job.name + "': " + e.what());
+        }
+    }
+}
+
+JobFileRunner::~JobFileRunner() {
+    Stop();
+}
+
+bool JobFileRunner::Run() {
+    stop_requested_ = false;
+    job_success_.assign(runners_.size(), 0);
+
+    if (job_file_.execution == JobExecutionMode::CONCURRENT) {
+        std::vector<std::thread> threads;
+        threads.reserve(runners_.size());
+        for (size_t i = 0; i < runners_.size(); ++i) {
+            threads.emplace_back(&JobFileRunner::RunJob, this, i);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    } else {
+        for (size_t i = 0; i < runners_.size() && !stop_requested_; ++i) {
+            RunJob(i);
+        }
+    }
+
+    return std::all_of(job_success_.begin(), job_success_.end(),
+                       [](uint8_t success) { return success != 0; });
+}
+
+void JobFileRunner::Stop() {
+    stop_requested_ = true;
+    for (auto& runner : runners_) {
+        runner->Stop();
+    }
+}
+
+double JobFileRunner::GetProgress() const {
+    double progress = 0.0;
+    for (const auto& runner : runners_) {
+        progress += runner->GetProgress();
+    }
+    return progress / runners_.size();
+}
+
+std::vector<WorkloadStats> JobFileRunner::GetResults() const {
+    std::vector<WorkloadStats> results;
+    results.reserve(runners_.size());
+    for (const auto& runner : runners_) {
+        results.push_back(runner->GetResults());
+    }
+    return results;
+}
+
+const JobFile& JobFileRunner::GetJobFile() const {
+    return job_file_;
+}
+
+void JobFileRunner::RunJob(size_t job_index) {
+    if (stop_requested_) {
+        return;
+    }
+
+    std::cout << "Running job '" << job_file_.jobs[job_index].name << "'" << std::endl;
+    job_success_[job_index] = runners_[job_index]->Run() ? 1 : 0;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,309 @@
+#include "../../include/benchmarking/job_runner.h"
+#include "../../include/benchmarking/spdk_backend.h"
+#include <iostream>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <cctype>
+
+#ifndef __APPLE__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nvmeof {
+namespace benchmarking {
+
+JobRunner::JobRunner(struct spdk_nvme_ctrlr *ctrlr,
+                     const WorkloadProfile& profile,
+                     const JobOptions& options)
+    : ctrlr_(ctrlr)
+    , profile_(profile)
+    , options_(options)
+    , stop_requested_(false)
+    , finished_workers_(0) {
+
+    if (ctrlr_ == nullptr && options_.backend.engine == IoEngine::SPDK) {
+        throw std::invalid_argument("NVMe controller cannot be null");
+    }
+    
+    if (!options_.backend.IsValid()) {
+        throw std::invalid_argument("Invalid I/O backend options");
+    }
+
+    if (!profile_.IsValid()) {
+        throw std::invalid_argument("Invalid workload profile");
+    }
+
+    if (options_.num_threads == 0) {
+        throw std::invalid_argument("Number of threads must be greater than zero");
+    }
+
+    if (profile_.total_size < options_.num_threads) {
+        throw std::invalid_argument("Total size is too small for the number of threads");
+    }
+
+    if (options_.range_mode == LbaRangeMode::DISJOINT &&
+        profile_.num_blocks < options_.num_threads) {
+        throw std::invalid_argument("Not enough blocks for a disjoint range per thread");
+    }
+
+    if (!options_.core_mask.empty()) {
+        cores_ = ParseCoreMask(options_.core_mask);
+    }
+}
+
+JobRunner::~JobRunner() {
+    Stop();
+}
+
+bool JobRunner::Run() {
+    // stop_requested_ is left alone: a Stop() issued as Run() starts must not be lost
+    finished_workers_ = 0;
+    worker_stats_.assign(options_.num_threads, WorkloadStats());
+    worker_success_.assign(options_.num_threads, 0);
+
+    std::vector<std::thread> workers;
+    workers.reserve(options_.num_threads);
+    for (uint32_t i = 0; i < options_.num_threads; ++i) {
+        workers.emplace_back(&JobRunner::RunWorker, this, i);
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return std::all_of(worker_success_.begin(), worker_success_.end(),
+                       [](uint8_t success) { return success != 0; });
+}
+
+void JobRunner::Stop() {
+    stop_requested_ = true;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto* generator : generators_) {
+        generator->Stop();
+    }
+}
+
+double JobRunner::GetProgress() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    double progress = finished_workers_;
+    for (const auto* generator : generators_) {
+        progress += generator->GetProgress();
+    }
+    return std::min(1.0, progress / options_.num_threads);
+}
+
+WorkloadStats JobRunner::GetResults() const {
+    WorkloadStats merged;
+    for (const auto& stats : worker_stats_) {
+        merged.Merge(stats);
+    }
+    return merged;
+}
+
+std::vector<WorkloadStats> JobRunner::GetWorkerResults() const {
+    return worker_stats_;
+}
+
+WorkloadProfile JobRunner::GetWorkerProfile(uint32_t worker_index) const {
+    if (worker_index >= options_.num_threads) {
+        throw std::out_of_range("Worker index out of range");
+    }
+
+    const uint32_t num_workers = options_.num_threads;
+    const bool is_last = (worker_index == num_workers - 1);
+    WorkloadProfile worker_profile = profile_;
+
+    // Split the byte budget evenly; the last worker takes the remainder
+    uint64_t size_share = profile_.total_size / num_workers;
+    worker_profile.total_size = is_last
+        ? profile_.total_size - size_share * (num_workers - 1)
+        : size_share;
+
+    // Rate caps apply to the whole job, so each worker paces its own share
+    uint64_t iops_share = profile_.rate_iops / num_workers;
+    worker_profile.rate_iops = is_last
+        ? profile_.rate_iops - iops_share * (num_workers - 1)
+        : iops_share;
+    if (profile_.rate_iops > 0 && worker_profile.rate_iops == 0) {
+        // A zero share would disable the cap altogether
+        worker_profile.rate_iops = 1;
+    }
+    worker_profile.rate_mbps = profile_.rate_mbps / num_workers;
+    worker_profile.arrival_rate = profile_.arrival_rate / num_workers;
+
+    // A replayed trace is divided by record instead of by range, so every
+    // worker keeps the job's range and the trace's addresses
+    worker_profile.trace_worker = worker_index;
+    worker_profile.trace_workers = num_workers;
+
+    if (options_.range_mode == LbaRangeMode::DISJOINT && profile_.trace_file.empty()) {
+        uint32_t blocks_share = profile_.num_blocks / num_workers;
+        worker_profile.start_block = profile_.start_block +
+                                     static_cast<uint64_t>(blocks_share) * worker_index;
+        worker_profile.num_blocks = is_last
+            ? profile_.num_blocks - blocks_share * (num_workers - 1)
+            : blocks_share;
+    }
+
+    return worker_profile;
+}
+
+std::vector<int> JobRunner::ParseCoreMask(const std::string& core_mask) {
+    std::set<int> cores;
+
+    if (core_mask.size() > 2 && core_mask[0] == '0' &&
+        (core_mask[1] == 'x' || core_mask[1] == 'X')) {
+        // Hexadecimal bit mask, least significant bit is CPU 0
+        int bit = 0;
+        for (auto it = core_mask.rbegin(); it != core_mask.rend() - 2; ++it) {
+            char c = static_cast<char>(std::tolower(static_cast<unsigned char>(*it)));
+            int nibble;
+            if (c >= '0' && c <= '9') {
+                nibble = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                nibble = c - 'a' + 10;
+            } else {
+                throw std::invalid_argument("Invalid core mask: " + core_mask);
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                if (nibble & (1 << i)) {
+                    cores.insert(bit + i);
+                }
+            }
+            bit += 4;
+        }
+    } else {
+        // List of CPUs and ranges
+        std::istringstream iss(core_mask);
+        std::string item;
+        while (std::getline(iss, item, ',')) {
+            try {
+                size_t dash = item.find('-');
+                size_t pos = 0;
+                if (dash == std::string::npos) {
+                    int cpu = std::stoi(item, &pos);
+                    if (pos != item.size() || cpu < 0) {
+                        throw std::invalid_argument(item);
+                    }
+                    cores.insert(cpu);
+                } else {
+                    std::string first_str = item.substr(0, dash);
+                    std::string last_str = item.substr(dash + 1);
+                    int first = std::stoi(first_str, &pos);
+                    if (pos != first_str.size()) {
+                        throw std::invalid_argument(item);
+                    }
+                    int last = std::stoi(last_str, &pos);
+                    if (pos != last_str.size() || first < 0 || last < first) {
+                        throw std::invalid_argument(item);
+                    }
+                    for (int cpu = first; cpu <= last; ++cpu) {
+                        cores.insert(cpu);
+                    }
+                }
+            } catch (const std::exception&) {
+                throw std::invalid_argument("Invalid core mask: " + core_mask);
+            }
+        }
+    }
+
+    if (cores.empty()) {
+        throw std::invalid_argument("Core mask selects no CPU: " + core_mask);
+    }
+
+    return std::vector<int>(cores.begin(), cores.end());
+}
+
+void JobRunner::RunWorker(uint32_t worker_index) {
+    if (!cores_.empty()) {
+        int cpu = cores_[worker_index % cores_.size()];
+        if (!PinCurrentThread(cpu)) {
+            std::cerr << "Warning: Failed to pin worker " << worker_index
+                     << " to CPU " << cpu << std::endl;
+        }
+    }
+
+    WorkloadProfile worker_profile = GetWorkerProfile(worker_index);
+
+    // Each worker owns its queue pair (or kernel ring); neither may be shared between threads
+    struct spdk_nvme_qpair *qpair = nullptr;
+    std::shared_ptr<IoBackend> backend;
+    try {
+        if (options_.backend.engine == IoEngine::SPDK) {
+            struct spdk_nvme_io_qpair_opts opts;
+            spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr_, &opts, sizeof(opts));
+            opts.io_queue_requests = std::max(opts.io_queue_requests, worker_profile.queue_depth);
+            
+            // Batched workers let the next poll ring one doorbell for the whole batch
+            opts.delay_cmd_submit = worker_profile.submit_batch > 1;
+
+            qpair = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, &opts, sizeof(opts));
+            if (qpair == nullptr) {
+                std::cerr << "Error: Failed to allocate I/O queue pair for worker "
+                         << worker_index << std::endl;
+                ++finished_workers_;
+                return;
+            }
+            backend = std::make_shared<SpdkBackend>(ctrlr_, qpair, worker_profile.namespace_id,
+                                                    opts.delay_cmd_submit);
+        } else {
+            backend = IoBackend::Create(options_.backend, worker_profile.queue_depth,
+                                        worker_profile.namespace_id);
+        }
+
+        WorkloadGenerator generator(backend, worker_profile);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            generators_.push_back(&generator);
+        }
+
+        bool success = !stop_requested_ && generator.Generate();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            generators_.erase(std::remove(generators_.begin(), generators_.end(), &generator),
+                              generators_.end());
+        }
+
+        worker_stats_[worker_index] = generator.GetStats();
+        worker_success_[worker_index] = success ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error in worker " << worker_index << ": " << e.what() << std::endl;
+    }
+
+    // Freeing the queue pair aborts commands a failed run left on it through
+    // the backend's callbacks, so the backend must outlive it
+    if (qpair != nullptr) {
+        spdk_nvme_ctrlr_free_io_qpair(qpair);
+    }
+    backend.reset();
+    ++finished_workers_;
+}
+
+bool JobRunner::PinCurrentThread(int cpu) {
+#ifdef __APPLE__
+    // macOS has no API for hard thread-to-CPU binding
+    (void)cpu;
+    return false;
+#else
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#endif
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,132 @@
+#include "../../include/benchmarking/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+int HighestBit(uint64_t value) {
+    return 63 - __builtin_clzll(value);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(kSubBucketCount + (kMaxValueBits - kSubBucketBits) * (kSubBucketCount / 2), 0)
+    , total_count_(0)
+    , min_(std::numeric_limits<uint64_t>::max())
+    , max_(0)
+    , sum_(0.0) {
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+    if (value < kSubBucketCount) {
+        return static_cast<size_t>(value);
+    }
+
+    value = std::min<uint64_t>(value, (1ULL << kMaxValueBits) - 1);
+
+    // Keep the top kSubBucketBits bits of the value; each doubling of the
+    // magnitude adds one group of kSubBucketCount / 2 buckets
+    int shift = HighestBit(value) - (kSubBucketBits - 1);
+    uint64_t sub_bucket = value >> shift;
+    return static_cast<size_t>(kSubBucketCount + (shift - 1) * (kSubBucketCount / 2) +
+                               (sub_bucket - kSubBucketCount / 2));
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+
+    size_t offset = index - kSubBucketCount;
+    int shift = static_cast<int>(offset / (kSubBucketCount / 2)) + 1;
+    uint64_t sub_bucket = offset % (kSubBucketCount / 2) + kSubBucketCount / 2;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value_ns) {
+    ++counts_[BucketIndex(value_ns)];
+    ++total_count_;
+    min_ = std::min(min_, value_ns);
+    max_ = std::max(max_, value_ns);
+    sum_ += static_cast<double>(value_ns);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_count_ += other.total_count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+    sum_ = 0.0;
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    return total_count_;
+}
+
+uint64_t LatencyHistogram::GetMin() const {
+    return total_count_ == 0 ? 0 : min_;
+}
+
+uint64_t LatencyHistogram::GetMax() const {
+    return max_;
+}
+
+double LatencyHistogram::GetMean() const {
+    if (total_count_ == 0) {
+        return 0.0;
+    }
+    return sum_ / static_cast<double>(total_count_);
+}
+
+uint64_t LatencyHistogram::GetValueAtPercentile(double percentile) const {
+    if (total_count_ == 0) {
+        return 0;
+    }
+
+    percentile = std::min(100.0, std::max(0.0, percentile));
+    uint64_t target = static_cast<uint64_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(total_count_)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        cumulative += counts_[i];
+        if (cumulative >= target) {
+            return std::max(min_, std::min(BucketHighestValue(i), max_));
+        }
+    }
+
+    return max_;
+}
+
+LatencySummary LatencyHistogram::GetSummary() const {
+    LatencySummary summary;
+    summary.count = total_count_;
+    summary.mean = GetMean();
+    summary.min = GetMin();
+    summary.p50 = GetValueAtPercentile(50.0);
+    summary.p90 = GetValueAtPercentile(90.0);
+    summary.p99 = GetValueAtPercentile(99.0);
+    summary.p999 = GetValueAtPercentile(99.9);
+    summary.p9999 = GetValueAtPercentile(99.99);
+    summary.max = GetMax();
+    return summary;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,312 @@
+#include "../../include/benchmarking/libaio_backend.h"
+#include <iostream>
+#include <stdexcept>
+#include <deque>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/aio_abi.h>)
+#define NVMEOF_HAVE_LINUX_AIO 1
+#endif
+#endif
+
+#ifdef NVMEOF_HAVE_LINUX_AIO
+#include <linux/aio_abi.h>
+#include <sys/syscall.h>
+#endif
+
+namespace nvmeof {
+namespace benchmarking {
+
+#ifdef NVMEOF_HAVE_LINUX_AIO
+
+namespace {
+
+int AioSetup(unsigned nr_events, aio_context_t* context) {
+    return static_cast<int>(syscall(__NR_io_setup, nr_events, context));
+}
+
+int AioDestroy(aio_context_t context) {
+    return static_cast<int>(syscall(__NR_io_destroy, context));
+}
+
+int AioSubmit(aio_context_t context, long nr, struct iocb** iocbs) {
+    return static_cast<int>(syscall(__NR_io_submit, context, nr, iocbs));
+}
+
+int AioGetEvents(aio_context_t context, long min_nr, long nr, struct io_event* events,
+                 struct timespec* timeout) {
+    return static_cast<int>(syscall(__NR_io_getevents, context, min_nr, nr, events, timeout));
+}
+
+}  // namespace
+
+struct LibaioBackend::AioState {
+    /**
+     * @brief Control block of a command; its address is the iocb's aio_data.
+     */
+    struct PendingIo {
+        struct iocb iocb;      ///< Kernel control block
+        IoBackendCallback cb;  ///< Caller's callback
+        void* cb_arg;          ///< Caller's argument
+        uint32_t length;       ///< Expected transfer size, to detect short I/O
+    };
+
+    std::deque<PendingIo> pending;        ///< All entries; a deque keeps their addresses stable
+    std::vector<PendingIo*> free_pending; ///< Entries available for new commands
+    std::vector<struct iocb*> queued;     ///< Commands not yet passed to the kernel, in order
+    std::vector<struct io_event> events;  ///< Completion buffer for io_getevents()
+};
+
+#else
+
+struct LibaioBackend::AioState {
+};
+
+#endif
+
+LibaioBackend::LibaioBackend(const IoBackendOptions& options, uint32_t queue_depth)
+    : options_(options)
+    , queue_depth_(queue_depth)
+    , fd_(-1)
+    , context_(0)
+    , sector_size_(0)
+    , size_(0)
+    , in_flight_(0)
+    , submit_calls_(0)
+    , state_(std::make_unique<AioState>()) {
+
+    if (options_.engine != IoEngine::LIBAIO || !options_.IsValid()) {
+        throw std::invalid_argument("Invalid libaio backend options");
+    }
+
+    if (queue_depth_ == 0) {
+        throw std::invalid_argument("Queue depth must be greater than zero");
+    }
+}
+
+LibaioBackend::~LibaioBackend() {
+    Close();
+}
+
+bool LibaioBackend::Open() {
+    if (context_ != 0) {
+        return true;
+    }
+
+#ifdef NVMEOF_HAVE_LINUX_AIO
+    fd_ = OpenBackendFile(options_, &size_, &sector_size_);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    aio_context_t context = 0;
+    if (AioSetup(queue_depth_, &context) != 0) {
+        std::cerr << "Error: Failed to set up an AIO context: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+    context_ = context;
+
+    state_->queued.reserve(queue_depth_);
+    state_->events.resize(queue_depth_);
+    in_flight_ = 0;
+    submit_calls_ = 0;
+    return true;
+#else
+    std::cerr << "Error: Linux AIO is not available on this platform" << std::endl;
+    return false;
+#endif
+}
+
+bool LibaioBackend::Close() {
+    bool drained = true;
+#ifdef NVMEOF_HAVE_LINUX_AIO
+    // io_destroy() cancels what it can and blocks until the rest has completed
+    if (context_ != 0) {
+        drained = AioDestroy(context_) == 0;
+        context_ = 0;
+    }
+    state_->queued.clear();
+#endif
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    return drained;
+}
+
+std::string LibaioBackend::GetName() const {
+    return "libaio";
+}
+
+uint32_t LibaioBackend::GetSectorSize() const {
+    return sector_size_;
+}
+
+uint64_t LibaioBackend::GetSize() const {
+    return size_;
+}
+
+uint64_t LibaioBackend::GetSubmitCalls() const {
+    return submit_calls_;
+}
+
+int LibaioBackend::SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                              IoBackendCallback cb, void* cb_arg) {
+    return Submit(false, buffer, offset, length, cb, cb_arg);
+}
+
+int LibaioBackend::SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                               IoBackendCallback cb, void* cb_arg) {
+    return Submit(true, buffer, offset, length, cb, cb_arg);
+}
+
+int LibaioBackend::Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+                          IoBackendCallback cb, void* cb_arg) {
+#ifdef NVMEOF_HAVE_LINUX_AIO
+    if (context_ == 0) {
+        return -EBADF;
+    }
+
+    // The context holds queue_depth events; more outstanding commands would be refused
+    if (in_flight_ >= queue_depth_) {
+        return -ENOMEM;
+    }
+
+    AioState::PendingIo* pending;
+    if (state_->free_pending.empty()) {
+        state_->pending.emplace_back();
+        pending = &state_->pending.back();
+    } else {
+        pending = state_->free_pending.back();
+        state_->free_pending.pop_back();
+    }
+    pending->cb = cb;
+    pending->cb_arg = cb_arg;
+    pending->length = length;
+
+    struct iocb* iocb = &pending->iocb;
+    std::memset(iocb, 0, sizeof(*iocb));
+    iocb->aio_data = reinterpret_cast<uint64_t>(pending);
+    iocb->aio_lio_opcode = is_write ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+    iocb->aio_fildes = static_cast<uint32_t>(fd_);
+    iocb->aio_buf = reinterpret_cast<uint64_t>(buffer);
+    iocb->aio_nbytes = length;
+    iocb->aio_offset = static_cast<int64_t>(offset);
+
+    state_->queued.push_back(iocb);
+    ++in_flight_;
+
+    // The command is queued either way; a failed flush is reported by ProcessCompletions()
+    if (state_->queued.size() >= options_.submit_batch) {
+        Flush();
+    }
+    return 0;
+#else
+    (void)is_write;
+    (void)buffer;
+    (void)offset;
+    (void)length;
+    (void)cb;
+    (void)cb_arg;
+    return -ENOSYS;
+#endif
+}
+
+int LibaioBackend::Flush() {
+#ifdef NVMEOF_HAVE_LINUX_AIO
+    std::vector<struct iocb*>& queued = state_->queued;
+    size_t done = 0;
+    while (done < queued.size()) {
+        ++submit_calls_;
+        int submitted = AioSubmit(context_, static_cast<long>(queued.size() - done), &queued[done]);
+        if (submitted <= 0) {
+            if (submitted == 0 || errno == EAGAIN || errno == EINTR) {
+                // Retried on the next flush once completions are reaped
+                break;
+            }
+            int rc = -errno;
+            queued.erase(queued.begin(), queued.begin() + static_cast<long>(done));
+            return rc;
+        }
+        done += static_cast<size_t>(submitted);
+    }
+    queued.erase(queued.begin(), queued.begin() + static_cast<long>(done));
+    return 0;
+#else
+    return -ENOSYS;
+#endif
+}
+
+int32_t LibaioBackend::ProcessCompletions(uint32_t max_completions) {
+    return Reap(max_completions, 0);
+}
+
+int32_t LibaioBackend::WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) {
+    return Reap(max_completions, timeout_ns);
+}
+
+int32_t LibaioBackend::Reap(uint32_t max_completions, uint64_t timeout_ns) {
+#ifdef NVMEOF_HAVE_LINUX_AIO
+    if (context_ == 0) {
+        return -EBADF;
+    }
+
+    // Partial batches are submitted here so they never wait for more commands
+    int rc = Flush();
+    if (rc < 0) {
+        return rc;
+    }
+
+    if (in_flight_ == 0) {
+        return 0;
+    }
+
+    long limit = static_cast<long>(state_->events.size());
+    if (max_completions > 0 && max_completions < state_->events.size()) {
+        limit = static_cast<long>(max_completions);
+    }
+
+    // With a timeout the kernel puts the thread to sleep until the first event
+    struct timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(timeout_ns / 1000000000ULL);
+    timeout.tv_nsec = static_cast<long>(timeout_ns % 1000000000ULL);
+    int reaped = AioGetEvents(context_, timeout_ns > 0 ? 1 : 0, limit, state_->events.data(), &timeout);
+    if (reaped < 0) {
+        return errno == EINTR ? 0 : -errno;
+    }
+
+    for (int i = 0; i < reaped; ++i) {
+        const struct io_event& event = state_->events[static_cast<size_t>(i)];
+        auto* pending = reinterpret_cast<AioState::PendingIo*>(event.data);
+        --in_flight_;
+
+        // Recycle the entry first: the callback may submit again
+        IoBackendCallback cb = pending->cb;
+        void* cb_arg = pending->cb_arg;
+        uint32_t length = pending->length;
+        state_->free_pending.push_back(pending);
+
+        int status = 0;
+        if (event.res < 0) {
+            status = static_cast<int>(event.res);
+        } else if (static_cast<uint64_t>(event.res) != length) {
+            status = -EIO;  // Short transfer, e.g. past the end of the file
+        }
+        cb(cb_arg, status);
+    }
+    return reaped;
+#else
+    (void)max_completions;
+    (void)timeout_ns;
+    return -ENOSYS;
+#endif
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,517 @@
+#include "../../include/benchmarking/loopback_target.h"
+#include "../../include/benchmarking/capsule_protocol.h"
+#include "../../include/benchmarking/spdk_backend.h"
+#include "../../include/benchmarking/dma_buffer_pool.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <memory>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// How long idle threads sleep in poll() before checking for Stop()
+constexpr int kIdlePollMs = 50;
+
+// Receive space beyond the largest PDU, so several capsules arrive per recv()
+constexpr size_t kReceiveSlack = 64 * 1024;
+
+const char kUnixPrefix[] = "unix:";
+
+template <typename Pdu>
+void AppendPdu(std::vector<uint8_t>& buffer, const Pdu& pdu) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&pdu);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(pdu));
+}
+
+/**
+ * @brief State of one host connection: its queue pair, buffers and commands.
+ */
+class TargetConnection {
+public:
+    TargetConnection(struct spdk_nvme_ctrlr *ctrlr, int fd, uint32_t max_data_size)
+        : ctrlr_(ctrlr)
+        , fd_(fd)
+        , max_data_size_(max_data_size)
+        , qpair_(nullptr)
+        , namespace_id_(0)
+        , sector_size_(0)
+        , outstanding_(0)
+        , rx_(sizeof(capsule::DataPdu) + max_data_size + kReceiveSlack)
+        , rx_start_(0)
+        , rx_end_(0)
+        , tx_offset_(0)
+        , closing_(false) {
+    }
+
+    ~TargetConnection() {
+        // Commands still on the queue pair reference the slots and buffers
+        while (outstanding_ > 0 && backend_->ProcessCompletions(0) >= 0) {
+        }
+        backend_.reset();
+        if (qpair_ != nullptr) {
+            spdk_nvme_ctrlr_free_io_qpair(qpair_);
+        }
+    }
+
+    TargetConnection(const TargetConnection&) = delete;
+    TargetConnection& operator=(const TargetConnection&) = delete;
+
+    /**
+     * @brief Runs one iteration: receive and execute capsules, reap completions, send responses.
+     *
+     * @return false once the connection should be closed
+     */
+    bool Poll() {
+        struct pollfd pfd;
+        pfd.fd = fd_;
+        pfd.events = static_cast<short>(POLLIN | (tx_offset_ < tx_.size() ? POLLOUT : 0));
+        pfd.revents = 0;
+
+        // Spin while commands are executing; otherwise sleep until the host sends something
+        int rc = poll(&pfd, 1, outstanding_ > 0 ? 0 : kIdlePollMs);
+        if (rc < 0 && errno != EINTR) {
+            return false;
+        }
+
+        if (rc > 0 && (pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+            if (!Receive()) {
+                return false;
+            }
+        }
+
+        if (backend_ && backend_->ProcessCompletions(0) < 0) {
+            return false;
+        }
+
+        return Flush() && !(closing_ && tx_offset_ >= tx_.size());
+    }
+
+private:
+    /**
+     * @brief A command slot, indexed by command identifier.
+     */
+    struct Slot {
+        TargetConnection* connection = nullptr; ///< Owning connection
+        uint16_t cid = 0;                      ///< Command identifier
+        bool active = false;                   ///< Received and not yet answered
+        bool awaiting_data = false;            ///< Write waiting for its H2C data PDU
+        bool is_write = false;                 ///< Write rather than read
+        uint64_t offset = 0;                   ///< Byte offset on the namespace
+        uint32_t length = 0;                   ///< Bytes transferred
+        uint16_t status = 0;                   ///< Error to report once rejected write data arrives
+        void* buffer = nullptr;                ///< Buffer from the pool while active
+    };
+
+    // Read from the socket and handle every complete PDU
+    bool Receive() {
+        if (rx_start_ > 0) {
+            std::memmove(rx_.data(), rx_.data() + rx_start_, rx_end_ - rx_start_);
+            rx_end_ -= rx_start_;
+            rx_start_ = 0;
+        }
+
+        ssize_t bytes = recv(fd_, rx_.data() + rx_end_, rx_.size() - rx_end_, MSG_DONTWAIT);
+        if (bytes == 0) {
+            return false;
+        }
+        if (bytes < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        rx_end_ += static_cast<size_t>(bytes);
+
+        while (rx_end_ - rx_start_ >= sizeof(capsule::PduHeader)) {
+            capsule::PduHeader header;
+            std::memcpy(&header, rx_.data() + rx_start_, sizeof(header));
+            if (header.hlen != capsule::GetPduHeaderLength(header.type) ||
+                header.plen < header.hlen || header.plen > rx_.size()) {
+                std::cerr << "Error: Malformed PDU of type " << static_cast<int>(header.type)
+                         << " from the host" << std::endl;
+                return false;
+            }
+            if (rx_end_ - rx_start_ < header.plen) {
+                break;
+            }
+            if (!HandlePdu(header, rx_.data() + rx_start_)) {
+                return false;
+            }
+            rx_start_ += header.plen;
+        }
+        return true;
+    }
+
+    bool HandlePdu(const capsule::PduHeader& header, const uint8_t* pdu) {
+        switch (static_cast<capsule::PduType>(header.type)) {
+            case capsule::PduType::IC_REQ:
+                return HandleIcReq(pdu);
+            case capsule::PduType::CAPSULE_CMD:
+                return HandleCommand(pdu);
+            case capsule::PduType::H2C_DATA:
+                return HandleData(header, pdu);
+            default:
+                std::cerr << "Error: Unexpected PDU of type " << static_cast<int>(header.type)
+                         << " from the host" << std::endl;
+                return false;
+        }
+    }
+
+    bool HandleIcReq(const uint8_t* pdu) {
+        capsule::IcReqPdu request;
+        std::memcpy(&request, pdu, sizeof(request));
+        if (backend_) {
+            std::cerr << "Error: Repeated ICReq from the host" << std::endl;
+            return false;
+        }
+
+        auto response = capsule::MakePdu<capsule::IcRespPdu>(capsule::PduType::IC_RESP);
+        response.pfv = capsule::kProtocolVersion;
+        response.status = Connect(request);
+        if (response.status == capsule::kStatusSuccess) {
+            response.sector_size = sector_size_;
+            response.num_sectors = backend_->GetSize() / sector_size_;
+            response.max_data_size = max_data_size_;
+        } else {
+            // Close once the refusal has been sent
+            closing_ = true;
+        }
+        AppendPdu(tx_, response);
+        return true;
+    }
+
+    // Bind the connection to a namespace and allocate its queue pair and buffers
+    uint16_t Connect(const capsule::IcReqPdu& request) {
+        if (request.pfv != capsule::kProtocolVersion || request.queue_depth == 0) {
+            return capsule::kStatusInvalidField;
+        }
+
+        struct spdk_nvme_io_qpair_opts opts;
+        spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr_, &opts, sizeof(opts));
+        if (opts.io_queue_requests < request.queue_depth) {
+            opts.io_queue_requests = request.queue_depth;
+        }
+        qpair_ = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, &opts, sizeof(opts));
+        if (qpair_ == nullptr) {
+            std::cerr << "Error: Failed to allocate an I/O queue pair for a connection" << std::endl;
+            return capsule::kStatusInternalError;
+        }
+
+        auto backend = std::make_unique<SpdkBackend>(ctrlr_, qpair_, request.namespace_id);
+        if (!backend->Open() || backend->GetSectorSize() > max_data_size_) {
+            return capsule::kStatusInvalidNamespace;
+        }
+
+        try {
+            pool_ = std::make_unique<DmaBufferPool>(max_data_size_, request.queue_depth);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: Failed to allocate connection buffers: " << e.what() << std::endl;
+            return capsule::kStatusInternalError;
+        }
+
+        backend_ = std::move(backend);
+        namespace_id_ = request.namespace_id;
+        sector_size_ = backend_->GetSectorSize();
+        slots_.resize(request.queue_depth);
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].connection = this;
+            slots_[i].cid = static_cast<uint16_t>(i);
+        }
+        return capsule::kStatusSuccess;
+    }
+
+    bool HandleCommand(const uint8_t* pdu) {
+        capsule::CapsuleCmdPdu command;
+        std::memcpy(&command, pdu, sizeof(command));
+        if (!backend_ || command.cid >= slots_.size() || slots_[command.cid].active) {
+            std::cerr << "Error: Unexpected command " << command.cid << " from the host" << std::endl;
+            return false;
+        }
+
+        Slot& slot = slots_[command.cid];
+        slot.active = true;
+
+        bool is_write = command.opcode == capsule::kOpcodeWrite;
+        uint16_t status = capsule::kStatusSuccess;
+        if (command.namespace_id != namespace_id_) {
+            status = capsule::kStatusInvalidNamespace;
+        } else if ((!is_write && command.opcode != capsule::kOpcodeRead) ||
+                   command.nlb == 0 || command.data_length == 0 ||
+                   command.data_length > max_data_size_ ||
+                   static_cast<uint64_t>(command.nlb) * sector_size_ != command.data_length) {
+            status = capsule::kStatusInvalidField;
+        }
+
+        if (status != capsule::kStatusSuccess) {
+            if (is_write) {
+                // The write data is still coming; it is discarded when it arrives
+                slot.awaiting_data = true;
+                slot.is_write = true;
+                slot.length = command.data_length;
+                slot.status = status;
+            } else {
+                Respond(slot, status);
+            }
+            return true;
+        }
+
+        slot.is_write = is_write;
+        slot.status = capsule::kStatusSuccess;
+        slot.offset = command.slba * sector_size_;
+        slot.length = command.data_length;
+        slot.buffer = pool_->Acquire();
+
+        if (is_write) {
+            slot.awaiting_data = true;
+            return true;
+        }
+        Execute(slot);
+        return true;
+    }
+
+    bool HandleData(const capsule::PduHeader& header, const uint8_t* pdu) {
+        capsule::DataPdu data;
+        std::memcpy(&data, pdu, sizeof(data));
+        if (data.cid >= slots_.size() || !slots_[data.cid].awaiting_data ||
+            data.data_offset != 0 || data.data_length != slots_[data.cid].length ||
+            header.plen != header.hlen + data.data_length) {
+            std::cerr << "Error: Unexpected write data for command " << data.cid << std::endl;
+            return false;
+        }
+
+        Slot& slot = slots_[data.cid];
+        slot.awaiting_data = false;
+        if (slot.status != capsule::kStatusSuccess) {
+            Respond(slot, slot.status);
+            return true;
+        }
+
+        std::memcpy(slot.buffer, pdu + header.hlen, data.data_length);
+        Execute(slot);
+        return true;
+    }
+
+    void Execute(Slot& slot) {
+        int rc = slot.is_write
+            ? backend_->SubmitWrite(slot.buffer, slot.offset, slot.length, &TargetConnection::OnComplete, &slot)
+            : backend_->SubmitRead(slot.buffer, slot.offset, slot.length, &TargetConnection::OnComplete, &slot);
+        if (rc != 0) {
+            Respond(slot, capsule::kStatusInternalError);
+            return;
+        }
+        ++outstanding_;
+    }
+
+    static void OnComplete(void* cb_arg, int status) {
+        auto* slot = static_cast<Slot*>(cb_arg);
+        TargetConnection* connection = slot->connection;
+        --connection->outstanding_;
+
+        uint16_t nvme_status = capsule::kStatusSuccess;
+        if (status > 0 && status <= UINT16_MAX) {
+            nvme_status = static_cast<uint16_t>(status);
+        } else if (status != 0) {
+            nvme_status = capsule::kStatusInternalError;
+        }
+
+        if (nvme_status == capsule::kStatusSuccess && !slot->is_write) {
+            auto data = capsule::MakePdu<capsule::DataPdu>(capsule::PduType::C2H_DATA, slot->length);
+            data.cid = slot->cid;
+            data.data_offset = 0;
+            data.data_length = slot->length;
+            AppendPdu(connection->tx_, data);
+            const auto* bytes = static_cast<const uint8_t*>(slot->buffer);
+            connection->tx_.insert(connection->tx_.end(), bytes, bytes + slot->length);
+        }
+        connection->Respond(*slot, nvme_status);
+    }
+
+    void Respond(Slot& slot, uint16_t status) {
+        if (slot.buffer != nullptr) {
+            pool_->Release(slot.buffer);
+            slot.buffer = nullptr;
+        }
+        slot.active = false;
+        slot.awaiting_data = false;
+
+        auto response = capsule::MakePdu<capsule::CapsuleRespPdu>(capsule::PduType::CAPSULE_RESP);
+        response.cid = slot.cid;
+        response.status = status;
+        AppendPdu(tx_, response);
+    }
+
+    // Write as much of the send buffer as the socket takes
+    bool Flush() {
+        while (tx_offset_ < tx_.size()) {
+            ssize_t sent = send(fd_, tx_.data() + tx_offset_, tx_.size() - tx_offset_,
+                                MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (sent < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            tx_offset_ += static_cast<size_t>(sent);
+        }
+        tx_.clear();
+        tx_offset_ = 0;
+        return true;
+    }
+
+    struct spdk_nvme_ctrlr *ctrlr_;          ///< Controller of the exported namespaces
+    int fd_;                                 ///< Connected socket, owned by the caller
+    uint32_t max_data_size_;                 ///< Largest transfer of one command
+    struct spdk_nvme_qpair *qpair_;          ///< Queue pair of this connection
+    std::unique_ptr<SpdkBackend> backend_;   ///< Namespace access, set by the ICReq
+    std::unique_ptr<DmaBufferPool> pool_;    ///< One buffer per command slot
+    uint32_t namespace_id_;                  ///< Namespace bound by the ICReq
+    uint32_t sector_size_;                   ///< Sector size of the namespace
+    uint32_t outstanding_;                   ///< Commands submitted to the namespace
+    std::vector<Slot> slots_;                ///< Command slots, one per identifier
+    std::vector<uint8_t> rx_;                ///< Receive buffer
+    size_t rx_start_;                        ///< Start of the first unparsed PDU in rx_
+    size_t rx_end_;                          ///< End of the received bytes in rx_
+    std::vector<uint8_t> tx_;                ///< Serialized PDUs not yet sent
+    size_t tx_offset_;                       ///< Bytes of tx_ already sent
+    bool closing_;                           ///< Close once tx_ is sent
+};
+
+}  // namespace
+
+LoopbackTarget::LoopbackTarget(struct spdk_nvme_ctrlr *ctrlr,
+                               const std::string& address,
+                               uint32_t max_data_size)
+    : ctrlr_(ctrlr)
+    , address_(address)
+    , max_data_size_(max_data_size)
+    , listen_fd_(-1)
+    , stop_(false)
+    , connections_(0) {
+
+    if (ctrlr_ == nullptr) {
+        throw std::invalid_argument("NVMe controller cannot be null");
+    }
+
+    if (address_.empty()) {
+        throw std::invalid_argument("Target address cannot be empty");
+    }
+
+    if (max_data_size_ == 0) {
+        throw std::invalid_argument("Maximum data size must be greater than zero");
+    }
+}
+
+LoopbackTarget::~LoopbackTarget() {
+    Stop();
+}
+
+bool LoopbackTarget::Start() {
+    if (listen_fd_ >= 0) {
+        return true;
+    }
+
+    std::string bound_address;
+    listen_fd_ = capsule::ListenOnAddress(address_, &bound_address);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    address_ = bound_address;
+
+    stop_ = false;
+    connections_ = 0;
+    accept_thread_ = std::thread(&LoopbackTarget::AcceptLoop, this);
+    return true;
+}
+
+void LoopbackTarget::Stop() {
+    if (listen_fd_ < 0) {
+        return;
+    }
+
+    stop_ = true;
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+
+    // No new connections can start once the accept thread is gone
+    for (auto& thread : connection_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    connection_threads_.clear();
+    finished_connections_.clear();
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+    if (address_.compare(0, sizeof(kUnixPrefix) - 1, kUnixPrefix) == 0) {
+        unlink(address_.c_str() + sizeof(kUnixPrefix) - 1);
+    }
+}
+
+std::string LoopbackTarget::GetAddress() const {
+    return address_;
+}
+
+uint64_t LoopbackTarget::GetConnectionCount() const {
+    return connections_;
+}
+
+size_t LoopbackTarget::GetOpenConnectionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connection_threads_.size();
+}
+
+void LoopbackTarget::AcceptLoop() {
+    while (!stop_) {
+        ReapConnections();
+
+        struct pollfd pfd;
+        pfd.fd = listen_fd_;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, kIdlePollMs) <= 0) {
+            continue;
+        }
+
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) {
+            continue;
+        }
+        ++connections_;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_threads_.emplace_back(&LoopbackTarget::ServeConnection, this, fd);
+    }
+}
+
+void LoopbackTarget::ServeConnection(int fd) {
+    {
+        TargetConnection connection(ctrlr_, fd, max_data_size_);
+        while (!stop_ && connection.Poll()) {
+        }
+    }
+    close(fd);
+
+    // Last step of the thread: the accept thread joins it from here on
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_connections_.push_back(std::this_thread::get_id());
+}
+
+void LoopbackTarget::ReapConnections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::thread::id id : finished_connections_) {
+        auto it = std::find_if(connection_threads_.begin(), connection_threads_.end(),
+                               [id](const std::thread& thread) { return thread.get_id() == id; });
+        if (it != connection_threads_.end()) {
+            it->join();
+            connection_threads_.erase(it);
+        }
+    }
+    finished_connections_.clear();
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,42 @@
+#include "../../include/benchmarking/metric_registry.h"
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+MetricRegistry::MetricRegistry()
+    : count_(0) {
+}
+
+MetricHandle MetricRegistry::Register(const std::string& label, const std::string& units) {
+    std::string key = label;
+    key.push_back('\0');
+    key += units;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    MetricHandle handle = static_cast<MetricHandle>(metrics_.size());
+    metrics_.push_back(Metric{label, units});
+    index_.emplace(std::move(key), handle);
+    count_.store(handle + 1, std::memory_order_release);
+    return handle;
+}
+
+const Metric& MetricRegistry::Get(MetricHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handle >= metrics_.size()) {
+        throw std::out_of_range("Unknown metric handle: " + std::to_string(handle));
+    }
+    return metrics_[handle];
+}
+
+size_t MetricRegistry::GetCount() const {
+    return count_.load(std::memory_order_acquire);
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
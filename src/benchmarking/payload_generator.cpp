@@ -0,0 +1,174 @@
+#include "../../include/benchmarking/payload_generator.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+constexpr int kLanes = 4;
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t Rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+}  // namespace
+
+PayloadPattern ParsePayloadPattern(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "random") {
+        return PayloadPattern::RANDOM;
+    } else if (lower == "zeros" || lower == "zero") {
+        return PayloadPattern::ZEROS;
+    } else if (lower == "repeating" || lower == "repeat") {
+        return PayloadPattern::REPEATING;
+    } else if (lower == "compressible") {
+        return PayloadPattern::COMPRESSIBLE;
+    }
+
+    throw std::invalid_argument("Unknown payload pattern: " + name);
+}
+
+PayloadGenerator::PayloadGenerator(PayloadPattern pattern,
+                                   size_t max_block_size,
+                                   uint32_t compress_percentage,
+                                   uint32_t dedupe_percentage,
+                                   uint64_t seed)
+    : pattern_(pattern)
+    , max_block_size_(max_block_size)
+    , dedupe_percentage_(dedupe_percentage)
+    , next_offset_(0)
+    , sequence_(0)
+    , rng_state_(0) {
+
+    if (max_block_size_ == 0) {
+        throw std::invalid_argument("Payload block size must be greater than zero");
+    }
+
+    if (compress_percentage > 100 || dedupe_percentage > 100) {
+        throw std::invalid_argument("Payload percentages must be between 0 and 100");
+    }
+
+    if (seed == 0) {
+        seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+    }
+    rng_state_ = seed;
+
+    // Large enough that consecutive slices rarely repeat, and always able to
+    // hold two maximum-size slices
+    size_t rounded_block = (max_block_size_ + kChunkSize - 1) / kChunkSize * kChunkSize;
+    pattern_buffer_.resize(std::max(kMinPatternSize, 2 * rounded_block));
+
+    switch (pattern_) {
+        case PayloadPattern::RANDOM:
+            FillRandom(pattern_buffer_.data(), pattern_buffer_.size(), seed);
+            break;
+
+        case PayloadPattern::ZEROS:
+            // Already zero-initialized
+            break;
+
+        case PayloadPattern::REPEATING: {
+            static const uint8_t kRepeat[] = {0xDE, 0xAD, 0xBE, 0xEF};
+            for (size_t i = 0; i < pattern_buffer_.size(); ++i) {
+                pattern_buffer_[i] = kRepeat[i % sizeof(kRepeat)];
+            }
+            break;
+        }
+
+        case PayloadPattern::COMPRESSIBLE: {
+            // Each chunk is a random prefix followed by zeros
+            FillRandom(pattern_buffer_.data(), pattern_buffer_.size(), seed);
+            size_t zero_bytes = kChunkSize * compress_percentage / 100;
+            for (size_t chunk = 0; chunk < pattern_buffer_.size(); chunk += kChunkSize) {
+                std::memset(pattern_buffer_.data() + chunk + (kChunkSize - zero_bytes), 0, zero_bytes);
+            }
+            break;
+        }
+    }
+}
+
+void PayloadGenerator::Fill(void* buffer, size_t size) {
+    size = std::min(size, max_block_size_);
+    uint8_t* dst = static_cast<uint8_t*>(buffer);
+
+    bool duplicate = false;
+    if (dedupe_percentage_ > 0) {
+        duplicate = SplitMix64(rng_state_) % 100 < dedupe_percentage_;
+    }
+
+    if (duplicate) {
+        // Duplicates are byte-identical copies of the first slice
+        std::memcpy(dst, pattern_buffer_.data(), size);
+        return;
+    }
+
+    if (next_offset_ + size > pattern_buffer_.size()) {
+        next_offset_ = 0;
+    }
+    std::memcpy(dst, pattern_buffer_.data() + next_offset_, size);
+    next_offset_ += (size + kChunkSize - 1) / kChunkSize * kChunkSize;
+
+    // Make the block unique so the pattern buffer wrapping around does not
+    // produce accidental duplicates
+    if ((pattern_ == PayloadPattern::RANDOM || pattern_ == PayloadPattern::COMPRESSIBLE) &&
+        size >= sizeof(sequence_)) {
+        ++sequence_;
+        std::memcpy(dst, &sequence_, sizeof(sequence_));
+    }
+}
+
+PayloadPattern PayloadGenerator::GetPattern() const {
+    return pattern_;
+}
+
+void PayloadGenerator::FillRandom(void* buffer, size_t size, uint64_t seed) {
+    uint64_t s0[kLanes], s1[kLanes], s2[kLanes], s3[kLanes];
+    uint64_t seed_state = seed;
+    for (int lane = 0; lane < kLanes; ++lane) {
+        s0[lane] = SplitMix64(seed_state);
+        s1[lane] = SplitMix64(seed_state);
+        s2[lane] = SplitMix64(seed_state);
+        s3[lane] = SplitMix64(seed_state);
+    }
+
+    uint8_t* dst = static_cast<uint8_t*>(buffer);
+    const size_t step = kLanes * sizeof(uint64_t);
+    uint64_t out[kLanes];
+
+    size_t offset = 0;
+    while (offset < size) {
+        // xoshiro256** on each lane; lanes are independent so this vectorizes
+        for (int lane = 0; lane < kLanes; ++lane) {
+            out[lane] = Rotl(s1[lane] * 5, 7) * 9;
+            uint64_t t = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = Rotl(s3[lane], 45);
+        }
+
+        size_t n = std::min(step, size - offset);
+        std::memcpy(dst + offset, out, n);
+        offset += n;
+    }
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,53 @@
+#include "../../include/benchmarking/rate_limiter.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+TokenBucket::TokenBucket(double rate, double burst)
+    : rate_(rate)
+    , burst_(burst)
+    , tokens_(burst)
+    , last_refill_ns_(0) {
+
+    if (!(rate_ > 0.0) || !(burst_ > 0.0)) {
+        throw std::invalid_argument("Token bucket rate and burst must be positive");
+    }
+}
+
+void TokenBucket::Refill(uint64_t now_ns) {
+    // The first refill only establishes the time base
+    if (last_refill_ns_ != 0 && now_ns > last_refill_ns_) {
+        double elapsed = static_cast<double>(now_ns - last_refill_ns_) / 1e9;
+        tokens_ = std::min(burst_, tokens_ + elapsed * rate_);
+    }
+
+    if (now_ns > last_refill_ns_) {
+        last_refill_ns_ = now_ns;
+    }
+}
+
+bool TokenBucket::TryConsume(double tokens) {
+    if (tokens_ < tokens) {
+        return false;
+    }
+
+    tokens_ -= tokens;
+    return true;
+}
+
+double TokenBucket::GetAvailable() const {
+    return tokens_;
+}
+
+double TokenBucket::GetRate() const {
+    return rate_;
+}
+
+double TokenBucket::GetBurst() const {
+    return burst_;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
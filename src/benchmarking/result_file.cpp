@@ -0,0 +1,528 @@
+#include "../../include/benchmarking/result_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'V', 'B', 'R', 'E', 'S', 'L', 'T'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kBlockMagic = 0x4B42564E;   // "NVBK"
+constexpr uint32_t kFooterMagic = 0x5446564E;  // "NVFT"
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(FileHeader) == 32, "Unexpected result file header size");
+
+struct BlockHeader {
+    uint32_t magic;
+    uint32_t record_count;
+    uint32_t dictionary_count;   // Entries first used in this block
+    uint8_t value_type;
+    uint8_t id_width;
+    uint16_t reserved;
+    int64_t first_ns;
+    int64_t last_ns;
+    uint32_t values_offset;      // Column offsets from the start of the block
+    uint32_t ids_offset;
+    uint32_t timestamps_offset;
+    uint32_t timestamps_size;
+    uint64_t block_size;         // Including the header and padding
+};
+static_assert(sizeof(BlockHeader) == 56, "Unexpected result block header size");
+
+struct DictionaryEntry {
+    uint32_t id;
+    uint16_t label_length;
+    uint16_t units_length;
+};
+
+struct FooterHeader {
+    uint32_t magic;
+    uint32_t label_count;
+    uint64_t block_count;
+};
+
+struct FooterEntry {
+    uint16_t label_length;
+    uint16_t units_length;
+};
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t record_count;
+    uint32_t reserved;
+    int64_t first_ns;
+    int64_t last_ns;
+};
+static_assert(sizeof(IndexEntry) == 32, "Unexpected result index entry size");
+
+struct Trailer {
+    uint64_t footer_offset;
+    char magic[8];
+};
+
+size_t AlignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+void AppendBytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+void PadTo8(std::string& out) {
+    out.resize(AlignUp(out.size()), '\0');
+}
+
+// Bytes of a name that fit its 16-bit length, without splitting a UTF-8 character
+uint16_t ClampedLength(const std::string& name) {
+    size_t length = name.size();
+    if (length > ResultFileEncoder::kMaxNameBytes) {
+        length = ResultFileEncoder::kMaxNameBytes;
+        while (length > 0 && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80) {
+            --length;
+        }
+    }
+    return static_cast<uint16_t>(length);
+}
+
+template <typename T>
+bool ReadAt(const uint8_t* data, size_t size, uint64_t offset, T* value) {
+    if (offset > size || size - offset < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(value, data + offset, sizeof(T));
+    return true;
+}
+
+}  // namespace
+
+ResultFileEncoder::ResultFileEncoder(const MetricRegistry& registry)
+    : registry_(registry)
+    , dictionary_written_(0)
+    , offset_(0) {
+    pending_.reserve(kBlockRecords);
+}
+
+void ResultFileEncoder::WriteHeader(std::string& out) {
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(FileHeader);
+    Emit(out, &header, sizeof(header));
+}
+
+void ResultFileEncoder::Append(const DataRecord& record, std::string& out) {
+    pending_.push_back(record);
+    if (pending_.size() >= kBlockRecords) {
+        FlushBlock(out);
+    }
+}
+
+void ResultFileEncoder::FlushBlock(std::string& out) {
+    if (pending_.empty()) {
+        return;
+    }
+
+    BlockHeader header{};
+    header.magic = kBlockMagic;
+    header.record_count = static_cast<uint32_t>(pending_.size());
+    header.first_ns = pending_.front().timestamp_ns;
+    header.last_ns = pending_.front().timestamp_ns;
+
+    bool floats_exact = true;
+    uint32_t max_id = 0;
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        double value = pending_[i].value;
+        floats_exact &= static_cast<double>(static_cast<float>(value)) == value || value != value;
+        max_id = std::max(max_id, pending_[i].metric);
+        header.first_ns = std::min(header.first_ns, pending_[i].timestamp_ns);
+        header.last_ns = std::max(header.last_ns, pending_[i].timestamp_ns);
+    }
+    header.value_type = static_cast<uint8_t>(floats_exact ? ResultValueType::FLOAT : ResultValueType::DOUBLE);
+    header.id_width = max_id < (1u << 8) ? 1 : max_id < (1u << 16) ? 2 : 4;
+    header.dictionary_count = max_id >= dictionary_written_ ? max_id + 1 - dictionary_written_ : 0;
+
+    // Build the block after a placeholder header, then fill in the offsets
+    std::string block(sizeof(BlockHeader), '\0');
+
+    // Handles are dense, so the entries up to the largest one in the block are written together
+    for (uint32_t id = dictionary_written_; id < dictionary_written_ + header.dictionary_count; ++id) {
+        const Metric& metric = registry_.Get(id);
+        DictionaryEntry dictionary_entry{id, ClampedLength(metric.label), ClampedLength(metric.units)};
+        AppendBytes(block, &dictionary_entry, sizeof(dictionary_entry));
+        block.append(metric.label, 0, dictionary_entry.label_length);
+        block.append(metric.units, 0, dictionary_entry.units_length);
+    }
+    dictionary_written_ += header.dictionary_count;
+    PadTo8(block);
+
+    header.values_offset = static_cast<uint32_t>(block.size());
+    for (const DataRecord& record : pending_) {
+        if (floats_exact) {
+            float value = static_cast<float>(record.value);
+            AppendBytes(block, &value, sizeof(value));
+        } else {
+            AppendBytes(block, &record.value, sizeof(record.value));
+        }
+    }
+    PadTo8(block);
+
+    header.ids_offset = static_cast<uint32_t>(block.size());
+    for (const DataRecord& record : pending_) {
+        AppendBytes(block, &record.metric, header.id_width);  // Little-endian: the low bytes come first
+    }
+    PadTo8(block);
+
+    // Timestamps as zigzag varint deltas from the previous point
+    header.timestamps_offset = static_cast<uint32_t>(block.size());
+    int64_t previous = header.first_ns;
+    for (const DataRecord& record : pending_) {
+        int64_t delta = record.timestamp_ns - previous;
+        uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        while (zigzag >= 0x80) {
+            block.push_back(static_cast<char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        block.push_back(static_cast<char>(zigzag));
+        previous = record.timestamp_ns;
+    }
+    header.timestamps_size = static_cast<uint32_t>(block.size() - header.timestamps_offset);
+    PadTo8(block);
+
+    header.block_size = block.size();
+    std::memcpy(&block[0], &header, sizeof(header));
+
+    index_.push_back({offset_, header.record_count, header.first_ns, header.last_ns});
+    Emit(out, block.data(), block.size());
+
+    pending_.clear();
+}
+
+void ResultFileEncoder::Finish(std::string& out) {
+    FlushBlock(out);
+
+    uint64_t footer_offset = offset_;
+    FooterHeader footer{kFooterMagic, dictionary_written_, index_.size()};
+    Emit(out, &footer, sizeof(footer));
+    for (uint32_t id = 0; id < dictionary_written_; ++id) {
+        const Metric& metric = registry_.Get(id);
+        FooterEntry footer_entry{ClampedLength(metric.label), ClampedLength(metric.units)};
+        Emit(out, &footer_entry, sizeof(footer_entry));
+        Emit(out, metric.label.data(), footer_entry.label_length);
+        Emit(out, metric.units.data(), footer_entry.units_length);
+    }
+    Align(out);
+
+    for (const BlockIndexEntry& block : index_) {
+        IndexEntry entry{block.offset, block.record_count, 0, block.first_ns, block.last_ns};
+        Emit(out, &entry, sizeof(entry));
+    }
+
+    Trailer trailer{};
+    trailer.footer_offset = footer_offset;
+    std::memcpy(trailer.magic, kMagic, sizeof(kMagic));
+    Emit(out, &trailer, sizeof(trailer));
+}
+
+size_t ResultFileEncoder::GetPendingCount() const {
+    return pending_.size();
+}
+
+void ResultFileEncoder::Emit(std::string& out, const void* data, size_t size) {
+    AppendBytes(out, data, size);
+    offset_ += size;
+}
+
+void ResultFileEncoder::Align(std::string& out) {
+    static const char padding[8] = {};
+    Emit(out, padding, AlignUp(offset_) - offset_);
+}
+
+double ResultBlock::GetValue(size_t index) const {
+    if (value_type == ResultValueType::FLOAT) {
+        return static_cast<const float*>(values)[index];
+    }
+    return static_cast<const double*>(values)[index];
+}
+
+uint32_t ResultBlock::GetLabelId(size_t index) const {
+    switch (id_width) {
+        case 1:
+            return ids[index];
+        case 2:
+            return reinterpret_cast<const uint16_t*>(ids)[index];
+        default:
+            return reinterpret_cast<const uint32_t*>(ids)[index];
+    }
+}
+
+bool ResultBlock::DecodeTimestamps(std::vector<int64_t>& out) const {
+    out.resize(record_count);
+    int64_t previous = first_ns;
+    size_t position = 0;
+    for (uint32_t i = 0; i < record_count; ++i) {
+        uint64_t zigzag = 0;
+        for (int shift = 0;; shift += 7) {
+            if (position >= timestamps_size || shift > 63) {
+                return false;
+            }
+            uint8_t byte = timestamps[position++];
+            zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        previous += delta;
+        out[i] = previous;
+    }
+    return position == timestamps_size;
+}
+
+ResultFileReader::ResultFileReader()
+    : data_(nullptr)
+    , size_(0)
+    , recovered_(false)
+    , point_count_(0) {
+}
+
+ResultFileReader::~ResultFileReader() {
+    Close();
+}
+
+bool ResultFileReader::IsResultFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool ResultFileReader::Open(const std::string& path) {
+    Close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: Failed to open result file " << path << ": "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+        std::cerr << "Error: " << path << " is not a result file" << std::endl;
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error: Failed to map result file " << path << ": "
+                 << std::strerror(errno) << std::endl;
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = size;
+
+    FileHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.header_size != sizeof(FileHeader)) {
+        std::cerr << "Error: " << path << " is not a valid result file" << std::endl;
+        Close();
+        return false;
+    }
+
+    // Files from interrupted runs have no footer; their blocks are still readable
+    Trailer trailer;
+    bool has_footer = ReadAt(data_, size_, size_ - std::min(size_, sizeof(Trailer)), &trailer) &&
+                      size_ >= sizeof(FileHeader) + sizeof(Trailer) &&
+                      std::memcmp(trailer.magic, kMagic, sizeof(kMagic)) == 0;
+    if (has_footer ? !ReadFooter() : !ScanBlocks()) {
+        std::cerr << "Error: " << path << " is corrupt" << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void ResultFileReader::Close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    recovered_ = false;
+    labels_.clear();
+    units_.clear();
+    blocks_.clear();
+    point_count_ = 0;
+}
+
+bool ResultFileReader::IsRecovered() const {
+    return recovered_;
+}
+
+size_t ResultFileReader::GetLabelCount() const {
+    return labels_.size();
+}
+
+const std::string& ResultFileReader::GetLabel(uint32_t id) const {
+    return labels_[id];
+}
+
+const std::string& ResultFileReader::GetUnits(uint32_t id) const {
+    return units_[id];
+}
+
+size_t ResultFileReader::GetBlockCount() const {
+    return blocks_.size();
+}
+
+const ResultBlock& ResultFileReader::GetBlock(size_t index) const {
+    return blocks_[index];
+}
+
+uint64_t ResultFileReader::GetPointCount() const {
+    return point_count_;
+}
+
+bool ResultFileReader::ReadFooter() {
+    Trailer trailer;
+    std::memcpy(&trailer, data_ + size_ - sizeof(Trailer), sizeof(trailer));
+    uint64_t end = size_ - sizeof(Trailer);
+
+    FooterHeader footer;
+    if (trailer.footer_offset < sizeof(FileHeader) || trailer.footer_offset % 8 != 0 ||
+        !ReadAt(data_, end, trailer.footer_offset, &footer) || footer.magic != kFooterMagic) {
+        return false;
+    }
+
+    uint64_t offset = trailer.footer_offset + sizeof(footer);
+    for (uint32_t i = 0; i < footer.label_count; ++i) {
+        FooterEntry entry;
+        if (!ReadAt(data_, end, offset, &entry)) {
+            return false;
+        }
+        offset += sizeof(entry);
+        if (end - offset < static_cast<uint64_t>(entry.label_length) + entry.units_length) {
+            return false;
+        }
+        labels_.emplace_back(reinterpret_cast<const char*>(data_ + offset), entry.label_length);
+        offset += entry.label_length;
+        units_.emplace_back(reinterpret_cast<const char*>(data_ + offset), entry.units_length);
+        offset += entry.units_length;
+    }
+    offset = AlignUp(offset);
+
+    if (offset > end || (end - offset) / sizeof(IndexEntry) != footer.block_count) {
+        return false;
+    }
+    for (uint64_t i = 0; i < footer.block_count; ++i) {
+        IndexEntry entry;
+        std::memcpy(&entry, data_ + offset + i * sizeof(IndexEntry), sizeof(entry));
+        if (entry.offset >= trailer.footer_offset || !ParseBlock(entry.offset, false, nullptr) ||
+            blocks_.back().record_count != entry.record_count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ResultFileReader::ScanBlocks() {
+    recovered_ = true;
+    uint64_t offset = sizeof(FileHeader);
+    while (offset < size_ && ParseBlock(offset, true, &offset)) {
+    }
+    return true;
+}
+
+bool ResultFileReader::ParseBlock(uint64_t offset, bool read_dictionary, uint64_t* next_offset) {
+    BlockHeader header;
+    if (offset % 8 != 0 || !ReadAt(data_, size_, offset, &header) || header.magic != kBlockMagic ||
+        header.block_size > size_ - offset || header.block_size < sizeof(BlockHeader)) {
+        return false;
+    }
+
+    size_t value_size = header.value_type == static_cast<uint8_t>(ResultValueType::FLOAT) ? 4 : 8;
+    if (header.value_type > static_cast<uint8_t>(ResultValueType::FLOAT) ||
+        (header.id_width != 1 && header.id_width != 2 && header.id_width != 4) ||
+        header.values_offset % 8 != 0 || header.ids_offset % 8 != 0 ||
+        header.values_offset < sizeof(BlockHeader) ||
+        header.ids_offset < header.values_offset + static_cast<uint64_t>(header.record_count) * value_size ||
+        header.timestamps_offset < header.ids_offset + static_cast<uint64_t>(header.record_count) * header.id_width ||
+        header.timestamps_offset + static_cast<uint64_t>(header.timestamps_size) > header.block_size) {
+        return false;
+    }
+
+    const uint8_t* block = data_ + offset;
+    if (read_dictionary) {
+        uint64_t position = sizeof(BlockHeader);
+        for (uint32_t i = 0; i < header.dictionary_count; ++i) {
+            DictionaryEntry entry;
+            if (!ReadAt(block, header.values_offset, position, &entry) || entry.id != labels_.size()) {
+                return false;
+            }
+            position += sizeof(entry);
+            if (header.values_offset - position < static_cast<uint64_t>(entry.label_length) + entry.units_length) {
+                return false;
+            }
+            labels_.emplace_back(reinterpret_cast<const char*>(block + position), entry.label_length);
+            position += entry.label_length;
+            units_.emplace_back(reinterpret_cast<const char*>(block + position), entry.units_length);
+            position += entry.units_length;
+        }
+    }
+
+    ResultBlock result;
+    result.record_count = header.record_count;
+    result.first_ns = header.first_ns;
+    result.last_ns = header.last_ns;
+    result.value_type = static_cast<ResultValueType>(header.value_type);
+    result.id_width = header.id_width;
+    result.values = block + header.values_offset;
+    result.ids = block + header.ids_offset;
+    result.timestamps = block + header.timestamps_offset;
+    result.timestamps_size = header.timestamps_size;
+
+    // Every label id must be in the dictionary
+    for (uint32_t i = 0; i < result.record_count; ++i) {
+        if (result.GetLabelId(i) >= labels_.size()) {
+            return false;
+        }
+    }
+
+    blocks_.push_back(result);
+    point_count_ += header.record_count;
+    if (next_offset != nullptr) {
+        *next_offset = offset + header.block_size;
+    }
+    return true;
+}
+
+std::string FormatResultTimestamp(int64_t timestamp_ns) {
+    std::time_t time = static_cast<std::time_t>(timestamp_ns / 1000000000);
+    std::tm local_time;
+    localtime_r(&time, &local_time);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &local_time);
+    return text;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -1,4 +1,6 @@
 #include "../../include/benchmarking/result_visualizer.h"
+#include "../../include/benchmarking/result_file.h"
+#include "../../include/benchmarking/stream_compression.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -19,8 +21,14 @@ ResultVisualizer::ResultVisualizer(const std::string& input_file)
 }
 
 void ResultVisualizer::Visualize() {
-    std::ifstream file(input_file_);
-    if (!file.is_open()) {
+    if (ResultFileReader::IsResultFile(input_file_)) {
+        VisualizeBinary();
+        return;
+    }
+
+    std::unique_ptr<std::istream> stream = OpenResultStream(input_file_);
+    std::istream& file = *stream;
+    if (!file) {
         std::cerr << "Error opening file: " << input_file_ << std::endl;
         return;
     }
@@ -71,7 +79,6 @@ void ResultVisualizer::Visualize() {
         data_points.push_back(fields);
     }
 
-    file.close();
 
     if (data_points.empty()) {
         std::cout << "No data points found." << std::endl;
@@ -100,5 +107,39 @@ void ResultVisualizer::Visualize() {
     }
 }
 
+void ResultVisualizer::VisualizeBinary() {
+    ResultFileReader reader;
+    if (!reader.Open(input_file_)) {
+        return;
+    }
+
+    if (reader.GetPointCount() == 0) {
+        std::cout << "No data points found." << std::endl;
+        return;
+    }
+
+    // Print benchmark results
+    std::cout << "Benchmark Results:" << std::endl;
+    std::cout << std::left << std::setw(25) << "Timestamp" 
+              << std::setw(20) << "Data Point" 
+              << std::setw(15) << "Value"
+              << "Units" << std::endl;
+    std::cout << std::string(70, '-') << std::endl;
+
+    int64_t last_second = -1;
+    std::string timestamp;
+    reader.ForEachPoint([&](int64_t timestamp_ns, uint32_t id, double value) {
+        if (timestamp_ns / 1000000000 != last_second) {
+            last_second = timestamp_ns / 1000000000;
+            timestamp = FormatResultTimestamp(timestamp_ns);
+        }
+        std::cout << std::left 
+                  << std::setw(25) << timestamp 
+                  << std::setw(20) << reader.GetLabel(id)
+                  << std::setw(15) << value
+                  << reader.GetUnits(id) << std::endl;
+    });
+}
+
 }  // namespace benchmarking
 }  // namespace nvmeof
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "../../include/benchmarking/spdk_backend.h"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+
+namespace nvmeof {
+namespace benchmarking {
+
+SpdkBackend::SpdkBackend(const struct spdk_nvme_ctrlr *ctrlr,
+                         const struct spdk_nvme_qpair *qpair,
+                         uint32_t namespace_id,
+                         bool delay_cmd_submit)
+    : ctrlr_(ctrlr)
+    // Need to remove const qualifier for the mock SPDK library
+    , qpair_(const_cast<struct spdk_nvme_qpair*>(qpair))
+    , namespace_id_(namespace_id)
+    , ns_(nullptr)
+    , sector_size_(0)
+    , delay_cmd_submit_(delay_cmd_submit)
+    , unrung_(0)
+    , doorbells_(0) {
+
+    if (ctrlr_ == nullptr) {
+        throw std::invalid_argument("NVMe controller cannot be null");
+    }
+
+    if (qpair_ == nullptr) {
+        throw std::invalid_argument("NVMe queue pair cannot be null");
+    }
+}
+
+bool SpdkBackend::Open() {
+    ns_ = spdk_nvme_ctrlr_get_ns(ctrlr_, namespace_id_);
+    if (ns_ == nullptr) {
+        std::cerr << "Error: Namespace " << namespace_id_ << " not found" << std::endl;
+        return false;
+    }
+
+    sector_size_ = spdk_nvme_ns_get_sector_size(ns_);
+    if (sector_size_ == 0) {
+        std::cerr << "Error: Invalid sector size" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool SpdkBackend::Close() {
+    // The caller is done with every command still outstanding
+    for (auto& pending : pending_) {
+        pending.cb = nullptr;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kCloseTimeoutMs);
+    while (pending_.size() > free_pending_.size()) {
+        if (ProcessCompletions(0) < 0 || std::chrono::steady_clock::now() >= deadline) {
+            std::cerr << "Error: " << pending_.size() - free_pending_.size()
+                      << " commands still outstanding on the queue pair" << std::endl;
+            return false;
+        }
+    }
+
+    ns_ = nullptr;
+    return true;
+}
+
+std::string SpdkBackend::GetName() const {
+    return "spdk";
+}
+
+uint32_t SpdkBackend::GetSectorSize() const {
+    return sector_size_;
+}
+
+uint64_t SpdkBackend::GetSize() const {
+    return ns_ != nullptr ? spdk_nvme_ns_get_size(ns_) : 0;
+}
+
+SpdkBackend::PendingIo* SpdkBackend::AcquirePending() {
+    if (free_pending_.empty()) {
+        pending_.push_back(PendingIo{this, nullptr, nullptr});
+        return &pending_.back();
+    }
+    PendingIo* pending = free_pending_.back();
+    free_pending_.pop_back();
+    return pending;
+}
+
+int SpdkBackend::SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                            IoBackendCallback cb, void* cb_arg) {
+    PendingIo* pending = AcquirePending();
+    pending->cb = cb;
+    pending->cb_arg = cb_arg;
+
+    int rc = spdk_nvme_ns_cmd_read(ns_, qpair_, buffer, offset / sector_size_, length / sector_size_,
+                                   CompletionCallback, pending, 0);
+    if (rc != 0) {
+        free_pending_.push_back(pending);
+    } else if (delay_cmd_submit_) {
+        ++unrung_;
+    } else {
+        ++doorbells_;
+    }
+    return rc;
+}
+
+int SpdkBackend::SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                             IoBackendCallback cb, void* cb_arg) {
+    PendingIo* pending = AcquirePending();
+    pending->cb = cb;
+    pending->cb_arg = cb_arg;
+
+    int rc = spdk_nvme_ns_cmd_write(ns_, qpair_, buffer, offset / sector_size_, length / sector_size_,
+                                    CompletionCallback, pending, 0);
+    if (rc != 0) {
+        free_pending_.push_back(pending);
+    } else if (delay_cmd_submit_) {
+        ++unrung_;
+    } else {
+        ++doorbells_;
+    }
+    return rc;
+}
+
+int32_t SpdkBackend::ProcessCompletions(uint32_t max_completions) {
+    // With delay_cmd_submit the poll writes one doorbell for everything queued
+    if (unrung_ > 0) {
+        ++doorbells_;
+        unrung_ = 0;
+    }
+    return spdk_nvme_qpair_process_completions(qpair_, max_completions);
+}
+
+uint64_t SpdkBackend::GetSubmitCalls() const {
+    return doorbells_;
+}
+
+void SpdkBackend::CompletionCallback(void* arg, const struct spdk_nvme_cpl* completion) {
+    auto* pending = static_cast<PendingIo*>(arg);
+
+    // Recycle the entry first: the caller's callback may submit again
+    IoBackendCallback cb = pending->cb;
+    void* cb_arg = pending->cb_arg;
+    pending->backend->free_pending_.push_back(pending);
+    if (cb == nullptr) {
+        return;
+    }
+
+    int status = 0;
+    if (spdk_nvme_cpl_is_error(completion)) {
+        status = (completion->status.sct << 8) | completion->status.sc;
+        if (status == 0) {
+            status = -EIO;
+        }
+    }
+    cb(cb_arg, status);
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
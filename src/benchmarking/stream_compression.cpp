@@ -0,0 +1,317 @@
+#include "../../include/benchmarking/stream_compression.h"
+#include "../../include/utils/crc32c.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'V', 'L', 'Z', 'S', 'T', 'R', 'M'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kFrameMagic = 0x464C564E;  // "NVLF"
+
+// 2^14 entries of 4 bytes keep the table in L2 while covering the window well
+constexpr int kHashBits = 14;
+
+// Past this many bytes without a match, the search skips ahead faster
+constexpr int kSkipShift = 6;
+
+struct StreamHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+static_assert(sizeof(StreamHeader) == 16, "Unexpected compressed stream header size");
+
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t raw_size;
+    uint32_t stored_size;  // Equal to raw_size when the frame is stored uncompressed
+    uint32_t crc;          // CRC-32C of the raw bytes
+};
+static_assert(sizeof(FrameHeader) == 16, "Unexpected compressed frame header size");
+
+uint32_t Load32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+void AppendLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+void AppendSequence(std::string& out, const uint8_t* literals, size_t literal_length,
+                    size_t offset, size_t match_length) {
+    size_t match_code = match_length > 0 ? match_length - LzCodec::kMinMatch : 0;
+    uint8_t token = static_cast<uint8_t>((std::min<size_t>(literal_length, 15) << 4) |
+                                        std::min<size_t>(match_code, 15));
+    out.push_back(static_cast<char>(token));
+    if (literal_length >= 15) {
+        AppendLength(out, literal_length - 15);
+    }
+    out.append(reinterpret_cast<const char*>(literals), literal_length);
+    if (match_length == 0) {
+        return;
+    }
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) {
+        AppendLength(out, match_code - 15);
+    }
+}
+
+// Reads a 255-run length extension; false if the input ends first
+bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+}  // namespace
+
+CompressionMode ParseCompressionMode(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "none") {
+        return CompressionMode::NONE;
+    } else if (lower == "lz") {
+        return CompressionMode::LZ;
+    }
+
+    throw std::invalid_argument("Unknown compression mode: " + name);
+}
+
+const char* GetCompressionExtension(CompressionMode mode) {
+    return mode == CompressionMode::LZ ? ".nvlz" : "";
+}
+
+LzCodec::LzCodec()
+    : table_(size_t(1) << kHashBits) {
+}
+
+void LzCodec::Compress(const char* data, size_t size, std::string& out) {
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(data);
+    std::fill(table_.begin(), table_.end(), 0);
+
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + kMinMatch <= size) {
+        uint32_t sequence = Load32(base + position);
+        uint32_t& slot = table_[Hash(sequence)];
+        size_t candidate = slot;  // Position + 1; 0 marks an empty slot
+        slot = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position + 1 - candidate > kMaxOffset ||
+            Load32(base + candidate - 1) != sequence) {
+            position += 1 + ((position - anchor) >> kSkipShift);
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t length = kMinMatch;
+        while (position + length < size && base[match + length] == base[position + length]) {
+            ++length;
+        }
+        AppendSequence(out, base + anchor, position - anchor, position - match, length);
+        position += length;
+        anchor = position;
+    }
+    AppendSequence(out, base + anchor, size - anchor, 0, 0);
+}
+
+bool LzCodec::Decompress(const char* data, size_t size, size_t raw_size, char* out) {
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = in + size;
+    size_t produced = 0;
+
+    while (in < end) {
+        uint8_t token = *in++;
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !ReadLength(in, end, literal_length)) {
+            return false;
+        }
+        if (literal_length > static_cast<size_t>(end - in) || literal_length > raw_size - produced) {
+            return false;
+        }
+        std::memcpy(out + produced, in, literal_length);
+        in += literal_length;
+        produced += literal_length;
+
+        // The last sequence of a block has no match
+        if (in == end) {
+            break;
+        }
+
+        if (end - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !ReadLength(in, end, match_length)) {
+            return false;
+        }
+        match_length += kMinMatch;
+        if (offset == 0 || offset > produced || match_length > raw_size - produced) {
+            return false;
+        }
+
+        // Byte by byte, since a match may overlap the bytes it produces
+        const char* source = out + produced - offset;
+        for (size_t i = 0; i < match_length; ++i) {
+            out[produced + i] = source[i];
+        }
+        produced += match_length;
+    }
+    return produced == raw_size;
+}
+
+void CompressedStreamEncoder::WriteHeader(std::string& out) {
+    StreamHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void CompressedStreamEncoder::EncodeFrame(const char* data, size_t size, std::string& out) {
+    scratch_.clear();
+    codec_.Compress(data, size, scratch_);
+
+    FrameHeader header{};
+    header.magic = kFrameMagic;
+    header.raw_size = static_cast<uint32_t>(size);
+    header.crc = utils::Crc32c::Compute(data, size);
+
+    // Incompressible frames are stored as they are
+    bool stored_raw = scratch_.size() >= size;
+    header.stored_size = static_cast<uint32_t>(stored_raw ? size : scratch_.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (stored_raw) {
+        out.append(data, size);
+    } else {
+        out += scratch_;
+    }
+}
+
+CompressedFileStream::FrameBuffer::FrameBuffer(const std::string& path)
+    : path_(path)
+    , file_(path, std::ios::binary)
+    , open_(false)
+    , truncated_(false) {
+    StreamHeader header;
+    if (file_.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion) {
+        open_ = true;
+    }
+}
+
+bool CompressedFileStream::FrameBuffer::IsOpen() const {
+    return open_;
+}
+
+bool CompressedFileStream::FrameBuffer::IsTruncated() const {
+    return truncated_;
+}
+
+CompressedFileStream::FrameBuffer::int_type CompressedFileStream::FrameBuffer::underflow() {
+    while (gptr() == egptr()) {
+        if (!open_ || truncated_ || !ReadFrame()) {
+            return traits_type::eof();
+        }
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+bool CompressedFileStream::FrameBuffer::ReadFrame() {
+    FrameHeader header;
+    file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (file_.gcount() == 0) {
+        return false;
+    }
+    if (file_.gcount() != sizeof(header)) {
+        return Truncate("incomplete frame header");
+    }
+    if (header.magic != kFrameMagic || header.raw_size > CompressedStreamEncoder::kMaxFrameBytes ||
+        header.stored_size > header.raw_size) {
+        return Truncate("corrupt frame header");
+    }
+
+    compressed_.resize(header.stored_size);
+    if (!file_.read(&compressed_[0], static_cast<std::streamsize>(compressed_.size()))) {
+        return Truncate("incomplete frame");
+    }
+
+    if (header.raw_size == 0) {
+        return true;
+    }
+    frame_.resize(header.raw_size);
+    if (header.stored_size == header.raw_size) {
+        std::memcpy(frame_.data(), compressed_.data(), compressed_.size());
+    } else if (!LzCodec::Decompress(compressed_.data(), compressed_.size(), frame_.size(), frame_.data())) {
+        return Truncate("corrupt frame");
+    }
+    if (utils::Crc32c::Compute(frame_.data(), frame_.size()) != header.crc) {
+        return Truncate("frame checksum mismatch");
+    }
+
+    setg(frame_.data(), frame_.data(), frame_.data() + frame_.size());
+    return true;
+}
+
+bool CompressedFileStream::FrameBuffer::Truncate(const char* reason) {
+    truncated_ = true;
+    std::cerr << "Warning: " << path_ << " ends with an unreadable frame (" << reason
+              << "); read up to the last intact frame" << std::endl;
+    return false;
+}
+
+CompressedFileStream::CompressedFileStream(const std::string& path)
+    : std::istream(nullptr)
+    , buffer_(path) {
+    rdbuf(&buffer_);
+    if (!buffer_.IsOpen()) {
+        setstate(std::ios::failbit);
+    }
+}
+
+bool CompressedFileStream::IsTruncated() const {
+    return buffer_.IsTruncated();
+}
+
+bool IsCompressedFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+std::unique_ptr<std::istream> OpenResultStream(const std::string& path) {
+    if (IsCompressedFile(path)) {
+        return std::make_unique<CompressedFileStream>(path);
+    }
+    return std::make_unique<std::ifstream>(path);
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,126 @@
+#include "../../include/benchmarking/sync_backend.h"
+#include <stdexcept>
+#include <cerrno>
+#include <unistd.h>
+
+namespace nvmeof {
+namespace benchmarking {
+
+SyncBackend::SyncBackend(const IoBackendOptions& options, uint32_t queue_depth)
+    : options_(options)
+    , queue_depth_(queue_depth)
+    , fd_(-1)
+    , sector_size_(0)
+    , size_(0) {
+
+    if (options_.engine != IoEngine::PSYNC || !options_.IsValid()) {
+        throw std::invalid_argument("Invalid psync backend options");
+    }
+
+    if (queue_depth_ == 0) {
+        throw std::invalid_argument("Queue depth must be greater than zero");
+    }
+}
+
+SyncBackend::~SyncBackend() {
+    Close();
+}
+
+bool SyncBackend::Open() {
+    if (fd_ >= 0) {
+        return true;
+    }
+
+    fd_ = OpenBackendFile(options_, &size_, &sector_size_);
+    return fd_ >= 0;
+}
+
+bool SyncBackend::Close() {
+    // Transfers finish inside the submit call; only their completions are pending
+    completed_.clear();
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    return true;
+}
+
+std::string SyncBackend::GetName() const {
+    return "psync";
+}
+
+uint32_t SyncBackend::GetSectorSize() const {
+    return sector_size_;
+}
+
+uint64_t SyncBackend::GetSize() const {
+    return size_;
+}
+
+int SyncBackend::SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                            IoBackendCallback cb, void* cb_arg) {
+    return Execute(false, buffer, offset, length, cb, cb_arg);
+}
+
+int SyncBackend::SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                             IoBackendCallback cb, void* cb_arg) {
+    return Execute(true, buffer, offset, length, cb, cb_arg);
+}
+
+int SyncBackend::Execute(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+                         IoBackendCallback cb, void* cb_arg) {
+    if (fd_ < 0) {
+        return -EBADF;
+    }
+
+    if (completed_.size() >= queue_depth_) {
+        return -ENOMEM;
+    }
+
+    // Retry interrupted and partial transfers until the end of the file
+    auto* data = static_cast<uint8_t*>(buffer);
+    uint32_t done = 0;
+    int status = 0;
+    while (done < length) {
+        ssize_t transferred = is_write
+            ? pwrite(fd_, data + done, length - done, static_cast<off_t>(offset + done))
+            : pread(fd_, data + done, length - done, static_cast<off_t>(offset + done));
+        if (transferred < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            status = -errno;
+            break;
+        }
+        if (transferred == 0) {
+            status = -EIO;  // Short transfer, e.g. past the end of the file
+            break;
+        }
+        done += static_cast<uint32_t>(transferred);
+    }
+
+    completed_.push_back(CompletedIo{cb, cb_arg, status});
+    return 0;
+}
+
+int32_t SyncBackend::ProcessCompletions(uint32_t max_completions) {
+    if (fd_ < 0) {
+        return -EBADF;
+    }
+
+    // Only the completions present on entry: callbacks may submit (and so complete) more
+    size_t available = completed_.size();
+    if (max_completions > 0 && max_completions < available) {
+        available = max_completions;
+    }
+
+    for (size_t i = 0; i < available; ++i) {
+        CompletedIo completion = completed_.front();
+        completed_.pop_front();
+        completion.cb(completion.cb_arg, completion.status);
+    }
+    return static_cast<int32_t>(available);
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,397 @@
+#include "../../include/benchmarking/tcp_backend.h"
+#include "../../include/benchmarking/capsule_protocol.h"
+#include <iostream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// Receive space beyond the largest PDU, so several small PDUs arrive per recv()
+constexpr size_t kReceiveSlack = 64 * 1024;
+
+template <typename Pdu>
+void AppendPdu(std::vector<uint8_t>& buffer, const Pdu& pdu) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&pdu);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(pdu));
+}
+
+}  // namespace
+
+TcpBackend::TcpBackend(const IoBackendOptions& options, uint32_t queue_depth, uint32_t namespace_id)
+    : options_(options)
+    , queue_depth_(queue_depth)
+    , namespace_id_(namespace_id)
+    , fd_(-1)
+    , sector_size_(0)
+    , size_(0)
+    , max_data_size_(0)
+    , unsent_commands_(0)
+    , tx_offset_(0)
+    , rx_start_(0)
+    , rx_end_(0) {
+
+    if (options_.engine != IoEngine::TCP || !options_.IsValid()) {
+        throw std::invalid_argument("Invalid TCP backend options");
+    }
+
+    if (queue_depth_ == 0 || queue_depth_ > UINT16_MAX) {
+        throw std::invalid_argument("Queue depth must be between 1 and 65535");
+    }
+}
+
+TcpBackend::~TcpBackend() {
+    Close();
+}
+
+bool TcpBackend::Open() {
+    if (fd_ >= 0) {
+        return true;
+    }
+
+    fd_ = capsule::ConnectToAddress(options_.address);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    auto request = capsule::MakePdu<capsule::IcReqPdu>(capsule::PduType::IC_REQ);
+    request.pfv = capsule::kProtocolVersion;
+    request.queue_depth = static_cast<uint16_t>(queue_depth_);
+    request.namespace_id = namespace_id_;
+
+    capsule::IcRespPdu response;
+    if (!capsule::SendAll(fd_, &request, sizeof(request)) ||
+        !capsule::ReceiveAll(fd_, &response, sizeof(response))) {
+        std::cerr << "Error: Connection to " << options_.address << " failed during setup" << std::endl;
+        Close();
+        return false;
+    }
+
+    if (response.header.type != static_cast<uint8_t>(capsule::PduType::IC_RESP) ||
+        response.header.plen != sizeof(response) ||
+        response.pfv != capsule::kProtocolVersion) {
+        std::cerr << "Error: " << options_.address << " did not answer with a valid ICResp" << std::endl;
+        Close();
+        return false;
+    }
+
+    if (response.status != capsule::kStatusSuccess) {
+        std::cerr << "Error: " << options_.address << " refused namespace " << namespace_id_
+                 << " (status 0x" << std::hex << response.status << std::dec << ")" << std::endl;
+        Close();
+        return false;
+    }
+
+    if (response.sector_size == 0 || response.max_data_size < response.sector_size) {
+        std::cerr << "Error: " << options_.address << " reported an invalid geometry" << std::endl;
+        Close();
+        return false;
+    }
+
+    // Everything from here on is polled
+    int flags = fcntl(fd_, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd_, F_SETFL, flags | O_NONBLOCK) != 0) {
+        std::cerr << "Error: Failed to make the socket non-blocking: " << std::strerror(errno) << std::endl;
+        Close();
+        return false;
+    }
+
+    sector_size_ = response.sector_size;
+    size_ = response.num_sectors * response.sector_size;
+    max_data_size_ = response.max_data_size;
+
+    commands_.assign(queue_depth_, Command());
+    free_cids_.clear();
+    for (uint32_t cid = queue_depth_; cid > 0; --cid) {
+        free_cids_.push_back(static_cast<uint16_t>(cid - 1));
+    }
+
+    tx_.clear();
+    tx_.reserve(queue_depth_ * (sizeof(capsule::CapsuleCmdPdu) + sizeof(capsule::DataPdu)));
+    tx_offset_ = 0;
+    rx_.assign(sizeof(capsule::DataPdu) + max_data_size_ + kReceiveSlack, 0);
+    rx_start_ = 0;
+    rx_end_ = 0;
+    unsent_commands_ = 0;
+    stats_ = TransportStats();
+    return true;
+}
+
+bool TcpBackend::Close() {
+    // Data only lands in the caller's buffers from ProcessCompletions()
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    return true;
+}
+
+std::string TcpBackend::GetName() const {
+    return "tcp";
+}
+
+uint32_t TcpBackend::GetSectorSize() const {
+    return sector_size_;
+}
+
+uint64_t TcpBackend::GetSize() const {
+    return size_;
+}
+
+uint32_t TcpBackend::GetMaxDataSize() const {
+    return max_data_size_;
+}
+
+uint64_t TcpBackend::GetSubmitCalls() const {
+    return stats_.send_calls;
+}
+
+const TransportStats& TcpBackend::GetTransportStats() const {
+    return stats_;
+}
+
+int TcpBackend::SubmitRead(void* buffer, uint64_t offset, uint32_t length,
+                           IoBackendCallback cb, void* cb_arg) {
+    return Submit(false, buffer, offset, length, cb, cb_arg);
+}
+
+int TcpBackend::SubmitWrite(void* buffer, uint64_t offset, uint32_t length,
+                            IoBackendCallback cb, void* cb_arg) {
+    return Submit(true, buffer, offset, length, cb, cb_arg);
+}
+
+int TcpBackend::Submit(bool is_write, void* buffer, uint64_t offset, uint32_t length,
+                       IoBackendCallback cb, void* cb_arg) {
+    if (fd_ < 0) {
+        return -EBADF;
+    }
+
+    if (length == 0 || length > max_data_size_ ||
+        length % sector_size_ != 0 || offset % sector_size_ != 0) {
+        return -EINVAL;
+    }
+
+    if (free_cids_.empty()) {
+        return -ENOMEM;
+    }
+
+    uint16_t cid = free_cids_.back();
+    free_cids_.pop_back();
+
+    Command& command = commands_[cid];
+    command.active = true;
+    command.is_write = is_write;
+    command.buffer = buffer;
+    command.length = length;
+    command.received = 0;
+    command.cb = cb;
+    command.cb_arg = cb_arg;
+
+    auto capsule_cmd = capsule::MakePdu<capsule::CapsuleCmdPdu>(capsule::PduType::CAPSULE_CMD);
+    capsule_cmd.opcode = is_write ? capsule::kOpcodeWrite : capsule::kOpcodeRead;
+    capsule_cmd.cid = cid;
+    capsule_cmd.namespace_id = namespace_id_;
+    capsule_cmd.slba = offset / sector_size_;
+    capsule_cmd.nlb = length / sector_size_;
+    capsule_cmd.data_length = length;
+    AppendPdu(tx_, capsule_cmd);
+    ++stats_.pdus_sent;
+
+    if (is_write) {
+        // Write data follows immediately; the target never asks for it (no R2T)
+        auto data = capsule::MakePdu<capsule::DataPdu>(capsule::PduType::H2C_DATA, length);
+        data.cid = cid;
+        data.data_offset = 0;
+        data.data_length = length;
+        AppendPdu(tx_, data);
+        const auto* bytes = static_cast<const uint8_t*>(buffer);
+        tx_.insert(tx_.end(), bytes, bytes + length);
+        ++stats_.pdus_sent;
+    }
+
+    // The command is queued either way; a failed send is reported by ProcessCompletions()
+    if (++unsent_commands_ >= options_.submit_batch) {
+        Flush();
+    }
+    return 0;
+}
+
+int TcpBackend::Flush() {
+    unsent_commands_ = 0;
+    while (tx_offset_ < tx_.size()) {
+        ++stats_.send_calls;
+        ssize_t sent = send(fd_, tx_.data() + tx_offset_, tx_.size() - tx_offset_,
+                            MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                // Retried on the next flush once the target has drained the socket
+                return 0;
+            }
+            return -errno;
+        }
+        stats_.bytes_sent += static_cast<uint64_t>(sent);
+        tx_offset_ += static_cast<size_t>(sent);
+    }
+    tx_.clear();
+    tx_offset_ = 0;
+    return 0;
+}
+
+int32_t TcpBackend::ProcessCompletions(uint32_t max_completions) {
+    if (fd_ < 0) {
+        return -EBADF;
+    }
+
+    // Partial batches are sent here so they never wait for more commands
+    int rc = Flush();
+    if (rc < 0) {
+        return rc;
+    }
+
+    if (free_cids_.size() == queue_depth_) {
+        return 0;
+    }
+
+    int32_t completed = 0;
+    bool received = false;
+    while (max_completions == 0 || static_cast<uint32_t>(completed) < max_completions) {
+        size_t available = rx_end_ - rx_start_;
+        if (available >= sizeof(capsule::PduHeader)) {
+            capsule::PduHeader header;
+            std::memcpy(&header, rx_.data() + rx_start_, sizeof(header));
+            if (header.plen < sizeof(header) || header.plen > rx_.size()) {
+                std::cerr << "Error: Invalid PDU length " << header.plen << " from "
+                         << options_.address << std::endl;
+                return -EPROTO;
+            }
+            if (available >= header.plen) {
+                rc = HandlePdu(rx_.data() + rx_start_, &completed);
+                if (rc < 0) {
+                    return rc;
+                }
+                rx_start_ += header.plen;
+                ++stats_.pdus_received;
+                continue;
+            }
+        }
+
+        // Read once per call; whatever is still in flight is picked up by the next poll
+        if (received) {
+            break;
+        }
+        received = true;
+
+        if (rx_start_ > 0) {
+            std::memmove(rx_.data(), rx_.data() + rx_start_, rx_end_ - rx_start_);
+            rx_end_ -= rx_start_;
+            rx_start_ = 0;
+        }
+
+        ++stats_.recv_calls;
+        ssize_t bytes = recv(fd_, rx_.data() + rx_end_, rx_.size() - rx_end_, MSG_DONTWAIT);
+        if (bytes == 0) {
+            std::cerr << "Error: " << options_.address << " closed the connection" << std::endl;
+            return -ECONNRESET;
+        }
+        if (bytes < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            return -errno;
+        }
+        stats_.bytes_received += static_cast<uint64_t>(bytes);
+        rx_end_ += static_cast<size_t>(bytes);
+    }
+
+    return completed;
+}
+
+int32_t TcpBackend::WaitForCompletions(uint32_t max_completions, uint64_t timeout_ns) {
+    int32_t completed = ProcessCompletions(max_completions);
+    if (completed != 0 || free_cids_.size() == queue_depth_ || timeout_ns == 0) {
+        return completed;
+    }
+
+    // Sleep until the target sends something (or the send buffer drains)
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = static_cast<short>(POLLIN | (tx_offset_ < tx_.size() ? POLLOUT : 0));
+    pfd.revents = 0;
+    struct timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(timeout_ns / 1000000000ULL);
+    timeout.tv_nsec = static_cast<long>(timeout_ns % 1000000000ULL);
+    if (ppoll(&pfd, 1, &timeout, nullptr) < 0 && errno != EINTR) {
+        return -errno;
+    }
+    return ProcessCompletions(max_completions);
+}
+
+int TcpBackend::HandlePdu(const uint8_t* pdu, int32_t* completed) {
+    capsule::PduHeader header;
+    std::memcpy(&header, pdu, sizeof(header));
+
+    if (header.hlen != capsule::GetPduHeaderLength(header.type) || header.plen < header.hlen) {
+        std::cerr << "Error: Malformed PDU of type " << static_cast<int>(header.type)
+                 << " from " << options_.address << std::endl;
+        return -EPROTO;
+    }
+
+    if (header.type == static_cast<uint8_t>(capsule::PduType::C2H_DATA)) {
+        capsule::DataPdu data;
+        std::memcpy(&data, pdu, sizeof(data));
+        if (data.cid >= queue_depth_ || !commands_[data.cid].active || commands_[data.cid].is_write ||
+            header.plen != header.hlen + data.data_length ||
+            data.data_offset != commands_[data.cid].received ||
+            data.data_length > commands_[data.cid].length - data.data_offset) {
+            std::cerr << "Error: Unexpected read data for command " << data.cid << std::endl;
+            return -EPROTO;
+        }
+
+        Command& command = commands_[data.cid];
+        std::memcpy(static_cast<uint8_t*>(command.buffer) + data.data_offset,
+                    pdu + header.hlen, data.data_length);
+        command.received += data.data_length;
+        return 0;
+    }
+
+    if (header.type == static_cast<uint8_t>(capsule::PduType::CAPSULE_RESP)) {
+        capsule::CapsuleRespPdu response;
+        std::memcpy(&response, pdu, sizeof(response));
+        if (response.cid >= queue_depth_ || !commands_[response.cid].active ||
+            header.plen != header.hlen) {
+            std::cerr << "Error: Unexpected response for command " << response.cid << std::endl;
+            return -EPROTO;
+        }
+
+        // Recycle the slot first: the callback may submit again
+        Command& command = commands_[response.cid];
+        command.active = false;
+        IoBackendCallback cb = command.cb;
+        void* cb_arg = command.cb_arg;
+        bool short_read = !command.is_write && command.received != command.length;
+        free_cids_.push_back(response.cid);
+
+        int status = response.status;
+        if (status == 0 && short_read) {
+            status = -EIO;
+        }
+        ++*completed;
+        cb(cb_arg, status);
+        return 0;
+    }
+
+    std::cerr << "Error: Unexpected PDU of type " << static_cast<int>(header.type)
+             << " from " << options_.address << std::endl;
+    return -EPROTO;
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
@@ -0,0 +1,138 @@
+#include "../../include/benchmarking/verify_pipeline.h"
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace nvmeof {
+namespace benchmarking {
+
+namespace {
+
+// Idle helper threads re-check for a stop this often
+constexpr std::chrono::milliseconds kIdleWait(10);
+
+}  // namespace
+
+VerifyPipeline::VerifyPipeline(const BlockVerifier& verifier, uint32_t threads)
+    : verifier_(verifier)
+    , idle_(0)
+    , stop_(false)
+    , pending_(0) {
+
+    if (threads == 0 || threads > kMaxThreads) {
+        throw std::invalid_argument("Verify threads must be between 1 and " +
+                                    std::to_string(kMaxThreads));
+    }
+
+    threads_.reserve(threads);
+    try {
+        for (uint32_t i = 0; i < threads; ++i) {
+            threads_.emplace_back(&VerifyPipeline::WorkerLoop, this);
+        }
+    } catch (...) {
+        StopThreads();
+        throw;
+    }
+}
+
+VerifyPipeline::~VerifyPipeline() {
+    StopThreads();
+}
+
+void VerifyPipeline::StopThreads() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+}
+
+void VerifyPipeline::Push(const Task& task) {
+    staged_.push_back(task);
+    ++pending_;
+}
+
+void VerifyPipeline::Flush() {
+    if (staged_.empty()) {
+        return;
+    }
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.insert(queue_.end(), staged_.begin(), staged_.end());
+        wake = idle_ > 0;
+    }
+    // Busy threads take the new tasks without a wake-up
+    if (wake) {
+        work_cv_.notify_all();
+    }
+    staged_.clear();
+}
+
+size_t VerifyPipeline::Collect(std::vector<Task>& done) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = done_.size();
+    done.insert(done.end(), done_.begin(), done_.end());
+    done_.clear();
+    pending_ -= static_cast<uint32_t>(count);
+    return count;
+}
+
+bool VerifyPipeline::WaitForDone(uint64_t timeout_ns) {
+    Flush();
+    std::unique_lock<std::mutex> lock(mutex_);
+    return done_cv_.wait_for(lock, std::chrono::nanoseconds(timeout_ns),
+                             [this]() { return !done_.empty(); });
+}
+
+uint32_t VerifyPipeline::GetPending() const {
+    return pending_;
+}
+
+VerifyStats VerifyPipeline::TakeStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    VerifyStats stats = std::move(stats_);
+    stats_ = VerifyStats();
+    return stats;
+}
+
+void VerifyPipeline::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (queue_.empty() && !stop_) {
+            ++idle_;
+            work_cv_.wait_for(lock, kIdleWait, [this]() { return stop_ || !queue_.empty(); });
+            --idle_;
+        }
+        if (stop_) {
+            return;
+        }
+        if (queue_.empty()) {
+            continue;
+        }
+        Task task = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+
+        VerifyStats stats;
+        if (task.is_write) {
+            verifier_.Stamp(task.buffer, task.offset, task.size, task.generation);
+        } else {
+            task.failed = verifier_.Verify(task.buffer, task.offset, task.size, stats);
+        }
+
+        lock.lock();
+        if (!task.is_write) {
+            stats_.Merge(stats);
+        }
+        done_.push_back(task);
+        done_cv_.notify_one();
+    }
+}
+
+}  // namespace benchmarking
+}  // namespace nvmeof
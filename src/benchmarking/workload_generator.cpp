@@ -1,45 +1,328 @@
 #include "../../include/benchmarking/workload_generator.h"
+#include "../../include/benchmarking/spdk_backend.h"
+#include "../../include/utils/tsc_clock.h"
 #include <iostream>
 #include <random>
 #include <chrono>
-#include <thread>
 #include <stdexcept>
 #include <cassert>
 #include <algorithm>
+#include <cerrno>
+#include <cctype>
+#include <ctime>
+#include <thread>
 
 namespace nvmeof {
 namespace benchmarking {
 
+namespace {
+
+// Pacing buckets hold at most this much time worth of tokens, which bounds the
+// size of a submission burst after the generator falls behind
+constexpr double kPacingBurstSeconds = 0.001;
+
+// Longest single wait for completions; keeps Stop() responsive in the
+// blocking and hybrid modes
+constexpr uint64_t kMaxCompletionWaitNs = 10000000;
+
+// Longest wait for completions while the verify pipeline holds commands
+constexpr uint64_t kVerifyPollNs = 20000;
+
+uint64_t NowNs() {
+    return utils::TscClock::NowNs();
+}
+
+// CPU time (user + system) consumed by the calling thread; system time covers
+// the kernel I/O path of the kernel engines
+uint64_t ThreadCpuNs() {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+#endif
+    return 0;
+}
+
+void PrintBatches(const char* label, const BatchHistogram& histogram) {
+    if (histogram.GetBatchCount() == 0) {
+        return;
+    }
+    
+    std::cout << label << " batches: mean=" << histogram.GetMean() << " max=" << histogram.GetMax();
+    for (size_t i = 0; i < BatchHistogram::kNumBuckets; ++i) {
+        if (histogram.GetBucketCount(i) == 0) {
+            continue;
+        }
+        uint32_t low = BatchHistogram::GetBucketLowerBound(i);
+        std::cout << " [" << low;
+        if (i + 1 < BatchHistogram::kNumBuckets) {
+            if (low * 2 - 1 > low) {
+                std::cout << "-" << low * 2 - 1;
+            }
+        } else {
+            std::cout << "+";
+        }
+        std::cout << "]=" << histogram.GetBucketCount(i);
+    }
+    std::cout << std::endl;
+}
+
+void PrintVerify(const VerifyStats& verify) {
+    std::cout << "Verify: " << verify.blocks_verified << " blocks verified, "
+             << verify.blocks_unwritten << " unwritten, " << verify.errors << " errors" << std::endl;
+    for (const auto& failure : verify.failures) {
+        std::cout << "  LBA " << failure.lba << ": " << GetVerifyErrorTypeName(failure.type)
+                 << " (header LBA " << failure.header_lba << ", generation " << failure.generation
+                 << ", seed " << failure.seed << std::hex << ", crc 0x" << failure.expected_crc
+                 << " computed 0x" << failure.actual_crc << std::dec << ")" << std::endl;
+    }
+}
+
+void PrintLatency(const char* label, const LatencyHistogram& histogram) {
+    if (histogram.GetCount() == 0) {
+        return;
+    }
+    
+    LatencySummary summary = histogram.GetSummary();
+    std::cout << label << " latency (us): p50=" << summary.p50 / 1e3
+             << " p90=" << summary.p90 / 1e3
+             << " p99=" << summary.p99 / 1e3
+             << " p99.9=" << summary.p999 / 1e3
+             << " p99.99=" << summary.p9999 / 1e3
+             << " max=" << summary.max / 1e3 << std::endl;
+}
+
+}  // namespace
+
+ArrivalMode ParseArrivalMode(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (lower == "closed" || lower == "closed_loop") {
+        return ArrivalMode::CLOSED_LOOP;
+    } else if (lower == "constant") {
+        return ArrivalMode::CONSTANT;
+    } else if (lower == "poisson") {
+        return ArrivalMode::POISSON;
+    }
+    
+    throw std::invalid_argument("Unknown arrival mode: " + name);
+}
+
+CompletionMode ParseCompletionMode(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    
+    if (lower == "poll" || lower == "polling") {
+        return CompletionMode::POLL;
+    } else if (lower == "block" || lower == "interrupt") {
+        return CompletionMode::BLOCK;
+    } else if (lower == "hybrid") {
+        return CompletionMode::HYBRID;
+    }
+    
+    throw std::invalid_argument("Unknown completion mode: " + name);
+}
+
+std::string GetCompletionModeName(CompletionMode mode) {
+    switch (mode) {
+        case CompletionMode::POLL:
+            return "poll";
+        case CompletionMode::BLOCK:
+            return "block";
+        case CompletionMode::HYBRID:
+            return "hybrid";
+    }
+    return "unknown";
+}
+
+void WorkloadStats::Merge(const WorkloadStats& other) {
+    read_ops += other.read_ops;
+    write_ops += other.write_ops;
+    read_bytes += other.read_bytes;
+    write_bytes += other.write_bytes;
+    errors += other.errors;
+    elapsed_seconds = std::max(elapsed_seconds, other.elapsed_seconds);
+    cpu_seconds += other.cpu_seconds;
+    latency_ns_sum += other.latency_ns_sum;
+    latency_ns_max = std::max(latency_ns_max, other.latency_ns_max);
+    service_ns_sum += other.service_ns_sum;
+    service_ns_max = std::max(service_ns_max, other.service_ns_max);
+    completion_waits += other.completion_waits;
+    submit_calls += other.submit_calls;
+    submit_batches.Merge(other.submit_batches);
+    reap_batches.Merge(other.reap_batches);
+    verify.Merge(other.verify);
+    read_latency.Merge(other.read_latency);
+    write_latency.Merge(other.write_latency);
+    
+    for (const auto& other_bucket : other.size_buckets) {
+        BlockSizeStats& bucket = GetSizeBucket(other_bucket.block_size);
+        bucket.read_ops += other_bucket.read_ops;
+        bucket.write_ops += other_bucket.write_ops;
+        bucket.bytes += other_bucket.bytes;
+        bucket.latency.Merge(other_bucket.latency);
+    }
+}
+
+BlockSizeStats& WorkloadStats::GetSizeBucket(uint32_t block_size) {
+    auto it = std::lower_bound(size_buckets.begin(), size_buckets.end(), block_size,
+                               [](const BlockSizeStats& bucket, uint32_t size) {
+                                   return bucket.block_size < size;
+                               });
+    if (it == size_buckets.end() || it->block_size != block_size) {
+        BlockSizeStats bucket;
+        bucket.block_size = block_size;
+        it = size_buckets.insert(it, bucket);
+    }
+    return *it;
+}
+
+double WorkloadStats::GetIops() const {
+    if (elapsed_seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(read_ops + write_ops) / elapsed_seconds;
+}
+
+double WorkloadStats::GetIopsPerCore() const {
+    if (cpu_seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(read_ops + write_ops) / cpu_seconds;
+}
+
+double WorkloadStats::GetCyclesPerIo() const {
+    uint64_t ops = read_ops + write_ops;
+    if (ops == 0) {
+        return 0.0;
+    }
+    return cpu_seconds * static_cast<double>(utils::TscClock::GetTicksPerSecond()) / ops;
+}
+
+double WorkloadStats::GetSubmitCallsPerIo() const {
+    uint64_t ops = read_ops + write_ops;
+    if (ops == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(submit_calls) / ops;
+}
+
+double WorkloadStats::GetThroughputMBps() const {
+    if (elapsed_seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(read_bytes + write_bytes) / elapsed_seconds / 1e6;
+}
+
+double WorkloadStats::GetMeanLatencyUs() const {
+    uint64_t ops = read_ops + write_ops;
+    if (ops == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(latency_ns_sum) / ops / 1e3;
+}
+
+double WorkloadStats::GetMeanServiceTimeUs() const {
+    uint64_t ops = read_ops + write_ops;
+    if (ops == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(service_ns_sum) / ops / 1e3;
+}
+
 WorkloadGenerator::WorkloadGenerator(const struct spdk_nvme_ctrlr *ctrlr, 
                                     const struct spdk_nvme_qpair *qpair,
                                     const WorkloadProfile& profile,
                                     IoCompletionCallback completion_callback)
-    : ctrlr_(ctrlr)
-    , qpair_(qpair)
+    : WorkloadGenerator(std::make_shared<SpdkBackend>(ctrlr, qpair, profile.namespace_id),
+                        profile, completion_callback) {
+}
+
+WorkloadGenerator::WorkloadGenerator(std::shared_ptr<IoBackend> backend,
+                                    const WorkloadProfile& profile,
+                                    IoCompletionCallback completion_callback)
+    : backend_(std::move(backend))
+    , sector_size_(0)
     , profile_(profile)
-    , write_completed_(true)
-    , read_completed_(true)
     , total_bytes_processed_(0)
+    , bytes_submitted_(0)
     , is_running_(false)
+    , stop_requested_(false)
+    , run_start_ns_(0)
+    , time_expired_(false)
+    , hybrid_spinning_(false)
+    , hybrid_wake_ns_(0)
+    , hybrid_empty_polls_(0)
+    , replay_position_(0)
+    , replay_record_count_(0)
+    , in_flight_(0)
+    , submitting_(false)
+    , refill_on_completion_(false)
+    , rng_(std::random_device{}())
+    , max_io_size_(0)
+    , has_next_op_(false)
+    , next_is_read_(false)
+    , next_size_(0)
+    , next_bucket_(0)
+    , next_range_offset_(0)
+    , next_trace_ns_(0)
+    , percent_dist_(1, 100)
     , completion_callback_(completion_callback) {
     
     // Validate parameters
-    if (ctrlr_ == nullptr) {
-        throw std::invalid_argument("NVMe controller cannot be null");
-    }
-    
-    if (qpair_ == nullptr) {
-        throw std::invalid_argument("NVMe queue pair cannot be null");
+    if (backend_ == nullptr) {
+        throw std::invalid_argument("I/O backend cannot be null");
     }
     
     if (!profile_.IsValid()) {
         throw std::invalid_argument("Invalid workload profile");
     }
+    
+    offset_generator_ = OffsetGenerator::Create(profile_.access_pattern, profile_.num_blocks);
+    
+    // Statistics get one bucket per distinct transfer size
+    for (const auto* sizes : {&profile_.read_block_sizes, &profile_.write_block_sizes}) {
+        if (sizes->empty()) {
+            bucket_sizes_.push_back(profile_.block_size);
+        }
+        for (const auto& entry : *sizes) {
+            bucket_sizes_.push_back(entry.block_size);
+        }
+    }
+    std::sort(bucket_sizes_.begin(), bucket_sizes_.end());
+    bucket_sizes_.erase(std::unique(bucket_sizes_.begin(), bucket_sizes_.end()), bucket_sizes_.end());
+    max_io_size_ = bucket_sizes_.back();
+    
+    read_sizes_ = BuildSizeTable(profile_.read_block_sizes);
+    write_sizes_ = BuildSizeTable(profile_.write_block_sizes);
+    if (profile_.arrival_mode == ArrivalMode::POISSON) {
+        interarrival_dist_ = std::exponential_distribution<double>(profile_.arrival_rate);
+    }
+    
+    // One context per queue slot; contexts are never reallocated so their
+    // addresses stay valid while commands are outstanding
+    contexts_.resize(profile_.queue_depth);
+    free_contexts_.reserve(profile_.queue_depth);
+    for (auto& ctx : contexts_) {
+        ctx = IoContext{this, nullptr, 0, 0, false, 0, 0, 0};
+    }
 }
 
 WorkloadGenerator::~WorkloadGenerator() {
     // Ensure workload generation is stopped before destruction
     Stop();
+    
+    // The target may still write into the buffers of commands the backend
+    // could not cancel, so their pool is never freed
+    if (in_flight_ > 0 && buffer_pool_ != nullptr) {
+        std::cerr << "Error: " << in_flight_ << " commands still outstanding; "
+                 << "leaking their buffer pool" << std::endl;
+        static_cast<void>(new std::shared_ptr<DmaBufferPool>(std::move(buffer_pool_)));
+    }
 }
 
 bool WorkloadGenerator::Generate() {
@@ -49,64 +332,315 @@ bool WorkloadGenerator::Generate() {
         return false;
     }
     
+    if (!backend_->Open()) {
+        return false;
+    }
+    
+    sector_size_ = backend_->GetSectorSize();
+    
+    // The addressed range must lie inside the target
+    uint64_t range_end = (profile_.start_block + profile_.num_blocks) * profile_.block_size;
+    if (range_end > backend_->GetSize()) {
+        std::cerr << "Error: Workload range (" << range_end << " bytes) exceeds the size of the "
+                  << backend_->GetName() << " target (" << backend_->GetSize() << " bytes)" << std::endl;
+        return false;
+    }
+    
+    // A replayed trace brings its own transfer sizes, capped at the addressed range
+    trace_cursor_.reset();
+    trace_.reset();
+    if (!profile_.trace_file.empty()) {
+        trace_ = std::make_unique<TraceReader>();
+        if (!trace_->Open(profile_.trace_file)) {
+            trace_.reset();
+            return false;
+        }
+        trace_cursor_ = std::make_unique<TraceCursor>(
+            *trace_, profile_.trace_partition, profile_.trace_worker, profile_.trace_workers);
+        replay_position_ = 0;
+        replay_record_count_ = trace_->GetRecordCount();
+        
+        uint64_t range_size = static_cast<uint64_t>(profile_.num_blocks) * profile_.block_size;
+        uint64_t trace_max = (static_cast<uint64_t>(trace_->GetMaxSize()) + sector_size_ - 1) /
+                             sector_size_ * sector_size_;
+        max_io_size_ = static_cast<uint32_t>(std::max<uint64_t>(
+            max_io_size_, std::min(trace_max, range_size / sector_size_ * sector_size_)));
+    }
+    
+    // Allocate the buffer pool once, sized for a full queue of the largest sector-aligned transfers
+    size_t aligned_block_size = (max_io_size_ + sector_size_ - 1) / sector_size_ * sector_size_;
+    if (buffer_pool_ != nullptr && buffer_pool_->GetBufferSize() < aligned_block_size) {
+        std::cerr << "Error: Buffer pool buffers are smaller than the block size" << std::endl;
+        return false;
+    }
+    
+    try {
+        if (buffer_pool_ == nullptr) {
+            buffer_pool_ = std::make_shared<DmaBufferPool>(
+                aligned_block_size, profile_.queue_depth, sector_size_);
+        }
+        backend_->RegisterBuffers(*buffer_pool_);
+        
+        // Write content is generated once here, not per I/O
+        if (payload_ == nullptr) {
+            payload_ = std::make_unique<PayloadGenerator>(
+                profile_.payload_pattern, aligned_block_size,
+                profile_.compress_percentage, profile_.dedupe_percentage);
+        }
+        
+        // Headers are per logical block so reads of any size and alignment can be checked
+        if (profile_.verify && (verifier_ == nullptr || verifier_->GetBlockSize() != sector_size_)) {
+            verifier_ = std::make_unique<BlockVerifier>(sector_size_, profile_.verify_seed);
+        }
+        verified_.clear();
+        verify_pipeline_.reset();
+        if (profile_.verify && profile_.verify_async > 0) {
+            verify_pipeline_ = std::make_unique<VerifyPipeline>(*verifier_, profile_.verify_async);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+    
+    // An explicit IOPS cap overrides the legacy per-operation interval
+    double iops_cap = static_cast<double>(profile_.rate_iops);
+    if (iops_cap == 0.0 && profile_.interval_us > 0) {
+        iops_cap = 1e6 / profile_.interval_us;
+    }
+    
+    // Open-loop runs are paced by their arrival schedule alone; timed replays
+    // follow the trace's schedule
+    const bool timed_replay = trace_cursor_ != nullptr && profile_.replay_speed > 0.0;
+    const bool open_loop = profile_.arrival_mode != ArrivalMode::CLOSED_LOOP || timed_replay;
+    
+    iops_limiter_.reset();
+    bandwidth_limiter_.reset();
+    if (!open_loop && iops_cap > 0.0) {
+        iops_limiter_ = std::make_unique<TokenBucket>(
+            iops_cap, std::max(1.0, iops_cap * kPacingBurstSeconds));
+    }
+    if (!open_loop && profile_.rate_mbps > 0.0) {
+        double bytes_per_second = profile_.rate_mbps * 1e6;
+        bandwidth_limiter_ = std::make_unique<TokenBucket>(
+            bytes_per_second,
+            std::max(static_cast<double>(max_io_size_), bytes_per_second * kPacingBurstSeconds));
+    }
+    const bool paced = iops_limiter_ != nullptr || bandwidth_limiter_ != nullptr;
+    
+    // Closed-loop runs may hold freed slots until a whole batch can be issued
+    const uint32_t submit_batch = std::min(profile_.submit_batch, profile_.queue_depth);
+    const bool batching = !open_loop && !paced && submit_batch > 1;
+    refill_on_completion_ = !open_loop && !paced && !batching;
+    
     is_running_ = true;
+    time_expired_ = false;
     total_bytes_processed_ = 0;
+    bytes_submitted_ = 0;
+    in_flight_ = 0;
+    has_next_op_ = false;
+    hybrid_spinning_ = false;
+    ResetStats();
     
-    // Set up random number generation
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint32_t> dist(0, profile_.num_blocks - 1);
-    std::uniform_int_distribution<uint32_t> op_dist(1, 100); // For determining read vs write
+    free_contexts_.clear();
+    for (auto& ctx : contexts_) {
+        free_contexts_.push_back(&ctx);
+    }
     
-    auto start_time = std::chrono::high_resolution_clock::now();
+    // A Stop() that arrived during setup ends the run before anything is issued
+    if (stop_requested_) {
+        is_running_ = false;
+        std::cout << "Workload generation stopped." << std::endl;
+        if (completion_callback_) {
+            completion_callback_(true, 0);
+        }
+        return true;
+    }
+    
+    const uint64_t start_ns = NowNs();
+    const uint64_t ramp_end_ns = start_ns + profile_.ramp_time_seconds * 1000000000ULL;
+    const uint64_t deadline_ns = profile_.runtime_seconds > 0
+        ? ramp_end_ns + profile_.runtime_seconds * 1000000000ULL
+        : 0;
+    uint64_t measure_start_ns = start_ns;
+    uint64_t measure_start_cpu_ns = ThreadCpuNs();
+    uint64_t measure_start_submit_calls = backend_->GetSubmitCalls();
+    bool ramping = profile_.ramp_time_seconds > 0;
+    run_start_ns_ = start_ns;
+    uint64_t next_arrival_ns = timed_replay ? GetReplayArrivalNs(start_ns) : start_ns;
     
     try {
-        // Main workload generation loop
-        while (is_running_ && total_bytes_processed_ < profile_.total_size) {
-            // Determine block offset based on randomness percentage
-            uint64_t block_index;
-            if (static_cast<uint32_t>(op_dist(gen)) <= profile_.random_percentage) {
-                // Random access
-                block_index = dist(gen);
-            } else {
-                // Sequential access
-                block_index = (total_bytes_processed_ / profile_.block_size) % profile_.num_blocks;
+        // Main workload generation loop: keep the queue full, then reap completions.
+        // Outstanding commands are always drained, even after Stop(); after an
+        // error they are cancelled by closing the backend.
+        while (in_flight_ > 0 || HasWorkRemaining()) {
+            uint64_t now_ns = NowNs();
+            
+            if (deadline_ns != 0 && now_ns >= deadline_ns) {
+                time_expired_ = true;
+            }
+            
+            // Discard everything completed during the ramp-up
+            if (ramping && now_ns >= ramp_end_ns) {
+                ramping = false;
+                ResetStats();
+                if (verify_pipeline_) {
+                    verify_pipeline_->TakeStats();
+                }
+                measure_start_ns = now_ns;
+                measure_start_cpu_ns = ThreadCpuNs();
+                measure_start_submit_calls = backend_->GetSubmitCalls();
             }
             
-            uint64_t block_offset = block_index * profile_.block_size;
-            uint32_t block_size = std::min(profile_.block_size, 
-                                        static_cast<uint32_t>(profile_.total_size - total_bytes_processed_));
+            // One clock read per pass covers the whole batch of submissions
+            if (paced) {
+                if (iops_limiter_) {
+                    iops_limiter_->Refill(now_ns);
+                }
+                if (bandwidth_limiter_) {
+                    bandwidth_limiter_->Refill(now_ns);
+                }
+            }
             
-            // Determine operation type (read or write)
-            bool is_read = static_cast<uint32_t>(op_dist(gen)) <= profile_.read_percentage;
+            // Stamped writes go to the backend and checked reads free their slots
+            if (verify_pipeline_) {
+                CollectVerified();
+            }
             
-            bool success = false;
-            if (is_read) {
-                success = ReadBlock(block_offset, block_size);
+            uint32_t submitted = 0;
+            if (open_loop) {
+                // Issue every arrival that is due; arrivals that find the queue
+                // full stay pending and keep their scheduled issue time
+                while (HasWorkRemaining() && in_flight_ < profile_.queue_depth &&
+                       next_arrival_ns <= now_ns) {
+                    if (!SubmitNext(next_arrival_ns)) {
+                        break;
+                    }
+                    ++submitted;
+                    next_arrival_ns = timed_replay ? GetReplayArrivalNs(start_ns)
+                                                   : next_arrival_ns + NextInterarrivalNs();
+                }
             } else {
-                success = WriteBlock(block_offset, block_size);
+                // At most one queue's worth per pass: a target that completes
+                // inline would otherwise keep this loop from seeing the deadline.
+                // A batch waits for enough free slots unless the queue has drained.
+                uint32_t limit = batching ? submit_batch : profile_.queue_depth;
+                if (batching && in_flight_ > 0 && profile_.queue_depth - in_flight_ < submit_batch) {
+                    limit = 0;
+                }
+                while (submitted < limit && HasWorkRemaining() &&
+                       in_flight_ < profile_.queue_depth) {
+                    if (!SubmitNext()) {
+                        break;
+                    }
+                    ++submitted;
+                }
             }
+            stats_.submit_batches.Record(submitted);
             
-            if (!success) {
-                std::cerr << "Error: " << (is_read ? "Read" : "Write") << " operation failed at offset " 
-                         << block_offset << " with size " << block_size << std::endl;
-                continue;
+            // Writes pushed by this pass and reads reaped by the last one go to
+            // the helper threads together
+            if (verify_pipeline_) {
+                verify_pipeline_->Flush();
             }
             
-            total_bytes_processed_ += block_size;
-            
-            // Sleep for the specified interval
-            std::this_thread::sleep_for(std::chrono::microseconds(profile_.interval_us));
+            if (in_flight_ > 0) {
+                // The loop must run again by the deadline, the end of the ramp-up,
+                // the next arrival or once the pacing buckets allow a submission
+                uint64_t wake_by_ns = now_ns + kMaxCompletionWaitNs;
+                if (deadline_ns != 0 && !time_expired_) {
+                    wake_by_ns = std::min(wake_by_ns, deadline_ns);
+                }
+                if (ramping) {
+                    wake_by_ns = std::min(wake_by_ns, ramp_end_ns);
+                }
+                if (HasWorkRemaining() && in_flight_ < profile_.queue_depth) {
+                    if (open_loop) {
+                        wake_by_ns = std::min(wake_by_ns, std::max(next_arrival_ns, now_ns));
+                    } else if (paced) {
+                        auto refill_ns = [](const TokenBucket& bucket, double needed) {
+                            double missing = needed - bucket.GetAvailable();
+                            return missing > 0.0
+                                ? static_cast<uint64_t>(missing / bucket.GetRate() * 1e9) : 0;
+                        };
+                        uint64_t wait_ns = 0;
+                        if (iops_limiter_) {
+                            wait_ns = refill_ns(*iops_limiter_, 1.0);
+                        }
+                        if (bandwidth_limiter_) {
+                            wait_ns = std::max(wait_ns, refill_ns(*bandwidth_limiter_,
+                                                                  has_next_op_ ? next_size_ : max_io_size_));
+                        }
+                        wake_by_ns = std::min(wake_by_ns, now_ns + wait_ns);
+                    }
+                }
+                
+                // Commands with the verify pipeline are collected on the next pass;
+                // when the backend has none outstanding, wait for the pipeline instead
+                uint32_t verifying = verify_pipeline_ ? verify_pipeline_->GetPending() : 0;
+                if (verifying + verified_.size() > 0) {
+                    wake_by_ns = std::min(wake_by_ns, now_ns + kVerifyPollNs);
+                }
+                if (verifying == in_flight_) {
+                    verify_pipeline_->WaitForDone(wake_by_ns > now_ns ? wake_by_ns - now_ns : 0);
+                    continue;
+                }
+                
+                int32_t rc = ReapCompletions(now_ns, wake_by_ns);
+                if (rc < 0) {
+                    throw std::runtime_error("Failed to process completions, rc=" +
+                                             std::to_string(rc));
+                }
+                stats_.reap_batches.Record(static_cast<uint32_t>(rc));
+            }
         }
         
-        auto end_time = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsed = end_time - start_time;
+        if (ramping) {
+            std::cerr << "Warning: Run ended during the ramp-up period; "
+                     << "statistics include the ramp-up" << std::endl;
+        }
+        
+        stats_.elapsed_seconds = static_cast<double>(NowNs() - measure_start_ns) / 1e9;
+        stats_.cpu_seconds = static_cast<double>(ThreadCpuNs() - measure_start_cpu_ns) / 1e9;
+        stats_.submit_calls = backend_->GetSubmitCalls() - measure_start_submit_calls;
+        if (verify_pipeline_) {
+            stats_.verify.Merge(verify_pipeline_->TakeStats());
+            verify_pipeline_.reset();
+        }
         
         // Log completion and statistics
         std::cout << "Workload generation " 
-                 << (is_running_ ? "completed" : "stopped") << "." << std::endl;
+                 << (stop_requested_ ? "stopped" : "completed") << "." << std::endl;
         std::cout << "Total bytes processed: " << total_bytes_processed_ << std::endl;
-        std::cout << "Elapsed time: " << elapsed.count() << " seconds" << std::endl;
+        std::cout << "Elapsed time: " << stats_.elapsed_seconds << " seconds" << std::endl;
+        std::cout << "I/O engine: " << backend_->GetName() << ", CPU time: " << stats_.cpu_seconds
+                 << " seconds, IOPS per core: " << stats_.GetIopsPerCore() << std::endl;
+        std::cout << "Completion mode: " << GetCompletionModeName(profile_.completion_mode)
+                 << ", cycles per I/O: " << stats_.GetCyclesPerIo()
+                 << ", waits: " << stats_.completion_waits << std::endl;
+        PrintBatches("Submit", stats_.submit_batches);
+        PrintBatches("Reap", stats_.reap_batches);
+        if (stats_.submit_calls > 0) {
+            std::cout << "Submit calls per I/O: " << stats_.GetSubmitCallsPerIo() << std::endl;
+        }
+        if (verifier_) {
+            PrintVerify(stats_.verify);
+        }
+        PrintLatency("Read", stats_.read_latency);
+        PrintLatency("Write", stats_.write_latency);
+        if (stats_.size_buckets.size() > 1) {
+            for (const auto& bucket : stats_.size_buckets) {
+                uint64_t ops = bucket.read_ops + bucket.write_ops;
+                double iops = stats_.elapsed_seconds > 0.0 ? ops / stats_.elapsed_seconds : 0.0;
+                std::cout << "  " << bucket.block_size << " bytes: " << ops << " ops, "
+                         << iops << " IOPS, p50=" << bucket.latency.GetValueAtPercentile(50.0) / 1e3
+                         << " us, p99=" << bucket.latency.GetValueAtPercentile(99.0) / 1e3
+                         << " us" << std::endl;
+            }
+        }
+        if (open_loop) {
+            std::cout << "Mean latency: " << stats_.GetMeanLatencyUs() << " us (service time "
+                     << stats_.GetMeanServiceTimeUs() << " us)" << std::endl;
+        }
         
         // Notify completion if callback is provided
         if (completion_callback_) {
@@ -120,6 +654,22 @@ bool WorkloadGenerator::Generate() {
         std::cerr << "Error during workload generation: " << e.what() << std::endl;
         is_running_ = false;
         
+        // Commands left in flight must be finished with before their buffers are
+        // reused or freed; the next Generate() opens the backend again. Helper
+        // threads are stopped first, dropping the buffers they have not reached.
+        verify_pipeline_.reset();
+        verified_.clear();
+        if (backend_->Close()) {
+            for (auto& ctx : contexts_) {
+                if (ctx.buffer != nullptr) {
+                    buffer_pool_->Release(ctx.buffer);
+                    ctx.buffer = nullptr;
+                    free_contexts_.push_back(&ctx);
+                }
+            }
+            in_flight_ = 0;
+        }
+        
         // Notify failure if callback is provided
         if (completion_callback_) {
             completion_callback_(false, total_bytes_processed_);
@@ -130,10 +680,27 @@ bool WorkloadGenerator::Generate() {
 }
 
 void WorkloadGenerator::Stop() {
+    stop_requested_ = true;
     is_running_ = false;
 }
 
 double WorkloadGenerator::GetProgress() const {
+    if (profile_.runtime_seconds > 0) {
+        uint64_t start_ns = run_start_ns_;
+        if (start_ns == 0) {
+            return 0.0;
+        }
+        
+        double duration = profile_.ramp_time_seconds + profile_.runtime_seconds;
+        double elapsed = static_cast<double>(NowNs() - start_ns) / 1e9;
+        return std::min(1.0, elapsed / duration);
+    }
+    
+    if (!profile_.trace_file.empty()) {
+        uint64_t record_count = replay_record_count_;
+        return record_count > 0 ? static_cast<double>(replay_position_) / record_count : 0.0;
+    }
+    
     if (profile_.total_size == 0) {
         return 0.0;
     }
@@ -141,161 +708,491 @@ double WorkloadGenerator::GetProgress() const {
     return static_cast<double>(total_bytes_processed_) / profile_.total_size;
 }
 
-bool WorkloadGenerator::WriteBlock(uint64_t offset, uint32_t size) {
-    assert(ctrlr_ != nullptr);
-    assert(qpair_ != nullptr);
+WorkloadStats WorkloadGenerator::GetStats() const {
+    return stats_;
+}
+
+void WorkloadGenerator::SetBufferPool(std::shared_ptr<DmaBufferPool> pool) {
+    if (is_running_) {
+        throw std::runtime_error("Cannot change the buffer pool while running");
+    }
+    buffer_pool_ = std::move(pool);
+}
+
+int32_t WorkloadGenerator::ReapCompletions(uint64_t now_ns, uint64_t wake_by_ns) {
+    uint64_t timeout_ns = wake_by_ns > now_ns ? wake_by_ns - now_ns : 0;
     
-    struct spdk_nvme_ns *ns = const_cast<struct spdk_nvme_ns*>(
-        spdk_nvme_ctrlr_get_ns(ctrlr_, 1)
-    );
+    switch (profile_.completion_mode) {
+        case CompletionMode::POLL:
+            return backend_->ProcessCompletions(profile_.reap_batch);
+            
+        case CompletionMode::BLOCK:
+            if (timeout_ns == 0) {
+                return backend_->ProcessCompletions(profile_.reap_batch);
+            }
+            ++stats_.completion_waits;
+            return backend_->WaitForCompletions(profile_.reap_batch, timeout_ns);
+            
+        case CompletionMode::HYBRID:
+            break;
+    }
     
-    if (ns == nullptr) {
-        std::cerr << "Error: Namespace not found" << std::endl;
-        return false;
+    // Sleep once per completion, then poll until it arrives. A sleep cut short
+    // by the next submission says nothing about the estimate and is not scored.
+    if (!hybrid_spinning_) {
+        uint64_t sleep_start_ns = NowNs();
+        uint64_t sleep_ns = hybrid_estimator_.GetSleepNs(GetOldestSubmitNs(), sleep_start_ns);
+        if (sleep_ns > 0 && timeout_ns > 0) {
+            bool truncated = sleep_ns > timeout_ns;
+            uint64_t requested_ns = std::min(sleep_ns, timeout_ns);
+            std::this_thread::sleep_for(std::chrono::nanoseconds(requested_ns));
+            ++stats_.completion_waits;
+            hybrid_wake_ns_ = NowNs();
+            hybrid_estimator_.RecordSleep(requested_ns, hybrid_wake_ns_ - sleep_start_ns);
+            hybrid_empty_polls_ = 0;
+            hybrid_spinning_ = !truncated;
+        }
     }
     
-    // Get the namespace sector size
-    uint32_t sector_size = spdk_nvme_ns_get_sector_size(ns);
-    if (sector_size == 0) {
-        std::cerr << "Error: Invalid sector size" << std::endl;
+    int32_t rc = backend_->ProcessCompletions(profile_.reap_batch);
+    if (hybrid_spinning_) {
+        if (rc == 0) {
+            ++hybrid_empty_polls_;
+        } else {
+            hybrid_estimator_.RecordWakeup(hybrid_empty_polls_, NowNs() - hybrid_wake_ns_);
+            hybrid_spinning_ = false;
+        }
+    }
+    return rc;
+}
+
+uint64_t WorkloadGenerator::GetOldestSubmitNs() const {
+    uint64_t oldest_ns = NowNs();
+    for (const auto& ctx : contexts_) {
+        if (ctx.buffer != nullptr) {
+            oldest_ns = std::min(oldest_ns, ctx.submit_ns);
+        }
+    }
+    return oldest_ns;
+}
+
+bool WorkloadGenerator::HasWorkRemaining() const {
+    if (!is_running_ || stop_requested_ || time_expired_) {
         return false;
     }
     
-    // Ensure size is aligned to sector size
-    if (size % sector_size != 0) {
-        size = (size / sector_size + 1) * sector_size;
+    // Replays run until the trace is exhausted
+    if (trace_cursor_) {
+        return has_next_op_ || trace_cursor_->HasNext();
     }
     
-    // Allocate a buffer for writing data
-    void *buffer = spdk_dma_malloc(size, 0, nullptr);
-    if (buffer == nullptr) {
-        std::cerr << "Error: Memory allocation failed for write buffer" << std::endl;
+    // Timed runs wrap around the addressed range until the runtime elapses
+    return profile_.runtime_seconds > 0 || bytes_submitted_ < profile_.total_size;
+}
+
+bool WorkloadGenerator::ConsumePacingTokens(uint32_t size) {
+    if (iops_limiter_ && iops_limiter_->GetAvailable() < 1.0) {
         return false;
     }
     
-    // Fill the buffer with random data
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(0, 255);
-    uint8_t *data = static_cast<uint8_t *>(buffer);
-    for (uint32_t i = 0; i < size; ++i) {
-        data[i] = dist(gen);
+    if (bandwidth_limiter_ && !bandwidth_limiter_->TryConsume(size)) {
+        return false;
     }
     
-    // Calculate LBA and LBA count
-    uint64_t lba = offset / sector_size;
-    uint32_t lba_count = size / sector_size;
+    if (iops_limiter_) {
+        iops_limiter_->TryConsume(1.0);
+    }
     
-    // Reset completion flag before submission
-    write_completed_ = false;
+    return true;
+}
+
+std::vector<WorkloadGenerator::SizeChoice> WorkloadGenerator::BuildSizeTable(
+    const std::vector<BlockSizeWeight>& sizes) const {
+    std::vector<SizeChoice> table;
+    auto bucket_of = [this](uint32_t block_size) {
+        return static_cast<size_t>(
+            std::lower_bound(bucket_sizes_.begin(), bucket_sizes_.end(), block_size) -
+            bucket_sizes_.begin());
+    };
     
-    // Need to remove const qualifier for the mock SPDK library
-    struct spdk_nvme_qpair* non_const_qpair = const_cast<struct spdk_nvme_qpair*>(qpair_);
+    if (sizes.empty()) {
+        table.push_back(SizeChoice{profile_.block_size, 1, bucket_of(profile_.block_size)});
+        return table;
+    }
     
-    // Submit the write operation
-    int rc = spdk_nvme_ns_cmd_write(ns, non_const_qpair, buffer, lba, lba_count, 
-                                    WriteCompletionCallback, this, 0);
-    if (rc != 0) {
-        std::cerr << "Error: Failed to submit write command, rc=" << rc << std::endl;
-        spdk_dma_free(buffer);
-        return false;
+    uint64_t cumulative_weight = 0;
+    for (const auto& entry : sizes) {
+        cumulative_weight += entry.weight;
+        table.push_back(SizeChoice{entry.block_size, cumulative_weight, bucket_of(entry.block_size)});
+    }
+    return table;
+}
+
+void WorkloadGenerator::PickNextOperation() {
+    if (trace_cursor_) {
+        const TraceRecord& record = trace_cursor_->Next();
+        replay_position_ = trace_cursor_->GetPosition();
+        
+        uint64_t range_size = static_cast<uint64_t>(profile_.num_blocks) * profile_.block_size;
+        uint64_t size = (std::max<uint64_t>(record.size, 1) + sector_size_ - 1) / sector_size_ * sector_size_;
+        next_is_read_ = record.is_write == 0;
+        next_size_ = static_cast<uint32_t>(std::min<uint64_t>(size, max_io_size_));
+        next_range_offset_ = (record.offset % range_size) / sector_size_ * sector_size_;
+        next_trace_ns_ = record.timestamp_ns;
+        next_bucket_ = 0;
+        has_next_op_ = true;
+        return;
     }
     
-    // Poll for completion
-    while (!write_completed_) {
-        spdk_nvme_qpair_process_completions(non_const_qpair, 0);
+    // Determine operation type (read or write)
+    next_is_read_ = percent_dist_(rng_) <= profile_.read_percentage;
+    
+    // Then its size; tables hold a handful of entries, so a linear scan is cheapest
+    const auto& table = next_is_read_ ? read_sizes_ : write_sizes_;
+    const SizeChoice* choice = &table.front();
+    if (table.size() > 1) {
+        std::uniform_int_distribution<uint64_t> weight_dist(0, table.back().cumulative_weight - 1);
+        uint64_t point = weight_dist(rng_);
+        for (const auto& entry : table) {
+            if (point < entry.cumulative_weight) {
+                choice = &entry;
+                break;
+            }
+        }
     }
     
-    // Free the buffer
-    spdk_dma_free(buffer);
+    next_size_ = choice->block_size;
+    next_bucket_ = choice->bucket;
+    has_next_op_ = true;
+}
+
+uint64_t WorkloadGenerator::GetReplayArrivalNs(uint64_t start_ns) {
+    if (!has_next_op_) {
+        if (!trace_cursor_->HasNext()) {
+            return start_ns;
+        }
+        PickNextOperation();
+    }
+    double offset_ns = static_cast<double>(next_trace_ns_ - std::min(next_trace_ns_, trace_->GetStartNs()));
+    return start_ns + static_cast<uint64_t>(offset_ns / profile_.replay_speed);
+}
+
+void WorkloadGenerator::ResetStats() {
+    stats_ = WorkloadStats();
     
-    return true;
+    // Replayed sizes are only known as they come; their buckets are added on completion
+    if (trace_cursor_) {
+        return;
+    }
+    for (uint32_t block_size : bucket_sizes_) {
+        stats_.GetSizeBucket(block_size);
+    }
 }
 
-bool WorkloadGenerator::ReadBlock(uint64_t offset, uint32_t size) {
-    assert(ctrlr_ != nullptr);
-    assert(qpair_ != nullptr);
+uint64_t WorkloadGenerator::NextInterarrivalNs() {
+    if (profile_.arrival_mode == ArrivalMode::POISSON) {
+        return static_cast<uint64_t>(interarrival_dist_(rng_) * 1e9);
+    }
+    return static_cast<uint64_t>(1e9 / profile_.arrival_rate);
+}
+
+bool WorkloadGenerator::SubmitNext(uint64_t intended_ns) {
+    if (free_contexts_.empty()) {
+        return false;
+    }
     
-    struct spdk_nvme_ns *ns = const_cast<struct spdk_nvme_ns*>(
-        spdk_nvme_ctrlr_get_ns(ctrlr_, 1)
-    );
+    if (!has_next_op_) {
+        PickNextOperation();
+    }
     
-    if (ns == nullptr) {
-        std::cerr << "Error: Namespace not found" << std::endl;
+    bool is_read = next_is_read_;
+    uint32_t block_size = next_size_;
+    if (profile_.runtime_seconds == 0 && !trace_cursor_) {
+        block_size = static_cast<uint32_t>(
+            std::min<uint64_t>(block_size, profile_.total_size - bytes_submitted_));
+    }
+    
+    if (!ConsumePacingTokens(block_size)) {
         return false;
     }
     
-    // Get the namespace sector size
-    uint32_t sector_size = spdk_nvme_ns_get_sector_size(ns);
-    if (sector_size == 0) {
-        std::cerr << "Error: Invalid sector size" << std::endl;
+    // Determine the offset within the range based on randomness percentage
+    uint64_t range_size = static_cast<uint64_t>(profile_.num_blocks) * profile_.block_size;
+    uint64_t range_offset;
+    if (trace_cursor_) {
+        range_offset = next_range_offset_;
+    } else if (percent_dist_(rng_) <= profile_.random_percentage) {
+        // Random access, following the configured distribution
+        range_offset = offset_generator_->NextBlock() * profile_.block_size;
+    } else {
+        // Sequential access
+        range_offset = (bytes_submitted_ % range_size) / sector_size_ * sector_size_;
+    }
+    
+    // Transfers larger than the addressing unit are pulled back inside the range
+    if (range_offset + block_size > range_size) {
+        range_offset = (range_size - block_size) / sector_size_ * sector_size_;
+    }
+    
+    uint64_t block_offset = profile_.start_block * profile_.block_size + range_offset;
+    
+    IoContext* ctx = free_contexts_.back();
+    free_contexts_.pop_back();
+    
+    // Closed-loop commands are intended to be issued right away
+    ctx->submit_ns = NowNs();
+    ctx->intended_ns = intended_ns != 0 ? intended_ns : ctx->submit_ns;
+    ctx->size_bucket = next_bucket_;
+    
+    // Completions delivered synchronously during submission must not recurse
+    // into SubmitNext(); the submit loop refills those slots instead
+    submitting_ = true;
+    int rc = is_read ? ReadBlock(ctx, block_offset, block_size)
+                     : WriteBlock(ctx, block_offset, block_size);
+    submitting_ = false;
+    
+    if (rc == -ENOMEM) {
+        // Queue pair is full; retry once completions have been reaped
+        free_contexts_.push_back(ctx);
         return false;
     }
     
+    has_next_op_ = false;
+    
+    // The byte budget is consumed even when submission fails so a persistently
+    // failing device cannot stall the run
+    bytes_submitted_ += block_size;
+    
+    if (rc != 0) {
+        std::cerr << "Error: " << (is_read ? "Read" : "Write") << " operation failed at offset " 
+                 << block_offset << " with size " << block_size << std::endl;
+        ++stats_.errors;
+        free_contexts_.push_back(ctx);
+    }
+    
+    return true;
+}
+
+int WorkloadGenerator::WriteBlock(IoContext* ctx, uint64_t offset, uint32_t size) {
+    assert(ctx != nullptr);
+    assert(sector_size_ != 0);
+    
     // Ensure size is aligned to sector size
-    if (size % sector_size != 0) {
-        size = (size / sector_size + 1) * sector_size;
+    uint32_t aligned_size = size;
+    if (aligned_size % sector_size_ != 0) {
+        aligned_size = (aligned_size / sector_size_ + 1) * sector_size_;
     }
     
-    // Allocate a buffer for reading data
-    void *buffer = spdk_dma_malloc(size, 0, nullptr);
+    // Take a pre-allocated buffer; an empty (shared) pool behaves like a full queue
+    void *buffer = buffer_pool_->Acquire();
     if (buffer == nullptr) {
-        std::cerr << "Error: Memory allocation failed for read buffer" << std::endl;
-        return false;
+        return -ENOMEM;
     }
     
-    // Calculate LBA and LBA count
-    uint64_t lba = offset / sector_size;
-    uint32_t lba_count = size / sector_size;
+    // Copy the next slice of the pre-generated payload
+    payload_->Fill(buffer, aligned_size);
+    if (verifier_ && !verify_pipeline_) {
+        verifier_->Stamp(buffer, offset, aligned_size);
+    }
     
-    // Reset completion flag before submission
-    read_completed_ = false;
+    ctx->buffer = buffer;
+    ctx->offset = offset;
+    ctx->size = size;
+    ctx->is_read = false;
     
-    // Need to remove const qualifier for the mock SPDK library
-    struct spdk_nvme_qpair* non_const_qpair = const_cast<struct spdk_nvme_qpair*>(qpair_);
+    // The write is submitted by CollectVerified() once a helper thread has stamped it
+    if (verify_pipeline_) {
+        ++in_flight_;
+        VerifyPipeline::Task task;
+        task.tag = ctx;
+        task.buffer = buffer;
+        task.offset = offset;
+        task.size = aligned_size;
+        task.is_write = true;
+        task.generation = verifier_->NextGeneration();
+        verify_pipeline_->Push(task);
+        return 0;
+    }
     
-    // Submit the read operation
-    int rc = spdk_nvme_ns_cmd_read(ns, non_const_qpair, buffer, lba, lba_count, 
-                                    ReadCompletionCallback, this, 0);
+    // In-flight accounting must be in place before submission because the
+    // completion may be delivered before the submit call returns
+    ++in_flight_;
+    
+    // Submit the write operation
+    int rc = backend_->SubmitWrite(buffer, offset, aligned_size, CompletionCallback, ctx);
     if (rc != 0) {
-        std::cerr << "Error: Failed to submit read command, rc=" << rc << std::endl;
-        spdk_dma_free(buffer);
-        return false;
+        if (rc != -ENOMEM) {
+            std::cerr << "Error: Failed to submit write command, rc=" << rc << std::endl;
+        }
+        --in_flight_;
+        ctx->buffer = nullptr;
+        buffer_pool_->Release(buffer);
+    }
+    
+    return rc;
+}
+
+int WorkloadGenerator::ReadBlock(IoContext* ctx, uint64_t offset, uint32_t size) {
+    assert(ctx != nullptr);
+    assert(sector_size_ != 0);
+    
+    // Ensure size is aligned to sector size
+    uint32_t aligned_size = size;
+    if (aligned_size % sector_size_ != 0) {
+        aligned_size = (aligned_size / sector_size_ + 1) * sector_size_;
     }
     
-    // Poll for completion
-    while (!read_completed_) {
-        spdk_nvme_qpair_process_completions(non_const_qpair, 0);
+    // Take a pre-allocated buffer; an empty (shared) pool behaves like a full queue
+    void *buffer = buffer_pool_->Acquire();
+    if (buffer == nullptr) {
+        return -ENOMEM;
     }
     
-    // Free the buffer
-    spdk_dma_free(buffer);
+    ctx->buffer = buffer;
+    ctx->offset = offset;
+    ctx->size = size;
+    ctx->is_read = true;
     
-    return true;
+    // In-flight accounting must be in place before submission because the
+    // completion may be delivered before the submit call returns
+    ++in_flight_;
+    
+    // Submit the read operation
+    int rc = backend_->SubmitRead(buffer, offset, aligned_size, CompletionCallback, ctx);
+    if (rc != 0) {
+        if (rc != -ENOMEM) {
+            std::cerr << "Error: Failed to submit read command, rc=" << rc << std::endl;
+        }
+        --in_flight_;
+        ctx->buffer = nullptr;
+        buffer_pool_->Release(buffer);
+    }
+    
+    return rc;
+}
+
+void WorkloadGenerator::OnCompletion(IoContext* ctx, bool success) {
+    assert(in_flight_ > 0);
+    
+    if (success) {
+        uint64_t complete_ns = NowNs();
+        uint64_t latency_ns = complete_ns - std::min(ctx->intended_ns, complete_ns);
+        uint64_t service_ns = complete_ns - std::min(ctx->submit_ns, complete_ns);
+        stats_.latency_ns_sum += latency_ns;
+        stats_.latency_ns_max = std::max(stats_.latency_ns_max, latency_ns);
+        stats_.service_ns_sum += service_ns;
+        stats_.service_ns_max = std::max(stats_.service_ns_max, service_ns);
+        if (profile_.completion_mode == CompletionMode::HYBRID) {
+            hybrid_estimator_.RecordServiceTime(service_ns);
+        }
+        
+        total_bytes_processed_ += ctx->size;
+        if (ctx->is_read) {
+            ++stats_.read_ops;
+            stats_.read_bytes += ctx->size;
+            stats_.read_latency.Record(latency_ns);
+        } else {
+            ++stats_.write_ops;
+            stats_.write_bytes += ctx->size;
+            stats_.write_latency.Record(latency_ns);
+        }
+        
+        if (ctx->is_read && verifier_ && !verify_pipeline_) {
+            uint32_t aligned_size = (ctx->size + sector_size_ - 1) / sector_size_ * sector_size_;
+            uint32_t failed = verifier_->Verify(ctx->buffer, ctx->offset, aligned_size, stats_.verify);
+            if (failed > 0) {
+                std::cerr << "Error: Verify failed for " << failed << " blocks of the read at offset "
+                         << ctx->offset << std::endl;
+            }
+        }
+        
+        BlockSizeStats& bucket = trace_cursor_ ? stats_.GetSizeBucket(ctx->size)
+                                               : stats_.size_buckets[ctx->size_bucket];
+        if (ctx->is_read) {
+            ++bucket.read_ops;
+        } else {
+            ++bucket.write_ops;
+        }
+        bucket.bytes += ctx->size;
+        bucket.latency.Record(latency_ns);
+        
+        // A read checked by a helper thread keeps its slot until the result is collected
+        if (ctx->is_read && verify_pipeline_) {
+            VerifyPipeline::Task task;
+            task.tag = ctx;
+            task.buffer = ctx->buffer;
+            task.offset = ctx->offset;
+            task.size = (ctx->size + sector_size_ - 1) / sector_size_ * sector_size_;
+            verify_pipeline_->Push(task);
+            return;
+        }
+    } else {
+        ++stats_.errors;
+    }
+    
+    FinishCommand(ctx);
 }
 
-void WorkloadGenerator::WriteCompletionCallback(void *arg, const struct spdk_nvme_cpl *completion) {
-    auto generator = static_cast<WorkloadGenerator*>(arg);
-    assert(generator != nullptr);
+void WorkloadGenerator::FinishCommand(IoContext* ctx) {
+    // Recycle the buffer and return the slot
+    buffer_pool_->Release(ctx->buffer);
+    ctx->buffer = nullptr;
+    --in_flight_;
+    free_contexts_.push_back(ctx);
     
-    if (spdk_nvme_cpl_is_error(completion)) {
-        std::cerr << "Error: Write operation failed with status code: " 
-                 << static_cast<int>(completion->status.sc) << std::endl;
+    // Refill the slot straight from the completion path so the queue depth is
+    // maintained between polls; paced, batched and open-loop runs submit from
+    // the polling loop instead
+    if (!submitting_ && refill_on_completion_ && HasWorkRemaining() && SubmitNext()) {
+        stats_.submit_batches.Record(1);
     }
+}
+
+void WorkloadGenerator::CollectVerified() {
+    verify_pipeline_->Collect(verified_);
     
-    generator->write_completed_ = true;
+    size_t handled = 0;
+    for (; handled < verified_.size(); ++handled) {
+        const VerifyPipeline::Task& task = verified_[handled];
+        auto* ctx = static_cast<IoContext*>(task.tag);
+        if (!task.is_write) {
+            if (task.failed > 0) {
+                std::cerr << "Error: Verify failed for " << task.failed << " blocks of the read at offset "
+                         << ctx->offset << std::endl;
+            }
+            FinishCommand(ctx);
+            continue;
+        }
+        
+        // Service time starts here; latency still counts from the intended issue time
+        ctx->submit_ns = NowNs();
+        submitting_ = true;
+        int rc = backend_->SubmitWrite(task.buffer, task.offset, task.size, CompletionCallback, ctx);
+        submitting_ = false;
+        if (rc == -ENOMEM) {
+            // Queue pair is full; this and the remaining tasks are retried on the next pass
+            break;
+        }
+        if (rc != 0) {
+            std::cerr << "Error: Failed to submit write command, rc=" << rc << std::endl;
+            ++stats_.errors;
+            FinishCommand(ctx);
+        }
+    }
+    verified_.erase(verified_.begin(), verified_.begin() + handled);
 }
 
-void WorkloadGenerator::ReadCompletionCallback(void *arg, const struct spdk_nvme_cpl *completion) {
-    auto generator = static_cast<WorkloadGenerator*>(arg);
-    assert(generator != nullptr);
+void WorkloadGenerator::CompletionCallback(void *arg, int status) {
+    auto ctx = static_cast<IoContext*>(arg);
+    assert(ctx != nullptr && ctx->generator != nullptr);
     
-    if (spdk_nvme_cpl_is_error(completion)) {
-        std::cerr << "Error: Read operation failed with status code: " 
-                 << static_cast<int>(completion->status.sc) << std::endl;
+    bool success = status == 0;
+    if (!success) {
+        std::cerr << "Error: " << (ctx->is_read ? "Read" : "Write")
+                 << " operation failed with status code: " << status << std::endl;
     }
     
-    generator->read_completed_ = true;
+    ctx->generator->OnCompletion(ctx, success);
 }
 
 }  // namespace benchmarking
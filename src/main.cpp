@@ -2,8 +2,10 @@
 #include <fstream>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <memory>
 #include <chrono>
+#include <atomic>
 #include <thread>
 #include <csignal>
 #include <cstdlib>
@@ -11,6 +13,9 @@
 #include <getopt.h>
 
 #include "../include/benchmarking/workload_generator.h"
+#include "../include/benchmarking/job_file.h"
+#include "../include/benchmarking/block_trace.h"
+#include "../include/benchmarking/loopback_target.h"
 #include "../include/benchmarking/data_collector.h"
 #include "../include/benchmarking/result_visualizer.h"
 #include "../include/bottleneck_analysis/system_profiler.h"
@@ -34,8 +39,13 @@ void signalHandler(int signum) {
 // Command-line options
 struct CommandLineOptions {
     std::string workload_profile;
+    std::string transport_id;
     std::string output_dir;
     std::string config_file;
+    std::string loopback_target;
+    std::string import_trace;
+    nvmeof::benchmarking::OutputFormat output_format;
+    nvmeof::benchmarking::CompressionMode compression;
     bool verbose;
     bool optimize;
     bool visualize;
@@ -48,9 +58,17 @@ void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [OPTIONS]\n";
     std::cout << "NVMe-oF Benchmarking Suite\n\n";
     std::cout << "Options:\n";
-    std::cout << "  -w, --workload-profile FILE   Specify the workload profile JSON file\n";
+    std::cout << "  -w, --workload-profile FILE   Specify the workload profile or job file (JSON)\n";
+    std::cout << "  -t, --transport TRID          Target transport ID (default: \"trtype:PCIe\")\n";
     std::cout << "  -o, --output-dir DIR          Specify the output directory for results\n";
     std::cout << "  -c, --config-file FILE        Specify the configuration file\n";
+    std::cout << "  -f, --output-format FMT       Results format: csv, json, text or binary (default: csv)\n";
+    std::cout << "  -z, --compression MODE        Compress text results while writing: none or lz\n";
+    std::cout << "                                (default: none)\n";
+    std::cout << "  -L, --loopback-target ADDR    Export the controller's namespaces to \"tcp\" jobs\n";
+    std::cout << "                                on ADDR (host:port or unix:/path)\n";
+    std::cout << "  -I, --import-trace FILE       Convert blkparse output FILE to the binary trace\n";
+    std::cout << "                                FILE.nvbt for \"trace_file\" and exit\n";
     std::cout << "  -v, --verbose                 Enable verbose output\n";
     std::cout << "  -O, --optimize                Enable automatic optimization\n";
     std::cout << "  -V, --visualize               Visualize results after benchmark\n";
@@ -63,8 +81,13 @@ void printUsage(const char* programName) {
 bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
     static struct option long_options[] = {
         {"workload-profile", required_argument, 0, 'w'},
+        {"transport",        required_argument, 0, 't'},
         {"output-dir",       required_argument, 0, 'o'},
         {"config-file",      required_argument, 0, 'c'},
+        {"output-format",    required_argument, 0, 'f'},
+        {"compression",      required_argument, 0, 'z'},
+        {"loopback-target",  required_argument, 0, 'L'},
+        {"import-trace",     required_argument, 0, 'I'},
         {"verbose",          no_argument,       0, 'v'},
         {"optimize",         no_argument,       0, 'O'},
         {"visualize",        no_argument,       0, 'V'},
@@ -80,20 +103,48 @@ bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
     options.visualize = false;
     options.monitor_resources = false;
     options.monitor_interval_ms = 1000;
+    options.transport_id = "trtype:PCIe";
+    options.output_format = nvmeof::benchmarking::OutputFormat::CSV;
+    options.compression = nvmeof::benchmarking::CompressionMode::NONE;
 
     int opt;
     int option_index = 0;
-    while ((opt = getopt_long(argc, argv, "w:o:c:vOVmi:h", long_options, &option_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "w:t:o:c:f:z:L:I:vOVmi:h", long_options, &option_index)) != -1) {
         switch (opt) {
             case 'w':
                 options.workload_profile = optarg;
                 break;
+            case 't':
+                options.transport_id = optarg;
+                break;
             case 'o':
                 options.output_dir = optarg;
                 break;
             case 'c':
                 options.config_file = optarg;
                 break;
+            case 'f':
+                try {
+                    options.output_format = nvmeof::benchmarking::ParseOutputFormat(optarg);
+                } catch (const std::invalid_argument& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                    return false;
+                }
+                break;
+            case 'z':
+                try {
+                    options.compression = nvmeof::benchmarking::ParseCompressionMode(optarg);
+                } catch (const std::invalid_argument& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
+                    return false;
+                }
+                break;
+            case 'L':
+                options.loopback_target = optarg;
+                break;
+            case 'I':
+                options.import_trace = optarg;
+                break;
             case 'v':
                 options.verbose = true;
                 break;
@@ -120,7 +171,18 @@ bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
         }
     }
 
+    // Importing a trace needs nothing else
+    if (!options.import_trace.empty()) {
+        return true;
+    }
+
     // Validate required options
+    if (options.compression != nvmeof::benchmarking::CompressionMode::NONE &&
+        options.output_format == nvmeof::benchmarking::OutputFormat::BINARY) {
+        std::cerr << "Error: Binary results are already compact and cannot be compressed\n";
+        return false;
+    }
+
     if (options.workload_profile.empty()) {
         std::cerr << "Error: Workload profile must be specified\n";
         printUsage(argv[0]);
@@ -144,25 +206,72 @@ bool parseCommandLine(int argc, char** argv, CommandLineOptions& options) {
     return true;
 }
 
-// Load workload profile from JSON file
-nvmeof::benchmarking::WorkloadProfile loadWorkloadProfile(const std::string& filename) {
-    std::string json_content = nvmeof::utils::ReadFileToString(filename);
-    if (json_content.empty()) {
-        throw std::runtime_error("Failed to read workload profile file: " + filename);
+// Convert blkparse text output into a binary trace next to it
+bool importTrace(const std::string& input_path) {
+    std::ifstream input(input_path);
+    if (!input) {
+        std::cerr << "Error: Failed to open " << input_path << std::endl;
+        return false;
+    }
+
+    const std::string output_path = input_path + ".nvbt";
+    nvmeof::benchmarking::TraceWriter writer;
+    if (!writer.Open(output_path)) {
+        return false;
+    }
+    int64_t imported = nvmeof::benchmarking::ImportBlkparseTrace(input, writer);
+    if (imported < 0 || !writer.Close()) {
+        return false;
+    }
+
+    std::cout << "Imported " << imported << " requests into " << output_path << std::endl;
+    return true;
+}
+
+// Record the statistics of a finished job
+void collectJobResults(nvmeof::benchmarking::DataCollector& collector,
+                       const nvmeof::benchmarking::JobDefinition& job,
+                       const nvmeof::benchmarking::WorkloadStats& stats,
+                       bool verbose) {
+    const std::string& job_name = job.name;
+    collector.CollectDataPoint(job_name + " Throughput", stats.GetThroughputMBps(), "MB/s");
+    collector.CollectDataPoint(job_name + " IOPS", stats.GetIops(), "ops/s");
+    collector.CollectDataPoint(job_name + " IOPS per Core", stats.GetIopsPerCore(), "ops/s/core");
+    collector.CollectDataPoint(job_name + " Cycles per I/O", stats.GetCyclesPerIo(), "cycles");
+    collector.CollectDataPoint(job_name + " Submit Batch Size", stats.submit_batches.GetMean(), "commands");
+    collector.CollectDataPoint(job_name + " Reap Batch Size", stats.reap_batches.GetMean(), "commands");
+    if (stats.submit_calls > 0) {
+        collector.CollectDataPoint(job_name + " Submit Calls per I/O", stats.GetSubmitCallsPerIo(), "");
+    }
+    collector.CollectDataPoint(job_name + " Latency", stats.GetMeanLatencyUs(), "µs");
+    collector.CollectDataPoint(job_name + " Errors", static_cast<double>(stats.errors), "");
+    if (job.profile.verify) {
+        collector.CollectDataPoint(job_name + " Verified Blocks",
+                                   static_cast<double>(stats.verify.blocks_verified), "blocks");
+        collector.CollectDataPoint(job_name + " Verify Errors", static_cast<double>(stats.verify.errors), "");
+    }
+    if (stats.read_latency.GetCount() > 0) {
+        collector.CollectLatencyPercentiles(job_name + " Read Latency", stats.read_latency);
+    }
+    if (stats.write_latency.GetCount() > 0) {
+        collector.CollectLatencyPercentiles(job_name + " Write Latency", stats.write_latency);
     }
 
-    // In a real implementation, this would parse the JSON
-    // For the example, we'll create a dummy profile
-    nvmeof::benchmarking::WorkloadProfile profile;
-    profile.total_size = 1048576;    // 1 MB
-    profile.block_size = 4096;       // 4 KB
-    profile.num_blocks = 256;        // 256 blocks
-    profile.interval_us = 100;       // 100 microseconds
-    profile.read_percentage = 70;    // 70% reads
-    profile.write_percentage = 30;   // 30% writes
-    profile.random_percentage = 50;  // 50% random
-
-    return profile;
+    if (verbose) {
+        std::cout << "Job '" << job_name << "' ("
+                 << nvmeof::benchmarking::GetIoEngineName(job.options.backend.engine) << "): "
+                 << "Throughput: " << stats.GetThroughputMBps() << " MB/s"
+                 << ", IOPS: " << stats.GetIops() << " ops/s"
+                 << ", IOPS per core: " << stats.GetIopsPerCore()
+                 << ", Cycles per I/O: " << stats.GetCyclesPerIo()
+                 << ", Latency: " << stats.GetMeanLatencyUs() << " µs"
+                 << ", Errors: " << stats.errors
+                 << std::endl;
+    }
+    if (stats.verify.errors > 0) {
+        std::cerr << "Warning: Job '" << job_name << "' failed data verification for "
+                 << stats.verify.errors << " blocks" << std::endl;
+    }
 }
 
 int main(int argc, char** argv) {
@@ -181,6 +290,10 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    if (!options.import_trace.empty()) {
+        return importTrace(options.import_trace) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // Print system information
     if (options.verbose) {
         std::cout << "System Information:" << std::endl;
@@ -202,24 +315,24 @@ int main(int argc, char** argv) {
         std::cout << std::endl;
     }
 
+    bool jobs_succeeded = false;
     try {
-        // Load workload profile
+        // Load the jobs; a plain workload profile becomes a single job
         std::cout << "Loading workload profile: " << options.workload_profile << std::endl;
-        
-        // Comment out or remove the unused workload_profile variable
-        // auto workload_profile = loadWorkloadProfile(options.workload_profile);
-        
-        // For a real implementation, you would use the workload profile here
-        // For example: auto generator = createWorkloadGenerator(workload_profile);
-        // generator.run();
+        auto job_file = nvmeof::benchmarking::LoadJobFile(options.workload_profile);
+        std::cout << "Loaded " << job_file.jobs.size() << " job(s)" << std::endl;
 
         // Set up output file path
         std::string timestamp = nvmeof::utils::GetCurrentTimestamp("%Y%m%d_%H%M%S");
-        std::string output_file = options.output_dir + "/benchmark_" + timestamp + ".csv";
+        std::string output_file = options.output_dir + "/benchmark_" + timestamp +
+                                  nvmeof::benchmarking::GetOutputFormatExtension(options.output_format) +
+                                  nvmeof::benchmarking::GetCompressionExtension(options.compression);
         
         // Create data collector
         std::cout << "Creating data collector, output file: " << output_file << std::endl;
-        nvmeof::benchmarking::DataCollector collector(output_file);
+        nvmeof::benchmarking::DataCollector collector(output_file, options.output_format,
+                                                      nvmeof::benchmarking::DataCollector::kDefaultRingCapacity,
+                                                      options.compression);
 
         // Set up resource monitoring if enabled
         std::unique_ptr<nvmeof::bottleneck_analysis::ResourceMonitor> resource_monitor;
@@ -227,23 +340,32 @@ int main(int argc, char** argv) {
             std::cout << "Starting resource monitoring with interval: " 
                      << options.monitor_interval_ms << "ms" << std::endl;
             
+            // Metrics are registered once; samples then carry only their handles
+            nvmeof::benchmarking::MetricHandle cpu_metric = collector.RegisterMetric("CPU Usage", "%");
+            nvmeof::benchmarking::MetricHandle memory_metric = collector.RegisterMetric("Memory Usage", "%");
+            std::unordered_map<std::string, std::pair<nvmeof::benchmarking::MetricHandle,
+                                                      nvmeof::benchmarking::MetricHandle>> network_metrics;
+
             resource_monitor = std::make_unique<nvmeof::bottleneck_analysis::ResourceMonitor>(
                 std::chrono::milliseconds(options.monitor_interval_ms),
-                [&collector](const nvmeof::bottleneck_analysis::ResourceUsage& usage) {
+                [&collector, cpu_metric, memory_metric, network_metrics](
+                        const nvmeof::bottleneck_analysis::ResourceUsage& usage) mutable {
                     // Log CPU usage
-                    collector.CollectDataPoint("CPU Usage", usage.cpu_usage_percent, "%");
+                    collector.CollectDataPoint(cpu_metric, usage.cpu_usage_percent);
                     
                     // Log memory usage
-                    double memory_usage_percent = usage.GetMemoryUsagePercent();
-                    collector.CollectDataPoint("Memory Usage", memory_usage_percent, "%");
+                    collector.CollectDataPoint(memory_metric, usage.GetMemoryUsagePercent());
                     
-                    // Log network usage for each interface
+                    // Log network usage for each interface, registering interfaces as they appear
                     for (size_t i = 0; i < usage.interfaces.size(); ++i) {
-                        std::string label = "Network RX: " + usage.interfaces[i];
-                        collector.CollectDataPoint(label, usage.rx_bytes[i], "bytes");
-                        
-                        label = "Network TX: " + usage.interfaces[i];
-                        collector.CollectDataPoint(label, usage.tx_bytes[i], "bytes");
+                        auto it = network_metrics.find(usage.interfaces[i]);
+                        if (it == network_metrics.end()) {
+                            it = network_metrics.emplace(usage.interfaces[i], std::make_pair(
+                                collector.RegisterMetric("Network RX: " + usage.interfaces[i], "bytes"),
+                                collector.RegisterMetric("Network TX: " + usage.interfaces[i], "bytes"))).first;
+                        }
+                        collector.CollectDataPoint(it->second.first, usage.rx_bytes[i]);
+                        collector.CollectDataPoint(it->second.second, usage.tx_bytes[i]);
                     }
                 }
             );
@@ -279,64 +401,104 @@ int main(int argc, char** argv) {
             }
         }
 
+        // Connect to the target controller; jobs on kernel engines open their own files
+        bool needs_controller = !options.loopback_target.empty();
+        for (const auto& job : job_file.jobs) {
+            needs_controller |= job.options.backend.engine == nvmeof::benchmarking::IoEngine::SPDK;
+        }
+
+        struct spdk_nvme_ctrlr* ctrlr = nullptr;
+        if (needs_controller) {
+            struct spdk_nvme_transport_id trid;
+            if (spdk_nvme_transport_id_parse(&trid, options.transport_id.c_str()) != 0) {
+                throw std::invalid_argument("Invalid transport ID: " + options.transport_id);
+            }
+
+            ctrlr = spdk_nvme_connect(&trid, nullptr, 0);
+            if (ctrlr == nullptr) {
+                throw std::runtime_error("Failed to connect to controller: " + options.transport_id);
+            }
+        }
+
+        // Serve the controller's namespaces to jobs on the tcp engine
+        std::unique_ptr<nvmeof::benchmarking::LoopbackTarget> loopback_target;
+        if (!options.loopback_target.empty()) {
+            loopback_target = std::make_unique<nvmeof::benchmarking::LoopbackTarget>(
+                ctrlr, options.loopback_target);
+            if (!loopback_target->Start()) {
+                spdk_nvme_detach(ctrlr);
+                throw std::runtime_error("Failed to start the loopback target on " + options.loopback_target);
+            }
+            std::cout << "Loopback target listening on " << loopback_target->GetAddress() << std::endl;
+        }
+
         // Generate and run the workload
         std::cout << "Starting benchmark with profile: " << options.workload_profile << std::endl;
-        
-        // In a real implementation, this would create and run the workload generator
-        // For the example, we'll simulate the benchmark
         collector.CollectDataPoint("Benchmark Start", 0, "");
-        
-        int progress = 0;
-        while (g_running && progress < 100) {
-            // Simulate workload execution
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            
-            // Update progress
-            progress += 5;
-            if (progress > 100) progress = 100;
-            
-            // Log progress
-            collector.CollectDataPoint("Progress", progress, "%");
-            
-            // Generate some simulated metrics
-            double throughput = 1000.0 + (std::rand() % 500);
-            double iops = 250000.0 + (std::rand() % 50000);
-            double latency = 100.0 + (std::rand() % 50);
-            
-            collector.CollectDataPoint("Throughput", throughput, "MB/s");
-            collector.CollectDataPoint("IOPS", iops, "ops/s");
-            collector.CollectDataPoint("Latency", latency, "µs");
-            
-            // If optimization is enabled, periodically check for bottlenecks
-            if (options.optimize && optimizer && resource_monitor) {
-                auto usage = resource_monitor->GetLatestUsage();
-                
-                // Calculate network usage (sum of all interfaces)
-                uint64_t network_rx_total = 0;
-                uint64_t network_tx_total = 0;
-                for (size_t i = 0; i < usage.interfaces.size(); ++i) {
-                    network_rx_total += usage.rx_bytes[i];
-                    network_tx_total += usage.tx_bytes[i];
+
+        bool success = false;
+        std::vector<nvmeof::benchmarking::WorkloadStats> results;
+        {
+            nvmeof::benchmarking::JobFileRunner runner(ctrlr, job_file);
+            std::atomic<bool> finished(false);
+            nvmeof::benchmarking::MetricHandle progress_metric = collector.RegisterMetric("Progress", "%");
+            std::thread run_thread([&]() {
+                success = runner.Run();
+                finished = true;
+            });
+
+            while (!finished) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+                if (!g_running) {
+                    runner.Stop();
+                }
+
+                double progress = runner.GetProgress() * 100.0;
+                collector.CollectDataPoint(progress_metric, progress);
+
+                // If optimization is enabled, periodically check for bottlenecks
+                if (options.optimize && optimizer && resource_monitor) {
+                    auto usage = resource_monitor->GetLatestUsage();
+
+                    // Calculate network usage (sum of all interfaces)
+                    uint64_t network_rx_total = 0;
+                    uint64_t network_tx_total = 0;
+                    for (size_t i = 0; i < usage.interfaces.size(); ++i) {
+                        network_rx_total += usage.rx_bytes[i];
+                        network_tx_total += usage.tx_bytes[i];
+                    }
+
+                    // Optimize configuration based on resource usage
+                    optimizer->OptimizeConfiguration(
+                        usage.cpu_usage_percent,
+                        usage.GetMemoryUsagePercent(),
+                        network_rx_total + network_tx_total
+                    );
+                }
+
+                // Print progress
+                if (options.verbose) {
+                    std::cout << "Progress: " << progress << "%" << std::endl;
                 }
-                
-                // Optimize configuration based on resource usage
-                optimizer->OptimizeConfiguration(
-                    usage.cpu_usage_percent,
-                    usage.GetMemoryUsagePercent(),
-                    network_rx_total + network_tx_total
-                );
-            }
-            
-            // Print progress
-            if (options.verbose) {
-                std::cout << "Progress: " << progress << "%" 
-                         << ", Throughput: " << throughput << " MB/s"
-                         << ", IOPS: " << iops << " ops/s"
-                         << ", Latency: " << latency << " µs"
-                         << std::endl;
             }
+
+            run_thread.join();
+            results = runner.GetResults();
         }
-        
+        loopback_target.reset();
+        if (ctrlr != nullptr) {
+            spdk_nvme_detach(ctrlr);
+        }
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            collectJobResults(collector, job_file.jobs[i], results[i], options.verbose);
+        }
+
+        if (!success) {
+            std::cerr << "Warning: One or more jobs did not complete successfully" << std::endl;
+        }
+
         collector.CollectDataPoint("Benchmark End", 0, "");
         
         // Stop resource monitoring if it was started
@@ -348,11 +510,13 @@ int main(int argc, char** argv) {
         // Visualize results if requested
         if (options.visualize) {
             std::cout << "Visualizing benchmark results" << std::endl;
+            collector.Flush();
             nvmeof::benchmarking::ResultVisualizer visualizer(output_file);
             visualizer.Visualize();
         }
         
         std::cout << "Benchmark completed. Results saved to: " << output_file << std::endl;
+        jobs_succeeded = success;
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -360,5 +524,8 @@ int main(int argc, char** argv) {
     }
     
     std::cout << "=======================================" << std::endl;
-    return EXIT_SUCCESS;
+    
+    // The collector has written its footer and the monitor has stopped by now;
+    // a failed job still fails the run so scripts can tell
+    return jobs_succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
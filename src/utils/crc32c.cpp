@@ -0,0 +1,270 @@
+#include "../../include/utils/crc32c.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace nvmeof {
+namespace utils {
+
+namespace {
+
+// Reflected CRC-32C polynomial
+constexpr uint32_t kPolynomial = 0x82F63B78;
+
+using Table = std::array<std::array<uint32_t, 256>, 8>;
+
+Table BuildSliceTable() {
+    Table table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t crc = n;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? kPolynomial : 0);
+        }
+        table[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+        for (size_t k = 1; k < table.size(); ++k) {
+            table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xFF];
+        }
+    }
+    return table;
+}
+
+const Table& GetSliceTable() {
+    static const Table table = BuildSliceTable();
+    return table;
+}
+
+uint64_t LoadU64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+#if defined(__x86_64__)
+
+// Lengths of the three interleaved streams; both must be powers of two
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+using ShiftTable = std::array<std::array<uint32_t, 256>, 4>;
+
+// Multiplies a 32x32 GF(2) matrix by a vector
+uint32_t MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+    uint32_t sum = 0;
+    while (vector != 0) {
+        if (vector & 1) {
+            sum ^= *matrix;
+        }
+        vector >>= 1;
+        ++matrix;
+    }
+    return sum;
+}
+
+void MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+    for (int n = 0; n < 32; ++n) {
+        square[n] = MatrixTimes(matrix, matrix[n]);
+    }
+}
+
+// Builds byte-wise tables of the operator that appends length zero bytes to a checksum
+ShiftTable BuildShiftTable(size_t length) {
+    uint32_t odd[32];
+    uint32_t even[32];
+
+    // Operator for one zero bit
+    odd[0] = kPolynomial;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    // Two and four zero bits, then square up to length zero bytes
+    MatrixSquare(even, odd);
+    MatrixSquare(odd, even);
+    const uint32_t* op = odd;
+    do {
+        MatrixSquare(even, odd);
+        op = even;
+        length >>= 1;
+        if (length == 0) {
+            break;
+        }
+        MatrixSquare(odd, even);
+        op = odd;
+        length >>= 1;
+    } while (length != 0);
+
+    ShiftTable table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        table[0][n] = MatrixTimes(op, n);
+        table[1][n] = MatrixTimes(op, n << 8);
+        table[2][n] = MatrixTimes(op, n << 16);
+        table[3][n] = MatrixTimes(op, n << 24);
+    }
+    return table;
+}
+
+uint32_t Shift(const ShiftTable& table, uint32_t crc) {
+    return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+           table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+struct ShiftTables {
+    ShiftTable long_block = BuildShiftTable(kLongBlock);
+    ShiftTable short_block = BuildShiftTable(kShortBlock);
+};
+
+const ShiftTables& GetShiftTables() {
+    static const ShiftTables tables;
+    return tables;
+}
+
+// Processes three blocks of block_size bytes each in parallel while enough data remains
+__attribute__((target("sse4.2")))
+uint64_t InterleavedBlocks(uint64_t crc0, const uint8_t*& next, size_t& size,
+                           size_t block_size, const ShiftTable& shift) {
+    while (size >= 3 * block_size) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        const uint8_t* end = next + block_size;
+        do {
+            crc0 = _mm_crc32_u64(crc0, LoadU64(next));
+            crc1 = _mm_crc32_u64(crc1, LoadU64(next + block_size));
+            crc2 = _mm_crc32_u64(crc2, LoadU64(next + 2 * block_size));
+            next += 8;
+        } while (next < end);
+        crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1);
+        crc0 = Shift(shift, static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc2);
+        next += 2 * block_size;
+        size -= 3 * block_size;
+    }
+    return crc0;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t ComputeHardware(const void* data, size_t size, uint32_t crc) {
+    const ShiftTables& tables = GetShiftTables();
+    const auto* next = static_cast<const uint8_t*>(data);
+    uint64_t crc0 = ~crc;
+
+    // Align to eight bytes
+    while (size > 0 && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+        --size;
+    }
+
+    crc0 = InterleavedBlocks(crc0, next, size, kLongBlock, tables.long_block);
+    crc0 = InterleavedBlocks(crc0, next, size, kShortBlock, tables.short_block);
+
+    while (size >= 8) {
+        crc0 = _mm_crc32_u64(crc0, LoadU64(next));
+        next += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next++);
+        --size;
+    }
+    return ~static_cast<uint32_t>(crc0);
+}
+
+// Checksums three buffers at a time on independent streams
+__attribute__((target("sse4.2")))
+void ComputeStridedHardware(const uint8_t* data, size_t size, size_t stride, size_t count, uint32_t* crcs) {
+    size_t i = 0;
+    for (; i + 3 <= count; i += 3) {
+        const uint8_t* first = data + i * stride;
+        const uint8_t* second = first + stride;
+        const uint8_t* third = second + stride;
+        uint64_t crc0 = 0xFFFFFFFF;
+        uint64_t crc1 = 0xFFFFFFFF;
+        uint64_t crc2 = 0xFFFFFFFF;
+        size_t done = 0;
+        for (; done + 8 <= size; done += 8) {
+            crc0 = _mm_crc32_u64(crc0, LoadU64(first + done));
+            crc1 = _mm_crc32_u64(crc1, LoadU64(second + done));
+            crc2 = _mm_crc32_u64(crc2, LoadU64(third + done));
+        }
+        for (; done < size; ++done) {
+            crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), first[done]);
+            crc1 = _mm_crc32_u8(static_cast<uint32_t>(crc1), second[done]);
+            crc2 = _mm_crc32_u8(static_cast<uint32_t>(crc2), third[done]);
+        }
+        crcs[i] = ~static_cast<uint32_t>(crc0);
+        crcs[i + 1] = ~static_cast<uint32_t>(crc1);
+        crcs[i + 2] = ~static_cast<uint32_t>(crc2);
+    }
+    for (; i < count; ++i) {
+        crcs[i] = ComputeHardware(data + i * stride, size, 0);
+    }
+}
+
+#endif
+
+bool DetectHardware() {
+#if defined(__x86_64__)
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
+
+}  // namespace
+
+uint32_t Crc32c::Compute(const void* data, size_t size, uint32_t crc) {
+#if defined(__x86_64__)
+    if (IsHardwareAccelerated()) {
+        return ComputeHardware(data, size, crc);
+    }
+#endif
+    return ComputeSoftware(data, size, crc);
+}
+
+void Crc32c::ComputeStrided(const void* data, size_t size, size_t stride, size_t count, uint32_t* crcs) {
+    const auto* next = static_cast<const uint8_t*>(data);
+#if defined(__x86_64__)
+    if (IsHardwareAccelerated()) {
+        ComputeStridedHardware(next, size, stride, count, crcs);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        crcs[i] = ComputeSoftware(next + i * stride, size);
+    }
+}
+
+uint32_t Crc32c::ComputeSoftware(const void* data, size_t size, uint32_t crc) {
+    const Table& table = GetSliceTable();
+    const auto* next = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+
+    // Slicing-by-8: eight table lookups per eight bytes
+    while (size >= 8) {
+        uint64_t word = LoadU64(next) ^ crc;
+        crc = table[7][word & 0xFF] ^ table[6][(word >> 8) & 0xFF] ^
+              table[5][(word >> 16) & 0xFF] ^ table[4][(word >> 24) & 0xFF] ^
+              table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF] ^
+              table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+        next += 8;
+        size -= 8;
+    }
+    while (size > 0) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *next++) & 0xFF];
+        --size;
+    }
+    return ~crc;
+}
+
+bool Crc32c::IsHardwareAccelerated() {
+    static const bool hardware = DetectHardware();
+    return hardware;
+}
+
+}  // namespace utils
+}  // namespace nvmeof
@@ -0,0 +1,446 @@
+#include "../../include/utils/json_parser.h"
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace nvmeof {
+namespace utils {
+
+namespace {
+
+// Deeper documents are rejected instead of overflowing the stack
+constexpr int kMaxDepth = 256;
+
+}  // namespace
+
+/**
+ * @brief Recursive-descent parser over a contiguous character range.
+ */
+class JsonParser {
+public:
+    JsonParser(const char* begin, const char* end)
+        : begin_(begin), cur_(begin), end_(end) {}
+
+    JsonValue ParseDocument() {
+        JsonValue value;
+        SkipWhitespace();
+        ParseValue(value, 0);
+        SkipWhitespace();
+        if (cur_ != end_) {
+            Fail("Unexpected trailing characters");
+        }
+        return value;
+    }
+
+private:
+    [[noreturn]] void Fail(const std::string& message) const {
+        size_t line = 1;
+        size_t column = 1;
+        for (const char* p = begin_; p < cur_; ++p) {
+            if (*p == '\n') {
+                ++line;
+                column = 1;
+            } else {
+                ++column;
+            }
+        }
+        throw std::runtime_error("JSON parse error at line " + std::to_string(line) +
+                                 ", column " + std::to_string(column) + ": " + message);
+    }
+
+    void SkipWhitespace() {
+        while (cur_ != end_ && (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r')) {
+            ++cur_;
+        }
+    }
+
+    void Expect(char c) {
+        if (cur_ == end_ || *cur_ != c) {
+            Fail(std::string("Expected '") + c + "'");
+        }
+        ++cur_;
+    }
+
+    void ExpectLiteral(const char* literal) {
+        for (const char* p = literal; *p != '\0'; ++p) {
+            if (cur_ == end_ || *cur_ != *p) {
+                Fail(std::string("Invalid literal, expected '") + literal + "'");
+            }
+            ++cur_;
+        }
+    }
+
+    void ParseValue(JsonValue& value, int depth) {
+        if (depth > kMaxDepth) {
+            Fail("Document is nested too deeply");
+        }
+
+        if (cur_ == end_) {
+            Fail("Unexpected end of input");
+        }
+
+        switch (*cur_) {
+            case '{':
+                ParseObject(value, depth);
+                break;
+            case '[':
+                ParseArray(value, depth);
+                break;
+            case '"':
+                value.type_ = JsonValue::Type::STRING;
+                ParseString(value.string_value_);
+                break;
+            case 't':
+                ExpectLiteral("true");
+                value.type_ = JsonValue::Type::BOOLEAN;
+                value.bool_value_ = true;
+                break;
+            case 'f':
+                ExpectLiteral("false");
+                value.type_ = JsonValue::Type::BOOLEAN;
+                value.bool_value_ = false;
+                break;
+            case 'n':
+                ExpectLiteral("null");
+                value.type_ = JsonValue::Type::NUL;
+                break;
+            default:
+                if (*cur_ == '-' || (*cur_ >= '0' && *cur_ <= '9')) {
+                    ParseNumber(value);
+                } else {
+                    Fail("Unexpected character");
+                }
+                break;
+        }
+    }
+
+    void ParseObject(JsonValue& value, int depth) {
+        value.type_ = JsonValue::Type::OBJECT;
+        Expect('{');
+        SkipWhitespace();
+        if (cur_ != end_ && *cur_ == '}') {
+            ++cur_;
+            return;
+        }
+
+        for (;;) {
+            SkipWhitespace();
+            if (cur_ == end_ || *cur_ != '"') {
+                Fail("Expected object key");
+            }
+            value.keys_.emplace_back();
+            ParseString(value.keys_.back());
+
+            SkipWhitespace();
+            Expect(':');
+            SkipWhitespace();
+            value.items_.emplace_back();
+            ParseValue(value.items_.back(), depth + 1);
+
+            SkipWhitespace();
+            if (cur_ != end_ && *cur_ == ',') {
+                ++cur_;
+                continue;
+            }
+            Expect('}');
+            return;
+        }
+    }
+
+    void ParseArray(JsonValue& value, int depth) {
+        value.type_ = JsonValue::Type::ARRAY;
+        Expect('[');
+        SkipWhitespace();
+        if (cur_ != end_ && *cur_ == ']') {
+            ++cur_;
+            return;
+        }
+
+        for (;;) {
+            SkipWhitespace();
+            value.items_.emplace_back();
+            ParseValue(value.items_.back(), depth + 1);
+
+            SkipWhitespace();
+            if (cur_ != end_ && *cur_ == ',') {
+                ++cur_;
+                continue;
+            }
+            Expect(']');
+            return;
+        }
+    }
+
+    uint32_t ParseHex4() {
+        if (end_ - cur_ < 4) {
+            Fail("Truncated unicode escape");
+        }
+
+        uint32_t code = 0;
+        for (int i = 0; i < 4; ++i, ++cur_) {
+            char c = *cur_;
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                code |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                code |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                Fail("Invalid unicode escape");
+            }
+        }
+        return code;
+    }
+
+    static void AppendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    void ParseString(std::string& out) {
+        Expect('"');
+        for (;;) {
+            // Copy runs of plain characters in one go
+            const char* run = cur_;
+            while (cur_ != end_ && *cur_ != '"' && *cur_ != '\\' &&
+                   static_cast<unsigned char>(*cur_) >= 0x20) {
+                ++cur_;
+            }
+            out.append(run, cur_);
+
+            if (cur_ == end_) {
+                Fail("Unterminated string");
+            }
+
+            char c = *cur_++;
+            if (c == '"') {
+                return;
+            }
+            if (c != '\\') {
+                --cur_;
+                Fail("Control character in string");
+            }
+
+            if (cur_ == end_) {
+                Fail("Unterminated escape sequence");
+            }
+            switch (*cur_++) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code = ParseHex4();
+                    if (code >= 0xD800 && code <= 0xDBFF) {
+                        // High surrogate; must be followed by a low surrogate
+                        if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') {
+                            Fail("Unpaired surrogate in unicode escape");
+                        }
+                        cur_ += 2;
+                        uint32_t low = ParseHex4();
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            Fail("Invalid low surrogate in unicode escape");
+                        }
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (code >= 0xDC00 && code <= 0xDFFF) {
+                        Fail("Unpaired surrogate in unicode escape");
+                    }
+                    AppendUtf8(out, code);
+                    break;
+                }
+                default:
+                    --cur_;
+                    Fail("Invalid escape sequence");
+            }
+        }
+    }
+
+    void ParseNumber(JsonValue& value) {
+        const char* start = cur_;
+        bool negative = false;
+        if (*cur_ == '-') {
+            negative = true;
+            ++cur_;
+        }
+
+        if (cur_ == end_ || *cur_ < '0' || *cur_ > '9') {
+            Fail("Invalid number");
+        }
+
+        // Accumulate the integer part exactly while it fits
+        uint64_t integer = 0;
+        bool overflow = false;
+        if (*cur_ == '0') {
+            ++cur_;
+        } else {
+            while (cur_ != end_ && *cur_ >= '0' && *cur_ <= '9') {
+                uint64_t digit = static_cast<uint64_t>(*cur_ - '0');
+                if (integer > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                    overflow = true;
+                }
+                integer = integer * 10 + digit;
+                ++cur_;
+            }
+        }
+
+        bool is_integer = true;
+        if (cur_ != end_ && *cur_ == '.') {
+            is_integer = false;
+            ++cur_;
+            if (cur_ == end_ || *cur_ < '0' || *cur_ > '9') {
+                Fail("Invalid number");
+            }
+            while (cur_ != end_ && *cur_ >= '0' && *cur_ <= '9') {
+                ++cur_;
+            }
+        }
+
+        if (cur_ != end_ && (*cur_ == 'e' || *cur_ == 'E')) {
+            is_integer = false;
+            ++cur_;
+            if (cur_ != end_ && (*cur_ == '+' || *cur_ == '-')) {
+                ++cur_;
+            }
+            if (cur_ == end_ || *cur_ < '0' || *cur_ > '9') {
+                Fail("Invalid number");
+            }
+            while (cur_ != end_ && *cur_ >= '0' && *cur_ <= '9') {
+                ++cur_;
+            }
+        }
+
+        value.type_ = JsonValue::Type::NUMBER;
+        if (is_integer && !overflow && !negative) {
+            value.is_uint_ = true;
+            value.uint_value_ = integer;
+            value.number_value_ = static_cast<double>(integer);
+        } else if (is_integer && !overflow) {
+            value.number_value_ = -static_cast<double>(integer);
+        } else {
+            // strtod needs a terminated copy; numbers are short
+            std::string text(start, cur_);
+            value.number_value_ = std::strtod(text.c_str(), nullptr);
+        }
+    }
+
+    const char* begin_;  ///< Start of the input, for error positions
+    const char* cur_;    ///< Next character to parse
+    const char* end_;    ///< End of the input
+};
+
+JsonValue::JsonValue()
+    : type_(Type::NUL)
+    , bool_value_(false)
+    , is_uint_(false)
+    , uint_value_(0)
+    , number_value_(0.0) {
+}
+
+JsonValue JsonValue::Parse(const std::string& text) {
+    JsonParser parser(text.data(), text.data() + text.size());
+    return parser.ParseDocument();
+}
+
+JsonValue::Type JsonValue::GetType() const {
+    return type_;
+}
+
+bool JsonValue::AsBool() const {
+    if (type_ != Type::BOOLEAN) {
+        throw std::runtime_error("JSON value is not a boolean");
+    }
+    return bool_value_;
+}
+
+double JsonValue::AsDouble() const {
+    if (type_ != Type::NUMBER) {
+        throw std::runtime_error("JSON value is not a number");
+    }
+    return number_value_;
+}
+
+uint64_t JsonValue::AsUint64() const {
+    if (type_ != Type::NUMBER) {
+        throw std::runtime_error("JSON value is not a number");
+    }
+
+    if (is_uint_) {
+        return uint_value_;
+    }
+
+    // Accept integral values written with a fraction or exponent, e.g. 1e6
+    if (number_value_ >= 0.0 && number_value_ < 18446744073709551616.0 &&
+        std::floor(number_value_) == number_value_) {
+        return static_cast<uint64_t>(number_value_);
+    }
+
+    throw std::runtime_error("JSON number is not a non-negative integer");
+}
+
+const std::string& JsonValue::AsString() const {
+    if (type_ != Type::STRING) {
+        throw std::runtime_error("JSON value is not a string");
+    }
+    return string_value_;
+}
+
+size_t JsonValue::Size() const {
+    return (type_ == Type::ARRAY || type_ == Type::OBJECT) ? items_.size() : 0;
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    if (type_ != Type::ARRAY) {
+        throw std::runtime_error("JSON value is not an array");
+    }
+    return items_.at(index);
+}
+
+const std::string& JsonValue::KeyAt(size_t index) const {
+    if (type_ != Type::OBJECT) {
+        throw std::runtime_error("JSON value is not an object");
+    }
+    return keys_.at(index);
+}
+
+const JsonValue& JsonValue::ValueAt(size_t index) const {
+    if (type_ != Type::OBJECT) {
+        throw std::runtime_error("JSON value is not an object");
+    }
+    return items_.at(index);
+}
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+    if (type_ != Type::OBJECT) {
+        return nullptr;
+    }
+
+    // Profiles have a few dozen keys at most; a linear scan beats hashing
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (keys_[i] == key) {
+            return &items_[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace utils
+}  // namespace nvmeof
@@ -0,0 +1,71 @@
+#include "../../include/utils/tsc_clock.h"
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace nvmeof {
+namespace utils {
+
+namespace {
+
+// Long enough for a calibration error well below 0.1%
+constexpr auto kCalibrationPeriod = std::chrono::milliseconds(20);
+
+#if defined(__x86_64__) || defined(__i386__)
+bool HasInvariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+        return false;
+    }
+
+    // CPUID.80000007H:EDX[8] - the TSC runs at a constant rate in all states
+    __cpuid(0x80000007, eax, ebx, ecx, edx);
+    return (edx & (1u << 8)) != 0;
+}
+#endif
+
+}  // namespace
+
+bool TscClock::IsTscEnabled() {
+    return GetCalibration().use_tsc;
+}
+
+double TscClock::GetTicksPerSecond() {
+    return 1e9 / GetCalibration().ns_per_tick;
+}
+
+const TscClock::Calibration& TscClock::GetCalibration() {
+    static const Calibration calibration = Calibrate();
+    return calibration;
+}
+
+TscClock::Calibration TscClock::Calibrate() {
+    Calibration fallback{false, 1.0};
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (!HasInvariantTsc()) {
+        return fallback;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    uint64_t start_ticks = __rdtsc();
+    std::this_thread::sleep_for(kCalibrationPeriod);
+    auto end_time = std::chrono::steady_clock::now();
+    uint64_t end_ticks = __rdtsc();
+
+    double elapsed_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+    if (end_ticks <= start_ticks || elapsed_ns <= 0.0) {
+        return fallback;
+    }
+
+    return Calibration{true, elapsed_ns / static_cast<double>(end_ticks - start_ticks)};
+#else
+    return fallback;
+#endif
+}
+
+}  // namespace utils
+}  // namespace nvmeof
@@ -19,6 +19,8 @@
 
 #include "../include/benchmarking/data_collector.h"
 #include "../include/benchmarking/result_visualizer.h"
+#include "../include/benchmarking/result_file.h"
+#include "../include/benchmarking/stream_compression.h"
 #include "../include/bottleneck_analysis/bottleneck_detector.h"
 #include "../include/utils/nvmeof_utils.h"
 
@@ -174,12 +176,56 @@ struct BenchmarkData {
     std::map<std::string, std::string> units;
 };
 
-// Parse benchmark data from a CSV file
+// Parse benchmark data from a binary result file
+BenchmarkData parseBinaryBenchmarkData(const std::string& filename) {
+    BenchmarkData data;
+    nvmeof::benchmarking::ResultFileReader reader;
+    if (!reader.Open(filename)) {
+        return data;
+    }
+    if (reader.IsRecovered()) {
+        std::cerr << "Warning: " << filename << " is incomplete; read "
+                  << reader.GetBlockCount() << " blocks" << std::endl;
+    }
+    
+    // Labels are resolved once per dictionary entry rather than per point
+    std::vector<std::vector<double>*> series(reader.GetLabelCount(), nullptr);
+    for (uint32_t id = 0; id < reader.GetLabelCount(); ++id) {
+        const std::string& label = reader.GetLabel(id);
+        if (label == "Benchmark Start" || label == "Benchmark End") {
+            continue;
+        }
+        series[id] = &data.metrics[label];
+        data.units.emplace(label, reader.GetUnits(id));
+    }
+    
+    // Points are stored in time order, so a new second means a new timestamp
+    int64_t last_second = -1;
+    reader.ForEachPoint([&](int64_t timestamp_ns, uint32_t id, double value) {
+        if (series[id] == nullptr) {
+            return;
+        }
+        if (timestamp_ns / 1000000000 != last_second) {
+            last_second = timestamp_ns / 1000000000;
+            data.timestamps.push_back(nvmeof::benchmarking::FormatResultTimestamp(timestamp_ns));
+        }
+        series[id]->push_back(value);
+    });
+    
+    return data;
+}
+
+// Parse benchmark data from a CSV or binary file
 BenchmarkData parseBenchmarkData(const std::string& filename) {
+    if (nvmeof::benchmarking::ResultFileReader::IsResultFile(filename)) {
+        return parseBinaryBenchmarkData(filename);
+    }
+    
     BenchmarkData data;
-    std::ifstream file(filename);
+    std::unique_ptr<std::istream> stream = nvmeof::benchmarking::OpenResultStream(filename);
+    std::istream& file = *stream;
     
-    if (!file.is_open()) {
+    if (!file) {
         std::cerr << "Error: Unable to open file: " << filename << std::endl;
         return data;
     }
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/access_pattern.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+namespace {
+
+// Draws samples and counts how often each block is hit
+std::vector<uint64_t> SampleHistogram(OffsetGenerator& generator, uint64_t num_blocks, int samples) {
+    std::vector<uint64_t> hits(num_blocks, 0);
+    for (int i = 0; i < samples; ++i) {
+        uint64_t block = generator.NextBlock();
+        EXPECT_LT(block, num_blocks);
+        if (block < num_blocks) {
+            ++hits[block];
+        }
+    }
+    return hits;
+}
+
+// Share of the samples that hit the first `blocks` blocks
+double ShareOfFirst(const std::vector<uint64_t>& hits, uint64_t blocks, int samples) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < blocks; ++i) {
+        sum += hits[i];
+    }
+    return static_cast<double>(sum) / samples;
+}
+
+}  // namespace
+
+// Test distribution name parsing
+TEST(AccessPatternTest, ParseAccessDistribution) {
+    EXPECT_EQ(AccessDistribution::UNIFORM, ParseAccessDistribution("uniform"));
+    EXPECT_EQ(AccessDistribution::ZIPF, ParseAccessDistribution("Zipf"));
+    EXPECT_EQ(AccessDistribution::PARETO, ParseAccessDistribution("PARETO"));
+    EXPECT_EQ(AccessDistribution::HOT_COLD, ParseAccessDistribution("hotcold"));
+    EXPECT_EQ(AccessDistribution::NORMAL, ParseAccessDistribution("normal"));
+    EXPECT_EQ(AccessDistribution::STRIDED, ParseAccessDistribution("strided"));
+    EXPECT_THROW(ParseAccessDistribution("bimodal"), std::invalid_argument);
+}
+
+// Test parameter validation
+TEST(AccessPatternTest, ConfigValidation) {
+    AccessPatternConfig config;
+    EXPECT_TRUE(config.IsValid());
+
+    config.distribution = AccessDistribution::ZIPF;
+    config.zipf_theta = 0.0;
+    EXPECT_FALSE(config.IsValid());
+
+    config.distribution = AccessDistribution::HOT_COLD;
+    config.hot_space_percentage = 0;
+    EXPECT_FALSE(config.IsValid());
+
+    config.distribution = AccessDistribution::STRIDED;
+    config.stride_blocks = 0;
+    EXPECT_FALSE(config.IsValid());
+    EXPECT_THROW(OffsetGenerator::Create(config, 100), std::invalid_argument);
+
+    EXPECT_THROW(OffsetGenerator::Create(AccessPatternConfig(), 0), std::invalid_argument);
+}
+
+// Test that uniform sampling covers the range evenly
+TEST(AccessPatternTest, Uniform) {
+    const uint64_t num_blocks = 100;
+    const int samples = 200000;
+    auto generator = OffsetGenerator::Create(AccessPatternConfig(), num_blocks, 1);
+    EXPECT_EQ(AccessDistribution::UNIFORM, generator->GetDistribution());
+
+    auto hits = SampleHistogram(*generator, num_blocks, samples);
+    for (uint64_t count : hits) {
+        EXPECT_NEAR(samples / num_blocks, count, samples / num_blocks * 0.15);
+    }
+}
+
+// Test that Zipf sampling follows 1 / k^theta
+TEST(AccessPatternTest, Zipf) {
+    const uint64_t num_blocks = 1000;
+    const int samples = 200000;
+    for (double theta : {0.8, 1.0, 1.2}) {
+        AccessPatternConfig config;
+        config.distribution = AccessDistribution::ZIPF;
+        config.zipf_theta = theta;
+        auto generator = OffsetGenerator::Create(config, num_blocks, 1);
+
+        double norm = 0.0;
+        for (uint64_t k = 1; k <= num_blocks; ++k) {
+            norm += 1.0 / std::pow(static_cast<double>(k), theta);
+        }
+
+        auto hits = SampleHistogram(*generator, num_blocks, samples);
+        for (uint64_t k = 1; k <= 3; ++k) {
+            double expected = 1.0 / std::pow(static_cast<double>(k), theta) / norm;
+            EXPECT_NEAR(expected, static_cast<double>(hits[k - 1]) / samples, expected * 0.05)
+                << "theta " << theta << " rank " << k;
+        }
+    }
+}
+
+// Test that Zipf sampling handles very large ranges without a precomputed table
+TEST(AccessPatternTest, ZipfLargeRange) {
+    AccessPatternConfig config;
+    config.distribution = AccessDistribution::ZIPF;
+    const uint64_t num_blocks = 1ULL << 40;
+    auto generator = OffsetGenerator::Create(config, num_blocks, 1);
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_LT(generator->NextBlock(), num_blocks);
+    }
+}
+
+// Test that the default Pareto shape gives roughly the 80/20 rule
+TEST(AccessPatternTest, Pareto) {
+    const uint64_t num_blocks = 10000;
+    const int samples = 200000;
+    AccessPatternConfig config;
+    config.distribution = AccessDistribution::PARETO;
+    auto generator = OffsetGenerator::Create(config, num_blocks, 1);
+
+    auto hits = SampleHistogram(*generator, num_blocks, samples);
+    double head_share = ShareOfFirst(hits, num_blocks / 5, samples);
+    EXPECT_GT(head_share, 0.75);
+    EXPECT_LT(head_share, 1.0);
+}
+
+// Test that the hot set receives the configured share of the I/O
+TEST(AccessPatternTest, HotCold) {
+    const uint64_t num_blocks = 1000;
+    const int samples = 200000;
+    AccessPatternConfig config;
+    config.distribution = AccessDistribution::HOT_COLD;
+    config.hot_io_percentage = 90;
+    config.hot_space_percentage = 10;
+    auto generator = OffsetGenerator::Create(config, num_blocks, 1);
+
+    auto hits = SampleHistogram(*generator, num_blocks, samples);
+    EXPECT_NEAR(0.90, ShareOfFirst(hits, num_blocks / 10, samples), 0.01);
+}
+
+// Test the normal distribution and its moving center
+TEST(AccessPatternTest, Normal) {
+    const uint64_t num_blocks = 10000;
+    const int samples = 100000;
+    AccessPatternConfig config;
+    config.distribution = AccessDistribution::NORMAL;
+    config.normal_stddev_percentage = 1.0;
+    auto generator = OffsetGenerator::Create(config, num_blocks, 1);
+
+    // About 95% of the samples fall within two standard deviations of the center
+    auto hits = SampleHistogram(*generator, num_blocks, samples);
+    uint64_t near_center = 0;
+    for (uint64_t i = 4800; i < 5200; ++i) {
+        near_center += hits[i];
+    }
+    EXPECT_NEAR(0.95, static_cast<double>(near_center) / samples, 0.01);
+
+    // A moving center sweeps the whole range
+    config.normal_center_step = 1.0;
+    generator = OffsetGenerator::Create(config, num_blocks, 1);
+    hits = SampleHistogram(*generator, num_blocks, samples);
+    EXPECT_GT(ShareOfFirst(hits, num_blocks / 4, samples), 0.2);
+}
+
+// Test strided access and wrap-around
+TEST(AccessPatternTest, Strided) {
+    AccessPatternConfig config;
+    config.distribution = AccessDistribution::STRIDED;
+    config.stride_blocks = 3;
+    auto generator = OffsetGenerator::Create(config, 10, 1);
+
+    std::vector<uint64_t> blocks;
+    for (int i = 0; i < 6; ++i) {
+        blocks.push_back(generator->NextBlock());
+    }
+    EXPECT_EQ(std::vector<uint64_t>({0, 3, 6, 9, 2, 5}), blocks);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/batch_histogram.h"
+
+using namespace nvmeof::benchmarking;
+
+// Test that an empty histogram reports nothing
+TEST(BatchHistogramTest, Empty) {
+    BatchHistogram histogram;
+    histogram.Record(0);
+    EXPECT_EQ(0u, histogram.GetBatchCount());
+    EXPECT_EQ(0u, histogram.GetCommandCount());
+    EXPECT_DOUBLE_EQ(0.0, histogram.GetMean());
+    EXPECT_EQ(0u, histogram.GetMax());
+}
+
+// Test that sizes fall into power-of-two buckets
+TEST(BatchHistogramTest, Buckets) {
+    BatchHistogram histogram;
+    for (uint32_t size : {1u, 2u, 3u, 4u, 7u, 8u, 255u, 256u, 4096u}) {
+        histogram.Record(size);
+    }
+
+    EXPECT_EQ(1u, histogram.GetBucketCount(0));
+    EXPECT_EQ(2u, histogram.GetBucketCount(1));
+    EXPECT_EQ(2u, histogram.GetBucketCount(2));
+    EXPECT_EQ(1u, histogram.GetBucketCount(3));
+    EXPECT_EQ(1u, histogram.GetBucketCount(7));
+    EXPECT_EQ(2u, histogram.GetBucketCount(8));
+    EXPECT_EQ(0u, histogram.GetBucketCount(BatchHistogram::kNumBuckets));
+    EXPECT_EQ(1u, BatchHistogram::GetBucketLowerBound(0));
+    EXPECT_EQ(256u, BatchHistogram::GetBucketLowerBound(8));
+
+    EXPECT_EQ(9u, histogram.GetBatchCount());
+    EXPECT_EQ(4632u, histogram.GetCommandCount());
+    EXPECT_EQ(4096u, histogram.GetMax());
+}
+
+// Test merging the histograms of two workers
+TEST(BatchHistogramTest, Merge) {
+    BatchHistogram a;
+    a.Record(4);
+    a.Record(4);
+
+    BatchHistogram b;
+    b.Record(1);
+    b.Record(16);
+
+    a.Merge(b);
+    EXPECT_EQ(4u, a.GetBatchCount());
+    EXPECT_DOUBLE_EQ(25.0 / 4, a.GetMean());
+    EXPECT_EQ(16u, a.GetMax());
+    EXPECT_EQ(2u, a.GetBucketCount(2));
+    EXPECT_EQ(1u, a.GetBucketCount(4));
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/block_trace.h"
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for trace files in a temporary directory
+class BlockTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "block_trace_test";
+        std::filesystem::create_directories(test_dir_);
+        trace_path_ = (test_dir_ / "trace.nvbt").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // Write records at 1 ms intervals over 8 MiB, alternating reads and writes across 4 CPUs
+    void WriteTrace(uint64_t count) {
+        TraceWriter writer;
+        ASSERT_TRUE(writer.Open(trace_path_));
+        for (uint64_t i = 0; i < count; ++i) {
+            TraceRecord record{};
+            record.timestamp_ns = 5000000 + i * 1000000;
+            record.offset = (i * 256 * 1024) % (8 << 20);
+            record.size = i % 3 == 0 ? 8192 : 4096;
+            record.cpu = static_cast<uint16_t>(i % 4);
+            record.is_write = i % 2;
+            ASSERT_TRUE(writer.Append(record));
+        }
+        EXPECT_EQ(count, writer.GetRecordCount());
+        ASSERT_TRUE(writer.Close());
+    }
+
+    std::filesystem::path test_dir_;
+    std::string trace_path_;
+};
+
+// Test parsing partition names
+TEST_F(BlockTraceTest, ParseTracePartition) {
+    EXPECT_EQ(TracePartition::LBA, ParseTracePartition("lba"));
+    EXPECT_EQ(TracePartition::CPU, ParseTracePartition("CPU"));
+    EXPECT_THROW(ParseTracePartition("pid"), std::invalid_argument);
+}
+
+// Test that written records are read back from the mapping with the header fields
+TEST_F(BlockTraceTest, WriteAndRead) {
+    WriteTrace(100);
+
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(trace_path_));
+    EXPECT_EQ(100u, reader.GetRecordCount());
+    EXPECT_EQ(5000000u, reader.GetStartNs());
+    EXPECT_EQ(8192u, reader.GetMaxSize());
+
+    const TraceRecord& record = reader.GetRecord(7);
+    EXPECT_EQ(12000000u, record.timestamp_ns);
+    EXPECT_EQ(7u * 256 * 1024, record.offset);
+    EXPECT_EQ(4096u, record.size);
+    EXPECT_EQ(3u, record.cpu);
+    EXPECT_EQ(1u, record.is_write);
+
+    // Released records are paged in again on access
+    reader.ReleaseBefore(100);
+    EXPECT_EQ(12000000u, reader.GetRecord(7).timestamp_ns);
+
+    reader.Close();
+    EXPECT_EQ(0u, reader.GetRecordCount());
+}
+
+// Test that missing, foreign and truncated files are rejected
+TEST_F(BlockTraceTest, InvalidFiles) {
+    TraceReader reader;
+    EXPECT_FALSE(reader.Open((test_dir_ / "missing.nvbt").string()));
+
+    std::ofstream((test_dir_ / "text.nvbt").string()) << std::string(100, 'x');
+    EXPECT_FALSE(reader.Open((test_dir_ / "text.nvbt").string()));
+
+    WriteTrace(10);
+    std::filesystem::resize_file(trace_path_, std::filesystem::file_size(trace_path_) - 1);
+    EXPECT_FALSE(reader.Open(trace_path_));
+}
+
+// Test that both partitions give every record to exactly one worker
+TEST_F(BlockTraceTest, Partitions) {
+    WriteTrace(1000);
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(trace_path_));
+
+    EXPECT_THROW(TraceCursor(reader, TracePartition::LBA, 3, 3), std::invalid_argument);
+
+    for (TracePartition partition : {TracePartition::LBA, TracePartition::CPU}) {
+        std::set<uint64_t> seen;
+        for (uint32_t worker = 0; worker < 3; ++worker) {
+            TraceCursor cursor(reader, partition, worker, 3);
+            std::set<uint64_t> keys;
+            while (cursor.HasNext()) {
+                const TraceRecord& record = cursor.Next();
+                EXPECT_TRUE(seen.insert(record.timestamp_ns).second);
+                keys.insert(partition == TracePartition::LBA ? record.offset / TraceCursor::kStripeBytes
+                                                             : record.cpu);
+            }
+            EXPECT_EQ(1000u, cursor.GetPosition());
+
+            // Each stripe or CPU stays with one worker
+            for (uint64_t key : keys) {
+                EXPECT_EQ(worker, key % 3);
+            }
+        }
+        EXPECT_EQ(1000u, seen.size());
+    }
+}
+
+// Test importing blkparse output
+TEST_F(BlockTraceTest, ImportBlkparse) {
+    std::istringstream input(
+        "  8,0    3        1     0.000000000   697  Q   W 223490 + 8 [kjournald]\n"
+        "  8,0    3        2     0.000001000   697  G   W 223490 + 8 [kjournald]\n"
+        "  8,0    1        3     0.000250000   700  Q  RA 1024 + 16 [cat]\n"
+        "  8,0    1        4     0.000300000   700  Q   D 4096 + 2048 [fstrim]\n"
+        "  8,0    0        5     0.000400000   701  Q  FN [flush]\n"
+        "  8,0    2        6     1.500000000   702  Q  WS 2048 + 256 [sync]\n"
+        "  8,0    2        7     1.500100000   702  D  WS 2048 + 256 [sync]\n"
+        "CPU0 (8,0):\n"
+        " Reads Queued:           1,        8KiB\n");
+
+    TraceWriter writer;
+    ASSERT_TRUE(writer.Open(trace_path_));
+    EXPECT_EQ(3, ImportBlkparseTrace(input, writer));
+    ASSERT_TRUE(writer.Close());
+
+    TraceReader reader;
+    ASSERT_TRUE(reader.Open(trace_path_));
+    ASSERT_EQ(3u, reader.GetRecordCount());
+    EXPECT_EQ(131072u, reader.GetMaxSize());
+
+    EXPECT_EQ(0u, reader.GetRecord(0).timestamp_ns);
+    EXPECT_EQ(223490u * 512, reader.GetRecord(0).offset);
+    EXPECT_EQ(4096u, reader.GetRecord(0).size);
+    EXPECT_EQ(3u, reader.GetRecord(0).cpu);
+    EXPECT_EQ(1u, reader.GetRecord(0).is_write);
+
+    EXPECT_EQ(250000u, reader.GetRecord(1).timestamp_ns);
+    EXPECT_EQ(0u, reader.GetRecord(1).is_write);
+    EXPECT_EQ(8192u, reader.GetRecord(1).size);
+
+    EXPECT_EQ(1500000000u, reader.GetRecord(2).timestamp_ns);
+    EXPECT_EQ(2u, reader.GetRecord(2).cpu);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/block_verifier.h"
+#include "../../../include/benchmarking/payload_generator.h"
+#include <cstring>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test constructor with invalid parameters
+TEST(BlockVerifierTest, ConstructorInvalidParams) {
+    EXPECT_THROW(BlockVerifier(0, 1), std::invalid_argument);
+    EXPECT_THROW(BlockVerifier(32, 1), std::invalid_argument);
+    EXPECT_NO_THROW(BlockVerifier(512, 1));
+}
+
+// Test that stamped blocks verify at their own offset
+TEST(BlockVerifierTest, StampAndVerify) {
+    BlockVerifier verifier(512, 99);
+    std::vector<uint8_t> buffer(4096);
+    PayloadGenerator::FillRandom(buffer.data(), buffer.size(), 1);
+
+    EXPECT_EQ(1u, verifier.Stamp(buffer.data(), 8192, 4096));
+    EXPECT_EQ(2u, verifier.Stamp(buffer.data(), 8192, 4096));
+
+    VerifyStats stats;
+    EXPECT_EQ(0u, verifier.Verify(buffer.data(), 8192, 4096, stats));
+    EXPECT_EQ(8u, stats.blocks_verified);
+    EXPECT_EQ(0u, stats.errors);
+
+    // A read of part of the write checks only the blocks it covers
+    EXPECT_EQ(0u, verifier.Verify(buffer.data() + 1024, 8192 + 1024, 1024, stats));
+    EXPECT_EQ(10u, stats.blocks_verified);
+
+    // Another verifier with the same seed accepts the data, e.g. a later read-only job
+    BlockVerifier reader(512, 99);
+    EXPECT_EQ(0u, reader.Verify(buffer.data(), 8192, 4096, stats));
+}
+
+// Test that zero blocks count as unwritten rather than as errors
+TEST(BlockVerifierTest, UnwrittenBlocks) {
+    BlockVerifier verifier(512, 1);
+    std::vector<uint8_t> buffer(2048, 0);
+    verifier.Stamp(buffer.data(), 0, 512);
+
+    VerifyStats stats;
+    EXPECT_EQ(0u, verifier.Verify(buffer.data(), 0, 2048, stats));
+    EXPECT_EQ(1u, stats.blocks_verified);
+    EXPECT_EQ(3u, stats.blocks_unwritten);
+}
+
+// Test each kind of failure and its details
+TEST(BlockVerifierTest, Failures) {
+    BlockVerifier verifier(512, 5);
+    std::vector<uint8_t> buffer(4 * 512);
+    PayloadGenerator::FillRandom(buffer.data(), buffer.size(), 3);
+    verifier.Stamp(buffer.data(), 0, 4 * 512);
+
+    // Flip a payload bit in block 0
+    buffer[100] ^= 0x01;
+    // Overwrite the header of block 1 with data
+    std::memset(buffer.data() + 512, 0xAB, 16);
+    // Block 2 written for LBA 7
+    verifier.Stamp(buffer.data() + 2 * 512, 7 * 512, 512);
+    // Block 3 written by a run with another seed
+    BlockVerifier(512, 6).Stamp(buffer.data() + 3 * 512, 3 * 512, 512);
+
+    VerifyStats stats;
+    EXPECT_EQ(4u, verifier.Verify(buffer.data(), 0, 4 * 512, stats));
+    EXPECT_EQ(4u, stats.errors);
+    EXPECT_EQ(0u, stats.blocks_verified);
+    ASSERT_EQ(4u, stats.failures.size());
+
+    EXPECT_EQ(VerifyErrorType::CRC_MISMATCH, stats.failures[0].type);
+    EXPECT_EQ(0u, stats.failures[0].lba);
+    EXPECT_EQ(1u, stats.failures[0].generation);
+    EXPECT_NE(stats.failures[0].expected_crc, stats.failures[0].actual_crc);
+
+    EXPECT_EQ(VerifyErrorType::BAD_MAGIC, stats.failures[1].type);
+    EXPECT_EQ(1u, stats.failures[1].lba);
+
+    EXPECT_EQ(VerifyErrorType::LBA_MISMATCH, stats.failures[2].type);
+    EXPECT_EQ(2u, stats.failures[2].lba);
+    EXPECT_EQ(7u, stats.failures[2].header_lba);
+    EXPECT_EQ(2u, stats.failures[2].generation);
+
+    EXPECT_EQ(VerifyErrorType::SEED_MISMATCH, stats.failures[3].type);
+    EXPECT_EQ(6u, stats.failures[3].seed);
+
+    EXPECT_EQ("crc_mismatch", GetVerifyErrorTypeName(VerifyErrorType::CRC_MISMATCH));
+}
+
+// Test that only the first failures keep their details, also when merged
+TEST(BlockVerifierTest, FailureLimit) {
+    VerifyStats a;
+    VerifyStats b;
+    VerifyError error;
+    for (size_t i = 0; i < VerifyStats::kMaxReportedErrors + 4; ++i) {
+        error.lba = i;
+        a.RecordError(error);
+        b.RecordError(error);
+    }
+    EXPECT_EQ(VerifyStats::kMaxReportedErrors + 4, a.errors);
+    EXPECT_EQ(VerifyStats::kMaxReportedErrors, a.failures.size());
+
+    VerifyStats merged;
+    merged.blocks_verified = 3;
+    merged.Merge(a);
+    merged.Merge(b);
+    EXPECT_EQ(2 * (VerifyStats::kMaxReportedErrors + 4), merged.errors);
+    EXPECT_EQ(3u, merged.blocks_verified);
+    EXPECT_EQ(VerifyStats::kMaxReportedErrors, merged.failures.size());
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/capsule_protocol.h"
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#include <sys/socket.h>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the capsule PDUs and socket helpers
+class CapsuleProtocolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "capsule_protocol_test";
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // Connect to a listening socket and exchange a few bytes both ways
+    static void ExpectEcho(int listen_fd, const std::string& address) {
+        int client = capsule::ConnectToAddress(address);
+        ASSERT_GE(client, 0);
+        int server = accept(listen_fd, nullptr, nullptr);
+        ASSERT_GE(server, 0);
+
+        const char request[] = "capsule";
+        char received[sizeof(request)] = {0};
+        EXPECT_TRUE(capsule::SendAll(client, request, sizeof(request)));
+        EXPECT_TRUE(capsule::ReceiveAll(server, received, sizeof(received)));
+        EXPECT_STREQ(request, received);
+
+        // End of stream is reported as a failure
+        close(client);
+        EXPECT_FALSE(capsule::ReceiveAll(server, received, 1));
+        close(server);
+    }
+
+    std::filesystem::path test_dir_;
+};
+
+// Test that PDU headers are filled in from the PDU type and data length
+TEST_F(CapsuleProtocolTest, MakePdu) {
+    auto command = capsule::MakePdu<capsule::CapsuleCmdPdu>(capsule::PduType::CAPSULE_CMD);
+    EXPECT_EQ(0x04, command.header.type);
+    EXPECT_EQ(sizeof(capsule::CapsuleCmdPdu), command.header.hlen);
+    EXPECT_EQ(0, command.header.pdo);
+    EXPECT_EQ(sizeof(capsule::CapsuleCmdPdu), command.header.plen);
+    EXPECT_EQ(0u, command.slba);
+
+    auto data = capsule::MakePdu<capsule::DataPdu>(capsule::PduType::C2H_DATA, 4096);
+    EXPECT_EQ(0x07, data.header.type);
+    EXPECT_EQ(sizeof(capsule::DataPdu), data.header.pdo);
+    EXPECT_EQ(sizeof(capsule::DataPdu) + 4096, data.header.plen);
+}
+
+// Test the expected header length of each PDU type
+TEST_F(CapsuleProtocolTest, GetPduHeaderLength) {
+    EXPECT_EQ(sizeof(capsule::IcReqPdu), capsule::GetPduHeaderLength(0x00));
+    EXPECT_EQ(sizeof(capsule::IcRespPdu), capsule::GetPduHeaderLength(0x01));
+    EXPECT_EQ(sizeof(capsule::CapsuleCmdPdu), capsule::GetPduHeaderLength(0x04));
+    EXPECT_EQ(sizeof(capsule::CapsuleRespPdu), capsule::GetPduHeaderLength(0x05));
+    EXPECT_EQ(sizeof(capsule::DataPdu), capsule::GetPduHeaderLength(0x06));
+    EXPECT_EQ(sizeof(capsule::DataPdu), capsule::GetPduHeaderLength(0x07));
+    EXPECT_EQ(0u, capsule::GetPduHeaderLength(0x02));
+    EXPECT_EQ(0u, capsule::GetPduHeaderLength(0xff));
+}
+
+// Test listening on an ephemeral TCP port and connecting to it
+TEST_F(CapsuleProtocolTest, TcpSocket) {
+    std::string bound;
+    int listen_fd = capsule::ListenOnAddress("127.0.0.1:0", &bound);
+    ASSERT_GE(listen_fd, 0);
+    EXPECT_EQ(0u, bound.find("127.0.0.1:"));
+    EXPECT_NE("127.0.0.1:0", bound);
+
+    ExpectEcho(listen_fd, bound);
+    close(listen_fd);
+}
+
+// Test listening on a Unix socket, replacing a stale socket file
+TEST_F(CapsuleProtocolTest, UnixSocket) {
+    std::string address = "unix:" + (test_dir_ / "target.sock").string();
+    std::string bound;
+    int stale = capsule::ListenOnAddress(address, &bound);
+    ASSERT_GE(stale, 0);
+    close(stale);
+
+    int listen_fd = capsule::ListenOnAddress(address, &bound);
+    ASSERT_GE(listen_fd, 0);
+    EXPECT_EQ(address, bound);
+
+    ExpectEcho(listen_fd, bound);
+    close(listen_fd);
+}
+
+// Test that malformed and unreachable addresses are rejected
+TEST_F(CapsuleProtocolTest, InvalidAddresses) {
+    std::string bound;
+    EXPECT_EQ(-1, capsule::ListenOnAddress("no-port", &bound));
+    EXPECT_EQ(-1, capsule::ListenOnAddress("unix:", &bound));
+    EXPECT_EQ(-1, capsule::ConnectToAddress("unix:" + (test_dir_ / "missing.sock").string()));
+    EXPECT_EQ(-1, capsule::ConnectToAddress("no-port"));
+}
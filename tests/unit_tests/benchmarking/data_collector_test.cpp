@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
 using namespace nvmeof::benchmarking;
 
@@ -84,6 +85,25 @@ TEST_F(DataCollectorTest, CsvFormatOutput) {
     EXPECT_TRUE(content.find("ms") != std::string::npos);
 }
 
+// Test collecting latency percentiles from a histogram
+TEST_F(DataCollectorTest, CollectLatencyPercentiles) {
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV);
+    
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 100; ++i) {
+        histogram.Record(i * 1000);  // 1-100 µs
+    }
+    
+    EXPECT_TRUE(collector.CollectLatencyPercentiles("Read Latency", histogram));
+    EXPECT_EQ(6, collector.GetDataPointCount());
+    EXPECT_TRUE(collector.Flush());
+    
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_TRUE(content.find("Read Latency p50") != std::string::npos);
+    EXPECT_TRUE(content.find("Read Latency p99.99") != std::string::npos);
+    EXPECT_TRUE(content.find("Read Latency max,100") != std::string::npos);
+}
+
 // Test JSON format output
 TEST_F(DataCollectorTest, JsonFormatOutput) {
     // Create a collector with JSON format
@@ -195,4 +215,167 @@ TEST_F(DataCollectorTest, ThreadSafety) {
     
     // Check the total number of data points
     EXPECT_EQ(num_threads * points_per_thread, collector.GetDataPointCount());
-}
\ No newline at end of file
+}
+// Test that points beyond a full ring are dropped and counted, not blocked on
+TEST_F(DataCollectorTest, DropsWhenRingFull) {
+    EXPECT_THROW(DataCollector(csv_file_path_.string(), OutputFormat::CSV, 0), std::invalid_argument);
+
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV, 4);
+
+    const size_t num_points = 10000;
+    size_t accepted = 0;
+    for (size_t i = 0; i < num_points; ++i) {
+        accepted += collector.CollectDataPoint("Burst", static_cast<double>(i), "") ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, collector.GetDataPointCount());
+    EXPECT_EQ(num_points - accepted, collector.GetDroppedCount());
+    EXPECT_GT(collector.GetDroppedCount(), 0u);
+
+    // Every accepted point reaches the file
+    EXPECT_TRUE(collector.Flush());
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_EQ(accepted + 1, static_cast<size_t>(std::count(content.begin(), content.end(), '\n')));
+}
+
+// Test that rings of exited threads are reused, so thread churn stays bounded
+TEST_F(DataCollectorTest, RingsReusedAcrossThreads) {
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV, 1024);
+
+    const size_t num_threads = 2 * DataCollector::kMaxRings;
+    for (size_t i = 0; i < num_threads; ++i) {
+        std::thread([&collector, i]() {
+            EXPECT_TRUE(collector.CollectDataPoint("Worker " + std::to_string(i), 1.0, "ops"));
+        }).join();
+    }
+    EXPECT_EQ(num_threads, collector.GetDataPointCount());
+    EXPECT_EQ(0u, collector.GetDroppedCount());
+
+    EXPECT_TRUE(collector.Flush());
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_TRUE(content.find("Worker 0,1,ops") != std::string::npos);
+    EXPECT_TRUE(content.find("Worker " + std::to_string(num_threads - 1) + ",1,ops") != std::string::npos);
+}
+
+// Test that a flush writes the points of all threads and long labels are kept whole
+TEST_F(DataCollectorTest, FlushFromManyThreads) {
+    const int num_threads = 8;
+    const int points_per_thread = 1000;
+
+    // Exited threads hand their rings on, so one ring may receive every point
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV, num_threads * points_per_thread * 2);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&collector]() {
+            for (int j = 0; j < points_per_thread; ++j) {
+                collector.CollectDataPoint("Point", j, "units");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(collector.CollectDataPoint(std::string(200, 'L'), 1.0, "units"));
+
+    const size_t expected = num_threads * points_per_thread + 1;
+    EXPECT_EQ(expected, collector.GetDataPointCount());
+    EXPECT_EQ(0u, collector.GetDroppedCount());
+    EXPECT_TRUE(collector.Flush());
+
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_EQ(expected + 1, static_cast<size_t>(std::count(content.begin(), content.end(), '\n')));
+    EXPECT_TRUE(content.find("," + std::string(200, 'L') + ",1,units") != std::string::npos);
+}
+
+// Test collecting through registered metric handles
+TEST_F(DataCollectorTest, CollectRegisteredMetric) {
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV);
+
+    MetricHandle iops = collector.RegisterMetric("IOPS", "ops/s");
+    EXPECT_EQ(iops, collector.RegisterMetric("IOPS", "ops/s"));
+    EXPECT_TRUE(collector.CollectDataPoint(iops, 250000));
+
+    // Points collected by name share the registered handle
+    EXPECT_TRUE(collector.CollectDataPoint("IOPS", 260000, "ops/s"));
+    EXPECT_TRUE(collector.CollectDataPoint("IOPS", 1.5, "Mops/s"));
+    EXPECT_EQ(2u, collector.GetMetricRegistry().GetCount());
+
+    EXPECT_FALSE(collector.CollectDataPoint(MetricHandle(42), 1.0));
+    EXPECT_EQ(3u, collector.GetDataPointCount());
+
+    EXPECT_TRUE(collector.Flush());
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_TRUE(content.find(",IOPS,250000,ops/s") != std::string::npos);
+    EXPECT_TRUE(content.find(",IOPS,260000,ops/s") != std::string::npos);
+    EXPECT_TRUE(content.find(",IOPS,1.5,Mops/s") != std::string::npos);
+}
+
+// Test parsing output format names and their file extensions
+TEST_F(DataCollectorTest, ParseOutputFormat) {
+    EXPECT_EQ(OutputFormat::CSV, ParseOutputFormat("csv"));
+    EXPECT_EQ(OutputFormat::PLAINTEXT, ParseOutputFormat("Text"));
+    EXPECT_EQ(OutputFormat::BINARY, ParseOutputFormat("binary"));
+    EXPECT_THROW(ParseOutputFormat("xml"), std::invalid_argument);
+    EXPECT_STREQ(".nvbr", GetOutputFormatExtension(OutputFormat::BINARY));
+    EXPECT_STREQ(".json", GetOutputFormatExtension(OutputFormat::JSON));
+}
+
+// Test keeping the last N written points for live queries
+TEST_F(DataCollectorTest, RetainLastPoints) {
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV);
+    EXPECT_EQ(RetentionMode::NONE, collector.GetRetentionPolicy().mode);
+    EXPECT_THROW(collector.SetRetentionPolicy({RetentionMode::LAST_N, 0, std::chrono::milliseconds(0)}),
+                 std::invalid_argument);
+
+    MetricHandle iops = collector.RegisterMetric("IOPS", "ops/s");
+    MetricHandle latency = collector.RegisterMetric("Latency", "µs");
+    collector.CollectDataPoint(iops, 1);
+    EXPECT_TRUE(collector.Flush());
+    EXPECT_TRUE(collector.GetRecentDataPoints().empty());
+
+    collector.SetRetentionPolicy({RetentionMode::LAST_N, 5, std::chrono::milliseconds(0)});
+    for (int i = 0; i < 20; ++i) {
+        collector.CollectDataPoint(i % 2 == 0 ? iops : latency, i);
+    }
+    EXPECT_TRUE(collector.Flush());
+
+    std::vector<DataPoint> recent = collector.GetRecentDataPoints();
+    ASSERT_EQ(5u, recent.size());
+    EXPECT_DOUBLE_EQ(15, recent.front().value);
+    EXPECT_EQ("Latency", recent.front().label);
+    EXPECT_EQ("µs", recent.front().units);
+    EXPECT_DOUBLE_EQ(19, recent.back().value);
+    EXPECT_EQ(2u, collector.GetRecentDataPoints(iops).size());
+
+    // The file keeps the full history
+    EXPECT_EQ(21u, collector.GetDataPointCount());
+    std::string content = ReadFileContents(csv_file_path_);
+    EXPECT_EQ(22, std::count(content.begin(), content.end(), '\n'));
+
+    // Shrinking the policy trims what is already retained
+    collector.SetRetentionPolicy({RetentionMode::LAST_N, 2, std::chrono::milliseconds(0)});
+    EXPECT_EQ(2u, collector.GetRecentDataPoints().size());
+    collector.SetRetentionPolicy({});
+    EXPECT_TRUE(collector.GetRecentDataPoints().empty());
+}
+
+// Test keeping only the points of a recent time window
+TEST_F(DataCollectorTest, RetainTimeWindow) {
+    DataCollector collector(csv_file_path_.string(), OutputFormat::CSV);
+    EXPECT_THROW(collector.SetRetentionPolicy({RetentionMode::TIME_WINDOW, 0, std::chrono::milliseconds(0)}),
+                 std::invalid_argument);
+    collector.SetRetentionPolicy({RetentionMode::TIME_WINDOW, 0, std::chrono::milliseconds(200)});
+
+    collector.CollectDataPoint("Old", 1, "");
+    EXPECT_TRUE(collector.Flush());
+    EXPECT_EQ(1u, collector.GetRecentDataPoints().size());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    collector.CollectDataPoint("New", 2, "");
+    EXPECT_TRUE(collector.Flush());
+
+    std::vector<DataPoint> recent = collector.GetRecentDataPoints();
+    ASSERT_EQ(1u, recent.size());
+    EXPECT_EQ("New", recent[0].label);
+    EXPECT_LE(std::chrono::system_clock::now() - recent[0].timestamp, std::chrono::milliseconds(200));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test constructor with invalid parameters
+TEST(DmaBufferPoolTest, ConstructorInvalidParams) {
+    EXPECT_THROW(DmaBufferPool(0, 4), std::invalid_argument);
+    EXPECT_THROW(DmaBufferPool(4096, 0), std::invalid_argument);
+    EXPECT_THROW(DmaBufferPool(4096, 4, 3000), std::invalid_argument);
+}
+
+// Test that buffer sizes are rounded up to the alignment
+TEST(DmaBufferPoolTest, BufferSizeRounding) {
+    DmaBufferPool pool(5000, 2, 4096);
+    EXPECT_EQ(8192u, pool.GetBufferSize());
+    EXPECT_EQ(2u, pool.GetBufferCount());
+    EXPECT_EQ(2u, pool.GetAvailableCount());
+}
+
+// Test acquiring every buffer, exhaustion and recycling
+TEST(DmaBufferPoolTest, AcquireAndRelease) {
+    const uint32_t count = 8;
+    DmaBufferPool pool(4096, count, 4096);
+
+    std::set<void*> buffers;
+    for (uint32_t i = 0; i < count; ++i) {
+        void* buffer = pool.Acquire();
+        ASSERT_NE(nullptr, buffer);
+        EXPECT_TRUE(pool.Owns(buffer));
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buffer) % 4096);
+        buffers.insert(buffer);
+    }
+
+    // Every buffer is distinct and the pool is now empty
+    EXPECT_EQ(count, buffers.size());
+    EXPECT_EQ(0u, pool.GetAvailableCount());
+    EXPECT_EQ(nullptr, pool.Acquire());
+
+    for (void* buffer : buffers) {
+        pool.Release(buffer);
+    }
+    EXPECT_EQ(count, pool.GetAvailableCount());
+
+    // Released buffers are handed out again
+    void* buffer = pool.Acquire();
+    EXPECT_EQ(1u, buffers.count(buffer));
+    pool.Release(buffer);
+}
+
+// Test that foreign and misaligned pointers are not owned by the pool
+TEST(DmaBufferPoolTest, Owns) {
+    DmaBufferPool pool(4096, 2, 4096);
+    int local = 0;
+
+    void* buffer = pool.Acquire();
+    EXPECT_TRUE(pool.Owns(buffer));
+    EXPECT_FALSE(pool.Owns(static_cast<uint8_t*>(buffer) + 1));
+    EXPECT_FALSE(pool.Owns(&local));
+    pool.Release(buffer);
+}
+
+// Test concurrent use of a shared pool
+TEST(DmaBufferPoolTest, ConcurrentAcquireRelease) {
+    const uint32_t count = 16;
+    DmaBufferPool pool(512, count, 512);
+
+    const int num_threads = 4;
+    const int iterations = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&pool, t]() {
+            for (int i = 0; i < iterations; ++i) {
+                void* buffer = pool.Acquire();
+                if (buffer == nullptr) {
+                    continue;
+                }
+
+                // A buffer must never be handed to two threads at once
+                auto* marker = static_cast<volatile int*>(buffer);
+                *marker = t;
+                std::this_thread::yield();
+                EXPECT_EQ(t, *marker);
+                pool.Release(buffer);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(count, pool.GetAvailableCount());
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/hybrid_poll_estimator.h"
+
+using namespace nvmeof::benchmarking;
+
+// Test constructor with invalid parameters
+TEST(HybridPollEstimatorTest, ConstructorInvalidParams) {
+    EXPECT_THROW(HybridPollEstimator(0.0, 0.5), std::invalid_argument);
+    EXPECT_THROW(HybridPollEstimator(1.5, 0.5), std::invalid_argument);
+    EXPECT_THROW(HybridPollEstimator(0.5, 0.0), std::invalid_argument);
+    EXPECT_THROW(HybridPollEstimator(0.5, -1.0), std::invalid_argument);
+}
+
+// Test that the estimator polls right away until it has seen a service time
+TEST(HybridPollEstimatorTest, NoHistory) {
+    HybridPollEstimator estimator;
+    EXPECT_EQ(0u, estimator.GetExpectedServiceNs());
+    EXPECT_EQ(0u, estimator.GetSleepNs(1000, 1000));
+}
+
+// Test the moving average of the service time
+TEST(HybridPollEstimatorTest, ServiceTimeAverage) {
+    HybridPollEstimator estimator(0.5, 0.5);
+    estimator.RecordServiceTime(100000);
+    EXPECT_EQ(100000u, estimator.GetExpectedServiceNs());
+
+    estimator.RecordServiceTime(200000);
+    EXPECT_EQ(150000u, estimator.GetExpectedServiceNs());
+}
+
+// Test that the sleep ends a fraction of the service time after the oldest submission
+TEST(HybridPollEstimatorTest, SleepTime) {
+    HybridPollEstimator estimator(0.5, 0.5);
+    estimator.RecordServiceTime(100000);
+
+    EXPECT_EQ(50000u, estimator.GetSleepNs(1000000, 1000000));
+    EXPECT_EQ(30000u, estimator.GetSleepNs(1000000, 1020000));
+
+    // Past the wakeup, or too close to it to be worth a sleep
+    EXPECT_EQ(0u, estimator.GetSleepNs(1000000, 1060000));
+    EXPECT_EQ(0u, estimator.GetSleepNs(1000000, 1049000));
+}
+
+// Test that the fraction adapts to how sleeps end
+TEST(HybridPollEstimatorTest, FractionAdapts) {
+    HybridPollEstimator estimator(0.5, 0.5);
+    estimator.RecordServiceTime(100000);
+
+    // A completion waiting on the first poll shortens the sleep
+    estimator.RecordWakeup(0, 0);
+    EXPECT_NEAR(0.48, estimator.GetSleepFraction(), 1e-9);
+
+    // A short spin keeps it, a long spin lengthens it
+    estimator.RecordWakeup(3, 5000);
+    EXPECT_NEAR(0.48, estimator.GetSleepFraction(), 1e-9);
+    estimator.RecordWakeup(100, 40000);
+    EXPECT_NEAR(0.50, estimator.GetSleepFraction(), 1e-9);
+
+    // The fraction stays within its bounds
+    for (int i = 0; i < 100; ++i) {
+        estimator.RecordWakeup(0, 0);
+    }
+    EXPECT_NEAR(0.05, estimator.GetSleepFraction(), 1e-9);
+    for (int i = 0; i < 100; ++i) {
+        estimator.RecordWakeup(100, 100000);
+    }
+    EXPECT_NEAR(0.95, estimator.GetSleepFraction(), 1e-9);
+}
+
+// Test that the usual oversleep is taken off the requested sleep
+TEST(HybridPollEstimatorTest, OversleepCompensation) {
+    HybridPollEstimator estimator(0.5, 0.5);
+    estimator.RecordServiceTime(100000);
+
+    estimator.RecordSleep(50000, 70000);
+    EXPECT_EQ(40000u, estimator.GetSleepNs(0, 0));
+
+    // Waking early adds no credit
+    estimator.RecordSleep(50000, 40000);
+    EXPECT_EQ(45000u, estimator.GetSleepNs(0, 0));
+
+    // An overshoot beyond the whole sleep turns sleeping off
+    for (int i = 0; i < 20; ++i) {
+        estimator.RecordSleep(1000, 200000);
+    }
+    EXPECT_EQ(0u, estimator.GetSleepNs(0, 0));
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/io_backend.h"
+#include "../../../include/benchmarking/spdk_backend.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <unistd.h>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the backend options, the file helper and the SPDK backend
+class IoBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ctrlr_ = reinterpret_cast<spdk_nvme_ctrlr*>(1);
+        qpair_ = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, nullptr, 0);
+        ASSERT_NE(nullptr, qpair_);
+
+        test_dir_ = std::filesystem::temp_directory_path() / "io_backend_test";
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        spdk_nvme_ctrlr_free_io_qpair(qpair_);
+        spdk_mock_remove_namespace(2);
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void OnCompletion(void* cb_arg, int status) {
+        static_cast<std::vector<int>*>(cb_arg)->push_back(status);
+    }
+
+    // Poll a backend until the given number of completions has been recorded
+    static void WaitFor(IoBackend& backend, const std::vector<int>& statuses, size_t count) {
+        while (statuses.size() < count) {
+            ASSERT_GE(backend.ProcessCompletions(0), 0);
+        }
+    }
+
+    spdk_nvme_ctrlr* ctrlr_ = nullptr;
+    spdk_nvme_qpair* qpair_ = nullptr;
+    std::filesystem::path test_dir_;
+};
+
+// Test parsing and naming of the I/O engines
+TEST_F(IoBackendTest, ParseIoEngine) {
+    EXPECT_EQ(IoEngine::SPDK, ParseIoEngine("spdk"));
+    EXPECT_EQ(IoEngine::IO_URING, ParseIoEngine("IO_URING"));
+    EXPECT_EQ(IoEngine::LIBAIO, ParseIoEngine("libaio"));
+    EXPECT_EQ(IoEngine::PSYNC, ParseIoEngine("psync"));
+    EXPECT_EQ(IoEngine::TCP, ParseIoEngine("Tcp"));
+    EXPECT_THROW(ParseIoEngine("posixaio"), std::invalid_argument);
+
+    EXPECT_EQ("spdk", GetIoEngineName(IoEngine::SPDK));
+    EXPECT_EQ("io_uring", GetIoEngineName(IoEngine::IO_URING));
+    EXPECT_EQ("libaio", GetIoEngineName(IoEngine::LIBAIO));
+    EXPECT_EQ("psync", GetIoEngineName(IoEngine::PSYNC));
+    EXPECT_EQ("tcp", GetIoEngineName(IoEngine::TCP));
+}
+
+// Test validation of the backend options
+TEST_F(IoBackendTest, OptionsValidation) {
+    IoBackendOptions options;
+    EXPECT_TRUE(options.IsValid());
+
+    // Kernel engines need a file
+    options.engine = IoEngine::IO_URING;
+    EXPECT_FALSE(options.IsValid());
+    options.filename = (test_dir_ / "target").string();
+    EXPECT_TRUE(options.IsValid());
+
+    options.submit_batch = 0;
+    EXPECT_FALSE(options.IsValid());
+    options.submit_batch = 4;
+
+    options.sector_size = 1000;
+    EXPECT_FALSE(options.IsValid());
+    options.sector_size = 4096;
+    EXPECT_TRUE(options.IsValid());
+
+    // Completion polling only works without the page cache
+    options.iopoll = true;
+    options.direct = false;
+    EXPECT_FALSE(options.IsValid());
+    options.direct = true;
+    EXPECT_TRUE(options.IsValid());
+
+    // The fabric engine needs a target address instead of a file
+    IoBackendOptions tcp_options;
+    tcp_options.engine = IoEngine::TCP;
+    tcp_options.filename = (test_dir_ / "target").string();
+    EXPECT_FALSE(tcp_options.IsValid());
+    tcp_options.address = "127.0.0.1:4420";
+    EXPECT_TRUE(tcp_options.IsValid());
+}
+
+// Test that only kernel engines are created from options
+TEST_F(IoBackendTest, Create) {
+    IoBackendOptions options;
+    EXPECT_THROW(IoBackend::Create(options, 4), std::invalid_argument);
+
+    options.engine = IoEngine::IO_URING;
+    EXPECT_THROW(IoBackend::Create(options, 4), std::invalid_argument);
+
+    options.filename = (test_dir_ / "target").string();
+    for (IoEngine engine : {IoEngine::IO_URING, IoEngine::LIBAIO, IoEngine::PSYNC}) {
+        options.engine = engine;
+        auto backend = IoBackend::Create(options, 4);
+        ASSERT_NE(nullptr, backend);
+        EXPECT_EQ(GetIoEngineName(engine), backend->GetName());
+    }
+}
+
+// Test creating, growing and sizing a regular file
+TEST_F(IoBackendTest, OpenBackendFile) {
+    IoBackendOptions options;
+    options.engine = IoEngine::IO_URING;
+    options.filename = (test_dir_ / "target").string();
+    options.direct = false;
+
+    // A new file without a size cannot be used
+    uint64_t size = 0;
+    uint32_t sector_size = 0;
+    EXPECT_EQ(-1, OpenBackendFile(options, &size, &sector_size));
+
+    options.file_size = 1024 * 1024 + 100;
+    int fd = OpenBackendFile(options, &size, &sector_size);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    EXPECT_EQ(512u, sector_size);
+    EXPECT_EQ(1024u * 1024u, size);
+    EXPECT_EQ(1024u * 1024u + 100u, std::filesystem::file_size(options.filename));
+
+    // An existing file keeps its size; the block size can be overridden
+    options.file_size = 0;
+    options.sector_size = 4096;
+    fd = OpenBackendFile(options, &size, &sector_size);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    EXPECT_EQ(4096u, sector_size);
+    EXPECT_EQ(1024u * 1024u, size);
+}
+
+// Test that the SPDK backend requires a controller and a queue pair
+TEST_F(IoBackendTest, SpdkBackendInvalidParams) {
+    EXPECT_THROW(SpdkBackend(nullptr, qpair_), std::invalid_argument);
+    EXPECT_THROW(SpdkBackend(ctrlr_, nullptr), std::invalid_argument);
+}
+
+// Test a write and read back through the SPDK backend on a memory namespace
+TEST_F(IoBackendTest, SpdkBackendRoundTrip) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=4,sector_size=512", &config));
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+
+    SpdkBackend missing(ctrlr_, qpair_, 3);
+    EXPECT_FALSE(missing.Open());
+
+    SpdkBackend backend(ctrlr_, qpair_, 2);
+    ASSERT_TRUE(backend.Open());
+    EXPECT_EQ("spdk", backend.GetName());
+    EXPECT_EQ(512u, backend.GetSectorSize());
+    EXPECT_EQ(4u * 1024 * 1024, backend.GetSize());
+
+    DmaBufferPool pool(4096, 2, 512);
+    auto* out = static_cast<uint8_t*>(pool.Acquire());
+    auto* in = static_cast<uint8_t*>(pool.Acquire());
+    for (size_t i = 0; i < 4096; ++i) {
+        out[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+    std::memset(in, 0, 4096);
+
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitWrite(out, 8192, 4096, &IoBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 1);
+    ASSERT_EQ(0, backend.SubmitRead(in, 8192, 4096, &IoBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 2);
+
+    EXPECT_THAT(statuses, ::testing::ElementsAre(0, 0));
+    EXPECT_EQ(0, std::memcmp(out, in, 4096));
+
+    // Commands past the end of the namespace fail with the NVMe status
+    ASSERT_EQ(0, backend.SubmitRead(in, backend.GetSize(), 512, &IoBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 3);
+    EXPECT_EQ(SPDK_NVME_SC_LBA_OUT_OF_RANGE, statuses[2]);
+
+    // Close() completes outstanding commands without invoking their callbacks
+    ASSERT_EQ(0, backend.SubmitRead(in, 0, 4096, &IoBackendTest::OnCompletion, &statuses));
+    EXPECT_TRUE(backend.Close());
+    EXPECT_EQ(3u, statuses.size());
+    ASSERT_TRUE(backend.Open());
+    ASSERT_EQ(0, backend.SubmitRead(in, 8192, 4096, &IoBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 4);
+    EXPECT_EQ(0, statuses[3]);
+
+    pool.Release(out);
+    pool.Release(in);
+}
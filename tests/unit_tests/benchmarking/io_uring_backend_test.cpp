@@ -0,0 +1,367 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/io_uring_backend.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include "../../../include/benchmarking/workload_generator.h"
+#include "../../../include/benchmarking/job_runner.h"
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the io_uring backend, run against a regular file
+class IoUringBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "io_uring_backend_test";
+        std::filesystem::create_directories(test_dir_);
+
+        options_.engine = IoEngine::IO_URING;
+        options_.filename = (test_dir_ / "target").string();
+        options_.file_size = 4 * 1024 * 1024;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // Tests skip where the backend cannot open: io_uring may be blocked (e.g. by a
+    // container's seccomp profile), or the file system may not support O_DIRECT.
+    // Open() prints which one on stderr.
+    static constexpr const char* kOpenSkipReason =
+        "backend did not open (io_uring, O_DIRECT or the target file is unavailable; see the error above)";
+
+    static void OnCompletion(void* cb_arg, int status) {
+        static_cast<std::vector<int>*>(cb_arg)->push_back(status);
+    }
+
+    static void WaitFor(IoBackend& backend, const std::vector<int>& statuses, size_t count) {
+        while (statuses.size() < count) {
+            ASSERT_GE(backend.ProcessCompletions(0), 0);
+        }
+    }
+
+    // Write a distinct block to each of the first blocks, read them back and compare
+    void RoundTrip(IoUringBackend& backend, DmaBufferPool& pool, uint32_t blocks) {
+        const uint32_t size = static_cast<uint32_t>(pool.GetBufferSize());
+        std::vector<uint8_t*> buffers;
+        std::vector<int> statuses;
+        for (uint32_t i = 0; i < blocks; ++i) {
+            auto* buffer = static_cast<uint8_t*>(pool.Acquire());
+            ASSERT_NE(nullptr, buffer);
+            std::memset(buffer, static_cast<int>(i + 1), size);
+            ASSERT_EQ(0, backend.SubmitWrite(buffer, uint64_t{i} * size, size,
+                                             &IoUringBackendTest::OnCompletion, &statuses));
+            buffers.push_back(buffer);
+        }
+        WaitFor(backend, statuses, blocks);
+
+        for (uint32_t i = 0; i < blocks; ++i) {
+            std::memset(buffers[i], 0, size);
+            ASSERT_EQ(0, backend.SubmitRead(buffers[i], uint64_t{i} * size, size,
+                                            &IoUringBackendTest::OnCompletion, &statuses));
+        }
+        WaitFor(backend, statuses, 2 * blocks);
+
+        EXPECT_THAT(statuses, ::testing::Each(0));
+        for (uint32_t i = 0; i < blocks; ++i) {
+            EXPECT_EQ(i + 1, buffers[i][0]);
+            EXPECT_EQ(i + 1, buffers[i][size - 1]);
+            pool.Release(buffers[i]);
+        }
+    }
+
+    IoBackendOptions options_;
+    std::filesystem::path test_dir_;
+};
+
+// Test constructor with invalid parameters
+TEST_F(IoUringBackendTest, ConstructorInvalidParams) {
+    EXPECT_THROW(IoUringBackend(options_, 0), std::invalid_argument);
+
+    auto invalid_options = options_;
+    invalid_options.filename.clear();
+    EXPECT_THROW(IoUringBackend(invalid_options, 4), std::invalid_argument);
+
+    invalid_options = options_;
+    invalid_options.engine = IoEngine::SPDK;
+    EXPECT_THROW(IoUringBackend(invalid_options, 4), std::invalid_argument);
+}
+
+// Test plain reads and writes through O_DIRECT
+TEST_F(IoUringBackendTest, ReadWrite) {
+    IoUringBackend backend(options_, 8);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+    EXPECT_EQ("io_uring", backend.GetName());
+    EXPECT_EQ(512u, backend.GetSectorSize());
+    EXPECT_EQ(options_.file_size, backend.GetSize());
+
+    DmaBufferPool pool(4096, 8, 4096);
+    RoundTrip(backend, pool, 8);
+    EXPECT_FALSE(backend.HasRegisteredBuffers());
+}
+
+// Test that Close() waits for commands in flight without invoking their callbacks
+TEST_F(IoUringBackendTest, CloseWithCommandsInFlight) {
+    options_.registered_buffers = true;
+    options_.submit_batch = 4;
+    IoUringBackend backend(options_, 8);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 8, 4096);
+    backend.RegisterBuffers(pool);
+    std::vector<void*> buffers;
+    std::vector<int> statuses;
+    for (uint64_t i = 0; i < 6; ++i) {
+        buffers.push_back(pool.Acquire());
+        ASSERT_EQ(0, backend.SubmitRead(buffers.back(), i * 4096, 4096,
+                                        &IoUringBackendTest::OnCompletion, &statuses));
+    }
+    EXPECT_TRUE(backend.Close());
+    EXPECT_TRUE(statuses.empty());
+    EXPECT_TRUE(backend.Close());
+
+    for (void* buffer : buffers) {
+        pool.Release(buffer);
+    }
+    ASSERT_TRUE(backend.Open());
+    RoundTrip(backend, pool, 8);
+}
+
+// Test registered buffers and a registered file
+TEST_F(IoUringBackendTest, RegisteredBuffersAndFiles) {
+    options_.registered_buffers = true;
+    options_.registered_files = true;
+    IoUringBackend backend(options_, 8);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 8, 4096);
+    backend.RegisterBuffers(pool);
+    EXPECT_TRUE(backend.HasRegisteredBuffers());
+    RoundTrip(backend, pool, 8);
+
+    // A buffer outside the registered region still works
+    std::vector<int> statuses;
+    alignas(4096) static uint8_t outside[4096];
+    ASSERT_EQ(0, backend.SubmitRead(outside, 0, sizeof(outside),
+                                    &IoUringBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 1);
+    EXPECT_EQ(0, statuses[0]);
+    EXPECT_EQ(1, outside[0]);
+}
+
+// Test that commands are passed to the kernel in batches
+TEST_F(IoUringBackendTest, SubmitBatching) {
+    options_.submit_batch = 4;
+    IoUringBackend backend(options_, 16);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 16, 4096);
+    std::vector<int> statuses;
+    std::vector<void*> buffers;
+    for (int i = 0; i < 10; ++i) {
+        void* buffer = pool.Acquire();
+        buffers.push_back(buffer);
+        ASSERT_EQ(0, backend.SubmitRead(buffer, uint64_t(i) * 4096, 4096,
+                                        &IoUringBackendTest::OnCompletion, &statuses));
+    }
+
+    // Two full batches went out on submission; the partial one waits for a poll
+    EXPECT_EQ(2u, backend.GetSubmitCalls());
+    WaitFor(backend, statuses, 10);
+    EXPECT_EQ(3u, backend.GetSubmitCalls());
+    EXPECT_THAT(statuses, ::testing::Each(0));
+
+    for (void* buffer : buffers) {
+        pool.Release(buffer);
+    }
+}
+
+// Test that a full queue refuses further commands
+TEST_F(IoUringBackendTest, QueueFull) {
+    options_.submit_batch = 64;
+    IoUringBackend backend(options_, 4);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 4, 4096);
+    std::vector<int> statuses;
+    void* buffer = pool.Acquire();
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &IoUringBackendTest::OnCompletion, &statuses));
+    }
+    EXPECT_EQ(-ENOMEM, backend.SubmitRead(buffer, 0, 4096, &IoUringBackendTest::OnCompletion, &statuses));
+
+    WaitFor(backend, statuses, 4);
+    pool.Release(buffer);
+}
+
+// Test that reads past the end of the file report a short transfer
+TEST_F(IoUringBackendTest, ShortRead) {
+    IoUringBackend backend(options_, 4);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(8192, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, backend.GetSize() - 4096, 8192,
+                                    &IoUringBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 1);
+    EXPECT_EQ(-EIO, statuses[0]);
+    pool.Release(buffer);
+}
+
+// Test kernel-side submission polling
+TEST_F(IoUringBackendTest, SubmissionPolling) {
+    options_.sqpoll = true;
+    options_.sqpoll_idle_ms = 10;
+    IoUringBackend backend(options_, 8);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 8, 4096);
+    RoundTrip(backend, pool, 8);
+}
+
+// Test completion polling; regular files on most file systems do not support it
+TEST_F(IoUringBackendTest, CompletionPolling) {
+    options_.iopoll = true;
+    IoUringBackend backend(options_, 4);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(4096, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &IoUringBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 1);
+    pool.Release(buffer);
+    if (statuses[0] == -EOPNOTSUPP) {
+        GTEST_SKIP() << "The file system does not support polled I/O";
+    }
+    EXPECT_EQ(0, statuses[0]);
+}
+
+// Test a workload generator and a multi-threaded job on the io_uring engine
+TEST_F(IoUringBackendTest, WorkloadOnIoUring) {
+    options_.registered_buffers = true;
+    options_.submit_batch = 2;
+
+    WorkloadProfile profile;
+    profile.total_size = 1024 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 50;
+    profile.write_percentage = 50;
+    profile.random_percentage = 100;
+    profile.queue_depth = 8;
+
+    auto backend = std::make_shared<IoUringBackend>(options_, profile.queue_depth);
+    if (!backend->Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+    WorkloadGenerator generator(backend, profile);
+    ASSERT_TRUE(generator.Generate());
+    WorkloadStats stats = generator.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_TRUE(backend->HasRegisteredBuffers());
+
+    // The range must fit in the file
+    profile.num_blocks = 2048;
+    WorkloadGenerator too_large(std::make_shared<IoUringBackend>(options_, profile.queue_depth), profile);
+    EXPECT_FALSE(too_large.Generate());
+    profile.num_blocks = 256;
+
+    JobOptions job_options;
+    job_options.num_threads = 2;
+    job_options.backend = options_;
+    JobRunner runner(nullptr, profile, job_options);
+    ASSERT_TRUE(runner.Run());
+    stats = runner.GetResults();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+}
+
+// Test blocking on the completion eventfd and a generator in each completion mode
+TEST_F(IoUringBackendTest, BlockingCompletions) {
+    IoUringBackend backend(options_, 4);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    // Nothing in flight: the wait times out
+    EXPECT_EQ(0, backend.WaitForCompletions(0, 1000000));
+
+    DmaBufferPool pool(4096, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &IoUringBackendTest::OnCompletion, &statuses));
+    while (statuses.empty()) {
+        ASSERT_GE(backend.WaitForCompletions(0, 1000000000), 0);
+    }
+    EXPECT_EQ(0, statuses[0]);
+    pool.Release(buffer);
+
+    WorkloadProfile profile;
+    profile.total_size = 512 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 50;
+    profile.write_percentage = 50;
+    profile.random_percentage = 100;
+    profile.queue_depth = 4;
+    for (auto mode : {CompletionMode::BLOCK, CompletionMode::HYBRID}) {
+        profile.completion_mode = mode;
+        WorkloadGenerator generator(std::make_shared<IoUringBackend>(options_, profile.queue_depth), profile);
+        ASSERT_TRUE(generator.Generate());
+        WorkloadStats stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.errors);
+        EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+        EXPECT_GT(stats.GetCyclesPerIo(), 0.0);
+    }
+}
+
+// Test that generator batches line up with the ring's submission batches
+TEST_F(IoUringBackendTest, BatchedWorkload) {
+    options_.submit_batch = 8;
+
+    WorkloadProfile profile;
+    profile.total_size = 512 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 100;
+    profile.write_percentage = 0;
+    profile.random_percentage = 100;
+    profile.queue_depth = 16;
+    profile.submit_batch = 8;
+
+    auto backend = std::make_shared<IoUringBackend>(options_, profile.queue_depth);
+    if (!backend->Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+    WorkloadGenerator generator(backend, profile);
+    ASSERT_TRUE(generator.Generate());
+    WorkloadStats stats = generator.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(8u, stats.submit_batches.GetMax());
+    EXPECT_EQ(16u, stats.submit_calls);
+    EXPECT_DOUBLE_EQ(0.125, stats.GetSubmitCallsPerIo());
+}
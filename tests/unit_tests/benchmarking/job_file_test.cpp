@@ -0,0 +1,314 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/job_file.h"
+#include "../../../include/utils/nvmeof_utils.h"
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+using namespace nvmeof::benchmarking;
+using nvmeof::utils::JsonValue;
+
+class JobFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Create a temporary test directory
+        test_dir_ = (std::filesystem::temp_directory_path() / "nvmeof_job_file_test").string();
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        // Clean up test files and directory
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    std::string WriteFile(const std::string& name, const std::string& content) {
+        std::string path = test_dir_ + "/" + name;
+        nvmeof::utils::WriteStringToFile(path, content);
+        return path;
+    }
+
+    spdk_nvme_ctrlr* MockController() {
+        return reinterpret_cast<spdk_nvme_ctrlr*>(1);
+    }
+
+    std::string test_dir_;
+};
+
+// Test that the shipped profile format is parsed field by field
+TEST_F(JobFileTest, ParseShippedProfile) {
+    WorkloadProfile profile = ParseWorkloadProfile(JsonValue::Parse(R"({
+        "name": "Random Mixed",
+        "description": "70% random read, 30% random write",
+        "total_size": 1073741824,
+        "block_size": 4096,
+        "num_blocks": 262144,
+        "read_percentage": 70,
+        "write_percentage": 30,
+        "random_percentage": 100
+    })"));
+
+    EXPECT_EQ(1073741824u, profile.total_size);
+    EXPECT_EQ(4096u, profile.block_size);
+    EXPECT_EQ(262144u, profile.num_blocks);
+    EXPECT_EQ(70u, profile.read_percentage);
+    EXPECT_EQ(30u, profile.write_percentage);
+    EXPECT_EQ(100u, profile.random_percentage);
+    EXPECT_EQ(1u, profile.queue_depth);
+}
+
+// Test size strings, durations, names and derived fields
+TEST_F(JobFileTest, ParseExtendedProfile) {
+    WorkloadProfile profile = ParseWorkloadProfile(JsonValue::Parse(R"({
+        "block_size": "4k",
+        "size": "1GiB",
+        "offset": "1m",
+        "namespace_id": 2,
+        "read_percentage": 25,
+        "queue_depth": 32,
+        "runtime_seconds": "2m",
+        "ramp_time_seconds": 5,
+        "payload_pattern": "compressible",
+        "compress_percentage": 50,
+        "arrival_mode": "poisson",
+        "arrival_rate": 1e5,
+        "completion_mode": "hybrid",
+        "submit_batch": 4,
+        "reap_batch": 8,
+        "access_pattern": {"distribution": "zipf", "zipf_theta": 0.9},
+        "write_block_sizes": "4k/60:64k/30:1m/10",
+        "read_block_sizes": [{"block_size": 8192, "weight": 1}]
+    })"));
+
+    EXPECT_EQ(4096u, profile.block_size);
+    EXPECT_EQ(262144u, profile.num_blocks);
+    EXPECT_EQ(1073741824u, profile.total_size);
+    EXPECT_EQ(256u, profile.start_block);
+    EXPECT_EQ(2u, profile.namespace_id);
+    EXPECT_EQ(25u, profile.read_percentage);
+    EXPECT_EQ(75u, profile.write_percentage);
+    EXPECT_EQ(32u, profile.queue_depth);
+    EXPECT_EQ(120u, profile.runtime_seconds);
+    EXPECT_EQ(5u, profile.ramp_time_seconds);
+    EXPECT_EQ(PayloadPattern::COMPRESSIBLE, profile.payload_pattern);
+    EXPECT_EQ(ArrivalMode::POISSON, profile.arrival_mode);
+    EXPECT_DOUBLE_EQ(1e5, profile.arrival_rate);
+    EXPECT_EQ(CompletionMode::HYBRID, profile.completion_mode);
+    EXPECT_EQ(4u, profile.submit_batch);
+    EXPECT_EQ(8u, profile.reap_batch);
+    EXPECT_EQ(AccessDistribution::ZIPF, profile.access_pattern.distribution);
+    EXPECT_DOUBLE_EQ(0.9, profile.access_pattern.zipf_theta);
+
+    ASSERT_EQ(3u, profile.write_block_sizes.size());
+    EXPECT_EQ(65536u, profile.write_block_sizes[1].block_size);
+    EXPECT_EQ(30u, profile.write_block_sizes[1].weight);
+    EXPECT_EQ(1048576u, profile.write_block_sizes[2].block_size);
+    ASSERT_EQ(1u, profile.read_block_sizes.size());
+    EXPECT_EQ(8192u, profile.read_block_sizes[0].block_size);
+}
+
+// Test the boolean shorthand of the optimization configurations
+TEST_F(JobFileTest, ParseUsePollingMode) {
+    const std::string base = R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, )";
+    EXPECT_EQ(CompletionMode::POLL, ParseWorkloadProfile(JsonValue::Parse(base + R"("use_polling_mode": true})")).completion_mode);
+    EXPECT_EQ(CompletionMode::BLOCK, ParseWorkloadProfile(JsonValue::Parse(base + R"("use_polling_mode": false})")).completion_mode);
+    EXPECT_THROW(ParseWorkloadProfile(JsonValue::Parse(base + R"("completion_mode": "spin"})")), std::invalid_argument);
+}
+
+// Test the verify keys, including fio's checksum names
+TEST_F(JobFileTest, ParseVerify) {
+    const std::string base = R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, )";
+    WorkloadProfile profile = ParseWorkloadProfile(JsonValue::Parse(base + R"("verify": true, "verify_seed": 42, "verify_async": 2})"));
+    EXPECT_TRUE(profile.verify);
+    EXPECT_EQ(42u, profile.verify_seed);
+    EXPECT_EQ(2u, profile.verify_async);
+    EXPECT_TRUE(ParseWorkloadProfile(JsonValue::Parse(base + R"("verify": "crc32c"})")).verify);
+    EXPECT_FALSE(ParseWorkloadProfile(JsonValue::Parse(base + R"("verify": "none"})")).verify);
+    EXPECT_FALSE(ParseWorkloadProfile(JsonValue::Parse(base + R"("verify": 0})")).verify);
+    EXPECT_FALSE(ParseWorkloadProfile(JsonValue::Parse(base + R"("block_size": 4096})")).verify);
+    EXPECT_THROW(ParseWorkloadProfile(JsonValue::Parse(base + R"("verify": "md5"})")), std::invalid_argument);
+}
+
+// Test the trace replay keys
+TEST_F(JobFileTest, ParseReplay) {
+    const std::string base = R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, )";
+    WorkloadProfile profile = ParseWorkloadProfile(JsonValue::Parse(
+        base + R"("trace_file": "prod.nvbt", "replay_speed": 2.5, "trace_partition": "cpu"})"));
+    EXPECT_EQ("prod.nvbt", profile.trace_file);
+    EXPECT_DOUBLE_EQ(2.5, profile.replay_speed);
+    EXPECT_EQ(TracePartition::CPU, profile.trace_partition);
+    EXPECT_THROW(ParseWorkloadProfile(JsonValue::Parse(base + R"("replay_speed": -1})")), std::invalid_argument);
+    EXPECT_THROW(ParseWorkloadProfile(JsonValue::Parse(base + R"("trace_partition": "pid"})")), std::invalid_argument);
+}
+
+// Test that mistakes in a profile are reported instead of ignored
+TEST_F(JobFileTest, ParseInvalidProfile) {
+    const char* invalid[] = {
+        R"({"block_size": 4096, "num_blocks": 16, "read_percentag": 100})",
+        R"({"block_size": 4096, "num_blocks": 16, "read_percentage": 101})",
+        R"({"block_size": 4096, "num_blocks": 16, "read_percentage": 60, "write_percentage": 60})",
+        R"({"block_size": "4q", "num_blocks": 16})",
+        R"({"block_size": 4096, "num_blocks": -1})",
+        R"({"block_size": 4096, "num_blocks": 16, "payload_pattern": "stripes"})",
+        R"({"block_size": 4096, "num_blocks": 16, "access_pattern": {"theta": 1}})",
+        R"({"block_size": 4096, "num_blocks": 16, "block_sizes": "4k:8k"})",
+        R"({"block_size": 4096, "num_blocks": 16, "offset": 100})",
+        R"({"block_size": 4096, "num_blocks": 16, "threads": 2})",
+        R"({"num_blocks": 16})",
+        R"([])"
+    };
+
+    for (const char* json : invalid) {
+        EXPECT_THROW(ParseWorkloadProfile(JsonValue::Parse(json)), std::invalid_argument) << json;
+    }
+}
+
+// Test that a plain profile file becomes a single job
+TEST_F(JobFileTest, LoadProfileAsJobFile) {
+    std::string path = WriteFile("profile.json", R"({
+        "name": "Sequential Read",
+        "total_size": 1048576,
+        "block_size": 4096,
+        "num_blocks": 256,
+        "read_percentage": 100,
+        "write_percentage": 0,
+        "random_percentage": 0,
+        "threads": 2
+    })");
+
+    JobFile job_file = LoadJobFile(path);
+    ASSERT_EQ(1u, job_file.jobs.size());
+    EXPECT_EQ("Sequential Read", job_file.jobs[0].name);
+    EXPECT_EQ(2u, job_file.jobs[0].options.num_threads);
+    EXPECT_EQ(1048576u, LoadWorkloadProfile(WriteFile("plain.json",
+        R"({"block_size": 4096, "num_blocks": 256, "read_percentage": 100})")).total_size);
+}
+
+// Test layering of defaults, referenced profiles and job keys
+TEST_F(JobFileTest, LoadMultiJobFile) {
+    WriteFile("seq_read.json", R"({
+        "name": "Sequential Read",
+        "total_size": 1048576,
+        "block_size": 4096,
+        "num_blocks": 256,
+        "read_percentage": 100,
+        "write_percentage": 0,
+        "random_percentage": 0
+    })");
+    std::string path = WriteFile("jobs.json", R"({
+        "execution": "concurrent",
+        "defaults": {"queue_depth": 8, "threads": 2, "range_mode": "shared"},
+        "jobs": [
+            {"profile": "seq_read.json", "queue_depth": 16},
+            {"name": "writer", "block_size": "8k", "size": "2m", "write_percentage": 100,
+             "core_mask": "0", "range_mode": "disjoint"}
+        ]
+    })");
+
+    JobFile job_file = LoadJobFile(path);
+    EXPECT_EQ(JobExecutionMode::CONCURRENT, job_file.execution);
+    ASSERT_EQ(2u, job_file.jobs.size());
+
+    const JobDefinition& reader = job_file.jobs[0];
+    EXPECT_EQ("Sequential Read", reader.name);
+    EXPECT_EQ(16u, reader.profile.queue_depth);
+    EXPECT_EQ(100u, reader.profile.read_percentage);
+    EXPECT_EQ(2u, reader.options.num_threads);
+    EXPECT_EQ(LbaRangeMode::SHARED, reader.options.range_mode);
+
+    const JobDefinition& writer = job_file.jobs[1];
+    EXPECT_EQ("writer", writer.name);
+    EXPECT_EQ(8u, writer.profile.queue_depth);
+    EXPECT_EQ(256u, writer.profile.num_blocks);
+    EXPECT_EQ(2097152u, writer.profile.total_size);
+    EXPECT_EQ(0u, writer.profile.read_percentage);
+    EXPECT_EQ("0", writer.options.core_mask);
+    EXPECT_EQ(LbaRangeMode::DISJOINT, writer.options.range_mode);
+}
+
+// Test selecting and configuring the I/O engine per job
+TEST_F(JobFileTest, ParseIoEngineOptions) {
+    JobFile job_file = ParseJobFile(JsonValue::Parse(R"({
+        "defaults": {"block_size": 4096, "num_blocks": 64, "read_percentage": 100},
+        "jobs": [
+            {"name": "nvme"},
+            {"name": "kernel", "ioengine": "io_uring", "filename": "/dev/nvme1n1", "direct": 1,
+             "filesize": "1g", "fixedbufs": true, "registerfiles": 1, "sqthread_poll": true,
+             "sqthread_poll_idle": 50, "hipri": 0, "iodepth_batch_submit": 8,
+             "iodepth_batch_complete_max": 16}
+        ]
+    })"));
+    ASSERT_EQ(2u, job_file.jobs.size());
+    EXPECT_EQ(IoEngine::SPDK, job_file.jobs[0].options.backend.engine);
+
+    const IoBackendOptions& backend = job_file.jobs[1].options.backend;
+    EXPECT_EQ(IoEngine::IO_URING, backend.engine);
+    EXPECT_EQ("/dev/nvme1n1", backend.filename);
+    EXPECT_TRUE(backend.direct);
+    EXPECT_EQ(1ULL << 30, backend.file_size);
+    EXPECT_TRUE(backend.registered_buffers);
+    EXPECT_TRUE(backend.registered_files);
+    EXPECT_TRUE(backend.sqpoll);
+    EXPECT_EQ(50u, backend.sqpoll_idle_ms);
+    EXPECT_FALSE(backend.iopoll);
+    EXPECT_EQ(8u, backend.submit_batch);
+    EXPECT_EQ(8u, job_file.jobs[1].profile.submit_batch);
+    EXPECT_EQ(16u, job_file.jobs[1].profile.reap_batch);
+    EXPECT_EQ(1u, job_file.jobs[0].profile.submit_batch);
+
+    // Kernel engines need a file, and flags are booleans
+    EXPECT_THROW(ParseJobFile(JsonValue::Parse(
+        R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, "ioengine": "io_uring"})")), std::invalid_argument);
+    EXPECT_THROW(ParseJobFile(JsonValue::Parse(
+        R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, "ioengine": "posix"})")), std::invalid_argument);
+    EXPECT_THROW(ParseJobFile(JsonValue::Parse(
+        R"({"block_size": 4096, "num_blocks": 1, "read_percentage": 100, "direct": 2})")), std::invalid_argument);
+}
+
+// Test that job file errors name the file
+TEST_F(JobFileTest, LoadInvalidJobFile) {
+    EXPECT_THROW(LoadJobFile(test_dir_ + "/missing.json"), std::runtime_error);
+    EXPECT_THROW(LoadJobFile(WriteFile("broken.json", "{\"jobs\": [")), std::runtime_error);
+    EXPECT_THROW(LoadJobFile(WriteFile("empty.json", R"({"jobs": []})")), std::invalid_argument);
+    EXPECT_THROW(LoadJobFile(WriteFile("mode.json",
+        R"({"execution": "parallel", "jobs": [{"block_size": 4096, "num_blocks": 1}]})")),
+        std::invalid_argument);
+    EXPECT_THROW(LoadJobFile(WriteFile("ref.json",
+        R"({"jobs": [{"profile": "nowhere.json"}]})")), std::runtime_error);
+
+    try {
+        LoadJobFile(WriteFile("typo.json", R"({"jobs": [{"block_size": 4096, "bogus": 1}]})"));
+        FAIL() << "Expected an invalid_argument exception";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("typo.json"));
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("bogus"));
+    }
+}
+
+// Test running jobs sequentially and concurrently
+TEST_F(JobFileTest, RunJobs) {
+    JobFile job_file = ParseJobFile(JsonValue::Parse(R"({
+        "jobs": [
+            {"name": "reads", "block_size": 4096, "size": "1m", "read_percentage": 100,
+             "queue_depth": 4, "threads": 2},
+            {"name": "writes", "block_size": 4096, "size": "512k", "write_percentage": 100}
+        ]
+    })"));
+
+    for (auto mode : {JobExecutionMode::SEQUENTIAL, JobExecutionMode::CONCURRENT}) {
+        job_file.execution = mode;
+        JobFileRunner runner(MockController(), job_file);
+        ASSERT_TRUE(runner.Run());
+        EXPECT_DOUBLE_EQ(1.0, runner.GetProgress());
+
+        std::vector<WorkloadStats> results = runner.GetResults();
+        ASSERT_EQ(2u, results.size());
+        EXPECT_EQ(256u, results[0].read_ops);
+        EXPECT_EQ(0u, results[0].write_ops);
+        EXPECT_EQ(128u, results[1].write_ops);
+        EXPECT_EQ(524288u, results[1].write_bytes);
+    }
+
+    EXPECT_THROW(JobFileRunner(nullptr, job_file), std::invalid_argument);
+    EXPECT_THROW(JobFileRunner(MockController(), JobFile()), std::invalid_argument);
+}
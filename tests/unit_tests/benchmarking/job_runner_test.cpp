@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/job_runner.h"
+#include <chrono>
+#include <filesystem>
+#include <future>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for JobRunner tests
+class JobRunnerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profile_.total_size = 1048576;        // 1 MB
+        profile_.block_size = 4096;           // 4 KB
+        profile_.num_blocks = 256;            // 256 blocks
+        profile_.interval_us = 0;
+        profile_.read_percentage = 50;
+        profile_.write_percentage = 50;
+        profile_.random_percentage = 70;
+        profile_.queue_depth = 4;
+    }
+
+    // The mock SPDK library does not dereference the controller
+    spdk_nvme_ctrlr* MockController() {
+        return reinterpret_cast<spdk_nvme_ctrlr*>(1);
+    }
+
+    WorkloadProfile profile_;
+};
+
+// Test core mask parsing for hexadecimal masks and CPU lists
+TEST_F(JobRunnerTest, ParseCoreMask) {
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), JobRunner::ParseCoreMask("0xF"));
+    EXPECT_EQ(std::vector<int>({4, 5, 6, 7}), JobRunner::ParseCoreMask("0xf0"));
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), JobRunner::ParseCoreMask("0-3,8,10-11"));
+    EXPECT_EQ(std::vector<int>({2}), JobRunner::ParseCoreMask("2"));
+
+    EXPECT_THROW(JobRunner::ParseCoreMask("0x0"), std::invalid_argument);
+    EXPECT_THROW(JobRunner::ParseCoreMask("0xZ"), std::invalid_argument);
+    EXPECT_THROW(JobRunner::ParseCoreMask("3-1"), std::invalid_argument);
+    EXPECT_THROW(JobRunner::ParseCoreMask("a,b"), std::invalid_argument);
+}
+
+// Test constructor with invalid parameters
+TEST_F(JobRunnerTest, ConstructorInvalidParams) {
+    JobOptions options;
+
+    EXPECT_THROW(JobRunner(nullptr, profile_, options), std::invalid_argument);
+
+    options.num_threads = 0;
+    EXPECT_THROW(JobRunner(MockController(), profile_, options), std::invalid_argument);
+
+    options.num_threads = 512;
+    options.range_mode = LbaRangeMode::DISJOINT;
+    EXPECT_THROW(JobRunner(MockController(), profile_, options), std::invalid_argument);
+
+    options.num_threads = 2;
+    options.core_mask = "bogus";
+    EXPECT_THROW(JobRunner(MockController(), profile_, options), std::invalid_argument);
+}
+
+// Test that disjoint ranges partition the block range and the byte budget
+TEST_F(JobRunnerTest, DisjointWorkerProfiles) {
+    JobOptions options;
+    options.num_threads = 3;
+    options.range_mode = LbaRangeMode::DISJOINT;
+    JobRunner runner(MockController(), profile_, options);
+
+    uint64_t next_block = 0;
+    uint64_t total_size = 0;
+    uint64_t total_blocks = 0;
+    for (uint32_t i = 0; i < options.num_threads; ++i) {
+        auto worker_profile = runner.GetWorkerProfile(i);
+        EXPECT_TRUE(worker_profile.IsValid());
+        EXPECT_EQ(next_block, worker_profile.start_block);
+        next_block += worker_profile.num_blocks;
+        total_blocks += worker_profile.num_blocks;
+        total_size += worker_profile.total_size;
+    }
+
+    EXPECT_EQ(profile_.num_blocks, total_blocks);
+    EXPECT_EQ(profile_.total_size, total_size);
+    EXPECT_THROW(runner.GetWorkerProfile(3), std::out_of_range);
+}
+
+// Test that shared ranges give every worker the full block range
+TEST_F(JobRunnerTest, SharedWorkerProfiles) {
+    JobOptions options;
+    options.num_threads = 4;
+    options.range_mode = LbaRangeMode::SHARED;
+    JobRunner runner(MockController(), profile_, options);
+
+    for (uint32_t i = 0; i < options.num_threads; ++i) {
+        auto worker_profile = runner.GetWorkerProfile(i);
+        EXPECT_EQ(profile_.start_block, worker_profile.start_block);
+        EXPECT_EQ(profile_.num_blocks, worker_profile.num_blocks);
+    }
+}
+
+// Test a multi-threaded run and the merging of worker results
+TEST_F(JobRunnerTest, RunMergesWorkerResults) {
+    JobOptions options;
+    options.num_threads = 4;
+    JobRunner runner(MockController(), profile_, options);
+
+    EXPECT_TRUE(runner.Run());
+
+    auto worker_results = runner.GetWorkerResults();
+    ASSERT_EQ(4u, worker_results.size());
+
+    uint64_t worker_bytes = 0;
+    for (const auto& stats : worker_results) {
+        worker_bytes += stats.read_bytes + stats.write_bytes;
+    }
+
+    auto merged = runner.GetResults();
+    EXPECT_EQ(profile_.total_size, merged.read_bytes + merged.write_bytes);
+    EXPECT_EQ(worker_bytes, merged.read_bytes + merged.write_bytes);
+    EXPECT_EQ(profile_.total_size / profile_.block_size, merged.read_ops + merged.write_ops);
+    EXPECT_EQ(0u, merged.errors);
+}
+
+// Test that a single Stop() issued as a timed run starts ends it promptly
+TEST_F(JobRunnerTest, StopRightAfterRunStarts) {
+    profile_.total_size = 1ULL << 40;
+    profile_.runtime_seconds = 10;
+    JobOptions options;
+    options.num_threads = 2;
+    JobRunner runner(MockController(), profile_, options);
+
+    auto start = std::chrono::steady_clock::now();
+    auto run = std::async(std::launch::async, [&runner] { return runner.Run(); });
+    runner.Stop();
+
+    ASSERT_EQ(std::future_status::ready, run.wait_for(std::chrono::seconds(5)));
+    run.get();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+// Test that a replayed trace is divided by record while every worker keeps the range
+TEST_F(JobRunnerTest, ReplayWorkers) {
+    auto trace_path = std::filesystem::temp_directory_path() / "job_runner_replay.nvbt";
+    {
+        TraceWriter writer;
+        ASSERT_TRUE(writer.Open(trace_path.string()));
+        for (uint64_t i = 0; i < 120; ++i) {
+            TraceRecord record{};
+            record.timestamp_ns = i * 1000;
+            record.offset = i * 4096;
+            record.size = 4096;
+            record.cpu = static_cast<uint16_t>(i % 3);
+            ASSERT_TRUE(writer.Append(record));
+        }
+        ASSERT_TRUE(writer.Close());
+    }
+
+    profile_.trace_file = trace_path.string();
+    profile_.trace_partition = TracePartition::CPU;
+    JobOptions options;
+    options.num_threads = 3;
+    JobRunner runner(MockController(), profile_, options);
+
+    for (uint32_t i = 0; i < options.num_threads; ++i) {
+        auto worker_profile = runner.GetWorkerProfile(i);
+        EXPECT_EQ(i, worker_profile.trace_worker);
+        EXPECT_EQ(3u, worker_profile.trace_workers);
+        EXPECT_EQ(profile_.num_blocks, worker_profile.num_blocks);
+    }
+
+    ASSERT_TRUE(runner.Run());
+    for (const auto& stats : runner.GetWorkerResults()) {
+        EXPECT_EQ(40u, stats.read_ops);
+    }
+    EXPECT_EQ(120u, runner.GetResults().read_ops);
+    std::filesystem::remove(trace_path);
+}
+
+// Test that job-wide rate caps are divided between the workers
+TEST_F(JobRunnerTest, RateCapsAreSplit) {
+    profile_.rate_iops = 1000;
+    profile_.rate_mbps = 30.0;
+
+    JobOptions options;
+    options.num_threads = 3;
+    JobRunner runner(MockController(), profile_, options);
+
+    uint64_t total_iops = 0;
+    for (uint32_t i = 0; i < options.num_threads; ++i) {
+        auto worker_profile = runner.GetWorkerProfile(i);
+        total_iops += worker_profile.rate_iops;
+        EXPECT_DOUBLE_EQ(10.0, worker_profile.rate_mbps);
+    }
+    EXPECT_EQ(profile_.rate_iops, total_iops);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test an empty histogram
+TEST(LatencyHistogramTest, Empty) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.GetCount());
+    EXPECT_EQ(0u, histogram.GetMin());
+    EXPECT_EQ(0u, histogram.GetMax());
+    EXPECT_DOUBLE_EQ(0.0, histogram.GetMean());
+    EXPECT_EQ(0u, histogram.GetValueAtPercentile(99.0));
+}
+
+// Test that small values are counted exactly
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 100; ++value) {
+        histogram.Record(value);
+    }
+
+    EXPECT_EQ(100u, histogram.GetCount());
+    EXPECT_EQ(1u, histogram.GetMin());
+    EXPECT_EQ(100u, histogram.GetMax());
+    EXPECT_DOUBLE_EQ(50.5, histogram.GetMean());
+    EXPECT_EQ(50u, histogram.GetValueAtPercentile(50.0));
+    EXPECT_EQ(90u, histogram.GetValueAtPercentile(90.0));
+    EXPECT_EQ(100u, histogram.GetValueAtPercentile(100.0));
+}
+
+// Test that percentiles of large values stay within the relative error bound
+TEST(LatencyHistogramTest, RelativeError) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(1);
+    std::lognormal_distribution<double> dist(12.0, 2.0);  // ~160 µs median, long tail
+
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = static_cast<uint64_t>(dist(rng));
+        values.push_back(value);
+        histogram.Record(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size())) - 1;
+        double exact = static_cast<double>(values[rank]);
+        double reported = static_cast<double>(histogram.GetValueAtPercentile(percentile));
+        EXPECT_NEAR(exact, reported, exact * 0.01) << "percentile " << percentile;
+    }
+    EXPECT_EQ(values.back(), histogram.GetMax());
+}
+
+// Test that merging is equivalent to recording into a single histogram
+TEST(LatencyHistogramTest, Merge) {
+    LatencyHistogram a, b, combined;
+    for (uint64_t value = 1; value <= 1000000; value += 997) {
+        (value % 2 ? a : b).Record(value);
+        combined.Record(value);
+    }
+
+    a.Merge(b);
+    EXPECT_EQ(combined.GetCount(), a.GetCount());
+    EXPECT_EQ(combined.GetMin(), a.GetMin());
+    EXPECT_EQ(combined.GetMax(), a.GetMax());
+    EXPECT_DOUBLE_EQ(combined.GetMean(), a.GetMean());
+
+    LatencySummary merged = a.GetSummary();
+    LatencySummary expected = combined.GetSummary();
+    EXPECT_EQ(expected.p50, merged.p50);
+    EXPECT_EQ(expected.p99, merged.p99);
+    EXPECT_EQ(expected.p9999, merged.p9999);
+}
+
+// Test values beyond the bucketed range and resetting
+TEST(LatencyHistogramTest, OverflowAndReset) {
+    LatencyHistogram histogram;
+    histogram.Record(1ULL << 50);
+    EXPECT_EQ(1ULL << 50, histogram.GetMax());
+    EXPECT_EQ(1ULL << 50, histogram.GetValueAtPercentile(50.0));
+
+    histogram.Reset();
+    EXPECT_EQ(0u, histogram.GetCount());
+    EXPECT_EQ(0u, histogram.GetMax());
+}
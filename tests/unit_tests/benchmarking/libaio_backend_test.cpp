@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/libaio_backend.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include "../../../include/benchmarking/workload_generator.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the Linux AIO backend, run against a regular file
+class LibaioBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "libaio_backend_test";
+        std::filesystem::create_directories(test_dir_);
+
+        options_.engine = IoEngine::LIBAIO;
+        options_.filename = (test_dir_ / "target").string();
+        options_.file_size = 4 * 1024 * 1024;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // Tests skip where the backend cannot open: Linux AIO may be blocked (e.g. by a
+    // container's seccomp profile), or the file system may not support O_DIRECT.
+    // Open() prints which one on stderr.
+    static constexpr const char* kOpenSkipReason =
+        "backend did not open (Linux AIO, O_DIRECT or the target file is unavailable; see the error above)";
+
+    static void OnCompletion(void* cb_arg, int status) {
+        static_cast<std::vector<int>*>(cb_arg)->push_back(status);
+    }
+
+    static void WaitFor(IoBackend& backend, const std::vector<int>& statuses, size_t count) {
+        while (statuses.size() < count) {
+            ASSERT_GE(backend.ProcessCompletions(0), 0);
+        }
+    }
+
+    IoBackendOptions options_;
+    std::filesystem::path test_dir_;
+};
+
+// Test constructor with invalid parameters
+TEST_F(LibaioBackendTest, ConstructorInvalidParams) {
+    EXPECT_THROW(LibaioBackend(options_, 0), std::invalid_argument);
+
+    auto invalid_options = options_;
+    invalid_options.filename.clear();
+    EXPECT_THROW(LibaioBackend(invalid_options, 4), std::invalid_argument);
+
+    invalid_options = options_;
+    invalid_options.engine = IoEngine::IO_URING;
+    EXPECT_THROW(LibaioBackend(invalid_options, 4), std::invalid_argument);
+}
+
+// Test writes and reads in batches through O_DIRECT
+TEST_F(LibaioBackendTest, BatchedReadWrite) {
+    options_.submit_batch = 4;
+    LibaioBackend backend(options_, 8);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+    EXPECT_EQ("libaio", backend.GetName());
+    EXPECT_EQ(512u, backend.GetSectorSize());
+    EXPECT_EQ(options_.file_size, backend.GetSize());
+
+    DmaBufferPool pool(4096, 8, 4096);
+    std::vector<uint8_t*> buffers;
+    std::vector<int> statuses;
+    for (uint32_t i = 0; i < 6; ++i) {
+        auto* buffer = static_cast<uint8_t*>(pool.Acquire());
+        std::memset(buffer, static_cast<int>(i + 1), 4096);
+        ASSERT_EQ(0, backend.SubmitWrite(buffer, uint64_t{i} * 4096, 4096,
+                                         &LibaioBackendTest::OnCompletion, &statuses));
+        buffers.push_back(buffer);
+    }
+
+    // One full batch went out on submission; the rest goes out with the next poll
+    EXPECT_EQ(1u, backend.GetSubmitCalls());
+    WaitFor(backend, statuses, 6);
+    EXPECT_EQ(2u, backend.GetSubmitCalls());
+
+    for (uint32_t i = 0; i < 6; ++i) {
+        std::memset(buffers[i], 0, 4096);
+        ASSERT_EQ(0, backend.SubmitRead(buffers[i], uint64_t{i} * 4096, 4096,
+                                        &LibaioBackendTest::OnCompletion, &statuses));
+    }
+    WaitFor(backend, statuses, 12);
+
+    EXPECT_THAT(statuses, ::testing::Each(0));
+    for (uint32_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(i + 1, buffers[i][0]);
+        EXPECT_EQ(i + 1, buffers[i][4095]);
+        pool.Release(buffers[i]);
+    }
+}
+
+// Test the queue limit and short transfers
+TEST_F(LibaioBackendTest, QueueFullAndShortRead) {
+    options_.submit_batch = 8;
+    LibaioBackend backend(options_, 2);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    DmaBufferPool pool(8192, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &LibaioBackendTest::OnCompletion, &statuses));
+    ASSERT_EQ(0, backend.SubmitRead(buffer, backend.GetSize() - 4096, 8192,
+                                    &LibaioBackendTest::OnCompletion, &statuses));
+    EXPECT_EQ(-ENOMEM, backend.SubmitRead(buffer, 0, 4096, &LibaioBackendTest::OnCompletion, &statuses));
+
+    WaitFor(backend, statuses, 2);
+    EXPECT_THAT(statuses, ::testing::UnorderedElementsAre(0, -EIO));
+    pool.Release(buffer);
+}
+
+// Test a workload generator on the libaio engine
+TEST_F(LibaioBackendTest, WorkloadOnLibaio) {
+    WorkloadProfile profile;
+    profile.total_size = 1024 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 70;
+    profile.write_percentage = 30;
+    profile.random_percentage = 100;
+    profile.queue_depth = 8;
+
+    auto backend = std::make_shared<LibaioBackend>(options_, profile.queue_depth);
+    if (!backend->Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+    WorkloadGenerator generator(backend, profile);
+    ASSERT_TRUE(generator.Generate());
+    WorkloadStats stats = generator.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_GT(stats.GetIopsPerCore(), 0.0);
+}
+
+// Test blocking in io_getevents() and a generator waiting for completions
+TEST_F(LibaioBackendTest, BlockingCompletions) {
+    LibaioBackend backend(options_, 4);
+    if (!backend.Open()) {
+        GTEST_SKIP() << kOpenSkipReason;
+    }
+
+    // Nothing in flight: the wait times out
+    EXPECT_EQ(0, backend.WaitForCompletions(0, 1000000));
+
+    DmaBufferPool pool(4096, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &LibaioBackendTest::OnCompletion, &statuses));
+    while (statuses.empty()) {
+        ASSERT_GE(backend.WaitForCompletions(0, 1000000000), 0);
+    }
+    EXPECT_EQ(0, statuses[0]);
+    pool.Release(buffer);
+
+    WorkloadProfile profile;
+    profile.total_size = 512 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 50;
+    profile.write_percentage = 50;
+    profile.random_percentage = 100;
+    profile.queue_depth = 4;
+    profile.completion_mode = CompletionMode::BLOCK;
+    WorkloadGenerator generator(std::make_shared<LibaioBackend>(options_, profile.queue_depth), profile);
+    ASSERT_TRUE(generator.Generate());
+    WorkloadStats stats = generator.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_GT(stats.GetCyclesPerIo(), 0.0);
+}
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/loopback_target.h"
+#include "../../../include/benchmarking/capsule_protocol.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture that drives a loopback target with hand-built PDUs over a Unix socket
+class LoopbackTargetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ctrlr_ = reinterpret_cast<spdk_nvme_ctrlr*>(1);
+
+        spdk_mock_ns_config config;
+        spdk_mock_get_default_ns_config(&config);
+        ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=4,sector_size=512", &config));
+        ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+
+        test_dir_ = std::filesystem::temp_directory_path() / "loopback_target_test";
+        std::filesystem::create_directories(test_dir_);
+        address_ = "unix:" + (test_dir_ / "target.sock").string();
+    }
+
+    void TearDown() override {
+        spdk_mock_remove_namespace(2);
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    // Connect and exchange ICReq / ICResp
+    int Connect(LoopbackTarget& target, uint32_t namespace_id, capsule::IcRespPdu* response) {
+        int fd = capsule::ConnectToAddress(target.GetAddress());
+        if (fd < 0) {
+            return -1;
+        }
+        auto request = capsule::MakePdu<capsule::IcReqPdu>(capsule::PduType::IC_REQ);
+        request.pfv = capsule::kProtocolVersion;
+        request.queue_depth = 4;
+        request.namespace_id = namespace_id;
+        if (!capsule::SendAll(fd, &request, sizeof(request)) ||
+            !capsule::ReceiveAll(fd, response, sizeof(*response))) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static void SendCommand(int fd, uint8_t opcode, uint16_t cid, uint64_t slba, uint32_t nlb,
+                            uint32_t data_length, uint32_t namespace_id = 2) {
+        auto command = capsule::MakePdu<capsule::CapsuleCmdPdu>(capsule::PduType::CAPSULE_CMD);
+        command.opcode = opcode;
+        command.cid = cid;
+        command.namespace_id = namespace_id;
+        command.slba = slba;
+        command.nlb = nlb;
+        command.data_length = data_length;
+        ASSERT_TRUE(capsule::SendAll(fd, &command, sizeof(command)));
+    }
+
+    static void SendData(int fd, uint16_t cid, const std::vector<uint8_t>& data) {
+        auto pdu = capsule::MakePdu<capsule::DataPdu>(capsule::PduType::H2C_DATA,
+                                                      static_cast<uint32_t>(data.size()));
+        pdu.cid = cid;
+        pdu.data_length = static_cast<uint32_t>(data.size());
+        ASSERT_TRUE(capsule::SendAll(fd, &pdu, sizeof(pdu)));
+        ASSERT_TRUE(capsule::SendAll(fd, data.data(), data.size()));
+    }
+
+    // Receive one PDU, header and data
+    static std::vector<uint8_t> ReceivePdu(int fd) {
+        capsule::PduHeader header;
+        if (!capsule::ReceiveAll(fd, &header, sizeof(header))) {
+            return {};
+        }
+        std::vector<uint8_t> pdu(header.plen);
+        std::memcpy(pdu.data(), &header, sizeof(header));
+        if (!capsule::ReceiveAll(fd, pdu.data() + sizeof(header), header.plen - sizeof(header))) {
+            return {};
+        }
+        return pdu;
+    }
+
+    static capsule::CapsuleRespPdu ReceiveResponse(int fd) {
+        capsule::CapsuleRespPdu response;
+        std::memset(&response, 0xff, sizeof(response));
+        std::vector<uint8_t> pdu = ReceivePdu(fd);
+        EXPECT_EQ(sizeof(response), pdu.size());
+        if (pdu.size() == sizeof(response)) {
+            std::memcpy(&response, pdu.data(), sizeof(response));
+            EXPECT_EQ(0x05, response.header.type);
+        }
+        return response;
+    }
+
+    spdk_nvme_ctrlr* ctrlr_ = nullptr;
+    std::filesystem::path test_dir_;
+    std::string address_;
+};
+
+// Test constructor with invalid parameters
+TEST_F(LoopbackTargetTest, ConstructorInvalidParams) {
+    EXPECT_THROW(LoopbackTarget(nullptr, address_), std::invalid_argument);
+    EXPECT_THROW(LoopbackTarget(ctrlr_, ""), std::invalid_argument);
+    EXPECT_THROW(LoopbackTarget(ctrlr_, address_, 0), std::invalid_argument);
+}
+
+// Test that the handshake reports the namespace geometry and refuses unknown namespaces
+TEST_F(LoopbackTargetTest, Handshake) {
+    LoopbackTarget target(ctrlr_, address_, 64 * 1024);
+    ASSERT_TRUE(target.Start());
+    EXPECT_EQ(address_, target.GetAddress());
+
+    capsule::IcRespPdu response;
+    int fd = Connect(target, 2, &response);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(0x01, response.header.type);
+    EXPECT_EQ(capsule::kStatusSuccess, response.status);
+    EXPECT_EQ(512u, response.sector_size);
+    EXPECT_EQ(4u * 1024 * 1024 / 512, response.num_sectors);
+    EXPECT_EQ(64u * 1024, response.max_data_size);
+    close(fd);
+
+    fd = Connect(target, 3, &response);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(capsule::kStatusInvalidNamespace, response.status);
+
+    // The target closes a refused connection
+    EXPECT_TRUE(ReceivePdu(fd).empty());
+    close(fd);
+    EXPECT_EQ(2u, target.GetConnectionCount());
+
+    target.Stop();
+    EXPECT_FALSE(std::filesystem::exists(test_dir_ / "target.sock"));
+}
+
+// Test that the threads of closed connections are reaped while the target runs
+TEST_F(LoopbackTargetTest, ReapsClosedConnections) {
+    LoopbackTarget target(ctrlr_, address_);
+    ASSERT_TRUE(target.Start());
+
+    for (int i = 0; i < 20; ++i) {
+        capsule::IcRespPdu response;
+        int fd = Connect(target, 2, &response);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+    EXPECT_EQ(20u, target.GetConnectionCount());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (target.GetOpenConnectionCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(0u, target.GetOpenConnectionCount());
+}
+
+// Test a write followed by a read of the same blocks
+TEST_F(LoopbackTargetTest, WriteAndRead) {
+    LoopbackTarget target(ctrlr_, address_);
+    ASSERT_TRUE(target.Start());
+
+    capsule::IcRespPdu ic_response;
+    int fd = Connect(target, 2, &ic_response);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(capsule::kStatusSuccess, ic_response.status);
+
+    std::vector<uint8_t> data(4096);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    SendCommand(fd, capsule::kOpcodeWrite, 1, 16, 8, 4096);
+    SendData(fd, 1, data);
+    capsule::CapsuleRespPdu response = ReceiveResponse(fd);
+    EXPECT_EQ(1, response.cid);
+    EXPECT_EQ(capsule::kStatusSuccess, response.status);
+
+    SendCommand(fd, capsule::kOpcodeRead, 3, 16, 8, 4096);
+    std::vector<uint8_t> pdu = ReceivePdu(fd);
+    ASSERT_EQ(sizeof(capsule::DataPdu) + 4096, pdu.size());
+    capsule::DataPdu header;
+    std::memcpy(&header, pdu.data(), sizeof(header));
+    EXPECT_EQ(0x07, header.header.type);
+    EXPECT_EQ(3, header.cid);
+    EXPECT_EQ(4096u, header.data_length);
+    EXPECT_EQ(0, std::memcmp(data.data(), pdu.data() + sizeof(header), data.size()));
+
+    response = ReceiveResponse(fd);
+    EXPECT_EQ(3, response.cid);
+    EXPECT_EQ(capsule::kStatusSuccess, response.status);
+    close(fd);
+}
+
+// Test that invalid commands complete with an error status
+TEST_F(LoopbackTargetTest, CommandErrors) {
+    LoopbackTarget target(ctrlr_, address_, 8192);
+    ASSERT_TRUE(target.Start());
+
+    capsule::IcRespPdu ic_response;
+    int fd = Connect(target, 2, &ic_response);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(capsule::kStatusSuccess, ic_response.status);
+
+    // Length not matching the block count
+    SendCommand(fd, capsule::kOpcodeRead, 0, 0, 8, 512);
+    EXPECT_EQ(capsule::kStatusInvalidField, ReceiveResponse(fd).status);
+
+    // Transfer larger than the target accepts
+    SendCommand(fd, capsule::kOpcodeRead, 0, 0, 32, 16384);
+    EXPECT_EQ(capsule::kStatusInvalidField, ReceiveResponse(fd).status);
+
+    // Namespace other than the connected one; the write data is consumed and dropped
+    SendCommand(fd, capsule::kOpcodeWrite, 1, 0, 1, 512, 1);
+    SendData(fd, 1, std::vector<uint8_t>(512, 0xaa));
+    EXPECT_EQ(capsule::kStatusInvalidNamespace, ReceiveResponse(fd).status);
+
+    // The namespace reports commands past its end
+    SendCommand(fd, capsule::kOpcodeRead, 2, ic_response.num_sectors, 1, 512);
+    EXPECT_EQ(SPDK_NVME_SC_LBA_OUT_OF_RANGE, ReceiveResponse(fd).status);
+    close(fd);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/metric_registry.h"
+#include <thread>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test that handles are dense and registration is idempotent
+TEST(MetricRegistryTest, RegisterAndGet) {
+    MetricRegistry registry;
+    EXPECT_EQ(0u, registry.GetCount());
+
+    MetricHandle iops = registry.Register("IOPS", "ops/s");
+    MetricHandle latency = registry.Register("Latency", "µs");
+    EXPECT_EQ(0u, iops);
+    EXPECT_EQ(1u, latency);
+    EXPECT_EQ(iops, registry.Register("IOPS", "ops/s"));
+
+    // The units are part of the metric's identity
+    EXPECT_EQ(2u, registry.Register("IOPS", "Kops/s"));
+    EXPECT_EQ(3u, registry.GetCount());
+
+    EXPECT_EQ("Latency", registry.Get(latency).label);
+    EXPECT_EQ("µs", registry.Get(latency).units);
+    EXPECT_THROW(registry.Get(3), std::out_of_range);
+}
+
+// Test that references stay valid while other threads register metrics
+TEST(MetricRegistryTest, ConcurrentRegistration) {
+    MetricRegistry registry;
+    const Metric& first = registry.Get(registry.Register("First", ""));
+
+    const int num_threads = 4;
+    const int metrics_per_thread = 500;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&registry]() {
+            for (int j = 0; j < metrics_per_thread; ++j) {
+                MetricHandle handle = registry.Register("Metric " + std::to_string(j), "ops");
+                EXPECT_EQ("Metric " + std::to_string(j), registry.Get(handle).label);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(static_cast<size_t>(metrics_per_thread + 1), registry.GetCount());
+    EXPECT_EQ("First", first.label);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/payload_generator.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test pattern name parsing
+TEST(PayloadGeneratorTest, ParsePayloadPattern) {
+    EXPECT_EQ(PayloadPattern::RANDOM, ParsePayloadPattern("random"));
+    EXPECT_EQ(PayloadPattern::ZEROS, ParsePayloadPattern("Zeros"));
+    EXPECT_EQ(PayloadPattern::REPEATING, ParsePayloadPattern("REPEATING"));
+    EXPECT_EQ(PayloadPattern::COMPRESSIBLE, ParsePayloadPattern("compressible"));
+    EXPECT_THROW(ParsePayloadPattern("sparse"), std::invalid_argument);
+}
+
+// Test constructor with invalid parameters
+TEST(PayloadGeneratorTest, ConstructorInvalidParams) {
+    EXPECT_THROW(PayloadGenerator(PayloadPattern::RANDOM, 0), std::invalid_argument);
+    EXPECT_THROW(PayloadGenerator(PayloadPattern::COMPRESSIBLE, 4096, 101), std::invalid_argument);
+    EXPECT_THROW(PayloadGenerator(PayloadPattern::RANDOM, 4096, 0, 101), std::invalid_argument);
+}
+
+// Test that the random fill is deterministic per seed and covers odd sizes
+TEST(PayloadGeneratorTest, FillRandomDeterministic) {
+    std::vector<uint8_t> a(1003), b(1003), c(1003);
+    PayloadGenerator::FillRandom(a.data(), a.size(), 42);
+    PayloadGenerator::FillRandom(b.data(), b.size(), 42);
+    PayloadGenerator::FillRandom(c.data(), c.size(), 43);
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+
+    // The output should not be dominated by any single byte value
+    size_t zeros = static_cast<size_t>(std::count(a.begin(), a.end(), 0));
+    EXPECT_LT(zeros, a.size() / 16);
+}
+
+// Test zero and repeating patterns
+TEST(PayloadGeneratorTest, ZerosAndRepeating) {
+    std::vector<uint8_t> block(8192, 0xFF);
+
+    PayloadGenerator zeros(PayloadPattern::ZEROS, block.size());
+    zeros.Fill(block.data(), block.size());
+    EXPECT_TRUE(std::all_of(block.begin(), block.end(), [](uint8_t b) { return b == 0; }));
+
+    PayloadGenerator repeating(PayloadPattern::REPEATING, block.size());
+    repeating.Fill(block.data(), block.size());
+    for (size_t i = 4; i < block.size(); ++i) {
+        ASSERT_EQ(block[i - 4], block[i]);
+    }
+}
+
+// Test that consecutive random payloads are unique
+TEST(PayloadGeneratorTest, RandomBlocksAreUnique) {
+    const size_t block_size = 4096;
+    PayloadGenerator generator(PayloadPattern::RANDOM, block_size, 0, 0, 7);
+
+    // Enough blocks to wrap around the pattern buffer
+    std::vector<std::vector<uint8_t>> blocks(600, std::vector<uint8_t>(block_size));
+    for (auto& block : blocks) {
+        generator.Fill(block.data(), block.size());
+    }
+
+    std::sort(blocks.begin(), blocks.end());
+    EXPECT_EQ(blocks.end(), std::adjacent_find(blocks.begin(), blocks.end()));
+}
+
+// Test that the compressible pattern zero-fills the requested share
+TEST(PayloadGeneratorTest, CompressiblePercentage) {
+    const size_t block_size = 65536;
+    PayloadGenerator generator(PayloadPattern::COMPRESSIBLE, block_size, 75, 0, 7);
+
+    std::vector<uint8_t> block(block_size);
+    generator.Fill(block.data(), block.size());
+
+    double zero_share = static_cast<double>(std::count(block.begin(), block.end(), 0)) / block_size;
+    EXPECT_NEAR(0.75, zero_share, 0.02);
+}
+
+// Test that the dedupe percentage produces duplicate blocks
+TEST(PayloadGeneratorTest, DedupePercentage) {
+    const size_t block_size = 4096;
+    const int num_blocks = 2000;
+    PayloadGenerator generator(PayloadPattern::RANDOM, block_size, 0, 40, 7);
+
+    // Duplicates are copies of one reference block; unique blocks occur once
+    std::map<std::vector<uint8_t>, int> occurrences;
+    std::vector<uint8_t> block(block_size);
+    for (int i = 0; i < num_blocks; ++i) {
+        generator.Fill(block.data(), block.size());
+        ++occurrences[block];
+    }
+
+    int duplicates = 0;
+    for (const auto& entry : occurrences) {
+        duplicates = std::max(duplicates, entry.second);
+    }
+
+    EXPECT_NEAR(0.40, static_cast<double>(duplicates) / num_blocks, 0.05);
+}
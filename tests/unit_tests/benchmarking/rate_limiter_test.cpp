@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/rate_limiter.h"
+
+using namespace nvmeof::benchmarking;
+
+// Test constructor with invalid parameters
+TEST(TokenBucketTest, ConstructorInvalidParams) {
+    EXPECT_THROW(TokenBucket(0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(TokenBucket(100.0, 0.0), std::invalid_argument);
+    EXPECT_THROW(TokenBucket(-1.0, 1.0), std::invalid_argument);
+}
+
+// Test that a new bucket starts full and cannot be overdrawn
+TEST(TokenBucketTest, StartsFull) {
+    TokenBucket bucket(1000.0, 4.0);
+    EXPECT_DOUBLE_EQ(4.0, bucket.GetAvailable());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(bucket.TryConsume(1.0));
+    }
+    EXPECT_FALSE(bucket.TryConsume(1.0));
+    EXPECT_DOUBLE_EQ(0.0, bucket.GetAvailable());
+}
+
+// Test that tokens accrue at the configured rate up to the burst capacity
+TEST(TokenBucketTest, RefillRateAndBurst) {
+    TokenBucket bucket(1000.0, 10.0);
+    ASSERT_TRUE(bucket.TryConsume(10.0));
+
+    // The first refill only sets the time base
+    bucket.Refill(1000000000ULL);
+    EXPECT_DOUBLE_EQ(0.0, bucket.GetAvailable());
+
+    // 5 ms at 1000 tokens/s
+    bucket.Refill(1005000000ULL);
+    EXPECT_NEAR(5.0, bucket.GetAvailable(), 1e-9);
+
+    // A long pause is capped at the burst size
+    bucket.Refill(2000000000ULL);
+    EXPECT_DOUBLE_EQ(10.0, bucket.GetAvailable());
+
+    // Time going backwards adds nothing
+    ASSERT_TRUE(bucket.TryConsume(10.0));
+    bucket.Refill(1500000000ULL);
+    EXPECT_DOUBLE_EQ(0.0, bucket.GetAvailable());
+}
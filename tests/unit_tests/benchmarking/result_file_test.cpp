@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/result_file.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for result files in a temporary directory
+class ResultFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "result_file_test";
+        std::filesystem::create_directories(test_dir_);
+        path_ = (test_dir_ / "results.nvbr").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    DataRecord MakeRecord(int64_t timestamp_ns, const std::string& label, double value,
+                          const std::string& units) {
+        DataRecord record{};
+        record.timestamp_ns = timestamp_ns;
+        record.value = value;
+        record.metric = registry_.Register(label, units);
+        return record;
+    }
+
+    void WriteFile(const std::string& data) {
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::path test_dir_;
+    std::string path_;
+    MetricRegistry registry_;
+};
+
+// Test that points written by the collector are read back with their labels
+TEST_F(ResultFileTest, CollectorRoundTrip) {
+    {
+        DataCollector collector(path_, OutputFormat::BINARY);
+        EXPECT_TRUE(collector.CollectDataPoint("IOPS", 250000, "ops/s"));
+        EXPECT_TRUE(collector.CollectDataPoint("Latency", 101.3, "µs"));
+        EXPECT_TRUE(collector.CollectDataPoint("IOPS", 260000, "ops/s"));
+    }
+
+    EXPECT_TRUE(ResultFileReader::IsResultFile(path_));
+    ResultFileReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_FALSE(reader.IsRecovered());
+    EXPECT_EQ(3u, reader.GetPointCount());
+    ASSERT_EQ(2u, reader.GetLabelCount());
+    EXPECT_EQ("IOPS", reader.GetLabel(0));
+    EXPECT_EQ("ops/s", reader.GetUnits(0));
+    EXPECT_EQ("Latency", reader.GetLabel(1));
+    EXPECT_EQ("µs", reader.GetUnits(1));
+
+    std::vector<std::pair<std::string, double>> points;
+    int64_t previous_ns = 0;
+    EXPECT_TRUE(reader.ForEachPoint([&](int64_t timestamp_ns, uint32_t id, double value) {
+        EXPECT_GE(timestamp_ns, previous_ns);
+        previous_ns = timestamp_ns;
+        points.emplace_back(reader.GetLabel(id), value);
+    }));
+    ASSERT_EQ(3u, points.size());
+    EXPECT_EQ("Latency", points[1].first);
+    EXPECT_DOUBLE_EQ(101.3, points[1].second);
+    EXPECT_DOUBLE_EQ(260000, points[2].second);
+}
+
+// Test block splitting, column types and exact timestamp decoding
+TEST_F(ResultFileTest, BlocksAndColumns) {
+    ResultFileEncoder encoder(registry_);
+    std::string data;
+    encoder.WriteHeader(data);
+
+    // A full block of exact floats over 300 labels, then a partial block of doubles
+    const int64_t start_ns = 1700000000000000000;
+    const size_t count = ResultFileEncoder::kBlockRecords + 10;
+    for (size_t i = 0; i < count; ++i) {
+        double value = i < ResultFileEncoder::kBlockRecords ? static_cast<double>(i) : 0.1 * i;
+        int64_t timestamp_ns = start_ns + static_cast<int64_t>(i) * 1000000 - (i % 7 == 0 ? 500 : 0);
+        encoder.Append(MakeRecord(timestamp_ns, "Metric " + std::to_string(i % 300), value, "x"), data);
+    }
+    EXPECT_EQ(10u, encoder.GetPendingCount());
+    encoder.Finish(data);
+    WriteFile(data);
+
+    ResultFileReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_EQ(count, reader.GetPointCount());
+    EXPECT_EQ(300u, reader.GetLabelCount());
+    ASSERT_EQ(2u, reader.GetBlockCount());
+
+    const ResultBlock& first = reader.GetBlock(0);
+    EXPECT_EQ(ResultValueType::FLOAT, first.value_type);
+    EXPECT_EQ(2u, first.id_width);
+    EXPECT_EQ(ResultFileEncoder::kBlockRecords, first.record_count);
+    EXPECT_DOUBLE_EQ(4095.0, first.GetValue(4095));
+    EXPECT_EQ(299u, first.GetLabelId(299));
+
+    const ResultBlock& second = reader.GetBlock(1);
+    EXPECT_EQ(ResultValueType::DOUBLE, second.value_type);
+    EXPECT_DOUBLE_EQ(0.1 * (count - 1), second.GetValue(9));
+
+    // Out-of-order timestamps survive the delta encoding
+    std::vector<int64_t> timestamps;
+    ASSERT_TRUE(first.DecodeTimestamps(timestamps));
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        EXPECT_EQ(start_ns + static_cast<int64_t>(i) * 1000000 - (i % 7 == 0 ? 500 : 0), timestamps[i]);
+    }
+    EXPECT_EQ(start_ns - 500, first.first_ns);
+}
+
+// Test that files without a footer are recovered block by block
+TEST_F(ResultFileTest, RecoverWithoutFooter) {
+    ResultFileEncoder encoder(registry_);
+    std::string data;
+    encoder.WriteHeader(data);
+    encoder.Append(MakeRecord(1000, "A", 1.0, ""), data);
+    encoder.FlushBlock(data);
+    size_t first_block_end = data.size();
+    encoder.Append(MakeRecord(2000, "B", 2.0, ""), data);
+    encoder.FlushBlock(data);
+
+    // Interrupted after two blocks
+    WriteFile(data);
+    ResultFileReader reader;
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_TRUE(reader.IsRecovered());
+    EXPECT_EQ(2u, reader.GetPointCount());
+    EXPECT_EQ("B", reader.GetLabel(1));
+
+    // Interrupted in the middle of the second block
+    WriteFile(data.substr(0, first_block_end + 20));
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_EQ(1u, reader.GetPointCount());
+    EXPECT_EQ(1u, reader.GetLabelCount());
+
+    // A flushed collector's file is readable while the run goes on
+    DataCollector collector(path_, OutputFormat::BINARY);
+    collector.CollectDataPoint("Progress", 50, "%");
+    ASSERT_TRUE(collector.Flush());
+    ASSERT_TRUE(reader.Open(path_));
+    EXPECT_TRUE(reader.IsRecovered());
+    EXPECT_EQ(1u, reader.GetPointCount());
+}
+
+// Test that names too long for their 16-bit lengths are cut without corrupting the file
+TEST_F(ResultFileTest, OversizedNames) {
+    // "µ" is two bytes, so a cut at the odd kMaxNameBytes would fall inside a character
+    std::string label;
+    while (label.size() < 70000) {
+        label += "µ";
+    }
+    std::string units(70000, 'u');
+
+    ResultFileEncoder encoder(registry_);
+    std::string data;
+    encoder.WriteHeader(data);
+    encoder.Append(MakeRecord(1000, label, 1.0, units), data);
+    encoder.Append(MakeRecord(2000, "IOPS", 2.0, "ops/s"), data);
+    encoder.FlushBlock(data);
+    size_t blocks_end = data.size();
+    encoder.Finish(data);
+
+    // Read through the footer, then through the block dictionary
+    for (size_t size : {data.size(), blocks_end}) {
+        WriteFile(data.substr(0, size));
+        ResultFileReader reader;
+        ASSERT_TRUE(reader.Open(path_));
+        EXPECT_EQ(size == blocks_end, reader.IsRecovered());
+        EXPECT_EQ(2u, reader.GetPointCount());
+        ASSERT_EQ(2u, reader.GetLabelCount());
+        EXPECT_EQ(label.substr(0, ResultFileEncoder::kMaxNameBytes - 1), reader.GetLabel(0));
+        EXPECT_EQ(units.substr(0, ResultFileEncoder::kMaxNameBytes), reader.GetUnits(0));
+        EXPECT_EQ("IOPS", reader.GetLabel(1));
+        EXPECT_EQ("ops/s", reader.GetUnits(1));
+    }
+}
+
+// Test that other and corrupt files are rejected
+TEST_F(ResultFileTest, InvalidFiles) {
+    ResultFileReader reader;
+    EXPECT_FALSE(reader.Open((test_dir_ / "missing.nvbr").string()));
+
+    WriteFile("Timestamp,Label,Value,Units\n");
+    EXPECT_FALSE(ResultFileReader::IsResultFile(path_));
+    EXPECT_FALSE(reader.Open(path_));
+
+    ResultFileEncoder encoder(registry_);
+    std::string data;
+    encoder.WriteHeader(data);
+    encoder.Append(MakeRecord(1000, "A", 1.0, ""), data);
+    encoder.Finish(data);
+
+    // A footer pointing outside the file
+    std::string corrupt = data;
+    corrupt[corrupt.size() - 16] = 0x7F;
+    WriteFile(corrupt);
+    EXPECT_FALSE(reader.Open(path_));
+
+    WriteFile(data);
+    EXPECT_TRUE(reader.Open(path_));
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/stream_compression.h"
+#include "../../../include/benchmarking/data_collector.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for compressed streams in a temporary directory
+class StreamCompressionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "stream_compression_test";
+        std::filesystem::create_directories(test_dir_);
+        path_ = (test_dir_ / "results.csv.nvlz").string();
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static std::string RoundTrip(LzCodec& codec, const std::string& data, size_t* compressed_size = nullptr) {
+        std::string compressed;
+        codec.Compress(data.data(), data.size(), compressed);
+        if (compressed_size != nullptr) {
+            *compressed_size = compressed.size();
+        }
+        std::string decompressed(data.size(), '\0');
+        EXPECT_TRUE(LzCodec::Decompress(compressed.data(), compressed.size(), data.size(), &decompressed[0]));
+        return decompressed;
+    }
+
+    static std::string ReadAll(std::istream& stream) {
+        std::ostringstream content;
+        content << stream.rdbuf();
+        return content.str();
+    }
+
+    void WriteFile(const std::string& data) {
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::path test_dir_;
+    std::string path_;
+};
+
+// Test that blocks of all shapes survive a round trip and repetitive text shrinks
+TEST_F(StreamCompressionTest, CodecRoundTrip) {
+    LzCodec codec;
+    for (const std::string& data : {std::string(), std::string("a"), std::string("abc"),
+                                    std::string(100000, 'x'), std::string("abcdabcdabcdabcdabcd")}) {
+        EXPECT_EQ(data, RoundTrip(codec, data));
+    }
+
+    // Random bytes: no matches, long literal runs
+    std::mt19937 rng(42);
+    std::string random(200000, '\0');
+    for (char& c : random) {
+        c = static_cast<char>(rng());
+    }
+    EXPECT_EQ(random, RoundTrip(codec, random));
+
+    // Result rows repeat labels, units and timestamps
+    std::string csv = "Timestamp,Label,Value,Units\n";
+    for (int i = 0; i < 10000; ++i) {
+        csv += "2026-10-16 12:00:0" + std::to_string(i / 2000) + ",Job " + std::to_string(i % 4) +
+               " Throughput," + std::to_string(1500 + i % 37) + ",MB/s\n";
+    }
+    size_t compressed_size = 0;
+    EXPECT_EQ(csv, RoundTrip(codec, csv, &compressed_size));
+    EXPECT_LT(compressed_size * 4, csv.size());
+}
+
+// Test that corrupt blocks are rejected rather than overrunning the output
+TEST_F(StreamCompressionTest, DecompressRejectsCorruptBlocks) {
+    LzCodec codec;
+    std::string data(1000, 'y');
+    std::string compressed;
+    codec.Compress(data.data(), data.size(), compressed);
+    std::string out(data.size(), '\0');
+
+    EXPECT_FALSE(LzCodec::Decompress(compressed.data(), compressed.size(), data.size() - 1, &out[0]));
+    EXPECT_FALSE(LzCodec::Decompress(compressed.data(), 3, data.size(), &out[0]));
+
+    // A back-reference before the start of the block
+    const char bad_offset[] = {0x10, 'a', 0x05, 0x00};
+    EXPECT_FALSE(LzCodec::Decompress(bad_offset, sizeof(bad_offset), 5, &out[0]));
+}
+
+// Test that compressed collector output reads back like the plain file
+TEST_F(StreamCompressionTest, CollectorRoundTrip) {
+    EXPECT_THROW(DataCollector(path_, OutputFormat::BINARY, DataCollector::kDefaultRingCapacity,
+                               CompressionMode::LZ), std::invalid_argument);
+
+    std::string plain_path = (test_dir_ / "results.csv").string();
+    {
+        DataCollector compressed(path_, OutputFormat::CSV, DataCollector::kDefaultRingCapacity,
+                                 CompressionMode::LZ);
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_TRUE(compressed.CollectDataPoint("IOPS", 250000 + i, "ops/s"));
+        }
+
+        // A flushed file is readable while the run goes on
+        ASSERT_TRUE(compressed.Flush());
+        EXPECT_TRUE(IsCompressedFile(path_));
+        std::unique_ptr<std::istream> partial = OpenResultStream(path_);
+        std::string content = ReadAll(*partial);
+        EXPECT_EQ(1001, std::count(content.begin(), content.end(), '\n'));
+        EXPECT_NE(std::string::npos, content.find(",IOPS,250999,ops/s"));
+
+        EXPECT_TRUE(compressed.CollectDataPoint("Latency", 101.3, "µs"));
+    }
+    EXPECT_LT(std::filesystem::file_size(path_), 1001u * 16);
+
+    std::unique_ptr<std::istream> stream = OpenResultStream(path_);
+    ASSERT_TRUE(*stream);
+    std::string line;
+    ASSERT_TRUE(std::getline(*stream, line));
+    EXPECT_EQ("Timestamp,Label,Value,Units", line);
+    size_t rows = 0;
+    std::string last_row;
+    while (std::getline(*stream, line)) {
+        ++rows;
+        last_row = line;
+    }
+    EXPECT_EQ(1001u, rows);
+    EXPECT_NE(std::string::npos, last_row.find(",Latency,101.3,µs"));
+
+    // Plain files open the same way
+    std::ofstream(plain_path) << "Timestamp,Label,Value,Units\n";
+    EXPECT_FALSE(IsCompressedFile(plain_path));
+    std::unique_ptr<std::istream> plain = OpenResultStream(plain_path);
+    EXPECT_EQ("Timestamp,Label,Value,Units\n", ReadAll(*plain));
+}
+
+// Test that a file cut short reads up to its last intact frame
+TEST_F(StreamCompressionTest, TruncatedStream) {
+    CompressedStreamEncoder encoder;
+    std::string data;
+    CompressedStreamEncoder::WriteHeader(data);
+    std::string first(5000, 'a');
+    encoder.EncodeFrame(first.data(), first.size(), data);
+    size_t first_frame_end = data.size();
+    std::string second = "second frame";
+    encoder.EncodeFrame(second.data(), second.size(), data);
+
+    WriteFile(data);
+    CompressedFileStream complete(path_);
+    EXPECT_EQ(first + second, ReadAll(complete));
+    EXPECT_FALSE(complete.IsTruncated());
+
+    WriteFile(data.substr(0, first_frame_end + 20));
+    CompressedFileStream truncated(path_);
+    EXPECT_EQ(first, ReadAll(truncated));
+    EXPECT_TRUE(truncated.IsTruncated());
+
+    // A flipped byte fails the frame checksum
+    std::string corrupt = data;
+    corrupt[corrupt.size() - 1] ^= 0x01;
+    WriteFile(corrupt);
+    CompressedFileStream corrupted(path_);
+    EXPECT_EQ(first, ReadAll(corrupted));
+    EXPECT_TRUE(corrupted.IsTruncated());
+
+    WriteFile("Timestamp,Label,Value,Units\n");
+    CompressedFileStream not_compressed(path_);
+    EXPECT_FALSE(not_compressed);
+}
+
+// Test parsing compression mode names
+TEST_F(StreamCompressionTest, ParseCompressionMode) {
+    EXPECT_EQ(CompressionMode::NONE, ParseCompressionMode("none"));
+    EXPECT_EQ(CompressionMode::LZ, ParseCompressionMode("LZ"));
+    EXPECT_THROW(ParseCompressionMode("zstd"), std::invalid_argument);
+    EXPECT_STREQ(".nvlz", GetCompressionExtension(CompressionMode::LZ));
+    EXPECT_STREQ("", GetCompressionExtension(CompressionMode::NONE));
+}
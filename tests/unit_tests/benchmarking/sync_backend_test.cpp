@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/sync_backend.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include "../../../include/benchmarking/job_runner.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the synchronous pread / pwrite backend
+class SyncBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = std::filesystem::temp_directory_path() / "sync_backend_test";
+        std::filesystem::create_directories(test_dir_);
+
+        options_.engine = IoEngine::PSYNC;
+        options_.filename = (test_dir_ / "target").string();
+        options_.file_size = 4 * 1024 * 1024;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void OnCompletion(void* cb_arg, int status) {
+        static_cast<std::vector<int>*>(cb_arg)->push_back(status);
+    }
+
+    IoBackendOptions options_;
+    std::filesystem::path test_dir_;
+};
+
+// Test constructor with invalid parameters
+TEST_F(SyncBackendTest, ConstructorInvalidParams) {
+    EXPECT_THROW(SyncBackend(options_, 0), std::invalid_argument);
+
+    auto invalid_options = options_;
+    invalid_options.engine = IoEngine::LIBAIO;
+    EXPECT_THROW(SyncBackend(invalid_options, 4), std::invalid_argument);
+}
+
+// Test that commands execute on submission and complete on the next poll
+TEST_F(SyncBackendTest, ReadWrite) {
+    SyncBackend backend(options_, 2);
+    ASSERT_TRUE(backend.Open());
+    EXPECT_EQ("psync", backend.GetName());
+    EXPECT_EQ(options_.file_size, backend.GetSize());
+
+    DmaBufferPool pool(4096, 1, 4096);
+    auto* buffer = static_cast<uint8_t*>(pool.Acquire());
+    std::memset(buffer, 0x5a, 4096);
+
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitWrite(buffer, 8192, 4096, &SyncBackendTest::OnCompletion, &statuses));
+    EXPECT_TRUE(statuses.empty());
+    EXPECT_EQ(1, backend.ProcessCompletions(0));
+
+    std::memset(buffer, 0, 4096);
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 8192, 4096, &SyncBackendTest::OnCompletion, &statuses));
+    EXPECT_EQ(0x5a, buffer[0]);
+    EXPECT_EQ(0x5a, buffer[4095]);
+
+    // Reads past the end of the file are short
+    ASSERT_EQ(0, backend.SubmitRead(buffer, backend.GetSize() - 512, 4096,
+                                    &SyncBackendTest::OnCompletion, &statuses));
+
+    // Undelivered completions occupy the queue
+    EXPECT_EQ(-ENOMEM, backend.SubmitRead(buffer, 0, 4096, &SyncBackendTest::OnCompletion, &statuses));
+    EXPECT_EQ(1, backend.ProcessCompletions(1));
+    EXPECT_EQ(1, backend.ProcessCompletions(0));
+
+    EXPECT_THAT(statuses, ::testing::ElementsAre(0, 0, -EIO));
+    pool.Release(buffer);
+}
+
+// Test a threaded job on the psync engine
+TEST_F(SyncBackendTest, ThreadedJob) {
+    WorkloadProfile profile;
+    profile.total_size = 1024 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 50;
+    profile.write_percentage = 50;
+    profile.random_percentage = 100;
+    profile.queue_depth = 1;
+
+    JobOptions job_options;
+    job_options.num_threads = 4;
+    job_options.backend = options_;
+    JobRunner runner(nullptr, profile, job_options);
+    ASSERT_TRUE(runner.Run());
+
+    WorkloadStats stats = runner.GetResults();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_GT(stats.cpu_seconds, 0.0);
+    EXPECT_GT(stats.GetIopsPerCore(), 0.0);
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/benchmarking/tcp_backend.h"
+#include "../../../include/benchmarking/loopback_target.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include "../../../include/benchmarking/workload_generator.h"
+#include "../../../include/benchmarking/job_runner.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test fixture for the TCP backend, connected to a loopback target on a memory namespace
+class TcpBackendTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ctrlr_ = reinterpret_cast<spdk_nvme_ctrlr*>(1);
+
+        spdk_mock_ns_config config;
+        spdk_mock_get_default_ns_config(&config);
+        ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=4,sector_size=512", &config));
+        ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+
+        test_dir_ = std::filesystem::temp_directory_path() / "tcp_backend_test";
+        std::filesystem::create_directories(test_dir_);
+
+        target_ = std::make_unique<LoopbackTarget>(ctrlr_, "127.0.0.1:0", 64 * 1024);
+        ASSERT_TRUE(target_->Start());
+
+        options_.engine = IoEngine::TCP;
+        options_.address = target_->GetAddress();
+    }
+
+    void TearDown() override {
+        target_.reset();
+        spdk_mock_remove_namespace(2);
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void OnCompletion(void* cb_arg, int status) {
+        static_cast<std::vector<int>*>(cb_arg)->push_back(status);
+    }
+
+    static void WaitFor(IoBackend& backend, const std::vector<int>& statuses, size_t count) {
+        while (statuses.size() < count) {
+            ASSERT_GE(backend.ProcessCompletions(0), 0);
+        }
+    }
+
+    // Write distinct blocks, read them back and compare
+    static void ExpectRoundTrip(TcpBackend& backend) {
+        DmaBufferPool pool(4096, 8, 4096);
+        std::vector<uint8_t*> buffers;
+        std::vector<int> statuses;
+        for (uint32_t i = 0; i < 6; ++i) {
+            auto* buffer = static_cast<uint8_t*>(pool.Acquire());
+            std::memset(buffer, static_cast<int>(i + 1), 4096);
+            ASSERT_EQ(0, backend.SubmitWrite(buffer, uint64_t{i} * 4096, 4096,
+                                             &TcpBackendTest::OnCompletion, &statuses));
+            buffers.push_back(buffer);
+        }
+        WaitFor(backend, statuses, 6);
+
+        for (uint32_t i = 0; i < 6; ++i) {
+            std::memset(buffers[i], 0, 4096);
+            ASSERT_EQ(0, backend.SubmitRead(buffers[i], uint64_t{i} * 4096, 4096,
+                                            &TcpBackendTest::OnCompletion, &statuses));
+        }
+        WaitFor(backend, statuses, 12);
+
+        EXPECT_THAT(statuses, ::testing::Each(0));
+        for (uint32_t i = 0; i < 6; ++i) {
+            EXPECT_EQ(i + 1, buffers[i][0]);
+            EXPECT_EQ(i + 1, buffers[i][4095]);
+            pool.Release(buffers[i]);
+        }
+    }
+
+    spdk_nvme_ctrlr* ctrlr_ = nullptr;
+    std::unique_ptr<LoopbackTarget> target_;
+    IoBackendOptions options_;
+    std::filesystem::path test_dir_;
+};
+
+// Test constructor with invalid parameters
+TEST_F(TcpBackendTest, ConstructorInvalidParams) {
+    EXPECT_THROW(TcpBackend(options_, 0, 2), std::invalid_argument);
+    EXPECT_THROW(TcpBackend(options_, 65536, 2), std::invalid_argument);
+
+    auto invalid_options = options_;
+    invalid_options.address.clear();
+    EXPECT_THROW(TcpBackend(invalid_options, 4, 2), std::invalid_argument);
+
+    invalid_options = options_;
+    invalid_options.engine = IoEngine::PSYNC;
+    EXPECT_THROW(TcpBackend(invalid_options, 4, 2), std::invalid_argument);
+}
+
+// Test that connecting fails for an unknown namespace or a missing target
+TEST_F(TcpBackendTest, OpenFailures) {
+    TcpBackend missing_namespace(options_, 4, 7);
+    EXPECT_FALSE(missing_namespace.Open());
+
+    auto unreachable = options_;
+    unreachable.address = "unix:" + (test_dir_ / "missing.sock").string();
+    TcpBackend missing_target(unreachable, 4, 2);
+    EXPECT_FALSE(missing_target.Open());
+    EXPECT_EQ(-EBADF, missing_target.ProcessCompletions(0));
+}
+
+// Test batched writes and reads over TCP and the transport counters
+TEST_F(TcpBackendTest, RoundTripOverTcp) {
+    options_.submit_batch = 4;
+    TcpBackend backend(options_, 8, 2);
+    ASSERT_TRUE(backend.Open());
+    EXPECT_EQ("tcp", backend.GetName());
+    EXPECT_EQ(512u, backend.GetSectorSize());
+    EXPECT_EQ(4u * 1024 * 1024, backend.GetSize());
+    EXPECT_EQ(64u * 1024, backend.GetMaxDataSize());
+
+    ExpectRoundTrip(backend);
+
+    // 6 capsules with data PDUs, 6 read capsules; 6 write responses, 6 data PDUs with responses
+    const TransportStats& stats = backend.GetTransportStats();
+    EXPECT_EQ(18u, stats.pdus_sent);
+    EXPECT_EQ(18u, stats.pdus_received);
+    EXPECT_GT(stats.bytes_sent, 6u * 4096);
+    EXPECT_GT(stats.bytes_received, 6u * 4096);
+    EXPECT_GT(stats.send_calls, 0u);
+    EXPECT_GT(stats.recv_calls, 0u);
+}
+
+// Test the same round trip over a Unix socket
+TEST_F(TcpBackendTest, RoundTripOverUnixSocket) {
+    LoopbackTarget unix_target(ctrlr_, "unix:" + (test_dir_ / "target.sock").string());
+    ASSERT_TRUE(unix_target.Start());
+    options_.address = unix_target.GetAddress();
+
+    TcpBackend backend(options_, 8, 2);
+    ASSERT_TRUE(backend.Open());
+    ExpectRoundTrip(backend);
+}
+
+// Test the queue limit, oversized transfers and target errors
+TEST_F(TcpBackendTest, QueueFullAndErrors) {
+    TcpBackend backend(options_, 2, 2);
+    ASSERT_TRUE(backend.Open());
+
+    DmaBufferPool pool(128 * 1024, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    EXPECT_EQ(-EINVAL, backend.SubmitRead(buffer, 0, 128 * 1024, &TcpBackendTest::OnCompletion, &statuses));
+    EXPECT_EQ(-EINVAL, backend.SubmitRead(buffer, 100, 512, &TcpBackendTest::OnCompletion, &statuses));
+
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &TcpBackendTest::OnCompletion, &statuses));
+    ASSERT_EQ(0, backend.SubmitRead(buffer, backend.GetSize(), 512, &TcpBackendTest::OnCompletion, &statuses));
+    EXPECT_EQ(-ENOMEM, backend.SubmitRead(buffer, 0, 4096, &TcpBackendTest::OnCompletion, &statuses));
+
+    WaitFor(backend, statuses, 2);
+    EXPECT_THAT(statuses, ::testing::UnorderedElementsAre(0, SPDK_NVME_SC_LBA_OUT_OF_RANGE));
+    pool.Release(buffer);
+}
+
+// Test that a stopped target surfaces as a connection error
+TEST_F(TcpBackendTest, TargetStopped) {
+    TcpBackend backend(options_, 2, 2);
+    ASSERT_TRUE(backend.Open());
+
+    DmaBufferPool pool(4096, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &TcpBackendTest::OnCompletion, &statuses));
+    WaitFor(backend, statuses, 1);
+
+    target_->Stop();
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &TcpBackendTest::OnCompletion, &statuses));
+    int32_t rc = 0;
+    while (rc == 0) {
+        rc = backend.ProcessCompletions(0);
+    }
+    EXPECT_LT(rc, 0);
+    pool.Release(buffer);
+}
+
+// Test a workload generator and a threaded job on the tcp engine
+TEST_F(TcpBackendTest, WorkloadOnTcp) {
+    WorkloadProfile profile;
+    profile.namespace_id = 2;
+    profile.total_size = 1024 * 1024;
+    profile.block_size = 4096;
+    profile.num_blocks = 256;
+    profile.interval_us = 0;
+    profile.read_percentage = 70;
+    profile.write_percentage = 30;
+    profile.random_percentage = 100;
+    profile.queue_depth = 8;
+
+    auto backend = std::make_shared<TcpBackend>(options_, profile.queue_depth, profile.namespace_id);
+    WorkloadGenerator generator(backend, profile);
+    ASSERT_TRUE(generator.Generate());
+    WorkloadStats stats = generator.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_GT(backend->GetTransportStats().pdus_received, 0u);
+
+    JobOptions job_options;
+    job_options.num_threads = 2;
+    job_options.backend = options_;
+    JobRunner runner(nullptr, profile, job_options);
+    ASSERT_TRUE(runner.Run());
+    stats = runner.GetResults();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(profile.total_size, stats.read_bytes + stats.write_bytes);
+    EXPECT_EQ(3u, target_->GetConnectionCount());
+}
+
+// Test waiting on the socket for the target's responses
+TEST_F(TcpBackendTest, BlockingCompletions) {
+    TcpBackend backend(options_, 4, 2);
+    ASSERT_TRUE(backend.Open());
+
+    // Nothing in flight: the wait times out
+    EXPECT_EQ(0, backend.WaitForCompletions(0, 1000000));
+
+    DmaBufferPool pool(4096, 1, 4096);
+    void* buffer = pool.Acquire();
+    std::vector<int> statuses;
+    ASSERT_EQ(0, backend.SubmitRead(buffer, 0, 4096, &TcpBackendTest::OnCompletion, &statuses));
+    while (statuses.empty()) {
+        ASSERT_GE(backend.WaitForCompletions(0, 1000000000), 0);
+    }
+    EXPECT_EQ(0, statuses[0]);
+    pool.Release(buffer);
+}
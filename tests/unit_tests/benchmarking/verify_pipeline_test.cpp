@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../../../include/benchmarking/verify_pipeline.h"
+#include "../../../include/benchmarking/payload_generator.h"
+#include <vector>
+
+using namespace nvmeof::benchmarking;
+
+// Test constructor with invalid parameters
+TEST(VerifyPipelineTest, ConstructorInvalidParams) {
+    BlockVerifier verifier(512, 1);
+    EXPECT_THROW(VerifyPipeline(verifier, 0), std::invalid_argument);
+    EXPECT_THROW(VerifyPipeline(verifier, VerifyPipeline::kMaxThreads + 1), std::invalid_argument);
+    EXPECT_NO_THROW(VerifyPipeline(verifier, 2));
+}
+
+// Test that buffers stamped by the helper threads verify there and inline
+TEST(VerifyPipelineTest, StampAndVerify) {
+    BlockVerifier verifier(512, 7);
+    VerifyPipeline pipeline(verifier, 3);
+
+    constexpr size_t kBuffers = 32;
+    std::vector<std::vector<uint8_t>> buffers(kBuffers, std::vector<uint8_t>(4096));
+    for (size_t i = 0; i < kBuffers; ++i) {
+        PayloadGenerator::FillRandom(buffers[i].data(), buffers[i].size(), i);
+        VerifyPipeline::Task task;
+        task.tag = &buffers[i];
+        task.buffer = buffers[i].data();
+        task.offset = i * 4096;
+        task.size = 4096;
+        task.is_write = true;
+        task.generation = verifier.NextGeneration();
+        pipeline.Push(task);
+    }
+
+    auto collect = [&pipeline](std::vector<VerifyPipeline::Task>& done) {
+        while (pipeline.GetPending() > 0) {
+            pipeline.WaitForDone(1000000);
+            pipeline.Collect(done);
+        }
+    };
+    std::vector<VerifyPipeline::Task> done;
+    collect(done);
+    ASSERT_EQ(kBuffers, done.size());
+    EXPECT_EQ(0u, pipeline.GetPending());
+    EXPECT_FALSE(pipeline.WaitForDone(0));
+
+    VerifyStats inline_stats;
+    for (size_t i = 0; i < kBuffers; ++i) {
+        EXPECT_EQ(0u, verifier.Verify(buffers[i].data(), i * 4096, 4096, inline_stats));
+    }
+    EXPECT_EQ(kBuffers * 8, inline_stats.blocks_verified);
+
+    // Corrupt one buffer, then check them all on the helper threads
+    buffers[5][700] ^= 0x01;
+    for (size_t i = 0; i < kBuffers; ++i) {
+        VerifyPipeline::Task task;
+        task.tag = &buffers[i];
+        task.buffer = buffers[i].data();
+        task.offset = i * 4096;
+        task.size = 4096;
+        pipeline.Push(task);
+    }
+    EXPECT_EQ(kBuffers, pipeline.GetPending());
+    pipeline.Flush();
+    done.clear();
+    collect(done);
+    ASSERT_EQ(kBuffers, done.size());
+    for (const auto& task : done) {
+        EXPECT_EQ(task.tag == &buffers[5] ? 1u : 0u, task.failed);
+    }
+
+    VerifyStats stats = pipeline.TakeStats();
+    EXPECT_EQ(kBuffers * 8 - 1, stats.blocks_verified);
+    EXPECT_EQ(1u, stats.errors);
+    ASSERT_EQ(1u, stats.failures.size());
+    EXPECT_EQ(VerifyErrorType::CRC_MISMATCH, stats.failures[0].type);
+    EXPECT_EQ(5u * 8 + 1, stats.failures[0].lba);
+    EXPECT_EQ(0u, pipeline.TakeStats().blocks_verified);
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "../../../include/benchmarking/workload_generator.h"
+#include "../../../include/benchmarking/spdk_backend.h"
+#include "../../../include/benchmarking/dma_buffer_pool.h"
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
 
 // Mock for NVMe controller
 class MockNvmeCtrlr {
@@ -16,6 +21,39 @@ public:
     virtual uint32_t GetSectorSize() const = 0;
 };
 
+// Backend that accepts commands but fails every poll, leaving them outstanding
+class FailingBackend : public nvmeof::benchmarking::IoBackend {
+public:
+    explicit FailingBackend(bool can_cancel) : can_cancel_(can_cancel) {}
+
+    bool Open() override { return true; }
+    bool Close() override {
+        ++close_calls;
+        if (can_cancel_) {
+            outstanding = 0;
+        }
+        return outstanding == 0;
+    }
+    std::string GetName() const override { return "failing"; }
+    uint32_t GetSectorSize() const override { return 512; }
+    uint64_t GetSize() const override { return 1048576; }
+    int SubmitRead(void*, uint64_t, uint32_t, nvmeof::benchmarking::IoBackendCallback, void*) override {
+        ++outstanding;
+        return 0;
+    }
+    int SubmitWrite(void*, uint64_t, uint32_t, nvmeof::benchmarking::IoBackendCallback, void*) override {
+        ++outstanding;
+        return 0;
+    }
+    int32_t ProcessCompletions(uint32_t) override { return -EIO; }
+
+    uint32_t outstanding = 0;
+    uint32_t close_calls = 0;
+
+private:
+    bool can_cancel_;
+};
+
 // Test fixture for WorkloadGenerator tests
 class WorkloadGeneratorTest : public ::testing::Test {
 protected:
@@ -28,9 +66,19 @@ protected:
         profile_.read_percentage = 50;        // 50% reads
         profile_.write_percentage = 50;       // 50% writes
         profile_.random_percentage = 70;      // 70% random
+        
+        // The mock queue pair holds commands until they are polled
+        qpair_ = spdk_nvme_ctrlr_alloc_io_qpair(
+            reinterpret_cast<spdk_nvme_ctrlr*>(1), nullptr, 0);
+        ASSERT_NE(nullptr, qpair_);
+    }
+    
+    void TearDown() override {
+        spdk_nvme_ctrlr_free_io_qpair(qpair_);
     }
     
     nvmeof::benchmarking::WorkloadProfile profile_;
+    spdk_nvme_qpair* qpair_ = nullptr;
 };
 
 // Test WorkloadProfile::IsValid() method
@@ -65,13 +113,41 @@ TEST_F(WorkloadGeneratorTest, ProfileValidation) {
     invalid_profile = profile_;
     invalid_profile.random_percentage = 110;
     EXPECT_FALSE(invalid_profile.IsValid());
+    
+    // Zero queue depth
+    invalid_profile = profile_;
+    invalid_profile.queue_depth = 0;
+    EXPECT_FALSE(invalid_profile.IsValid());
+    
+    // Negative throughput cap
+    invalid_profile = profile_;
+    invalid_profile.rate_mbps = -1.0;
+    EXPECT_FALSE(invalid_profile.IsValid());
+    
+    // Open loop without an arrival rate
+    invalid_profile = profile_;
+    invalid_profile.arrival_mode = nvmeof::benchmarking::ArrivalMode::POISSON;
+    EXPECT_FALSE(invalid_profile.IsValid());
+    
+    // Zero-weight or oversized entries in a block-size distribution
+    invalid_profile = profile_;
+    invalid_profile.read_block_sizes = {{4096, 0}};
+    EXPECT_FALSE(invalid_profile.IsValid());
+    invalid_profile.read_block_sizes = {{4096, 1}, {2 * 1048576, 1}};
+    EXPECT_FALSE(invalid_profile.IsValid());
+    
+    // Invalid access distribution parameters
+    invalid_profile = profile_;
+    invalid_profile.access_pattern.distribution = nvmeof::benchmarking::AccessDistribution::ZIPF;
+    invalid_profile.access_pattern.zipf_theta = -1.0;
+    EXPECT_FALSE(invalid_profile.IsValid());
 }
 
 // Test WorkloadGenerator constructor with invalid parameters
 TEST_F(WorkloadGeneratorTest, ConstructorInvalidParams) {
     // Null controller
     EXPECT_THROW(
-        nvmeof::benchmarking::WorkloadGenerator(nullptr, reinterpret_cast<const spdk_nvme_qpair*>(1), profile_),
+        nvmeof::benchmarking::WorkloadGenerator(nullptr, qpair_, profile_),
         std::invalid_argument
     );
     
@@ -87,7 +163,7 @@ TEST_F(WorkloadGeneratorTest, ConstructorInvalidParams) {
     EXPECT_THROW(
         nvmeof::benchmarking::WorkloadGenerator(
             reinterpret_cast<const spdk_nvme_ctrlr*>(1),
-            reinterpret_cast<const spdk_nvme_qpair*>(1),
+            qpair_,
             invalid_profile
         ),
         std::invalid_argument
@@ -102,7 +178,7 @@ TEST_F(WorkloadGeneratorTest, GetProgress) {
     // Create a generator with mock objects
     auto generator = nvmeof::benchmarking::WorkloadGenerator(
         reinterpret_cast<const spdk_nvme_ctrlr*>(1),
-        reinterpret_cast<const spdk_nvme_qpair*>(1),
+        qpair_,
         profile_
     );
     
@@ -117,7 +193,7 @@ TEST_F(WorkloadGeneratorTest, Stop) {
     // Create a generator with mock objects
     auto generator = nvmeof::benchmarking::WorkloadGenerator(
         reinterpret_cast<const spdk_nvme_ctrlr*>(1),
-        reinterpret_cast<const spdk_nvme_qpair*>(1),
+        qpair_,
         profile_
     );
     
@@ -142,7 +218,7 @@ TEST_F(WorkloadGeneratorTest, Callback) {
     // Create a generator with the callback
     auto generator = nvmeof::benchmarking::WorkloadGenerator(
         reinterpret_cast<const spdk_nvme_ctrlr*>(1),
-        reinterpret_cast<const spdk_nvme_qpair*>(1),
+        qpair_,
         profile_,
         callback
     );
@@ -151,4 +227,613 @@ TEST_F(WorkloadGeneratorTest, Callback) {
     // This would require more sophisticated mocking of the SPDK APIs
 }
 
+// Test that commands left in flight by a failed poll are cancelled before their buffers are released
+TEST_F(WorkloadGeneratorTest, FailedPollClosesBackend) {
+    profile_.interval_us = 0;
+    profile_.queue_depth = 4;
+    auto pool = std::make_shared<nvmeof::benchmarking::DmaBufferPool>(
+        profile_.block_size, profile_.queue_depth, 512);
+    
+    auto cancelling = std::make_shared<FailingBackend>(true);
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(cancelling, profile_);
+        generator.SetBufferPool(pool);
+        EXPECT_FALSE(generator.Generate());
+        EXPECT_EQ(1u, cancelling->close_calls);
+        EXPECT_EQ(profile_.queue_depth, pool->GetAvailableCount());
+    }
+    EXPECT_EQ(1, pool.use_count());
+    
+    // A pool the target may still write into outlives the generator
+    auto stuck = std::make_shared<FailingBackend>(false);
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(stuck, profile_);
+        generator.SetBufferPool(pool);
+        EXPECT_FALSE(generator.Generate());
+        EXPECT_EQ(1u, stuck->close_calls);
+    }
+    EXPECT_EQ(2, pool.use_count());
+}
+
+// Test that a run with several commands in flight processes the whole profile
+TEST_F(WorkloadGeneratorTest, GenerateWithQueueDepth) {
+    profile_.queue_depth = 8;
+    profile_.interval_us = 0;
+    
+    bool callback_success = false;
+    uint32_t callback_bytes = 0;
+    auto callback = [&callback_success, &callback_bytes](bool success, uint32_t bytes_processed) {
+        callback_success = success;
+        callback_bytes = bytes_processed;
+    };
+    
+    // The mock SPDK library does not dereference the controller
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_,
+        callback
+    );
+    
+    EXPECT_TRUE(generator.Generate());
+    EXPECT_TRUE(callback_success);
+    EXPECT_EQ(profile_.total_size, callback_bytes);
+    EXPECT_DOUBLE_EQ(1.0, generator.GetProgress());
+}
+
+// Test that the generator addresses the configured namespace and stays inside it
+TEST_F(WorkloadGeneratorTest, GenerateOnNamespace) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    config.backing = SPDK_MOCK_NS_BACKING_MEMORY;
+    config.num_sectors = 128;  // 512 KiB, half of the addressed range
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+    
+    profile_.queue_depth = 4;
+    profile_.interval_us = 0;
+    profile_.namespace_id = 2;
+    
+    nvmeof::benchmarking::WorkloadGenerator oversized(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    EXPECT_FALSE(oversized.Generate());
+    
+    profile_.num_blocks = 128;
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    EXPECT_TRUE(generator.Generate());
+    EXPECT_EQ(0u, generator.GetStats().errors);
+    EXPECT_EQ(profile_.total_size, generator.GetStats().read_bytes + generator.GetStats().write_bytes);
+    
+    // Missing namespaces are reported
+    spdk_mock_remove_namespace(2);
+    nvmeof::benchmarking::WorkloadGenerator missing(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    EXPECT_FALSE(missing.Generate());
+}
+
+// Test that an IOPS cap paces the run
+TEST_F(WorkloadGeneratorTest, GenerateWithIopsCap) {
+    profile_.queue_depth = 4;
+    profile_.interval_us = 0;
+    profile_.total_size = 200 * profile_.block_size;
+    profile_.rate_iops = 2000;
+    
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_
+    );
+    
+    ASSERT_TRUE(generator.Generate());
+    
+    // 200 commands at 2000 IOPS take about 100 ms (minus the initial burst)
+    auto stats = generator.GetStats();
+    EXPECT_EQ(200u, stats.read_ops + stats.write_ops);
+    EXPECT_GT(stats.elapsed_seconds, 0.08);
+    EXPECT_LT(stats.GetIops(), 2000 * 1.2);
+}
+
+// Test that a timed run ignores the byte budget and stops after the runtime
+TEST_F(WorkloadGeneratorTest, GenerateTimed) {
+    profile_.queue_depth = 2;
+    profile_.interval_us = 0;
+    profile_.total_size = profile_.block_size;
+    profile_.runtime_seconds = 1;
+    profile_.rate_mbps = 4.096;  // 1000 blocks per second
+    
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_
+    );
+    
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(generator.Generate());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    
+    EXPECT_GE(elapsed.count(), 1.0);
+    EXPECT_LT(elapsed.count(), 3.0);
+    EXPECT_DOUBLE_EQ(1.0, generator.GetProgress());
+    
+    auto stats = generator.GetStats();
+    EXPECT_GT(stats.GetThroughputMBps(), 0.0);
+    EXPECT_LT(stats.GetThroughputMBps(), 4.096 * 1.2);
+}
+
+// Test that an unpaced timed run ends at its deadline when commands complete inline
+TEST_F(WorkloadGeneratorTest, GenerateTimedUnpaced) {
+    profile_.queue_depth = 4;
+    profile_.interval_us = 0;
+    profile_.runtime_seconds = 1;
+
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_
+    );
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(generator.Generate());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed.count(), 1.0);
+    EXPECT_LT(elapsed.count(), 3.0);
+    EXPECT_GT(generator.GetStats().read_ops + generator.GetStats().write_ops, 0u);
+}
+
+// Test arrival mode name parsing
+TEST_F(WorkloadGeneratorTest, ParseArrivalMode) {
+    using nvmeof::benchmarking::ArrivalMode;
+    using nvmeof::benchmarking::ParseArrivalMode;
+    
+    EXPECT_EQ(ArrivalMode::CLOSED_LOOP, ParseArrivalMode("closed"));
+    EXPECT_EQ(ArrivalMode::CONSTANT, ParseArrivalMode("Constant"));
+    EXPECT_EQ(ArrivalMode::POISSON, ParseArrivalMode("POISSON"));
+    EXPECT_THROW(ParseArrivalMode("bursty"), std::invalid_argument);
+}
+
+// Test that open-loop runs follow the arrival schedule
+TEST_F(WorkloadGeneratorTest, GenerateOpenLoop) {
+    using nvmeof::benchmarking::ArrivalMode;
+    
+    for (auto mode : {ArrivalMode::CONSTANT, ArrivalMode::POISSON}) {
+        profile_.queue_depth = 4;
+        profile_.total_size = 200 * profile_.block_size;
+        profile_.arrival_mode = mode;
+        profile_.arrival_rate = 2000.0;
+        
+        nvmeof::benchmarking::WorkloadGenerator generator(
+            reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+            qpair_,
+            profile_
+        );
+        
+        ASSERT_TRUE(generator.Generate());
+        
+        // 200 arrivals at 2000 per second span about 100 ms
+        auto stats = generator.GetStats();
+        EXPECT_EQ(200u, stats.read_ops + stats.write_ops);
+        EXPECT_GT(stats.elapsed_seconds, 0.05);
+        EXPECT_LT(stats.elapsed_seconds, 0.5);
+        
+        // Latency from the intended issue time can never be below the service time
+        EXPECT_GE(stats.latency_ns_sum, stats.service_ns_sum);
+        EXPECT_GE(stats.latency_ns_max, stats.service_ns_max);
+    }
+}
+
+// Test merging latency statistics
+TEST_F(WorkloadGeneratorTest, MergeLatencyStats) {
+    nvmeof::benchmarking::WorkloadStats a;
+    a.read_ops = 2;
+    a.latency_ns_sum = 4000;
+    a.latency_ns_max = 3000;
+    a.service_ns_sum = 2000;
+    a.service_ns_max = 1500;
+    
+    nvmeof::benchmarking::WorkloadStats b;
+    b.write_ops = 2;
+    b.latency_ns_sum = 8000;
+    b.latency_ns_max = 5000;
+    b.service_ns_sum = 2000;
+    b.service_ns_max = 1000;
+    
+    a.Merge(b);
+    EXPECT_EQ(5000u, a.latency_ns_max);
+    EXPECT_EQ(1500u, a.service_ns_max);
+    EXPECT_DOUBLE_EQ(3.0, a.GetMeanLatencyUs());
+    EXPECT_DOUBLE_EQ(1.0, a.GetMeanServiceTimeUs());
+}
+
+// Test that commands overlap on a device with a service time
+TEST_F(WorkloadGeneratorTest, GenerateWithServiceTime) {
+    const uint64_t service_time_ns = 200000;  // 200 us
+    const uint64_t saved_service_time_ns = spdk_mock_get_service_time_ns();
+    spdk_mock_set_service_time_ns(service_time_ns);
+
+    profile_.queue_depth = 8;
+    profile_.interval_us = 0;
+    profile_.total_size = 400 * profile_.block_size;
+
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_
+    );
+
+    auto start = std::chrono::steady_clock::now();
+    bool success = generator.Generate();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    spdk_mock_set_service_time_ns(saved_service_time_ns);
+    ASSERT_TRUE(success);
+
+    // Serial execution would take 400 service times
+    EXPECT_LT(elapsed.count(), 400 * service_time_ns / 1e9 / 2);
+
+    auto stats = generator.GetStats();
+    EXPECT_EQ(400u, stats.read_ops + stats.write_ops);
+    EXPECT_GE(stats.read_latency.GetMin(), service_time_ns);
+    EXPECT_GE(stats.write_latency.GetMin(), service_time_ns);
+}
+
+// Test that a run with weighted block sizes reports per-size statistics
+TEST_F(WorkloadGeneratorTest, GenerateMixedBlockSizes) {
+    profile_.queue_depth = 4;
+    profile_.interval_us = 0;
+    profile_.total_size = 64ULL * 1048576;
+    profile_.read_block_sizes = {{4096, 60}, {65536, 30}, {1048576, 10}};
+    profile_.write_block_sizes = {{4096, 1}};
+    
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1),
+        qpair_,
+        profile_
+    );
+    
+    ASSERT_TRUE(generator.Generate());
+    auto stats = generator.GetStats();
+    EXPECT_EQ(profile_.total_size, stats.read_bytes + stats.write_bytes);
+    
+    ASSERT_EQ(3u, stats.size_buckets.size());
+    EXPECT_EQ(4096u, stats.size_buckets[0].block_size);
+    EXPECT_EQ(65536u, stats.size_buckets[1].block_size);
+    EXPECT_EQ(1048576u, stats.size_buckets[2].block_size);
+    
+    // All writes are 4 KiB; reads follow the 60/30/10 weights
+    EXPECT_EQ(stats.write_ops, stats.size_buckets[0].write_ops);
+    EXPECT_EQ(0u, stats.size_buckets[2].write_ops);
+    double reads = static_cast<double>(stats.read_ops);
+    EXPECT_NEAR(0.3, stats.size_buckets[1].read_ops / reads, 0.08);
+    EXPECT_NEAR(0.1, stats.size_buckets[2].read_ops / reads, 0.05);
+    
+    uint64_t bucket_ops = 0;
+    for (const auto& bucket : stats.size_buckets) {
+        bucket_ops += bucket.read_ops + bucket.write_ops;
+        EXPECT_EQ(bucket.read_ops + bucket.write_ops, bucket.latency.GetCount());
+    }
+    EXPECT_EQ(stats.read_ops + stats.write_ops, bucket_ops);
+}
+
+// Test that merging matches size buckets by transfer size
+TEST_F(WorkloadGeneratorTest, MergeSizeBuckets) {
+    nvmeof::benchmarking::WorkloadStats a;
+    a.GetSizeBucket(65536).read_ops = 2;
+    
+    nvmeof::benchmarking::WorkloadStats b;
+    b.GetSizeBucket(65536).read_ops = 3;
+    b.GetSizeBucket(4096).write_ops = 5;
+    
+    a.Merge(b);
+    ASSERT_EQ(2u, a.size_buckets.size());
+    EXPECT_EQ(4096u, a.size_buckets[0].block_size);
+    EXPECT_EQ(5u, a.size_buckets[0].write_ops);
+    EXPECT_EQ(5u, a.size_buckets[1].read_ops);
+}
+
+// Test IOPS per core across merged workers
+TEST_F(WorkloadGeneratorTest, IopsPerCore) {
+    nvmeof::benchmarking::WorkloadStats a;
+    EXPECT_DOUBLE_EQ(0.0, a.GetIopsPerCore());
+    a.read_ops = 3000;
+    a.cpu_seconds = 0.5;
+    
+    nvmeof::benchmarking::WorkloadStats b;
+    b.write_ops = 1000;
+    b.cpu_seconds = 0.5;
+    
+    a.Merge(b);
+    EXPECT_DOUBLE_EQ(1.0, a.cpu_seconds);
+    EXPECT_DOUBLE_EQ(4000.0, a.GetIopsPerCore());
+    
+    // A run charges the CPU time of the generator thread
+    profile_.interval_us = 0;
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    ASSERT_TRUE(generator.Generate());
+    nvmeof::benchmarking::WorkloadStats stats = generator.GetStats();
+    EXPECT_GT(stats.cpu_seconds, 0.0);
+    EXPECT_LE(stats.cpu_seconds, stats.elapsed_seconds * 1.5 + 0.01);
+    EXPECT_GT(stats.GetIopsPerCore(), 0.0);
+}
+
+// Test parsing completion mode names
+TEST_F(WorkloadGeneratorTest, ParseCompletionMode) {
+    using nvmeof::benchmarking::CompletionMode;
+    using nvmeof::benchmarking::ParseCompletionMode;
+    
+    EXPECT_EQ(CompletionMode::POLL, ParseCompletionMode("poll"));
+    EXPECT_EQ(CompletionMode::POLL, ParseCompletionMode("Polling"));
+    EXPECT_EQ(CompletionMode::BLOCK, ParseCompletionMode("block"));
+    EXPECT_EQ(CompletionMode::BLOCK, ParseCompletionMode("interrupt"));
+    EXPECT_EQ(CompletionMode::HYBRID, ParseCompletionMode("HYBRID"));
+    EXPECT_THROW(ParseCompletionMode("spin"), std::invalid_argument);
+    EXPECT_EQ("hybrid", nvmeof::benchmarking::GetCompletionModeName(CompletionMode::HYBRID));
+}
+
+// Test that blocking and hybrid waits spend fewer cycles per I/O than polling
+TEST_F(WorkloadGeneratorTest, CompletionModes) {
+    using nvmeof::benchmarking::CompletionMode;
+    
+    nvmeof::benchmarking::WorkloadStats empty;
+    EXPECT_DOUBLE_EQ(0.0, empty.GetCyclesPerIo());
+    
+    const uint64_t service_time_ns = 500000;  // 500 us
+    const uint64_t saved_service_time_ns = spdk_mock_get_service_time_ns();
+    spdk_mock_set_service_time_ns(service_time_ns);
+    
+    profile_.queue_depth = 4;
+    profile_.interval_us = 0;
+    profile_.total_size = 200 * profile_.block_size;
+    
+    double poll_cycles = 0.0;
+    for (auto mode : {CompletionMode::POLL, CompletionMode::BLOCK, CompletionMode::HYBRID}) {
+        profile_.completion_mode = mode;
+        nvmeof::benchmarking::WorkloadGenerator generator(
+            reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+        ASSERT_TRUE(generator.Generate());
+        
+        auto stats = generator.GetStats();
+        EXPECT_EQ(200u, stats.read_ops + stats.write_ops);
+        EXPECT_EQ(0u, stats.errors);
+        EXPECT_GE(stats.read_latency.GetMin(), service_time_ns);
+        EXPECT_GT(stats.GetCyclesPerIo(), 0.0);
+        if (mode == CompletionMode::POLL) {
+            EXPECT_EQ(0u, stats.completion_waits);
+            poll_cycles = stats.GetCyclesPerIo();
+        } else {
+            EXPECT_GT(stats.completion_waits, 0u);
+            EXPECT_LT(stats.GetCyclesPerIo(), poll_cycles);
+        }
+    }
+    spdk_mock_set_service_time_ns(saved_service_time_ns);
+}
+
+// Test batched submission with delayed doorbells and bounded reaping
+TEST_F(WorkloadGeneratorTest, GenerateBatched) {
+    profile_.queue_depth = 32;
+    profile_.interval_us = 0;
+    profile_.total_size = 512 * profile_.block_size;
+    
+    // Unbatched: one doorbell per command
+    {
+        auto backend = std::make_shared<nvmeof::benchmarking::SpdkBackend>(
+            reinterpret_cast<spdk_nvme_ctrlr*>(1), qpair_);
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(512u, stats.submit_calls);
+        EXPECT_DOUBLE_EQ(1.0, stats.GetSubmitCallsPerIo());
+        EXPECT_EQ(512u, stats.submit_batches.GetCommandCount());
+    }
+    
+    spdk_nvme_io_qpair_opts opts;
+    spdk_nvme_ctrlr_get_default_io_qpair_opts(reinterpret_cast<spdk_nvme_ctrlr*>(1), &opts, sizeof(opts));
+    opts.delay_cmd_submit = true;
+    spdk_nvme_qpair* qpair = spdk_nvme_ctrlr_alloc_io_qpair(
+        reinterpret_cast<spdk_nvme_ctrlr*>(1), &opts, sizeof(opts));
+    ASSERT_NE(nullptr, qpair);
+    
+    profile_.submit_batch = 8;
+    profile_.reap_batch = 4;
+    auto backend = std::make_shared<nvmeof::benchmarking::SpdkBackend>(
+        reinterpret_cast<spdk_nvme_ctrlr*>(1), qpair, 1, true);
+    nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+    ASSERT_TRUE(generator.Generate());
+    auto stats = generator.GetStats();
+    EXPECT_EQ(512u, stats.read_ops + stats.write_ops);
+    EXPECT_EQ(0u, stats.errors);
+    
+    // Batches of up to 8 commands, each sent with one doorbell by the following poll
+    EXPECT_EQ(512u, stats.submit_batches.GetCommandCount());
+    EXPECT_EQ(8u, stats.submit_batches.GetMax());
+    EXPECT_EQ(64u, stats.submit_batches.GetBatchCount());
+    EXPECT_EQ(64u, stats.submit_calls);
+    EXPECT_DOUBLE_EQ(0.125, stats.GetSubmitCallsPerIo());
+    EXPECT_EQ(512u, stats.reap_batches.GetCommandCount());
+    EXPECT_EQ(4u, stats.reap_batches.GetMax());
+    
+    spdk_mock_qpair_stats qpair_stats;
+    ASSERT_EQ(0, spdk_mock_qpair_get_stats(qpair, &qpair_stats));
+    EXPECT_EQ(64u, qpair_stats.sq_doorbells);
+    EXPECT_EQ(stats.reap_batches.GetBatchCount(), qpair_stats.cq_doorbells);
+    
+    // Batch counters are summed across workers
+    nvmeof::benchmarking::WorkloadStats merged;
+    merged.Merge(stats);
+    merged.Merge(stats);
+    EXPECT_EQ(128u, merged.submit_calls);
+    EXPECT_EQ(128u, merged.submit_batches.GetBatchCount());
+    
+    spdk_nvme_ctrlr_free_io_qpair(qpair);
+}
+
+// Test that verify mode checks reads against the headers stamped by writes
+TEST_F(WorkloadGeneratorTest, GenerateVerified) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=1,sector_size=512", &config));
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+    
+    profile_.queue_depth = 8;
+    profile_.interval_us = 0;
+    profile_.namespace_id = 2;
+    profile_.random_percentage = 100;
+    profile_.total_size = 4 * 1024 * 1024;
+    profile_.verify = true;
+    profile_.verify_seed = 11;
+    
+    auto backend = std::make_shared<nvmeof::benchmarking::SpdkBackend>(
+        reinterpret_cast<spdk_nvme_ctrlr*>(1), qpair_, 2);
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.errors);
+        EXPECT_EQ(0u, stats.verify.errors);
+        EXPECT_GT(stats.verify.blocks_verified, 0u);
+        EXPECT_EQ(stats.read_bytes / 512, stats.verify.blocks_verified + stats.verify.blocks_unwritten);
+    }
+    
+    // Data written by a run with another seed is reported as stale
+    profile_.read_percentage = 100;
+    profile_.write_percentage = 0;
+    profile_.total_size = 1024 * 1024;
+    profile_.random_percentage = 0;
+    profile_.verify_seed = 12;
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.errors);
+        EXPECT_EQ(0u, stats.verify.blocks_verified);
+        EXPECT_GT(stats.verify.errors, 0u);
+        ASSERT_FALSE(stats.verify.failures.empty());
+        EXPECT_EQ(nvmeof::benchmarking::VerifyErrorType::SEED_MISMATCH, stats.verify.failures[0].type);
+        EXPECT_EQ(11u, stats.verify.failures[0].seed);
+    }
+    spdk_mock_remove_namespace(2);
+    
+    // The pattern namespace returns data without headers; LBA 0 would read as zeros
+    profile_.namespace_id = 1;
+    profile_.start_block = 1;
+    profile_.total_size = 64 * 1024;
+    nvmeof::benchmarking::WorkloadGenerator generator(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    ASSERT_TRUE(generator.Generate());
+    auto stats = generator.GetStats();
+    EXPECT_EQ(16u, stats.verify.errors);
+    EXPECT_EQ(nvmeof::benchmarking::VerifyErrorType::BAD_MAGIC, stats.verify.failures[0].type);
+}
+
+// Test that verify_async stamps and checks on helper threads with the same results
+TEST_F(WorkloadGeneratorTest, GenerateVerifiedAsync) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=1,sector_size=512", &config));
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+    
+    profile_.queue_depth = 8;
+    profile_.interval_us = 0;
+    profile_.namespace_id = 2;
+    profile_.random_percentage = 100;
+    profile_.total_size = 4 * 1024 * 1024;
+    profile_.verify = true;
+    profile_.verify_seed = 21;
+    profile_.verify_async = 2;
+    
+    auto backend = std::make_shared<nvmeof::benchmarking::SpdkBackend>(
+        reinterpret_cast<spdk_nvme_ctrlr*>(1), qpair_, 2);
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.errors);
+        EXPECT_EQ(0u, stats.verify.errors);
+        EXPECT_GT(stats.verify.blocks_verified, 0u);
+        EXPECT_EQ(stats.read_bytes / 512, stats.verify.blocks_verified + stats.verify.blocks_unwritten);
+    }
+    
+    // Blocks stamped on the helper threads check out inline, and the other way round
+    profile_.read_percentage = 100;
+    profile_.write_percentage = 0;
+    profile_.total_size = 1024 * 1024;
+    profile_.random_percentage = 0;
+    profile_.verify_async = 0;
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.verify.errors);
+        EXPECT_GT(stats.verify.blocks_verified, 0u);
+    }
+    profile_.verify_async = 1;
+    profile_.verify_seed = 22;
+    {
+        nvmeof::benchmarking::WorkloadGenerator generator(backend, profile_);
+        ASSERT_TRUE(generator.Generate());
+        auto stats = generator.GetStats();
+        EXPECT_EQ(0u, stats.verify.blocks_verified);
+        EXPECT_EQ(stats.read_bytes / 512, stats.verify.errors + stats.verify.blocks_unwritten);
+        ASSERT_FALSE(stats.verify.failures.empty());
+        EXPECT_EQ(nvmeof::benchmarking::VerifyErrorType::SEED_MISMATCH, stats.verify.failures[0].type);
+    }
+    spdk_mock_remove_namespace(2);
+    
+    profile_.verify_async = nvmeof::benchmarking::VerifyPipeline::kMaxThreads + 1;
+    EXPECT_FALSE(profile_.IsValid());
+}
+
+// Test replaying a trace as fast as possible and at its recorded timing
+TEST_F(WorkloadGeneratorTest, GenerateReplay) {
+    auto trace_path = std::filesystem::temp_directory_path() / "workload_generator_replay.nvbt";
+    {
+        nvmeof::benchmarking::TraceWriter writer;
+        ASSERT_TRUE(writer.Open(trace_path.string()));
+        for (uint64_t i = 0; i < 200; ++i) {
+            // 200 ms of requests, addressed far beyond the 1 MiB range
+            nvmeof::benchmarking::TraceRecord record{};
+            record.timestamp_ns = 1000000000 + i * 1000000;
+            record.offset = (i * 7919 % 1000) * 1048576 + 3 * 512;
+            record.size = i % 4 == 0 ? 8192 : 4096;
+            record.is_write = i % 2;
+            ASSERT_TRUE(writer.Append(record));
+        }
+        ASSERT_TRUE(writer.Close());
+    }
+    
+    profile_.interval_us = 0;
+    profile_.queue_depth = 8;
+    profile_.trace_file = trace_path.string();
+    
+    nvmeof::benchmarking::WorkloadGenerator fast(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    ASSERT_TRUE(fast.Generate());
+    auto stats = fast.GetStats();
+    EXPECT_EQ(0u, stats.errors);
+    EXPECT_EQ(100u, stats.read_ops);
+    EXPECT_EQ(100u, stats.write_ops);
+    EXPECT_EQ(150u * 4096 + 50u * 8192, stats.read_bytes + stats.write_bytes);
+    ASSERT_EQ(2u, stats.size_buckets.size());
+    EXPECT_EQ(150u, stats.size_buckets[0].read_ops + stats.size_buckets[0].write_ops);
+    EXPECT_DOUBLE_EQ(1.0, fast.GetProgress());
+    
+    // Recorded timing at ten times the speed takes about 20 ms
+    profile_.replay_speed = 10.0;
+    nvmeof::benchmarking::WorkloadGenerator timed(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    ASSERT_TRUE(timed.Generate());
+    stats = timed.GetStats();
+    EXPECT_EQ(200u, stats.read_ops + stats.write_ops);
+    EXPECT_GE(stats.elapsed_seconds, 0.0199);
+    EXPECT_LT(stats.elapsed_seconds, 1.0);
+    
+    // A missing trace fails the run
+    profile_.trace_file = (std::filesystem::temp_directory_path() / "missing.nvbt").string();
+    nvmeof::benchmarking::WorkloadGenerator missing(
+        reinterpret_cast<const spdk_nvme_ctrlr*>(1), qpair_, profile_);
+    EXPECT_FALSE(missing.Generate());
+    
+    std::filesystem::remove(trace_path);
+}
+
 // Additional tests would be implemented for real hardware or with more sophisticated mocking
\ No newline at end of file
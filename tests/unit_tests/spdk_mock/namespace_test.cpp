@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../third_party/spdk_mock/include/nvme.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// Test fixture for the namespaces and backing stores of the SPDK mock
+class SpdkMockNamespaceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Namespace 1 may come from the environment; restore it afterwards
+        ASSERT_EQ(0, spdk_mock_get_namespace(1, &saved_ns1_));
+
+        ctrlr_ = reinterpret_cast<spdk_nvme_ctrlr*>(1);
+        qpair_ = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, nullptr, 0);
+        ASSERT_NE(nullptr, qpair_);
+
+        test_dir_ = std::filesystem::temp_directory_path() / "spdk_mock_namespace_test";
+        std::filesystem::create_directories(test_dir_);
+    }
+
+    void TearDown() override {
+        spdk_nvme_ctrlr_free_io_qpair(qpair_);
+        for (uint32_t ns_id = 2; ns_id <= SPDK_MOCK_MAX_NAMESPACES; ++ns_id) {
+            spdk_mock_remove_namespace(ns_id);
+        }
+        spdk_mock_set_namespace(1, &saved_ns1_);
+        std::filesystem::remove_all(test_dir_);
+    }
+
+    static void OnCompletion(void* cb_arg, const spdk_nvme_cpl* cpl) {
+        auto* statuses = static_cast<std::vector<int>*>(cb_arg);
+        statuses->push_back(spdk_nvme_cpl_is_error(cpl) ? cpl->status.sc : 0);
+    }
+
+    // Submit a command and poll until it completes; returns its status code
+    int Execute(bool is_write, spdk_nvme_ns* ns, void* buffer, uint64_t lba, uint32_t lba_count) {
+        std::vector<int> statuses;
+        int rc = is_write
+            ? spdk_nvme_ns_cmd_write(ns, qpair_, buffer, lba, lba_count,
+                                     &SpdkMockNamespaceTest::OnCompletion, &statuses, 0)
+            : spdk_nvme_ns_cmd_read(ns, qpair_, buffer, lba, lba_count,
+                                    &SpdkMockNamespaceTest::OnCompletion, &statuses, 0);
+        if (rc != 0) {
+            return rc;
+        }
+        while (statuses.empty()) {
+            spdk_nvme_qpair_process_completions(qpair_, 0);
+        }
+        return statuses[0];
+    }
+
+    // Fill a buffer with bytes derived from a seed
+    static std::vector<uint8_t> MakeData(size_t size, uint8_t seed) {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(seed + i * 7);
+        }
+        return data;
+    }
+
+    spdk_mock_ns_config saved_ns1_{};
+    spdk_nvme_ctrlr* ctrlr_ = nullptr;
+    spdk_nvme_qpair* qpair_ = nullptr;
+    std::filesystem::path test_dir_;
+};
+
+// Test the default namespace and namespace lookup
+TEST_F(SpdkMockNamespaceTest, DefaultNamespace) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_set_namespace(1, &config));
+
+    spdk_nvme_ns* ns = spdk_nvme_ctrlr_get_ns(ctrlr_, 1);
+    ASSERT_NE(nullptr, ns);
+    EXPECT_EQ(1u, spdk_nvme_ns_get_id(ns));
+    EXPECT_EQ(4096u, spdk_nvme_ns_get_sector_size(ns));
+    EXPECT_EQ(1ULL << 40, spdk_nvme_ns_get_size(ns));
+    EXPECT_EQ(1u, spdk_nvme_ctrlr_get_num_ns(ctrlr_));
+    EXPECT_FALSE(spdk_nvme_ctrlr_is_active_ns(ctrlr_, 2));
+    EXPECT_EQ(nullptr, spdk_nvme_ctrlr_get_ns(ctrlr_, 0));
+    EXPECT_EQ(nullptr, spdk_nvme_ctrlr_get_ns(ctrlr_, SPDK_MOCK_MAX_NAMESPACES + 1));
+
+    // The pattern store fills reads with the low byte of the LBA
+    std::vector<uint8_t> buffer(4096, 0);
+    EXPECT_EQ(0, Execute(false, ns, buffer.data(), 0x1234, 1));
+    EXPECT_EQ(0x34, buffer[0]);
+    EXPECT_EQ(0x34, buffer[4095]);
+}
+
+// Test parsing of namespace descriptions
+TEST_F(SpdkMockNamespaceTest, ParseNamespaceConfig) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_ns_config(
+        "backing=memory, size_mib=16 ,sector_size=512", &config));
+    EXPECT_EQ(SPDK_MOCK_NS_BACKING_MEMORY, config.backing);
+    EXPECT_EQ(512u, config.sector_size);
+    EXPECT_EQ(16u * 2048, config.num_sectors);
+
+    ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=file,path=/dev/ram0,direct_io=1,num_sectors=8",
+                                           &config));
+    EXPECT_EQ(SPDK_MOCK_NS_BACKING_FILE, config.backing);
+    EXPECT_STREQ("/dev/ram0", config.path);
+    EXPECT_TRUE(config.direct_io);
+    EXPECT_EQ(8u, config.num_sectors);
+
+    // Invalid input leaves the configuration untouched
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_ns_config("backing=tape", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_ns_config("sector_size=-512", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_ns_config("direct_io=2", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_ns_config("colour=blue", &config));
+    EXPECT_EQ(SPDK_MOCK_NS_BACKING_FILE, config.backing);
+
+    // Sector sizes must be powers of two from 512 to 64 KiB
+    config.backing = SPDK_MOCK_NS_BACKING_MEMORY;
+    config.sector_size = 520;
+    EXPECT_EQ(-EINVAL, spdk_mock_set_namespace(2, &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_set_namespace(0, &config));
+}
+
+// Test that a memory namespace reads back what was written
+TEST_F(SpdkMockNamespaceTest, MemoryBackingPersistsData) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_ns_config("backing=memory,size_mib=8,sector_size=512", &config));
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+    EXPECT_EQ(2u, spdk_nvme_ctrlr_get_num_ns(ctrlr_));
+
+    spdk_nvme_ns* ns = spdk_nvme_ctrlr_get_ns(ctrlr_, 2);
+    ASSERT_NE(nullptr, ns);
+    EXPECT_EQ(512u, spdk_nvme_ns_get_sector_size(ns));
+    EXPECT_EQ(8u << 20, spdk_nvme_ns_get_size(ns));
+
+    // Write 16 sectors straddling the first 1 MiB chunk boundary
+    uint64_t lba = (1u << 20) / 512 - 8;
+    auto data = MakeData(16 * 512, 3);
+    ASSERT_EQ(0, Execute(true, ns, data.data(), lba, 16));
+
+    std::vector<uint8_t> buffer(16 * 512, 0xFF);
+    ASSERT_EQ(0, Execute(false, ns, buffer.data(), lba, 16));
+    EXPECT_EQ(data, buffer);
+
+    // Unwritten sectors read as zeros
+    ASSERT_EQ(0, Execute(false, ns, buffer.data(), 0, 16));
+    EXPECT_EQ(std::vector<uint8_t>(16 * 512, 0), buffer);
+
+    // Namespace 1 is unaffected
+    ASSERT_EQ(0, Execute(false, spdk_nvme_ctrlr_get_ns(ctrlr_, 1), buffer.data(), 2, 1));
+    EXPECT_EQ(2, buffer[0]);
+}
+
+// Test that a file namespace persists data across reattachment
+TEST_F(SpdkMockNamespaceTest, FileBackingPersistsData) {
+    auto path = test_dir_ / "ns.img";
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    config.backing = SPDK_MOCK_NS_BACKING_FILE;
+    config.num_sectors = 256;
+    std::strncpy(config.path, path.c_str(), sizeof(config.path) - 1);
+    ASSERT_EQ(0, spdk_mock_set_namespace(3, &config));
+    EXPECT_EQ(256u * 4096, std::filesystem::file_size(path));
+
+    spdk_nvme_ns* ns = spdk_nvme_ctrlr_get_ns(ctrlr_, 3);
+    ASSERT_NE(nullptr, ns);
+    auto data = MakeData(2 * 4096, 11);
+    ASSERT_EQ(0, Execute(true, ns, data.data(), 100, 2));
+
+    // Reattach, taking the capacity from the file
+    config.num_sectors = 0;
+    ASSERT_EQ(0, spdk_mock_set_namespace(3, &config));
+    EXPECT_EQ(256u, spdk_nvme_ns_get_num_sectors(ns));
+
+    std::vector<uint8_t> buffer(2 * 4096, 0);
+    ASSERT_EQ(0, Execute(false, ns, buffer.data(), 100, 2));
+    EXPECT_EQ(data, buffer);
+}
+
+// Test O_DIRECT access with an unaligned buffer
+TEST_F(SpdkMockNamespaceTest, DirectIo) {
+    auto path = test_dir_ / "direct.img";
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    config.backing = SPDK_MOCK_NS_BACKING_FILE;
+    config.num_sectors = 16;
+    config.direct_io = true;
+    std::strncpy(config.path, path.c_str(), sizeof(config.path) - 1);
+    if (spdk_mock_set_namespace(2, &config) != 0) {
+        GTEST_SKIP() << "O_DIRECT is not supported in " << test_dir_;
+    }
+
+    spdk_nvme_ns* ns = spdk_nvme_ctrlr_get_ns(ctrlr_, 2);
+    ASSERT_NE(nullptr, ns);
+    std::vector<uint8_t> storage(4096 + 1);
+    uint8_t* unaligned = storage.data() + 1;
+    auto data = MakeData(4096, 5);
+    std::memcpy(unaligned, data.data(), data.size());
+    ASSERT_EQ(0, Execute(true, ns, unaligned, 3, 1));
+
+    std::memset(unaligned, 0, 4096);
+    ASSERT_EQ(0, Execute(false, ns, unaligned, 3, 1));
+    EXPECT_EQ(0, std::memcmp(data.data(), unaligned, data.size()));
+}
+
+// Test that commands outside the namespace complete with an error
+TEST_F(SpdkMockNamespaceTest, OutOfRangeAndMissingNamespace) {
+    spdk_mock_ns_config config;
+    spdk_mock_get_default_ns_config(&config);
+    config.backing = SPDK_MOCK_NS_BACKING_MEMORY;
+    config.num_sectors = 16;
+    ASSERT_EQ(0, spdk_mock_set_namespace(2, &config));
+    spdk_nvme_ns* ns = spdk_nvme_ctrlr_get_ns(ctrlr_, 2);
+    ASSERT_NE(nullptr, ns);
+
+    std::vector<uint8_t> buffer(2 * 4096, 0);
+    EXPECT_EQ(0, Execute(true, ns, buffer.data(), 14, 2));
+    EXPECT_EQ(SPDK_NVME_SC_LBA_OUT_OF_RANGE, Execute(true, ns, buffer.data(), 15, 2));
+    EXPECT_EQ(SPDK_NVME_SC_LBA_OUT_OF_RANGE, Execute(false, ns, buffer.data(), UINT64_MAX, 2));
+
+    // A detached namespace keeps its pointer but rejects commands
+    EXPECT_EQ(0, spdk_mock_remove_namespace(2));
+    EXPECT_EQ(-ENOENT, spdk_mock_remove_namespace(2));
+    EXPECT_EQ(nullptr, spdk_nvme_ctrlr_get_ns(ctrlr_, 2));
+    EXPECT_EQ(SPDK_NVME_SC_INVALID_NAMESPACE_OR_FORMAT, Execute(false, ns, buffer.data(), 0, 1));
+}
@@ -0,0 +1,362 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../third_party/spdk_mock/include/nvme.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Test fixture for the deferred-completion queue pair of the SPDK mock
+class SpdkMockTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        saved_service_time_ns_ = spdk_mock_get_service_time_ns();
+        spdk_mock_set_service_time_ns(0);
+        spdk_mock_get_device_config(&saved_device_config_);
+        spdk_mock_device_config ideal;
+        spdk_mock_get_default_device_config(&ideal);
+        spdk_mock_set_device_config(&ideal);
+
+        ctrlr_ = reinterpret_cast<spdk_nvme_ctrlr*>(1);
+        ns_ = spdk_nvme_ctrlr_get_ns(ctrlr_, 1);
+
+        spdk_nvme_io_qpair_opts opts;
+        spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr_, &opts, sizeof(opts));
+        opts.io_queue_requests = kQueueSize;
+        qpair_ = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, &opts, sizeof(opts));
+        ASSERT_NE(nullptr, qpair_);
+
+        buffer_.assign(4096, 0);
+    }
+
+    void TearDown() override {
+        spdk_nvme_ctrlr_free_io_qpair(qpair_);
+        spdk_mock_set_service_time_ns(saved_service_time_ns_);
+        spdk_mock_set_device_config(&saved_device_config_);
+    }
+
+    static void OnCompletion(void* cb_arg, const spdk_nvme_cpl* cpl) {
+        auto* completions = static_cast<std::vector<int>*>(cb_arg);
+        completions->push_back(spdk_nvme_cpl_is_error(cpl) ? -1 : 1);
+    }
+
+    int SubmitRead() {
+        return spdk_nvme_ns_cmd_read(ns_, qpair_, buffer_.data(), 7, 1,
+                                     &SpdkMockTest::OnCompletion, &completions_, 0);
+    }
+
+    // Poll until the given number of commands have completed; returns seconds waited,
+    // which falls short of the modeled latency by the time spent submitting
+    double WaitForCompletions(size_t count) {
+        auto start = std::chrono::steady_clock::now();
+        while (completions_.size() < count) {
+            if (spdk_nvme_qpair_process_completions(qpair_, 0) < 0) {
+                break;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    static constexpr uint32_t kQueueSize = 4;
+
+    uint64_t saved_service_time_ns_ = 0;
+    spdk_mock_device_config saved_device_config_{};
+    spdk_nvme_ctrlr* ctrlr_ = nullptr;
+    spdk_nvme_ns* ns_ = nullptr;
+    spdk_nvme_qpair* qpair_ = nullptr;
+    std::vector<uint8_t> buffer_;
+    std::vector<int> completions_;
+};
+
+// Test that commands complete only when the queue pair is polled
+TEST_F(SpdkMockTest, CompletionsAreDeferred) {
+    ASSERT_EQ(0, SubmitRead());
+    EXPECT_TRUE(completions_.empty());
+    EXPECT_EQ(1u, spdk_mock_qpair_get_num_outstanding(qpair_));
+    EXPECT_EQ(7, buffer_[0]);
+
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 0));
+    ASSERT_EQ(1u, completions_.size());
+    EXPECT_EQ(1, completions_[0]);
+    EXPECT_EQ(0u, spdk_mock_qpair_get_num_outstanding(qpair_));
+    EXPECT_EQ(0, spdk_nvme_qpair_process_completions(qpair_, 0));
+}
+
+// Test that a full queue pair rejects submissions with -ENOMEM
+TEST_F(SpdkMockTest, FullQueueReturnsEnomem) {
+    for (uint32_t i = 0; i < kQueueSize; ++i) {
+        ASSERT_EQ(0, SubmitRead());
+    }
+    EXPECT_EQ(-ENOMEM, SubmitRead());
+    EXPECT_EQ(-ENOMEM, spdk_nvme_ns_cmd_write(ns_, qpair_, buffer_.data(), 0, 1,
+                                              &SpdkMockTest::OnCompletion, &completions_, 0));
+
+    // Reaping one command frees one slot, and the ring wraps around
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 1));
+    EXPECT_EQ(0, SubmitRead());
+    EXPECT_EQ(static_cast<int32_t>(kQueueSize), spdk_nvme_qpair_process_completions(qpair_, 0));
+    EXPECT_EQ(kQueueSize + 1, completions_.size());
+}
+
+// Test that max_completions bounds the number of callbacks per poll
+TEST_F(SpdkMockTest, MaxCompletionsIsHonoured) {
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(0, SubmitRead());
+    }
+    EXPECT_EQ(2, spdk_nvme_qpair_process_completions(qpair_, 2));
+    EXPECT_EQ(2u, completions_.size());
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 2));
+    EXPECT_EQ(3u, completions_.size());
+}
+
+// Test that delayed submission rings one doorbell per poll and starts commands then
+TEST_F(SpdkMockTest, DelayedDoorbell) {
+    spdk_mock_qpair_stats stats;
+    for (uint32_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(0, SubmitRead());
+    }
+    ASSERT_EQ(0, spdk_mock_qpair_get_stats(qpair_, &stats));
+    EXPECT_EQ(3u, stats.submissions);
+    EXPECT_EQ(3u, stats.sq_doorbells);
+    EXPECT_EQ(3, spdk_nvme_qpair_process_completions(qpair_, 0));
+    ASSERT_EQ(0, spdk_mock_qpair_get_stats(qpair_, &stats));
+    EXPECT_EQ(3u, stats.completions);
+    EXPECT_EQ(1u, stats.cq_doorbells);
+    EXPECT_EQ(-EINVAL, spdk_mock_qpair_get_stats(qpair_, nullptr));
+
+    spdk_nvme_io_qpair_opts opts;
+    spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr_, &opts, sizeof(opts));
+    EXPECT_FALSE(opts.delay_cmd_submit);
+    opts.io_queue_requests = kQueueSize;
+    opts.delay_cmd_submit = true;
+    spdk_nvme_qpair* delayed = spdk_nvme_ctrlr_alloc_io_qpair(ctrlr_, &opts, sizeof(opts));
+    ASSERT_NE(nullptr, delayed);
+
+    // Held commands count against the queue
+    for (uint32_t i = 0; i < kQueueSize; ++i) {
+        ASSERT_EQ(0, spdk_nvme_ns_cmd_read(ns_, delayed, buffer_.data(), 7, 1,
+                                           &SpdkMockTest::OnCompletion, &completions_, 0));
+    }
+    EXPECT_EQ(-ENOMEM, spdk_nvme_ns_cmd_read(ns_, delayed, buffer_.data(), 7, 1,
+                                             &SpdkMockTest::OnCompletion, &completions_, 0));
+    EXPECT_EQ(kQueueSize, spdk_mock_qpair_get_num_outstanding(delayed));
+    ASSERT_EQ(0, spdk_mock_qpair_get_stats(delayed, &stats));
+    EXPECT_EQ(0u, stats.sq_doorbells);
+
+    // One poll rings the doorbell for all of them and reaps them
+    EXPECT_EQ(static_cast<int32_t>(kQueueSize), spdk_nvme_qpair_process_completions(delayed, 0));
+    ASSERT_EQ(0, spdk_mock_qpair_get_stats(delayed, &stats));
+    EXPECT_EQ(kQueueSize, stats.submissions);
+    EXPECT_EQ(1u, stats.sq_doorbells);
+    EXPECT_EQ(1u, stats.cq_doorbells);
+    EXPECT_EQ(0u, spdk_mock_qpair_get_num_outstanding(delayed));
+    spdk_nvme_ctrlr_free_io_qpair(delayed);
+}
+
+// Test that commands are held for the configured service time
+TEST_F(SpdkMockTest, ServiceTime) {
+    spdk_mock_set_service_time_ns(20 * 1000 * 1000);  // 20 ms
+    EXPECT_EQ(20000000u, spdk_mock_get_service_time_ns());
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(0, SubmitRead());
+    EXPECT_EQ(0, spdk_nvme_qpair_process_completions(qpair_, 0));
+
+    while (completions_.empty()) {
+        ASSERT_GE(spdk_nvme_qpair_process_completions(qpair_, 0), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed.count(), 0.02);
+}
+
+// Test that commands submitted from a callback wait for the next poll
+TEST_F(SpdkMockTest, ResubmitFromCallback) {
+    struct Context {
+        spdk_nvme_ns* ns;
+        spdk_nvme_qpair* qpair;
+        void* buffer;
+        int remaining;
+    } context{ns_, qpair_, buffer_.data(), 3};
+
+    auto callback = [](void* cb_arg, const spdk_nvme_cpl*) {
+        auto* ctx = static_cast<Context*>(cb_arg);
+        if (--ctx->remaining > 0) {
+            spdk_nvme_ns_cmd_write(ctx->ns, ctx->qpair, ctx->buffer, 0, 1,
+                                   [](void*, const spdk_nvme_cpl*) {}, nullptr, 0);
+        }
+    };
+
+    ASSERT_EQ(0, spdk_nvme_ns_cmd_read(ns_, qpair_, buffer_.data(), 0, 1, callback, &context, 0));
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 0));
+    EXPECT_EQ(1u, spdk_mock_qpair_get_num_outstanding(qpair_));
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 0));
+}
+
+// Test transport ID parsing and controller connection
+TEST_F(SpdkMockTest, ConnectWithTransportId) {
+    spdk_nvme_transport_id trid;
+    ASSERT_EQ(0, spdk_nvme_transport_id_parse(
+        &trid, "trtype:tcp  traddr:192.168.1.10 trsvcid:4420 subnqn:nqn.2016-06.io.spdk:cnode1"));
+    EXPECT_EQ(SPDK_NVME_TRANSPORT_TCP, trid.trtype);
+    EXPECT_STREQ("192.168.1.10", trid.traddr);
+    EXPECT_STREQ("4420", trid.trsvcid);
+    EXPECT_STREQ("nqn.2016-06.io.spdk:cnode1", trid.subnqn);
+
+    EXPECT_EQ(-EINVAL, spdk_nvme_transport_id_parse(&trid, "trtype:carrier-pigeon"));
+    EXPECT_EQ(-EINVAL, spdk_nvme_transport_id_parse(&trid, "traddr"));
+
+    spdk_nvme_ctrlr* ctrlr = spdk_nvme_connect(&trid, nullptr, 0);
+    ASSERT_NE(nullptr, ctrlr);
+    EXPECT_EQ(0, spdk_nvme_detach(ctrlr));
+}
+
+// Test parsing of the key=value device description
+TEST_F(SpdkMockTest, ParseDeviceConfig) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    ASSERT_EQ(0, spdk_mock_parse_device_config(
+        "# NVMe/TCP, 8 dies\n"
+        "channels = 8\n"
+        "read_latency_us=80, write_latency_us=20.5; fabric_rtt_us=25\n"
+        "read_us_per_kib=0.25 # per KiB, after the base latency\n"
+        "gc_threshold_mib=1,gc_reclaim_mbps=500,gc_stall_us=1000\n",
+        &config));
+    EXPECT_EQ(8u, config.channels);
+    EXPECT_EQ(80000u, config.read_latency_ns);
+    EXPECT_EQ(20500u, config.write_latency_ns);
+    EXPECT_EQ(250u, config.read_ns_per_kib);
+    EXPECT_EQ(0u, config.write_ns_per_kib);
+    EXPECT_EQ(25000u, config.fabric_rtt_ns);
+    EXPECT_EQ(1048576u, config.gc_threshold_bytes);
+    EXPECT_EQ(500000000u, config.gc_reclaim_bytes_per_sec);
+    EXPECT_EQ(1000000u, config.gc_stall_ns);
+
+    // Invalid input leaves the configuration untouched
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_device_config("channels=4,bogus_key=1", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_device_config("read_latency_us=-1", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_device_config("channels=2.5", &config));
+    EXPECT_EQ(-EINVAL, spdk_mock_parse_device_config("channels", &config));
+    EXPECT_EQ(8u, config.channels);
+}
+
+// Test loading the device description from a file
+TEST_F(SpdkMockTest, LoadDeviceConfig) {
+    auto path = std::filesystem::temp_directory_path() / "spdk_mock_device_test.conf";
+    {
+        std::ofstream file(path);
+        file << "channels=2\nwrite_latency_us=15\n";
+    }
+
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    EXPECT_EQ(0, spdk_mock_load_device_config(path.c_str(), &config));
+    EXPECT_EQ(2u, config.channels);
+    EXPECT_EQ(15000u, config.write_latency_ns);
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(-ENOENT, spdk_mock_load_device_config(path.c_str(), &config));
+}
+
+// Test that reads and writes pay their own latency
+TEST_F(SpdkMockTest, ReadWriteAsymmetry) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    config.read_latency_ns = 2 * 1000 * 1000;    // 2 ms
+    config.write_latency_ns = 20 * 1000 * 1000;  // 20 ms
+    ASSERT_EQ(0, spdk_mock_set_device_config(&config));
+
+    ASSERT_EQ(0, SubmitRead());
+    EXPECT_GE(WaitForCompletions(1), 0.0019);
+
+    ASSERT_EQ(0, spdk_nvme_ns_cmd_write(ns_, qpair_, buffer_.data(), 0, 1,
+                                        &SpdkMockTest::OnCompletion, &completions_, 0));
+    EXPECT_GE(WaitForCompletions(2), 0.019);
+
+    spdk_mock_device_stats stats;
+    spdk_mock_get_device_stats(&stats);
+    EXPECT_EQ(1u, stats.reads);
+    EXPECT_EQ(1u, stats.writes);
+    EXPECT_EQ(4096u, stats.write_bytes);
+}
+
+// Test that a slow command does not hold back faster ones behind it
+TEST_F(SpdkMockTest, OutOfOrderCompletion) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    config.write_latency_ns = 50 * 1000 * 1000;  // 50 ms
+    ASSERT_EQ(0, spdk_mock_set_device_config(&config));
+
+    std::vector<int> writes;
+    ASSERT_EQ(0, spdk_nvme_ns_cmd_write(ns_, qpair_, buffer_.data(), 0, 1,
+                                        &SpdkMockTest::OnCompletion, &writes, 0));
+    ASSERT_EQ(0, SubmitRead());
+    EXPECT_EQ(1, spdk_nvme_qpair_process_completions(qpair_, 0));
+    EXPECT_EQ(1u, completions_.size());
+    EXPECT_TRUE(writes.empty());
+    EXPECT_EQ(1u, spdk_mock_qpair_get_num_outstanding(qpair_));
+}
+
+// Test that a bounded number of channels serializes excess commands
+TEST_F(SpdkMockTest, ChannelSaturation) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    config.channels = 1;
+    config.read_latency_ns = 5 * 1000 * 1000;  // 5 ms
+    ASSERT_EQ(0, spdk_mock_set_device_config(&config));
+
+    for (uint32_t i = 0; i < kQueueSize; ++i) {
+        ASSERT_EQ(0, SubmitRead());
+    }
+    EXPECT_GE(WaitForCompletions(kQueueSize), 0.019);
+
+    // The second to fourth commands queued for 5, 10 and 15 ms
+    spdk_mock_device_stats stats;
+    spdk_mock_get_device_stats(&stats);
+    EXPECT_GE(stats.queued_ns, 29u * 1000 * 1000);
+}
+
+// Test that the fabric round trip adds latency without using channels
+TEST_F(SpdkMockTest, FabricRoundTrip) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    config.channels = 1;
+    config.fabric_rtt_ns = 10 * 1000 * 1000;  // 10 ms
+    ASSERT_EQ(0, spdk_mock_set_device_config(&config));
+
+    for (uint32_t i = 0; i < kQueueSize; ++i) {
+        ASSERT_EQ(0, SubmitRead());
+    }
+    double elapsed = WaitForCompletions(kQueueSize);
+    EXPECT_GE(elapsed, 0.0095);
+
+    spdk_mock_device_stats stats;
+    spdk_mock_get_device_stats(&stats);
+    EXPECT_EQ(0u, stats.queued_ns);
+}
+
+// Test that sustained writes beyond the reclaim rate trigger GC stalls
+TEST_F(SpdkMockTest, GarbageCollectionStalls) {
+    spdk_mock_device_config config;
+    spdk_mock_get_default_device_config(&config);
+    config.gc_threshold_bytes = 16 * 1024;
+    config.gc_reclaim_bytes_per_sec = 1024;  // Effectively no reclaim during the test
+    config.gc_stall_ns = 1000;
+    ASSERT_EQ(0, spdk_mock_set_device_config(&config));
+
+    // Each write is 4 KiB; the fifth one pushes the backlog over 16 KiB
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(0, spdk_nvme_ns_cmd_write(ns_, qpair_, buffer_.data(), 0, 1,
+                                            &SpdkMockTest::OnCompletion, &completions_, 0));
+        WaitForCompletions(static_cast<size_t>(i + 1));
+    }
+
+    spdk_mock_device_stats stats;
+    spdk_mock_get_device_stats(&stats);
+    EXPECT_EQ(8u, stats.writes);
+    EXPECT_EQ(4u, stats.gc_stalls);
+}
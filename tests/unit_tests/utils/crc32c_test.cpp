@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "../../../include/utils/crc32c.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace nvmeof::utils;
+
+// Test the standard check values of CRC-32C
+TEST(Crc32cTest, KnownValues) {
+    const char* check = "123456789";
+    EXPECT_EQ(0xE3069283u, Crc32c::Compute(check, 9));
+    EXPECT_EQ(0xE3069283u, Crc32c::ComputeSoftware(check, 9));
+
+    // RFC 3720 (iSCSI) test vectors: 32 bytes of zeros and of ones
+    std::vector<uint8_t> data(32, 0);
+    EXPECT_EQ(0x8A9136AAu, Crc32c::Compute(data.data(), data.size()));
+    std::memset(data.data(), 0xFF, data.size());
+    EXPECT_EQ(0x62A8AB43u, Crc32c::Compute(data.data(), data.size()));
+
+    EXPECT_EQ(0u, Crc32c::Compute(nullptr, 0));
+}
+
+// Test that both implementations agree on every length and alignment,
+// including lengths that use the interleaved streams
+TEST(Crc32cTest, HardwareMatchesSoftware) {
+    std::vector<uint8_t> data(3 * 8192 * 2 + 1024);
+    std::mt19937 rng(42);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    for (size_t size : {size_t{1}, size_t{7}, size_t{64}, size_t{511}, size_t{768},
+                        size_t{4064}, size_t{4096}, size_t{3 * 8192}, size_t{3 * 8192 * 2 + 1000}}) {
+        for (size_t offset = 0; offset < 8; ++offset) {
+            EXPECT_EQ(Crc32c::ComputeSoftware(data.data() + offset, size),
+                      Crc32c::Compute(data.data() + offset, size))
+                << "size " << size << ", offset " << offset;
+        }
+    }
+}
+
+// Test that a checksum can be extended piece by piece
+TEST(Crc32cTest, Incremental) {
+    std::vector<uint8_t> data(10000);
+    std::mt19937 rng(7);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    uint32_t whole = Crc32c::Compute(data.data(), data.size());
+    uint32_t crc = Crc32c::Compute(data.data(), 3333);
+    crc = Crc32c::Compute(data.data() + 3333, data.size() - 3333, crc);
+    EXPECT_EQ(whole, crc);
+
+    crc = Crc32c::ComputeSoftware(data.data(), 17);
+    crc = Crc32c::ComputeSoftware(data.data() + 17, data.size() - 17, crc);
+    EXPECT_EQ(whole, crc);
+}
+
+// Test that strided checksums match one checksum per buffer, for every count around the stream width
+TEST(Crc32cTest, Strided) {
+    std::vector<uint8_t> data(8 * 512);
+    std::mt19937 rng(11);
+    for (auto& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    for (size_t size : {size_t{5}, size_t{480}, size_t{509}}) {
+        for (size_t count = 0; count <= 7; ++count) {
+            std::vector<uint32_t> crcs(count);
+            Crc32c::ComputeStrided(data.data() + 3, size, 512, count, crcs.data());
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(Crc32c::ComputeSoftware(data.data() + 3 + i * 512, size), crcs[i])
+                    << "size " << size << ", buffer " << i << " of " << count;
+            }
+        }
+    }
+}
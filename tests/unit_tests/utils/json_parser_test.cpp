@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/utils/json_parser.h"
+#include <stdexcept>
+
+using namespace nvmeof::utils;
+
+// Test parsing of scalar values
+TEST(JsonParserTest, Scalars) {
+    EXPECT_TRUE(JsonValue::Parse("null").IsNull());
+    EXPECT_TRUE(JsonValue::Parse(" true ").AsBool());
+    EXPECT_FALSE(JsonValue::Parse("false").AsBool());
+    EXPECT_EQ("a\"b\\/\n", JsonValue::Parse("\"a\\\"b\\\\\\/\\n\"").AsString());
+    EXPECT_DOUBLE_EQ(-1.5e3, JsonValue::Parse("-1.5e3").AsDouble());
+    EXPECT_DOUBLE_EQ(-7.0, JsonValue::Parse("-7").AsDouble());
+}
+
+// Test that 64-bit integers are held exactly
+TEST(JsonParserTest, Integers) {
+    EXPECT_EQ(18446744073709551615ULL, JsonValue::Parse("18446744073709551615").AsUint64());
+    EXPECT_EQ(1000000u, JsonValue::Parse("1e6").AsUint64());
+    EXPECT_THROW(JsonValue::Parse("-1").AsUint64(), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("1.5").AsUint64(), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("\"1\"").AsUint64(), std::runtime_error);
+}
+
+// Test unicode escapes, including surrogate pairs
+TEST(JsonParserTest, UnicodeEscapes) {
+    EXPECT_EQ("\xC2\xB5s", JsonValue::Parse("\"\\u00b5s\"").AsString());
+    EXPECT_EQ("\xF0\x9F\x98\x80", JsonValue::Parse("\"\\ud83d\\ude00\"").AsString());
+    EXPECT_THROW(JsonValue::Parse("\"\\ud83d\""), std::runtime_error);
+}
+
+// Test arrays and objects, which keep document order
+TEST(JsonParserTest, Containers) {
+    JsonValue value = JsonValue::Parse(
+        "{\"b\": [1, 2, {\"c\": null}], \"a\": {}, \"d\": []}");
+
+    ASSERT_TRUE(value.IsObject());
+    ASSERT_EQ(3u, value.Size());
+    EXPECT_EQ("b", value.KeyAt(0));
+    EXPECT_EQ("a", value.KeyAt(1));
+    EXPECT_TRUE(value.ValueAt(1).IsObject());
+
+    const JsonValue* b = value.Find("b");
+    ASSERT_NE(nullptr, b);
+    ASSERT_TRUE(b->IsArray());
+    ASSERT_EQ(3u, b->Size());
+    EXPECT_EQ(2u, (*b)[1].AsUint64());
+    EXPECT_TRUE((*b)[2].Find("c")->IsNull());
+    EXPECT_EQ(0u, value.Find("d")->Size());
+
+    EXPECT_EQ(nullptr, value.Find("missing"));
+    EXPECT_EQ(nullptr, (*b)[0].Find("b"));
+    EXPECT_THROW((*b)[3], std::out_of_range);
+    EXPECT_THROW(value[0], std::runtime_error);
+}
+
+// Test that malformed documents are rejected with their position
+TEST(JsonParserTest, Errors) {
+    EXPECT_THROW(JsonValue::Parse(""), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("{\"a\": 1,}"), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("[1 2]"), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("01"), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("1."), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("\"tab\there\""), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("tru"), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse("{} {}"), std::runtime_error);
+    EXPECT_THROW(JsonValue::Parse(std::string(1000, '[')), std::runtime_error);
+
+    try {
+        JsonValue::Parse("{\n  \"a\": ?\n}");
+        FAIL() << "Expected a parse error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("line 2, column 8"));
+    }
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../include/utils/tsc_clock.h"
+#include <chrono>
+#include <thread>
+
+using namespace nvmeof::utils;
+
+// Test that the clock never goes backwards
+TEST(TscClockTest, Monotonic) {
+    uint64_t previous = TscClock::NowNs();
+    for (int i = 0; i < 10000; ++i) {
+        uint64_t now = TscClock::NowNs();
+        EXPECT_GE(now, previous);
+        previous = now;
+    }
+}
+
+// Test that the calibrated clock agrees with steady_clock
+TEST(TscClockTest, MatchesSteadyClock) {
+    // The first call calibrates the clock; keep that out of the measurement
+    TscClock::NowNs();
+
+    auto steady_start = std::chrono::steady_clock::now();
+    uint64_t start = TscClock::NowNs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    uint64_t end = TscClock::NowNs();
+    auto steady_end = std::chrono::steady_clock::now();
+
+    double steady_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(steady_end - steady_start).count());
+    double tsc_ns = static_cast<double>(end - start);
+
+    EXPECT_GT(TscClock::GetTicksPerSecond(), 0.0);
+    EXPECT_NEAR(steady_ns, tsc_ns, steady_ns * 0.02);
+}
+
+// Test the tick to nanosecond conversion
+TEST(TscClockTest, TicksToNs) {
+    uint64_t one_second = static_cast<uint64_t>(TscClock::GetTicksPerSecond());
+    EXPECT_NEAR(1e9, static_cast<double>(TscClock::TicksToNs(one_second)), 1e3);
+
+    if (!TscClock::IsTscEnabled()) {
+        EXPECT_EQ(1234u, TscClock::TicksToNs(1234));
+    }
+}
@@ -28,22 +28,107 @@
      /* Minimal set of fields needed */
  };
  
+ /**
+  * @brief NVMe transport types
+  */
+ enum spdk_nvme_transport_type {
+     SPDK_NVME_TRANSPORT_PCIE = 256,
+     SPDK_NVME_TRANSPORT_RDMA = 1,
+     SPDK_NVME_TRANSPORT_FC = 2,
+     SPDK_NVME_TRANSPORT_TCP = 3
+ };
+ 
+ #define SPDK_NVMF_TRADDR_MAX_LEN 256
+ #define SPDK_NVMF_TRSVCID_MAX_LEN 32
+ #define SPDK_NVMF_NQN_MAX_LEN 223
+ 
+ /**
+  * @brief Mock NVMe transport identifier
+  */
+ struct spdk_nvme_transport_id {
+     enum spdk_nvme_transport_type trtype;
+     char traddr[SPDK_NVMF_TRADDR_MAX_LEN + 1];
+     char trsvcid[SPDK_NVMF_TRSVCID_MAX_LEN + 1];
+     char subnqn[SPDK_NVMF_NQN_MAX_LEN + 1];
+ };
+ 
+ /**
+  * @brief Mock NVMe controller options (opaque; the mock uses defaults)
+  */
+ struct spdk_nvme_ctrlr_opts;
+ 
+ /**
+  * @brief Outstanding command on a mock queue pair (defined in nvme.c)
+  */
+ struct spdk_mock_request;
+ 
  /**
   * @brief Mock NVMe queue pair structure
+  * 
+  * Submitted commands wait on the queue pair until the device model says they
+  * are done, and complete in order of completion time when
+  * spdk_nvme_qpair_process_completions() is called. With delay_cmd_submit,
+  * new commands are held until the next call rings the doorbell and only then
+  * reach the device model.
   */
  struct spdk_nvme_qpair {
      uint32_t id;
      void* userdata;
-     /* Minimal set of fields needed */
+     struct spdk_mock_request* requests;  /* Slots for outstanding commands */
+     uint32_t* heap;                      /* Busy slots ordered by completion time */
+     uint32_t* free_slots;                /* Stack of idle slots */
+     uint32_t queue_size;                 /* Number of slots (io_queue_requests) */
+     uint32_t num_outstanding;            /* Number of commands at the device (heap entries) */
+     uint64_t next_seq;                   /* Submission number of the next command */
+     bool delay_cmd_submit;               /* Hold new commands until the next poll */
+     uint32_t* unrung;                    /* Slots of held commands, in submission order */
+     uint32_t num_unrung;                 /* Number of held commands */
+     uint64_t submissions;                /* Commands submitted */
+     uint64_t sq_doorbells;               /* Submission queue doorbell writes */
+     uint64_t completions;                /* Commands completed */
+     uint64_t cq_doorbells;               /* Completion queue doorbell writes */
+ };
+ 
+ /**
+  * @brief Mock I/O queue pair creation options
+  */
+ struct spdk_nvme_io_qpair_opts {
+     uint32_t io_queue_size;      /* Number of submission queue entries */
+     uint32_t io_queue_requests;  /* Number of requests that can be outstanding */
+     bool delay_cmd_submit;       /* Ring the submission doorbell once per poll instead of per command */
  };
  
+ /**
+  * @brief Backing store of a mock namespace (defined in namespace.c)
+  */
+ struct spdk_mock_ns_store;
+ 
  /**
   * @brief Mock NVMe namespace structure
   */
  struct spdk_nvme_ns {
      uint32_t id;
      uint32_t sector_size;
-     /* Minimal set of fields needed */
+     uint64_t num_sectors;              /* Capacity in sectors */
+     bool active;                       /* Whether the namespace is attached */
+     struct spdk_mock_ns_store* store;  /* Data of the namespace */
+ };
+ 
+ /**
+  * @brief Generic command status codes used by the mock
+  */
+ enum spdk_nvme_generic_command_status_code {
+     SPDK_NVME_SC_SUCCESS = 0x00,
+     SPDK_NVME_SC_INTERNAL_DEVICE_ERROR = 0x06,
+     SPDK_NVME_SC_INVALID_NAMESPACE_OR_FORMAT = 0x0b,
+     SPDK_NVME_SC_LBA_OUT_OF_RANGE = 0x80
+ };
+ 
+ /**
+  * @brief Status code types
+  */
+ enum spdk_nvme_status_code_type {
+     SPDK_NVME_SCT_GENERIC = 0x0
  };
  
  /**
@@ -51,23 +136,105 @@
   */
  struct spdk_nvme_cpl {
      struct {
-         uint16_t status_code_type : 3;
-         uint16_t status_code : 8;
-         uint16_t p : 1;
-         uint16_t sc : 4;  /* Status Code */
+         uint16_t p : 1;    /* Phase tag */
+         uint16_t sc : 8;   /* Status code */
+         uint16_t sct : 3;  /* Status code type */
+         uint16_t crd : 2;  /* Command retry delay */
+         uint16_t m : 1;    /* More */
+         uint16_t dnr : 1;  /* Do not retry */
      } status;
      /* Minimal set of fields needed */
  };
  
+ /**
+  * @brief Parse a transport ID string
+  * 
+  * The string holds whitespace-separated key:value pairs; the keys trtype,
+  * traddr, trsvcid and subnqn are recognized (case-insensitive).
+  * 
+  * @param trid Transport ID to fill
+  * @param str Transport ID string, e.g. "trtype:TCP traddr:192.168.1.10 trsvcid:4420"
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_nvme_transport_id_parse(struct spdk_nvme_transport_id* trid, const char* str);
+ 
+ /**
+  * @brief Connect to an NVMe controller
+  * 
+  * @param trid Transport ID of the controller
+  * @param opts Controller options, or NULL for defaults
+  * @param opts_size Size of the options structure
+  * @return Pointer to the controller, or NULL on failure
+  */
+ struct spdk_nvme_ctrlr* spdk_nvme_connect(const struct spdk_nvme_transport_id* trid,
+                                           const struct spdk_nvme_ctrlr_opts* opts,
+                                           size_t opts_size);
+ 
+ /**
+  * @brief Detach a controller returned by spdk_nvme_connect()
+  * 
+  * @param ctrlr Controller
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_nvme_detach(struct spdk_nvme_ctrlr* ctrlr);
+ 
  /**
   * @brief Get a namespace from the controller
   * 
   * @param ctrlr Controller
   * @param ns_id Namespace ID
-  * @return Pointer to namespace structure
+  * @return Pointer to namespace structure, or NULL if the namespace is not attached
   */
  struct spdk_nvme_ns* spdk_nvme_ctrlr_get_ns(const struct spdk_nvme_ctrlr* ctrlr, uint32_t ns_id);
  
+ /**
+  * @brief Get the number of namespace IDs of the controller
+  * 
+  * @param ctrlr Controller
+  * @return Highest namespace ID; IDs below it may be inactive
+  */
+ uint32_t spdk_nvme_ctrlr_get_num_ns(const struct spdk_nvme_ctrlr* ctrlr);
+ 
+ /**
+  * @brief Check whether a namespace ID is attached
+  * 
+  * @param ctrlr Controller
+  * @param ns_id Namespace ID
+  * @return true if the namespace is active
+  */
+ bool spdk_nvme_ctrlr_is_active_ns(const struct spdk_nvme_ctrlr* ctrlr, uint32_t ns_id);
+ 
+ /**
+  * @brief Get the default options for I/O queue pair creation
+  * 
+  * @param ctrlr Controller
+  * @param opts Options structure to fill
+  * @param opts_size Size of the options structure
+  */
+ void spdk_nvme_ctrlr_get_default_io_qpair_opts(struct spdk_nvme_ctrlr* ctrlr,
+                                                struct spdk_nvme_io_qpair_opts* opts,
+                                                size_t opts_size);
+ 
+ /**
+  * @brief Allocate an I/O queue pair on a controller
+  * 
+  * @param ctrlr Controller
+  * @param opts Queue pair options, or NULL for defaults
+  * @param opts_size Size of the options structure
+  * @return Pointer to the new queue pair, or NULL on failure
+  */
+ struct spdk_nvme_qpair* spdk_nvme_ctrlr_alloc_io_qpair(struct spdk_nvme_ctrlr* ctrlr,
+                                                        const struct spdk_nvme_io_qpair_opts* opts,
+                                                        size_t opts_size);
+ 
+ /**
+  * @brief Free an I/O queue pair
+  * 
+  * @param qpair Queue pair allocated with spdk_nvme_ctrlr_alloc_io_qpair()
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_nvme_ctrlr_free_io_qpair(struct spdk_nvme_qpair* qpair);
+ 
  /**
   * @brief Get sector size of a namespace
   * 
@@ -76,6 +243,30 @@
   */
  uint32_t spdk_nvme_ns_get_sector_size(const struct spdk_nvme_ns* ns);
  
+ /**
+  * @brief Get the ID of a namespace
+  * 
+  * @param ns Namespace
+  * @return Namespace ID
+  */
+ uint32_t spdk_nvme_ns_get_id(const struct spdk_nvme_ns* ns);
+ 
+ /**
+  * @brief Get the capacity of a namespace in sectors
+  * 
+  * @param ns Namespace
+  * @return Number of sectors
+  */
+ uint64_t spdk_nvme_ns_get_num_sectors(const struct spdk_nvme_ns* ns);
+ 
+ /**
+  * @brief Get the capacity of a namespace in bytes
+  * 
+  * @param ns Namespace
+  * @return Size in bytes
+  */
+ uint64_t spdk_nvme_ns_get_size(const struct spdk_nvme_ns* ns);
+ 
  /**
   * @brief Check if completion has an error
   * 
@@ -88,8 +279,8 @@
   * @brief Process completions on a queue pair
   * 
   * @param qpair Queue pair
-  * @param max_completions Maximum number of completions to process
-  * @return Number of completions processed
+  * @param max_completions Maximum number of completions to process, or 0 for no limit
+  * @return Number of completions processed, or negative errno on failure
   */
  int32_t spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair* qpair, uint32_t max_completions);
  
@@ -121,7 +312,7 @@
   * @param cb_fn Completion callback function
   * @param cb_arg Argument for callback function
   * @param io_flags I/O flags
-  * @return 0 on success, negative errno on failure
+  * @return 0 on success, -ENOMEM if the queue pair is full, negative errno on failure
   */
  int spdk_nvme_ns_cmd_read(struct spdk_nvme_ns* ns, struct spdk_nvme_qpair* qpair,
                            void* buffer, uint64_t lba, uint32_t lba_count,
@@ -139,13 +330,229 @@
   * @param cb_fn Completion callback function
   * @param cb_arg Argument for callback function
   * @param io_flags I/O flags
-  * @return 0 on success, negative errno on failure
+  * @return 0 on success, -ENOMEM if the queue pair is full, negative errno on failure
   */
  int spdk_nvme_ns_cmd_write(struct spdk_nvme_ns* ns, struct spdk_nvme_qpair* qpair,
                             void* buffer, uint64_t lba, uint32_t lba_count,
                             void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl),
                             void* cb_arg, uint32_t io_flags);
  
+ /**
+  * @brief Set a fixed delay added to commands submitted from now on (mock only)
+  * 
+  * The delay comes on top of the device model and does not occupy a channel.
+  * The initial value is read from the SPDK_MOCK_SERVICE_TIME_US environment
+  * variable, and defaults to 0 (commands complete on the next poll).
+  * 
+  * @param service_time_ns Fixed delay in nanoseconds
+  */
+ void spdk_mock_set_service_time_ns(uint64_t service_time_ns);
+ 
+ /**
+  * @brief Get the fixed delay added to submitted commands (mock only)
+  * 
+  * @return Fixed delay in nanoseconds
+  */
+ uint64_t spdk_mock_get_service_time_ns(void);
+ 
+ /**
+  * @brief Mock device performance model
+  * 
+  * A command occupies one of the internal channels for its base latency plus
+  * its per-KiB transfer cost. Writes add to a garbage-collection backlog that
+  * drains at gc_reclaim_bytes_per_sec; writes issued while the backlog exceeds
+  * gc_threshold_bytes take gc_stall_ns longer. The fabric round trip is added
+  * outside the channels. All-zero fields describe an ideal device.
+  * 
+  * In configuration text the fields are written as key=value settings with
+  * units in the key: channels, read_latency_us, write_latency_us,
+  * read_us_per_kib, write_us_per_kib, fabric_rtt_us, gc_threshold_mib,
+  * gc_reclaim_mbps and gc_stall_us.
+  */
+ struct spdk_mock_device_config {
+     uint32_t channels;                  /* Commands serviced in parallel; 0 for unlimited */
+     uint64_t read_latency_ns;           /* Base service time of a read */
+     uint64_t write_latency_ns;          /* Base service time of a write */
+     uint64_t read_ns_per_kib;           /* Transfer cost of a read per KiB */
+     uint64_t write_ns_per_kib;          /* Transfer cost of a write per KiB */
+     uint64_t fabric_rtt_ns;             /* Fabric round trip added to every command */
+     uint64_t gc_threshold_bytes;        /* Write backlog that triggers GC stalls; 0 disables GC */
+     uint64_t gc_reclaim_bytes_per_sec;  /* Rate at which GC drains the write backlog */
+     uint64_t gc_stall_ns;               /* Extra service time of a write during GC */
+ };
+ 
+ /**
+  * @brief Counters of the mock device since its configuration was last set
+  */
+ struct spdk_mock_device_stats {
+     uint64_t reads;        /* Read commands */
+     uint64_t writes;       /* Write commands */
+     uint64_t read_bytes;   /* Bytes read */
+     uint64_t write_bytes;  /* Bytes written */
+     uint64_t gc_stalls;    /* Writes that paid the GC stall */
+     uint64_t queued_ns;    /* Total time commands waited for a free channel */
+ };
+ 
+ /**
+  * @brief Get the configuration of an ideal device (mock only)
+  * 
+  * @param config Configuration to fill
+  */
+ void spdk_mock_get_default_device_config(struct spdk_mock_device_config* config);
+ 
+ /**
+  * @brief Apply key=value settings to a device configuration (mock only)
+  * 
+  * Settings are separated by newlines, commas or semicolons, and '#' starts a
+  * comment. Keys that are not given keep their current value.
+  * 
+  * @param str Configuration text, e.g. "channels=8, read_latency_us=80"
+  * @param config Configuration to update; unchanged on failure
+  * @return 0 on success, -EINVAL on an unknown key or invalid value
+  */
+ int spdk_mock_parse_device_config(const char* str, struct spdk_mock_device_config* config);
+ 
+ /**
+  * @brief Apply the settings of a configuration file (mock only)
+  * 
+  * @param path Path of a file in the spdk_mock_parse_device_config() format
+  * @param config Configuration to update; unchanged on failure
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_mock_load_device_config(const char* path, struct spdk_mock_device_config* config);
+ 
+ /**
+  * @brief Replace the device model and reset its state and counters (mock only)
+  * 
+  * Until this is called, the model is read from the file named by the
+  * SPDK_MOCK_DEVICE_CONFIG environment variable and the settings in
+  * SPDK_MOCK_DEVICE.
+  * 
+  * @param config New configuration
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_mock_set_device_config(const struct spdk_mock_device_config* config);
+ 
+ /**
+  * @brief Get the current device model (mock only)
+  * 
+  * @param config Configuration to fill
+  */
+ void spdk_mock_get_device_config(struct spdk_mock_device_config* config);
+ 
+ /**
+  * @brief Get the counters of the device model (mock only)
+  * 
+  * @param stats Counters to fill
+  */
+ void spdk_mock_get_device_stats(struct spdk_mock_device_stats* stats);
+ 
+ #define SPDK_MOCK_MAX_NAMESPACES 32
+ #define SPDK_MOCK_NS_PATH_MAX 4096
+ 
+ /**
+  * @brief Where the data of a mock namespace lives
+  */
+ enum spdk_mock_ns_backing {
+     SPDK_MOCK_NS_BACKING_PATTERN = 0,  /* Reads return the low byte of the LBA; writes are dropped */
+     SPDK_MOCK_NS_BACKING_MEMORY = 1,   /* Sparse in-memory store; unwritten blocks read as zeros */
+     SPDK_MOCK_NS_BACKING_FILE = 2      /* File or block device accessed with pread()/pwrite() */
+ };
+ 
+ /**
+  * @brief Configuration of a mock namespace
+  * 
+  * Data is moved when a command is submitted, so a read returns what the
+  * writes submitted before it stored. In configuration text the fields are
+  * comma-separated key=value settings: backing (pattern, memory or file),
+  * sector_size, size_mib or num_sectors, path and direct_io (0 or 1).
+  */
+ struct spdk_mock_ns_config {
+     enum spdk_mock_ns_backing backing;  /* Backing store */
+     uint32_t sector_size;               /* Power of two from 512 to 65536 */
+     uint64_t num_sectors;               /* Capacity; 0 takes the size of the backing file */
+     char path[SPDK_MOCK_NS_PATH_MAX];   /* Backing file, created if missing */
+     bool direct_io;                     /* Bypass the page cache (O_DIRECT) */
+ };
+ 
+ /**
+  * @brief Get the default namespace: 1 TiB of 4 KiB sectors with pattern backing (mock only)
+  * 
+  * @param config Configuration to fill
+  */
+ void spdk_mock_get_default_ns_config(struct spdk_mock_ns_config* config);
+ 
+ /**
+  * @brief Parse a namespace description (mock only)
+  * 
+  * Settings present in the string override the fields of config; on failure
+  * config is left unchanged.
+  * 
+  * @param str Description, e.g. "backing=memory,size_mib=1024,sector_size=512"
+  * @param config Configuration to update
+  * @return 0 on success, -EINVAL on an unknown key or invalid value
+  */
+ int spdk_mock_parse_ns_config(const char* str, struct spdk_mock_ns_config* config);
+ 
+ /**
+  * @brief Attach or reconfigure a namespace of the mock controller (mock only)
+  * 
+  * The previous contents of the namespace are discarded (file contents are
+  * kept on disk). Must not be called while commands are outstanding on the
+  * namespace. Initially namespaces are read from SPDK_MOCK_NAMESPACES, a
+  * semicolon-separated list of descriptions for IDs 1, 2, ...; without it
+  * namespace 1 has the default configuration.
+  * 
+  * @param ns_id Namespace ID, from 1 to SPDK_MOCK_MAX_NAMESPACES
+  * @param config Namespace configuration
+  * @return 0 on success, negative errno on failure
+  */
+ int spdk_mock_set_namespace(uint32_t ns_id, const struct spdk_mock_ns_config* config);
+ 
+ /**
+  * @brief Get the configuration of an attached namespace (mock only)
+  * 
+  * @param ns_id Namespace ID
+  * @param config Configuration to fill
+  * @return 0 on success, -ENOENT if the namespace is not attached
+  */
+ int spdk_mock_get_namespace(uint32_t ns_id, struct spdk_mock_ns_config* config);
+ 
+ /**
+  * @brief Detach a namespace and release its backing store (mock only)
+  * 
+  * @param ns_id Namespace ID
+  * @return 0 on success, -ENOENT if the namespace is not attached
+  */
+ int spdk_mock_remove_namespace(uint32_t ns_id);
+ 
+ /**
+  * @brief Get the number of commands outstanding on a queue pair (mock only)
+  * 
+  * @param qpair Queue pair
+  * @return Number of submitted commands that have not completed yet
+  */
+ uint32_t spdk_mock_qpair_get_num_outstanding(const struct spdk_nvme_qpair* qpair);
+ 
+ /**
+  * @brief Doorbell counters of a mock queue pair
+  */
+ struct spdk_mock_qpair_stats {
+     uint64_t submissions;   /* Commands submitted */
+     uint64_t sq_doorbells;  /* Submission queue doorbell writes */
+     uint64_t completions;   /* Commands completed */
+     uint64_t cq_doorbells;  /* Completion queue doorbell writes, one per poll that reaped */
+ };
+ 
+ /**
+  * @brief Get the doorbell counters of a queue pair (mock only)
+  * 
+  * @param qpair Queue pair
+  * @param stats Counters to fill
+  * @return 0 on success, -EINVAL if an argument is NULL
+  */
+ int spdk_mock_qpair_get_stats(const struct spdk_nvme_qpair* qpair, struct spdk_mock_qpair_stats* stats);
+ 
  #ifdef __cplusplus
  }
  #endif
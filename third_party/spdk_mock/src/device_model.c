@@ -0,0 +1,359 @@
+/**
+ * @file device_model.c
+ * @brief Performance model of the mock NVMe device
+ *
+ * Every command costs a base latency plus a per-KiB transfer cost, which differ
+ * for reads and writes, and occupies one of a bounded number of internal
+ * channels for that time. Writes add to a garbage-collection backlog that
+ * drains at a fixed rate; while the backlog exceeds its threshold, writes pay
+ * an extra stall. A fabric round trip is added outside the channels, so it
+ * raises latency without limiting throughput.
+ *
+ * The model is configured from the file named by SPDK_MOCK_DEVICE_CONFIG and
+ * then from the key=value list in SPDK_MOCK_DEVICE, or with
+ * spdk_mock_set_device_config(). The default device is ideal: no latency,
+ * unlimited channels and no garbage collection.
+ */
+
+ #include "device_model.h"
+ #include "../include/nvme.h"
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdio.h>
+ #include <stdatomic.h>
+ #include <ctype.h>
+ #include <errno.h>
+
+ // Upper bound on the number of channels, to keep the channel scan cheap
+ #define MOCK_MAX_CHANNELS 4096
+
+ // Device state shared by all queue pairs; guarded by g_device_lock
+ static atomic_flag g_device_lock = ATOMIC_FLAG_INIT;
+ static atomic_bool g_device_initialized = false;
+ static struct spdk_mock_device_config g_config;
+ static struct spdk_mock_device_stats g_stats;
+ static uint64_t* g_channel_free_ns = NULL;  // Time at which each channel becomes idle
+ static double g_gc_backlog_bytes = 0.0;     // Written bytes not yet reclaimed
+ static uint64_t g_gc_update_ns = 0;         // Time of the last backlog update
+
+ static void mock_device_lock(void) {
+     while (atomic_flag_test_and_set_explicit(&g_device_lock, memory_order_acquire)) {
+         // Critical sections are a few dozen instructions; spin
+     }
+ }
+
+ static void mock_device_unlock(void) {
+     atomic_flag_clear_explicit(&g_device_lock, memory_order_release);
+ }
+
+ // Install a configuration; the caller holds the lock
+ static int mock_device_apply_locked(const struct spdk_mock_device_config* config) {
+     uint64_t* channels = NULL;
+     if (config->channels > 0) {
+         channels = calloc(config->channels, sizeof(*channels));
+         if (channels == NULL) {
+             return -ENOMEM;
+         }
+     }
+
+     free(g_channel_free_ns);
+     g_channel_free_ns = channels;
+     g_config = *config;
+     memset(&g_stats, 0, sizeof(g_stats));
+     g_gc_backlog_bytes = 0.0;
+     g_gc_update_ns = 0;
+     return 0;
+ }
+
+ // Load the configuration from the environment on first use
+ static void mock_device_init(void) {
+     if (atomic_load(&g_device_initialized)) {
+         return;
+     }
+
+     struct spdk_mock_device_config config;
+     spdk_mock_get_default_device_config(&config);
+
+     const char* path = getenv("SPDK_MOCK_DEVICE_CONFIG");
+     if (path != NULL && spdk_mock_load_device_config(path, &config) != 0) {
+         fprintf(stderr, "spdk_mock: ignoring invalid device config file %s\n", path);
+         spdk_mock_get_default_device_config(&config);
+     }
+
+     const char* inline_config = getenv("SPDK_MOCK_DEVICE");
+     if (inline_config != NULL) {
+         struct spdk_mock_device_config overridden = config;
+         if (spdk_mock_parse_device_config(inline_config, &overridden) == 0) {
+             config = overridden;
+         } else {
+             fprintf(stderr, "spdk_mock: ignoring invalid SPDK_MOCK_DEVICE: %s\n", inline_config);
+         }
+     }
+
+     mock_device_lock();
+     if (!atomic_load(&g_device_initialized)) {
+         if (mock_device_apply_locked(&config) != 0) {
+             struct spdk_mock_device_config ideal;
+             spdk_mock_get_default_device_config(&ideal);
+             mock_device_apply_locked(&ideal);
+         }
+         atomic_store(&g_device_initialized, true);
+     }
+     mock_device_unlock();
+ }
+
+ void spdk_mock_get_default_device_config(struct spdk_mock_device_config* config) {
+     if (config != NULL) {
+         memset(config, 0, sizeof(*config));
+     }
+ }
+
+ // Parse a non-negative decimal number; the whole value must be consumed
+ static int mock_parse_number(const char* value, double* out) {
+     char* end = NULL;
+     errno = 0;
+     double number = strtod(value, &end);
+     if (end == value || *end != '\0' || errno != 0 || !(number >= 0.0)) {
+         return -EINVAL;
+     }
+     *out = number;
+     return 0;
+ }
+
+ // Apply one key=value setting; units are part of the key names
+ static int mock_apply_setting(struct spdk_mock_device_config* config,
+                               const char* key, const char* value) {
+     double number;
+     if (mock_parse_number(value, &number) != 0) {
+         return -EINVAL;
+     }
+
+     if (strcmp(key, "channels") == 0) {
+         if (number > MOCK_MAX_CHANNELS || number != (double)(uint32_t)number) {
+             return -EINVAL;
+         }
+         config->channels = (uint32_t)number;
+     } else if (strcmp(key, "read_latency_us") == 0) {
+         config->read_latency_ns = (uint64_t)(number * 1e3);
+     } else if (strcmp(key, "write_latency_us") == 0) {
+         config->write_latency_ns = (uint64_t)(number * 1e3);
+     } else if (strcmp(key, "read_us_per_kib") == 0) {
+         config->read_ns_per_kib = (uint64_t)(number * 1e3);
+     } else if (strcmp(key, "write_us_per_kib") == 0) {
+         config->write_ns_per_kib = (uint64_t)(number * 1e3);
+     } else if (strcmp(key, "fabric_rtt_us") == 0) {
+         config->fabric_rtt_ns = (uint64_t)(number * 1e3);
+     } else if (strcmp(key, "gc_threshold_mib") == 0) {
+         config->gc_threshold_bytes = (uint64_t)(number * 1048576.0);
+     } else if (strcmp(key, "gc_reclaim_mbps") == 0) {
+         config->gc_reclaim_bytes_per_sec = (uint64_t)(number * 1e6);
+     } else if (strcmp(key, "gc_stall_us") == 0) {
+         config->gc_stall_ns = (uint64_t)(number * 1e3);
+     } else {
+         return -EINVAL;
+     }
+     return 0;
+ }
+
+ int spdk_mock_parse_device_config(const char* str, struct spdk_mock_device_config* config) {
+     if (str == NULL || config == NULL) {
+         return -EINVAL;
+     }
+
+     // Settings are separated by newlines, commas or semicolons; '#' starts a comment
+     struct spdk_mock_device_config parsed = *config;
+     const char* p = str;
+     while (*p) {
+         const char* end = p;
+         while (*end && *end != '\n' && *end != ',' && *end != ';') {
+             ++end;
+         }
+
+         // A comment runs to the end of the line, across separators
+         const char* hash = memchr(p, '#', (size_t)(end - p));
+         const char* stop = hash != NULL ? hash : end;
+
+         // Trim the setting
+         while (p < stop && isspace((unsigned char)*p)) {
+             ++p;
+         }
+         const char* last = stop;
+         while (last > p && isspace((unsigned char)last[-1])) {
+             --last;
+         }
+
+         if (last > p) {
+             char setting[128];
+             size_t len = (size_t)(last - p);
+             if (len >= sizeof(setting)) {
+                 return -EINVAL;
+             }
+             memcpy(setting, p, len);
+             setting[len] = '\0';
+
+             char* equals = strchr(setting, '=');
+             if (equals == NULL) {
+                 return -EINVAL;
+             }
+
+             char* key_end = equals;
+             while (key_end > setting && isspace((unsigned char)key_end[-1])) {
+                 --key_end;
+             }
+             *key_end = '\0';
+             char* value = equals + 1;
+             while (isspace((unsigned char)*value)) {
+                 ++value;
+             }
+
+             if (mock_apply_setting(&parsed, setting, value) != 0) {
+                 return -EINVAL;
+             }
+         }
+
+         if (hash != NULL) {
+             const char* newline = strchr(hash, '\n');
+             p = newline != NULL ? newline + 1 : hash + strlen(hash);
+         } else {
+             p = *end ? end + 1 : end;
+         }
+     }
+
+     *config = parsed;
+     return 0;
+ }
+
+ int spdk_mock_load_device_config(const char* path, struct spdk_mock_device_config* config) {
+     if (path == NULL || config == NULL) {
+         return -EINVAL;
+     }
+
+     FILE* file = fopen(path, "r");
+     if (file == NULL) {
+         return -errno;
+     }
+
+     char* content = NULL;
+     size_t size = 0;
+     size_t capacity = 0;
+     char chunk[4096];
+     size_t read;
+     while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+         if (size + read + 1 > capacity) {
+             capacity = (size + read + 1) * 2;
+             char* grown = realloc(content, capacity);
+             if (grown == NULL) {
+                 free(content);
+                 fclose(file);
+                 return -ENOMEM;
+             }
+             content = grown;
+         }
+         memcpy(content + size, chunk, read);
+         size += read;
+     }
+     fclose(file);
+
+     int rc;
+     if (content == NULL) {
+         rc = spdk_mock_parse_device_config("", config);
+     } else {
+         content[size] = '\0';
+         rc = spdk_mock_parse_device_config(content, config);
+         free(content);
+     }
+     return rc;
+ }
+
+ int spdk_mock_set_device_config(const struct spdk_mock_device_config* config) {
+     if (config == NULL || config->channels > MOCK_MAX_CHANNELS) {
+         return -EINVAL;
+     }
+
+     mock_device_lock();
+     int rc = mock_device_apply_locked(config);
+     atomic_store(&g_device_initialized, true);
+     mock_device_unlock();
+     return rc;
+ }
+
+ void spdk_mock_get_device_config(struct spdk_mock_device_config* config) {
+     if (config == NULL) {
+         return;
+     }
+
+     mock_device_init();
+     mock_device_lock();
+     *config = g_config;
+     mock_device_unlock();
+ }
+
+ void spdk_mock_get_device_stats(struct spdk_mock_device_stats* stats) {
+     if (stats == NULL) {
+         return;
+     }
+
+     mock_device_init();
+     mock_device_lock();
+     *stats = g_stats;
+     mock_device_unlock();
+ }
+
+ uint64_t mock_device_schedule(bool is_write, uint64_t bytes, uint64_t now_ns) {
+     mock_device_init();
+     mock_device_lock();
+
+     const struct spdk_mock_device_config* config = &g_config;
+     uint64_t service_ns = is_write
+         ? config->write_latency_ns + config->write_ns_per_kib * bytes / 1024
+         : config->read_latency_ns + config->read_ns_per_kib * bytes / 1024;
+
+     if (is_write) {
+         g_stats.writes++;
+         g_stats.write_bytes += bytes;
+
+         if (config->gc_threshold_bytes > 0) {
+             // Drain the backlog for the time since the last write, then add this one
+             if (g_gc_update_ns != 0 && now_ns > g_gc_update_ns) {
+                 double reclaimed = (double)config->gc_reclaim_bytes_per_sec *
+                                    (double)(now_ns - g_gc_update_ns) / 1e9;
+                 g_gc_backlog_bytes = g_gc_backlog_bytes > reclaimed
+                     ? g_gc_backlog_bytes - reclaimed : 0.0;
+             }
+             if (now_ns > g_gc_update_ns) {
+                 g_gc_update_ns = now_ns;
+             }
+             g_gc_backlog_bytes += (double)bytes;
+
+             if (g_gc_backlog_bytes > (double)config->gc_threshold_bytes) {
+                 service_ns += config->gc_stall_ns;
+                 g_stats.gc_stalls++;
+             }
+         }
+     } else {
+         g_stats.reads++;
+         g_stats.read_bytes += bytes;
+     }
+
+     // The command reaches the device after half a round trip
+     uint64_t arrival_ns = now_ns + config->fabric_rtt_ns / 2;
+     uint64_t start_ns = arrival_ns;
+
+     if (config->channels > 0) {
+         uint32_t channel = 0;
+         for (uint32_t i = 1; i < config->channels; ++i) {
+             if (g_channel_free_ns[i] < g_channel_free_ns[channel]) {
+                 channel = i;
+             }
+         }
+         if (g_channel_free_ns[channel] > start_ns) {
+             g_stats.queued_ns += g_channel_free_ns[channel] - start_ns;
+             start_ns = g_channel_free_ns[channel];
+         }
+         g_channel_free_ns[channel] = start_ns + service_ns;
+     }
+
+     uint64_t complete_ns = start_ns + service_ns + (config->fabric_rtt_ns - config->fabric_rtt_ns / 2);
+     mock_device_unlock();
+     return complete_ns;
+ }
@@ -0,0 +1,22 @@
+/**
+ * @file device_model.h
+ * @brief Internal interface of the mock device performance model
+ */
+
+ #pragma once
+
+ #include <stdbool.h>
+ #include <stdint.h>
+
+ /**
+  * @brief Schedule a command on the modeled device
+  *
+  * Places the command on the internal channel that frees up first and
+  * returns the time at which its completion reaches the host.
+  *
+  * @param is_write Whether the command is a write
+  * @param bytes Transfer size in bytes
+  * @param now_ns Submission time (monotonic nanoseconds)
+  * @return Completion time (monotonic nanoseconds)
+  */
+ uint64_t mock_device_schedule(bool is_write, uint64_t bytes, uint64_t now_ns);
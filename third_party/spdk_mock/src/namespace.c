@@ -0,0 +1,651 @@
+/**
+ * @file namespace.c
+ * @brief Namespaces of the mock NVMe controller and their backing stores
+ *
+ * A namespace keeps its data in one of three stores: the legacy pattern store,
+ * which fills reads with the low byte of the LBA and drops writes; a sparse
+ * in-memory store, which allocates 1 MiB chunks on first write; or a file (or
+ * block device such as a ramdisk) accessed with pread()/pwrite(), optionally
+ * with O_DIRECT. Data is moved when a command is submitted, so the memory and
+ * file stores read back what was written.
+ *
+ * Namespaces are configured from SPDK_MOCK_NAMESPACES on first use, or with
+ * spdk_mock_set_namespace(). Namespace structures live in a static table, so
+ * pointers returned by spdk_nvme_ctrlr_get_ns() stay valid when a namespace
+ * is reconfigured.
+ */
+
+ #define _GNU_SOURCE  /* O_DIRECT, pread(), pwrite() */
+
+ #include "namespace.h"
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdio.h>
+ #include <stdatomic.h>
+ #include <ctype.h>
+ #include <errno.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <sys/stat.h>
+
+ // Memory stores allocate their data in chunks of 1 MiB
+ #define MOCK_NS_CHUNK_SHIFT 20
+ #define MOCK_NS_CHUNK_SIZE ((uint64_t)1 << MOCK_NS_CHUNK_SHIFT)
+
+ // Buffer alignment required by O_DIRECT; unaligned buffers go through a bounce buffer
+ #define MOCK_NS_DIRECT_ALIGN 4096
+
+ /**
+  * @brief Data of a mock namespace
+  */
+ struct spdk_mock_ns_store {
+     struct spdk_mock_ns_config config;  /* Configuration, with num_sectors resolved */
+     _Atomic(uint8_t*)* chunks;          /* Memory backing: chunks allocated on first write */
+     uint64_t num_chunks;                /* Memory backing: number of chunk pointers */
+     int fd;                             /* File backing: open descriptor */
+ };
+
+ // Namespace table, indexed by ID - 1; guarded by g_ns_lock
+ static struct spdk_nvme_ns g_namespaces[SPDK_MOCK_MAX_NAMESPACES];
+ static atomic_flag g_ns_lock = ATOMIC_FLAG_INIT;
+ static atomic_bool g_ns_initialized = false;
+
+ static void mock_ns_lock(void) {
+     while (atomic_flag_test_and_set_explicit(&g_ns_lock, memory_order_acquire)) {
+         // Only taken while namespaces are configured or looked up; spin
+     }
+ }
+
+ static void mock_ns_unlock(void) {
+     atomic_flag_clear_explicit(&g_ns_lock, memory_order_release);
+ }
+
+ static void mock_ns_store_destroy(struct spdk_mock_ns_store* store) {
+     if (store == NULL) {
+         return;
+     }
+     if (store->chunks != NULL) {
+         for (uint64_t i = 0; i < store->num_chunks; ++i) {
+             free(atomic_load(&store->chunks[i]));
+         }
+         free(store->chunks);
+     }
+     if (store->fd >= 0) {
+         close(store->fd);
+     }
+     free(store);
+ }
+
+ // Open the backing file and resolve the capacity
+ static int mock_ns_open_file(struct spdk_mock_ns_store* store) {
+     struct spdk_mock_ns_config* config = &store->config;
+     if (config->path[0] == '\0') {
+         return -EINVAL;
+     }
+
+     int flags = O_RDWR | O_CREAT;
+ #ifdef O_DIRECT
+     if (config->direct_io) {
+         flags |= O_DIRECT;
+     }
+ #endif
+     store->fd = open(config->path, flags, 0644);
+     if (store->fd < 0) {
+         return -errno;
+     }
+ #if !defined(O_DIRECT) && defined(F_NOCACHE)
+     if (config->direct_io) {
+         fcntl(store->fd, F_NOCACHE, 1);
+     }
+ #endif
+
+     off_t end = lseek(store->fd, 0, SEEK_END);
+     if (end < 0) {
+         return -errno;
+     }
+
+     if (config->num_sectors == 0) {
+         // Take the capacity from the file or block device
+         config->num_sectors = (uint64_t)end / config->sector_size;
+         return config->num_sectors > 0 ? 0 : -EINVAL;
+     }
+
+     // Grow regular files to the requested size; the new space is sparse
+     uint64_t size = config->num_sectors * config->sector_size;
+     struct stat st;
+     if (fstat(store->fd, &st) != 0) {
+         return -errno;
+     }
+     if ((uint64_t)end < size) {
+         if (!S_ISREG(st.st_mode)) {
+             return -ENOSPC;
+         }
+         if (ftruncate(store->fd, (off_t)size) != 0) {
+             return -errno;
+         }
+     }
+     return 0;
+ }
+
+ static int mock_ns_store_create(const struct spdk_mock_ns_config* config,
+                                 struct spdk_mock_ns_store** out) {
+     uint32_t sector_size = config->sector_size;
+     if (sector_size < 512 || sector_size > 65536 || (sector_size & (sector_size - 1)) != 0) {
+         return -EINVAL;
+     }
+     if (config->num_sectors > UINT64_MAX / sector_size) {
+         return -EINVAL;
+     }
+     if (config->backing != SPDK_MOCK_NS_BACKING_FILE && config->num_sectors == 0) {
+         return -EINVAL;
+     }
+
+     struct spdk_mock_ns_store* store = calloc(1, sizeof(*store));
+     if (store == NULL) {
+         return -ENOMEM;
+     }
+     store->config = *config;
+     store->config.path[SPDK_MOCK_NS_PATH_MAX - 1] = '\0';
+     store->fd = -1;
+
+     int rc = 0;
+     switch (config->backing) {
+     case SPDK_MOCK_NS_BACKING_PATTERN:
+         break;
+     case SPDK_MOCK_NS_BACKING_MEMORY:
+         store->num_chunks = (config->num_sectors * sector_size + MOCK_NS_CHUNK_SIZE - 1) >>
+                             MOCK_NS_CHUNK_SHIFT;
+         store->chunks = calloc(store->num_chunks, sizeof(*store->chunks));
+         if (store->chunks == NULL) {
+             rc = -ENOMEM;
+         }
+         break;
+     case SPDK_MOCK_NS_BACKING_FILE:
+         rc = mock_ns_open_file(store);
+         break;
+     default:
+         rc = -EINVAL;
+         break;
+     }
+
+     if (rc != 0) {
+         mock_ns_store_destroy(store);
+         return rc;
+     }
+     *out = store;
+     return 0;
+ }
+
+ // Attach a namespace; the caller holds the lock
+ static int mock_ns_attach_locked(uint32_t ns_id, const struct spdk_mock_ns_config* config) {
+     struct spdk_mock_ns_store* store = NULL;
+     int rc = mock_ns_store_create(config, &store);
+     if (rc != 0) {
+         return rc;
+     }
+
+     struct spdk_nvme_ns* ns = &g_namespaces[ns_id - 1];
+     mock_ns_store_destroy(ns->store);
+     ns->id = ns_id;
+     ns->sector_size = store->config.sector_size;
+     ns->num_sectors = store->config.num_sectors;
+     ns->store = store;
+     ns->active = true;
+     return 0;
+ }
+
+ // Detach every namespace; the caller holds the lock
+ static void mock_ns_clear_locked(void) {
+     for (uint32_t i = 0; i < SPDK_MOCK_MAX_NAMESPACES; ++i) {
+         mock_ns_store_destroy(g_namespaces[i].store);
+         memset(&g_namespaces[i], 0, sizeof(g_namespaces[i]));
+     }
+ }
+
+ // Attach the namespaces listed in SPDK_MOCK_NAMESPACES; the caller holds the lock
+ static int mock_ns_load_env_locked(const char* list) {
+     char* copy = strdup(list);
+     if (copy == NULL) {
+         return -ENOMEM;
+     }
+
+     // Descriptions are separated by ';' and numbered from 1; empty ones skip an ID
+     int rc = 0;
+     uint32_t ns_id = 1;
+     char* p = copy;
+     while (rc == 0) {
+         char* end = strchr(p, ';');
+         if (end != NULL) {
+             *end = '\0';
+         }
+
+         const char* q = p;
+         while (isspace((unsigned char)*q)) {
+             ++q;
+         }
+         if (*q != '\0') {
+             struct spdk_mock_ns_config config;
+             spdk_mock_get_default_ns_config(&config);
+             if (ns_id > SPDK_MOCK_MAX_NAMESPACES) {
+                 rc = -EINVAL;
+             } else if ((rc = spdk_mock_parse_ns_config(q, &config)) == 0) {
+                 rc = mock_ns_attach_locked(ns_id, &config);
+             }
+         }
+
+         if (end == NULL) {
+             break;
+         }
+         p = end + 1;
+         ns_id++;
+     }
+
+     free(copy);
+     return rc;
+ }
+
+ // Attach the initial namespaces on first use
+ static void mock_ns_init(void) {
+     if (atomic_load(&g_ns_initialized)) {
+         return;
+     }
+
+     mock_ns_lock();
+     if (!atomic_load(&g_ns_initialized)) {
+         const char* list = getenv("SPDK_MOCK_NAMESPACES");
+         int rc = list != NULL ? mock_ns_load_env_locked(list) : -ENOENT;
+         if (list != NULL && rc != 0) {
+             fprintf(stderr, "spdk_mock: ignoring invalid SPDK_MOCK_NAMESPACES: %s\n", list);
+             mock_ns_clear_locked();
+         }
+
+         if (rc != 0) {
+             struct spdk_mock_ns_config config;
+             spdk_mock_get_default_ns_config(&config);
+             mock_ns_attach_locked(1, &config);
+         }
+         atomic_store(&g_ns_initialized, true);
+     }
+     mock_ns_unlock();
+ }
+
+ void spdk_mock_get_default_ns_config(struct spdk_mock_ns_config* config) {
+     if (config == NULL) {
+         return;
+     }
+     memset(config, 0, sizeof(*config));
+     config->backing = SPDK_MOCK_NS_BACKING_PATTERN;
+     config->sector_size = 4096;  // Standard 4K sector size
+     config->num_sectors = ((uint64_t)1 << 40) / 4096;
+ }
+
+ // Parse an unsigned decimal integer; the whole value must be consumed
+ static int mock_parse_uint(const char* value, uint64_t* out) {
+     if (!isdigit((unsigned char)*value)) {
+         return -EINVAL;
+     }
+     char* end = NULL;
+     errno = 0;
+     unsigned long long number = strtoull(value, &end, 10);
+     if (*end != '\0' || errno != 0) {
+         return -EINVAL;
+     }
+     *out = number;
+     return 0;
+ }
+
+ int spdk_mock_parse_ns_config(const char* str, struct spdk_mock_ns_config* config) {
+     if (str == NULL || config == NULL) {
+         return -EINVAL;
+     }
+
+     struct spdk_mock_ns_config parsed = *config;
+     uint64_t size_mib = 0;
+     bool has_size_mib = false;
+
+     const char* p = str;
+     while (*p) {
+         const char* end = strchr(p, ',');
+         if (end == NULL) {
+             end = p + strlen(p);
+         }
+
+         // Trim the setting
+         const char* first = p;
+         while (first < end && isspace((unsigned char)*first)) {
+             ++first;
+         }
+         const char* last = end;
+         while (last > first && isspace((unsigned char)last[-1])) {
+             --last;
+         }
+
+         if (last > first) {
+             char setting[SPDK_MOCK_NS_PATH_MAX + 32];
+             size_t len = (size_t)(last - first);
+             if (len >= sizeof(setting)) {
+                 return -EINVAL;
+             }
+             memcpy(setting, first, len);
+             setting[len] = '\0';
+
+             char* equals = strchr(setting, '=');
+             if (equals == NULL) {
+                 return -EINVAL;
+             }
+             char* key_end = equals;
+             while (key_end > setting && isspace((unsigned char)key_end[-1])) {
+                 --key_end;
+             }
+             *key_end = '\0';
+             char* value = equals + 1;
+             while (isspace((unsigned char)*value)) {
+                 ++value;
+             }
+
+             uint64_t number = 0;
+             if (strcmp(setting, "backing") == 0) {
+                 if (strcmp(value, "pattern") == 0) {
+                     parsed.backing = SPDK_MOCK_NS_BACKING_PATTERN;
+                 } else if (strcmp(value, "memory") == 0) {
+                     parsed.backing = SPDK_MOCK_NS_BACKING_MEMORY;
+                 } else if (strcmp(value, "file") == 0) {
+                     parsed.backing = SPDK_MOCK_NS_BACKING_FILE;
+                 } else {
+                     return -EINVAL;
+                 }
+             } else if (strcmp(setting, "path") == 0) {
+                 size_t path_len = strlen(value);
+                 if (path_len == 0 || path_len >= sizeof(parsed.path)) {
+                     return -EINVAL;
+                 }
+                 memcpy(parsed.path, value, path_len + 1);
+             } else if (mock_parse_uint(value, &number) != 0) {
+                 return -EINVAL;
+             } else if (strcmp(setting, "sector_size") == 0) {
+                 if (number > UINT32_MAX) {
+                     return -EINVAL;
+                 }
+                 parsed.sector_size = (uint32_t)number;
+             } else if (strcmp(setting, "size_mib") == 0) {
+                 size_mib = number;
+                 has_size_mib = true;
+             } else if (strcmp(setting, "num_sectors") == 0) {
+                 parsed.num_sectors = number;
+                 has_size_mib = false;
+             } else if (strcmp(setting, "direct_io") == 0) {
+                 if (number > 1) {
+                     return -EINVAL;
+                 }
+                 parsed.direct_io = number == 1;
+             } else {
+                 return -EINVAL;
+             }
+         }
+
+         p = *end ? end + 1 : end;
+     }
+
+     // The size is converted once the sector size is known
+     if (has_size_mib) {
+         if (parsed.sector_size == 0 || size_mib > (UINT64_MAX >> 20)) {
+             return -EINVAL;
+         }
+         uint64_t bytes = size_mib << 20;
+         if (bytes % parsed.sector_size != 0) {
+             return -EINVAL;
+         }
+         parsed.num_sectors = bytes / parsed.sector_size;
+     }
+
+     *config = parsed;
+     return 0;
+ }
+
+ int spdk_mock_set_namespace(uint32_t ns_id, const struct spdk_mock_ns_config* config) {
+     if (ns_id == 0 || ns_id > SPDK_MOCK_MAX_NAMESPACES || config == NULL) {
+         return -EINVAL;
+     }
+
+     mock_ns_init();
+     mock_ns_lock();
+     int rc = mock_ns_attach_locked(ns_id, config);
+     mock_ns_unlock();
+     return rc;
+ }
+
+ int spdk_mock_get_namespace(uint32_t ns_id, struct spdk_mock_ns_config* config) {
+     if (ns_id == 0 || ns_id > SPDK_MOCK_MAX_NAMESPACES || config == NULL) {
+         return -EINVAL;
+     }
+
+     mock_ns_init();
+     mock_ns_lock();
+     int rc = -ENOENT;
+     if (g_namespaces[ns_id - 1].active) {
+         *config = g_namespaces[ns_id - 1].store->config;
+         rc = 0;
+     }
+     mock_ns_unlock();
+     return rc;
+ }
+
+ int spdk_mock_remove_namespace(uint32_t ns_id) {
+     if (ns_id == 0 || ns_id > SPDK_MOCK_MAX_NAMESPACES) {
+         return -EINVAL;
+     }
+
+     mock_ns_init();
+     mock_ns_lock();
+     struct spdk_nvme_ns* ns = &g_namespaces[ns_id - 1];
+     int rc = -ENOENT;
+     if (ns->active) {
+         mock_ns_store_destroy(ns->store);
+         ns->store = NULL;
+         ns->active = false;
+         rc = 0;
+     }
+     mock_ns_unlock();
+     return rc;
+ }
+
+ struct spdk_nvme_ns* spdk_nvme_ctrlr_get_ns(const struct spdk_nvme_ctrlr* ctrlr, uint32_t ns_id) {
+     // All controllers share the namespace table
+     (void)ctrlr;
+
+     if (ns_id == 0 || ns_id > SPDK_MOCK_MAX_NAMESPACES) {
+         return NULL;
+     }
+
+     mock_ns_init();
+     mock_ns_lock();
+     struct spdk_nvme_ns* ns = g_namespaces[ns_id - 1].active ? &g_namespaces[ns_id - 1] : NULL;
+     mock_ns_unlock();
+     return ns;
+ }
+
+ uint32_t spdk_nvme_ctrlr_get_num_ns(const struct spdk_nvme_ctrlr* ctrlr) {
+     (void)ctrlr;
+
+     mock_ns_init();
+     mock_ns_lock();
+     uint32_t num_ns = 0;
+     for (uint32_t i = 0; i < SPDK_MOCK_MAX_NAMESPACES; ++i) {
+         if (g_namespaces[i].active) {
+             num_ns = i + 1;
+         }
+     }
+     mock_ns_unlock();
+     return num_ns;
+ }
+
+ bool spdk_nvme_ctrlr_is_active_ns(const struct spdk_nvme_ctrlr* ctrlr, uint32_t ns_id) {
+     return spdk_nvme_ctrlr_get_ns(ctrlr, ns_id) != NULL;
+ }
+
+ uint32_t spdk_nvme_ns_get_sector_size(const struct spdk_nvme_ns* ns) {
+     if (ns == NULL) {
+         return 0;
+     }
+     return ns->sector_size;
+ }
+
+ uint32_t spdk_nvme_ns_get_id(const struct spdk_nvme_ns* ns) {
+     return ns != NULL ? ns->id : 0;
+ }
+
+ uint64_t spdk_nvme_ns_get_num_sectors(const struct spdk_nvme_ns* ns) {
+     return ns != NULL ? ns->num_sectors : 0;
+ }
+
+ uint64_t spdk_nvme_ns_get_size(const struct spdk_nvme_ns* ns) {
+     return ns != NULL ? ns->num_sectors * ns->sector_size : 0;
+ }
+
+ // Check that a command addresses an attached namespace and stays inside it
+ static uint16_t mock_ns_check(const struct spdk_nvme_ns* ns, uint64_t lba, uint32_t lba_count) {
+     if (ns == NULL || !ns->active || ns->store == NULL) {
+         return SPDK_NVME_SC_INVALID_NAMESPACE_OR_FORMAT;
+     }
+     if (lba > ns->num_sectors || lba_count > ns->num_sectors - lba) {
+         return SPDK_NVME_SC_LBA_OUT_OF_RANGE;
+     }
+     return SPDK_NVME_SC_SUCCESS;
+ }
+
+ // Transfer between a buffer and the backing file
+ static uint16_t mock_ns_file_io(struct spdk_mock_ns_store* store, bool is_write,
+                                 void* buffer, uint64_t offset, size_t len) {
+     uint8_t* data = buffer;
+     void* bounce = NULL;
+     if (store->config.direct_io && (uintptr_t)buffer % MOCK_NS_DIRECT_ALIGN != 0) {
+         size_t bounce_size = (len + MOCK_NS_DIRECT_ALIGN - 1) / MOCK_NS_DIRECT_ALIGN *
+                              MOCK_NS_DIRECT_ALIGN;
+         bounce = aligned_alloc(MOCK_NS_DIRECT_ALIGN, bounce_size);
+         if (bounce == NULL) {
+             return SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
+         }
+         if (is_write) {
+             memcpy(bounce, buffer, len);
+         }
+         data = bounce;
+     }
+
+     uint16_t status = SPDK_NVME_SC_SUCCESS;
+     size_t done = 0;
+     while (done < len) {
+         ssize_t n = is_write
+             ? pwrite(store->fd, data + done, len - done, (off_t)(offset + done))
+             : pread(store->fd, data + done, len - done, (off_t)(offset + done));
+         if (n < 0 && errno == EINTR) {
+             continue;
+         }
+         if (n < 0 || (n == 0 && is_write)) {
+             status = SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
+             break;
+         }
+         if (n == 0) {
+             // Past the end of a file that shrank underneath us
+             memset(data + done, 0, len - done);
+             break;
+         }
+         done += (size_t)n;
+     }
+
+     if (bounce != NULL) {
+         if (!is_write && status == SPDK_NVME_SC_SUCCESS) {
+             memcpy(buffer, bounce, len);
+         }
+         free(bounce);
+     }
+     return status;
+ }
+
+ uint16_t mock_ns_read(struct spdk_nvme_ns* ns, void* buffer, uint64_t lba, uint32_t lba_count) {
+     uint16_t status = mock_ns_check(ns, lba, lba_count);
+     if (status != SPDK_NVME_SC_SUCCESS || buffer == NULL || lba_count == 0) {
+         return status;
+     }
+
+     struct spdk_mock_ns_store* store = ns->store;
+     uint64_t offset = lba * ns->sector_size;
+     uint64_t len = (uint64_t)lba_count * ns->sector_size;
+
+     switch (store->config.backing) {
+     case SPDK_MOCK_NS_BACKING_PATTERN:
+         // Fill with a simple pattern based on LBA
+         memset(buffer, (int)(lba & 0xFF), len);
+         break;
+     case SPDK_MOCK_NS_BACKING_MEMORY: {
+         uint8_t* dst = buffer;
+         while (len > 0) {
+             uint64_t within = offset & (MOCK_NS_CHUNK_SIZE - 1);
+             uint64_t n = MOCK_NS_CHUNK_SIZE - within < len ? MOCK_NS_CHUNK_SIZE - within : len;
+             uint8_t* chunk = atomic_load_explicit(&store->chunks[offset >> MOCK_NS_CHUNK_SHIFT],
+                                                   memory_order_acquire);
+             if (chunk != NULL) {
+                 memcpy(dst, chunk + within, n);
+             } else {
+                 memset(dst, 0, n);
+             }
+             dst += n;
+             offset += n;
+             len -= n;
+         }
+         break;
+     }
+     case SPDK_MOCK_NS_BACKING_FILE:
+         status = mock_ns_file_io(store, false, buffer, offset, len);
+         break;
+     }
+     return status;
+ }
+
+ uint16_t mock_ns_write(struct spdk_nvme_ns* ns, const void* buffer, uint64_t lba, uint32_t lba_count) {
+     uint16_t status = mock_ns_check(ns, lba, lba_count);
+     if (status != SPDK_NVME_SC_SUCCESS || buffer == NULL || lba_count == 0) {
+         return status;
+     }
+
+     struct spdk_mock_ns_store* store = ns->store;
+     uint64_t offset = lba * ns->sector_size;
+     uint64_t len = (uint64_t)lba_count * ns->sector_size;
+
+     switch (store->config.backing) {
+     case SPDK_MOCK_NS_BACKING_PATTERN:
+         // Writes are dropped
+         break;
+     case SPDK_MOCK_NS_BACKING_MEMORY: {
+         const uint8_t* src = buffer;
+         while (len > 0) {
+             uint64_t within = offset & (MOCK_NS_CHUNK_SIZE - 1);
+             uint64_t n = MOCK_NS_CHUNK_SIZE - within < len ? MOCK_NS_CHUNK_SIZE - within : len;
+             _Atomic(uint8_t*)* slot = &store->chunks[offset >> MOCK_NS_CHUNK_SHIFT];
+             uint8_t* chunk = atomic_load_explicit(slot, memory_order_acquire);
+             if (chunk == NULL) {
+                 // Queue pairs on other threads may race to allocate the same chunk
+                 uint8_t* fresh = calloc(1, MOCK_NS_CHUNK_SIZE);
+                 if (fresh == NULL) {
+                     return SPDK_NVME_SC_INTERNAL_DEVICE_ERROR;
+                 }
+                 if (atomic_compare_exchange_strong_explicit(slot, &chunk, fresh,
+                                                             memory_order_acq_rel,
+                                                             memory_order_acquire)) {
+                     chunk = fresh;
+                 } else {
+                     free(fresh);
+                 }
+             }
+             memcpy(chunk + within, src, n);
+             src += n;
+             offset += n;
+             len -= n;
+         }
+         break;
+     }
+     case SPDK_MOCK_NS_BACKING_FILE:
+         status = mock_ns_file_io(store, true, (void*)buffer, offset, len);
+         break;
+     }
+     return status;
+ }
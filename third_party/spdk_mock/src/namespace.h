@@ -0,0 +1,30 @@
+/**
+ * @file namespace.h
+ * @brief Internal interface of the mock namespace backing stores
+ */
+
+ #pragma once
+
+ #include "../include/nvme.h"
+
+ /**
+  * @brief Read sectors of a namespace into a buffer
+  *
+  * @param ns Namespace
+  * @param buffer Destination of lba_count sectors
+  * @param lba First sector
+  * @param lba_count Number of sectors
+  * @return NVMe status code (SPDK_NVME_SC_SUCCESS on success)
+  */
+ uint16_t mock_ns_read(struct spdk_nvme_ns* ns, void* buffer, uint64_t lba, uint32_t lba_count);
+
+ /**
+  * @brief Write sectors of a namespace from a buffer
+  *
+  * @param ns Namespace
+  * @param buffer Source of lba_count sectors
+  * @param lba First sector
+  * @param lba_count Number of sectors
+  * @return NVMe status code (SPDK_NVME_SC_SUCCESS on success)
+  */
+ uint16_t mock_ns_write(struct spdk_nvme_ns* ns, const void* buffer, uint64_t lba, uint32_t lba_count);
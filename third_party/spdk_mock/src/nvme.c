@@ -1,63 +1,421 @@
 /**
  * @file nvme.c
- * @brief Mock SPDK NVMe implementation for macOS development
+ * @brief Mock SPDK NVMe implementation for development without hardware
  * 
  * This provides a simplified mock implementation of the SPDK NVMe API functions
- * for development purposes on macOS. The functions simulate success but don't
- * perform any actual NVMe operations.
+ * for development on macOS and on Linux machines without SPDK. Commands do not
+ * touch any device: they wait on their queue pair for the time given by the
+ * device model (device_model.c) and complete when the queue pair is polled,
+ * like a real controller. Their data is moved at submission by the backing
+ * store of the namespace (namespace.c).
  */
 
+ #define _POSIX_C_SOURCE 200809L  /* clock_gettime() */
+ 
 //  #include <spdk/nvme.h>
  #include "../include/nvme.h"
+ #include "device_model.h"
+ #include "namespace.h"
  #include <stdlib.h>
  #include <string.h>
  #include <stdio.h>
+ #include <stdatomic.h>
+ #include <ctype.h>
+ #include <errno.h>
+ #include <time.h>
   
  // Global variables for mock implementation
- static struct spdk_nvme_ns g_mock_ns = {
-     .id = 1,
-     .sector_size = 4096  // Standard 4K sector size
+ static atomic_uint g_next_qpair_id = 0;
+ static atomic_uint g_next_ctrlr_id = 0;
+ 
+ // Service time of new commands; UINT64_MAX until read from the environment
+ static _Atomic uint64_t g_service_time_ns = UINT64_MAX;
+ 
+ /**
+  * @brief Outstanding command on a mock queue pair
+  */
+ struct spdk_mock_request {
+     void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl);
+     void* cb_arg;
+     uint64_t complete_ns;  /* Monotonic time at which the command completes */
+     uint64_t seq;          /* Submission number; orders commands completing together */
+     uint64_t bytes;        /* Transfer size, scheduled on the device model when rung */
+     bool is_write;         /* Write rather than read */
+     uint16_t status;       /* NVMe status code reported on completion */
  };
+ 
+ static uint64_t mock_now_ns(void) {
+     struct timespec ts;
+     clock_gettime(CLOCK_MONOTONIC, &ts);
+     return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+ }
+ 
+ void spdk_mock_set_service_time_ns(uint64_t service_time_ns) {
+     atomic_store(&g_service_time_ns, service_time_ns);
+ }
+ 
+ uint64_t spdk_mock_get_service_time_ns(void) {
+     uint64_t service_time_ns = atomic_load(&g_service_time_ns);
+     if (service_time_ns == UINT64_MAX) {
+         const char* env = getenv("SPDK_MOCK_SERVICE_TIME_US");
+         service_time_ns = env != NULL ? strtoull(env, NULL, 10) * 1000ULL : 0;
+         
+         // Keep a value set concurrently by spdk_mock_set_service_time_ns()
+         uint64_t expected = UINT64_MAX;
+         if (!atomic_compare_exchange_strong(&g_service_time_ns, &expected, service_time_ns)) {
+             service_time_ns = expected;
+         }
+     }
+     return service_time_ns;
+ }
+ 
+ // Slots in use: commands at the device plus commands waiting for the doorbell
+ static uint32_t mock_qpair_busy(const struct spdk_nvme_qpair* qpair) {
+     return qpair->num_outstanding + qpair->num_unrung;
+ }
+ 
+ uint32_t spdk_mock_qpair_get_num_outstanding(const struct spdk_nvme_qpair* qpair) {
+     return qpair != NULL ? mock_qpair_busy(qpair) : 0;
+ }
+ 
+ int spdk_mock_qpair_get_stats(const struct spdk_nvme_qpair* qpair, struct spdk_mock_qpair_stats* stats) {
+     if (qpair == NULL || stats == NULL) {
+         return -EINVAL;
+     }
+     stats->submissions = qpair->submissions;
+     stats->sq_doorbells = qpair->sq_doorbells;
+     stats->completions = qpair->completions;
+     stats->cq_doorbells = qpair->cq_doorbells;
+     return 0;
+ }
+ 
+ // Whether the command in slot a completes before the one in slot b
+ static bool mock_request_before(const struct spdk_nvme_qpair* qpair, uint32_t a, uint32_t b) {
+     const struct spdk_mock_request* ra = &qpair->requests[a];
+     const struct spdk_mock_request* rb = &qpair->requests[b];
+     return ra->complete_ns < rb->complete_ns ||
+            (ra->complete_ns == rb->complete_ns && ra->seq < rb->seq);
+ }
+ 
+ static void mock_heap_push(struct spdk_nvme_qpair* qpair, uint32_t slot) {
+     uint32_t i = qpair->num_outstanding++;
+     while (i > 0) {
+         uint32_t parent = (i - 1) / 2;
+         if (!mock_request_before(qpair, slot, qpair->heap[parent])) {
+             break;
+         }
+         qpair->heap[i] = qpair->heap[parent];
+         i = parent;
+     }
+     qpair->heap[i] = slot;
+ }
+ 
+ static void mock_heap_pop(struct spdk_nvme_qpair* qpair) {
+     uint32_t last = qpair->heap[--qpair->num_outstanding];
+     uint32_t n = qpair->num_outstanding;
+     uint32_t i = 0;
+     for (;;) {
+         uint32_t child = 2 * i + 1;
+         if (child >= n) {
+             break;
+         }
+         if (child + 1 < n && mock_request_before(qpair, qpair->heap[child + 1], qpair->heap[child])) {
+             child++;
+         }
+         if (!mock_request_before(qpair, qpair->heap[child], last)) {
+             break;
+         }
+         qpair->heap[i] = qpair->heap[child];
+         i = child;
+     }
+     if (n > 0) {
+         qpair->heap[i] = last;
+     }
+ }
+ 
+ // Pass a command to the device model; it completes when the model says so
+ static void mock_qpair_start(struct spdk_nvme_qpair* qpair, uint32_t slot, uint64_t now_ns) {
+     struct spdk_mock_request* req = &qpair->requests[slot];
+     req->complete_ns = mock_device_schedule(req->is_write, req->bytes, now_ns) +
+                        spdk_mock_get_service_time_ns();
+     mock_heap_push(qpair, slot);
+ }
+ 
+ // Queue a command on the qpair, holding it for the next doorbell with delay_cmd_submit
+ static int mock_qpair_submit(struct spdk_nvme_qpair* qpair, bool is_write, uint64_t bytes,
+                              uint16_t status,
+                              void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl),
+                              void* cb_arg) {
+     if (qpair == NULL) {
+         return -EINVAL;
+     }
+     
+     // Like SPDK, report a full queue with -ENOMEM so the caller can retry
+     if (mock_qpair_busy(qpair) == qpair->queue_size) {
+         return -ENOMEM;
+     }
+     
+     uint32_t slot = qpair->free_slots[qpair->queue_size - mock_qpair_busy(qpair) - 1];
+     struct spdk_mock_request* req = &qpair->requests[slot];
+     req->cb_fn = cb_fn;
+     req->cb_arg = cb_arg;
+     req->seq = qpair->next_seq++;
+     req->bytes = bytes;
+     req->is_write = is_write;
+     req->status = status;
+     qpair->submissions++;
+     
+     if (qpair->delay_cmd_submit) {
+         qpair->unrung[qpair->num_unrung++] = slot;
+     } else {
+         qpair->sq_doorbells++;
+         mock_qpair_start(qpair, slot, mock_now_ns());
+     }
+     return 0;
+ }
+ 
+ // Case-insensitive string comparison (strcasecmp is not part of C11)
+ static bool mock_str_equal_nocase(const char* a, const char* b) {
+     while (*a && *b) {
+         if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) {
+             return false;
+         }
+         ++a;
+         ++b;
+     }
+     return *a == *b;
+ }
+ 
+ // Copy a value into a fixed-size field, failing if it does not fit
+ static int mock_copy_field(char* dst, size_t dst_size, const char* src, size_t len) {
+     if (len >= dst_size) {
+         return -EINVAL;
+     }
+     memcpy(dst, src, len);
+     dst[len] = '\0';
+     return 0;
+ }
+ 
+ int spdk_nvme_transport_id_parse(struct spdk_nvme_transport_id* trid, const char* str) {
+     if (trid == NULL || str == NULL) {
+         return -EINVAL;
+     }
+     
+     memset(trid, 0, sizeof(*trid));
+     trid->trtype = SPDK_NVME_TRANSPORT_PCIE;
+     
+     const char* p = str;
+     while (*p) {
+         while (*p && isspace((unsigned char)*p)) {
+             ++p;
+         }
+         if (!*p) {
+             break;
+         }
+         
+         const char* token = p;
+         while (*p && !isspace((unsigned char)*p)) {
+             ++p;
+         }
+         size_t token_len = (size_t)(p - token);
+         
+         const char* colon = memchr(token, ':', token_len);
+         if (colon == NULL) {
+             return -EINVAL;
+         }
+         
+         char key[32];
+         if (mock_copy_field(key, sizeof(key), token, (size_t)(colon - token)) != 0) {
+             return -EINVAL;
+         }
+         const char* value = colon + 1;
+         size_t value_len = token_len - (size_t)(value - token);
+         
+         int rc = 0;
+         if (mock_str_equal_nocase(key, "trtype")) {
+             char type[16];
+             if (mock_copy_field(type, sizeof(type), value, value_len) != 0) {
+                 return -EINVAL;
+             }
+             if (mock_str_equal_nocase(type, "PCIe")) {
+                 trid->trtype = SPDK_NVME_TRANSPORT_PCIE;
+             } else if (mock_str_equal_nocase(type, "RDMA")) {
+                 trid->trtype = SPDK_NVME_TRANSPORT_RDMA;
+             } else if (mock_str_equal_nocase(type, "FC")) {
+                 trid->trtype = SPDK_NVME_TRANSPORT_FC;
+             } else if (mock_str_equal_nocase(type, "TCP")) {
+                 trid->trtype = SPDK_NVME_TRANSPORT_TCP;
+             } else {
+                 return -EINVAL;
+             }
+         } else if (mock_str_equal_nocase(key, "traddr")) {
+             rc = mock_copy_field(trid->traddr, sizeof(trid->traddr), value, value_len);
+         } else if (mock_str_equal_nocase(key, "trsvcid")) {
+             rc = mock_copy_field(trid->trsvcid, sizeof(trid->trsvcid), value, value_len);
+         } else if (mock_str_equal_nocase(key, "subnqn")) {
+             rc = mock_copy_field(trid->subnqn, sizeof(trid->subnqn), value, value_len);
+         }
+         // Other keys (adrfam, hostnqn, ...) are accepted and ignored
+         
+         if (rc != 0) {
+             return rc;
+         }
+     }
+     
+     return 0;
+ }
+ 
+ struct spdk_nvme_ctrlr* spdk_nvme_connect(const struct spdk_nvme_transport_id* trid,
+                                           const struct spdk_nvme_ctrlr_opts* opts,
+                                           size_t opts_size) {
+     (void)trid;
+     (void)opts;
+     (void)opts_size;
+     
+     struct spdk_nvme_ctrlr* ctrlr = calloc(1, sizeof(*ctrlr));
+     if (ctrlr == NULL) {
+         return NULL;
+     }
+     
+     ctrlr->id = atomic_fetch_add(&g_next_ctrlr_id, 1) + 1;
+     return ctrlr;
+ }
+ 
+ int spdk_nvme_detach(struct spdk_nvme_ctrlr* ctrlr) {
+     free(ctrlr);
+     return 0;
+ }
   
- struct spdk_nvme_ns* spdk_nvme_ctrlr_get_ns(const struct spdk_nvme_ctrlr* ctrlr, uint32_t ns_id) {
-     // Mark parameters as used to suppress warnings
+ void spdk_nvme_ctrlr_get_default_io_qpair_opts(struct spdk_nvme_ctrlr* ctrlr,
+                                                struct spdk_nvme_io_qpair_opts* opts,
+                                                size_t opts_size) {
      (void)ctrlr;
-     (void)ns_id;
      
-     // Always return our mock namespace
-     return &g_mock_ns;
+     if (opts == NULL || opts_size < sizeof(*opts)) {
+         return;
+     }
+     
+     opts->io_queue_size = 256;
+     opts->io_queue_requests = 512;
+     opts->delay_cmd_submit = false;
+ }
+  
+ struct spdk_nvme_qpair* spdk_nvme_ctrlr_alloc_io_qpair(struct spdk_nvme_ctrlr* ctrlr,
+                                                        const struct spdk_nvme_io_qpair_opts* opts,
+                                                        size_t opts_size) {
+     struct spdk_nvme_io_qpair_opts qpair_opts;
+     spdk_nvme_ctrlr_get_default_io_qpair_opts(ctrlr, &qpair_opts, sizeof(qpair_opts));
+     if (opts != NULL && opts_size >= sizeof(*opts)) {
+         qpair_opts = *opts;
+     }
+     if (qpair_opts.io_queue_requests == 0) {
+         return NULL;
+     }
+     
+     struct spdk_nvme_qpair* qpair = calloc(1, sizeof(*qpair));
+     if (qpair == NULL) {
+         return NULL;
+     }
+     
+     uint32_t size = qpair_opts.io_queue_requests;
+     qpair->requests = calloc(size, sizeof(*qpair->requests));
+     qpair->heap = calloc(size, sizeof(*qpair->heap));
+     qpair->free_slots = calloc(size, sizeof(*qpair->free_slots));
+     qpair->unrung = calloc(size, sizeof(*qpair->unrung));
+     if (qpair->requests == NULL || qpair->heap == NULL || qpair->free_slots == NULL ||
+         qpair->unrung == NULL) {
+         spdk_nvme_ctrlr_free_io_qpair(qpair);
+         return NULL;
+     }
+     qpair->queue_size = size;
+     qpair->delay_cmd_submit = qpair_opts.delay_cmd_submit;
+     for (uint32_t i = 0; i < size; ++i) {
+         qpair->free_slots[i] = size - 1 - i;
+     }
+     
+     // Queue pair IDs are unique per process; admin queue is ID 0
+     qpair->id = atomic_fetch_add(&g_next_qpair_id, 1) + 1;
+     qpair->userdata = ctrlr;
+     return qpair;
  }
   
- uint32_t spdk_nvme_ns_get_sector_size(const struct spdk_nvme_ns* ns) {
-     if (ns == NULL) {
-         return 0;
+ int spdk_nvme_ctrlr_free_io_qpair(struct spdk_nvme_qpair* qpair) {
+     // Outstanding commands are dropped without invoking their callbacks
+     if (qpair != NULL) {
+         free(qpair->requests);
+         free(qpair->heap);
+         free(qpair->free_slots);
+         free(qpair->unrung);
      }
-     return ns->sector_size;
+     free(qpair);
+     return 0;
  }
   
  bool spdk_nvme_cpl_is_error(const struct spdk_nvme_cpl* cpl) {
-     // Mark parameter as used to suppress warnings
-     (void)cpl;
-     
-     // For mock implementation, we'll say there's no error
-     return false;
+     return cpl->status.sc != SPDK_NVME_SC_SUCCESS || cpl->status.sct != SPDK_NVME_SCT_GENERIC;
  }
   
  int32_t spdk_nvme_qpair_process_completions(struct spdk_nvme_qpair* qpair, uint32_t max_completions) {
-     // Mark parameters as used to suppress warnings
-     (void)qpair;
-     (void)max_completions;
+     if (qpair == NULL) {
+         return -EINVAL;
+     }
+     
+     uint64_t now_ns = mock_now_ns();
+     
+     // Held commands reach the device with one doorbell write
+     if (qpair->num_unrung > 0) {
+         uint32_t held = qpair->num_unrung;
+         qpair->num_unrung = 0;
+         for (uint32_t i = 0; i < held; ++i) {
+             mock_qpair_start(qpair, qpair->unrung[i], now_ns);
+         }
+         qpair->sq_doorbells++;
+     }
+     
+     // Commands submitted from completion callbacks wait for the next call
+     uint64_t seq_limit = qpair->next_seq;
+     int32_t completed = 0;
+     while (qpair->num_outstanding > 0 &&
+            (max_completions == 0 || (uint32_t)completed < max_completions)) {
+         uint32_t slot = qpair->heap[0];
+         struct spdk_mock_request* req = &qpair->requests[slot];
+         if (req->complete_ns > now_ns || req->seq >= seq_limit) {
+             break;
+         }
+         
+         // Retire the slot before the callback, which may submit again
+         void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl) = req->cb_fn;
+         void* cb_arg = req->cb_arg;
+         uint16_t status = req->status;
+         mock_heap_pop(qpair);
+         qpair->free_slots[qpair->queue_size - mock_qpair_busy(qpair) - 1] = slot;
+         completed++;
+         
+         if (cb_fn) {
+             struct spdk_nvme_cpl cpl = {0};
+             cpl.status.sct = SPDK_NVME_SCT_GENERIC;
+             cpl.status.sc = status;
+             cb_fn(cb_arg, &cpl);
+         }
+     }
      
-     // Mock processing 1 completion
-     return 1;
+     if (completed > 0) {
+         qpair->completions += (uint64_t)completed;
+         qpair->cq_doorbells++;
+     }
+     return completed;
  }
   
  void* spdk_dma_malloc(size_t size, size_t alignment, uint64_t* phys_addr) {
-     // Mark alignment parameter as used to suppress warnings
-     (void)alignment;
-     
-     // Just use regular malloc for the mock
-     void* ptr = malloc(size);
+     void* ptr;
+     if (alignment > sizeof(void*)) {
+         // aligned_alloc requires the size to be a multiple of the alignment
+         size_t aligned_size = (size + alignment - 1) / alignment * alignment;
+         ptr = aligned_alloc(alignment, aligned_size);
+     } else {
+         // Just use regular malloc for the mock
+         ptr = malloc(size);
+     }
      if (phys_addr) {
          // In a real implementation, this would be a physical address
          *phys_addr = (uint64_t)ptr;
@@ -70,27 +428,29 @@
      free(buf);
  }
   
+ // Reject commands the mock cannot queue before their data is moved
+ static int mock_check_submit(struct spdk_nvme_qpair* qpair) {
+     if (qpair == NULL) {
+         return -EINVAL;
+     }
+     return mock_qpair_busy(qpair) == qpair->queue_size ? -ENOMEM : 0;
+ }
+ 
  int spdk_nvme_ns_cmd_read(struct spdk_nvme_ns* ns, struct spdk_nvme_qpair* qpair,
                           void* buffer, uint64_t lba, uint32_t lba_count,
                           void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl),
                           void* cb_arg, uint32_t io_flags) {
      // Mark unused parameters to suppress warnings
-     (void)qpair;
      (void)io_flags;
      
-     // Simulate successful read by filling buffer with some pattern
-     if (buffer && lba_count > 0) {
-         // Fill with a simple pattern based on LBA
-         memset(buffer, (int)(lba & 0xFF), lba_count * (ns ? ns->sector_size : 4096));
-     }
-     
-     // Call the completion callback if provided
-     if (cb_fn) {
-         struct spdk_nvme_cpl cpl = {0};  // Zero-initialized (success)
-         cb_fn(cb_arg, &cpl);
+     int rc = mock_check_submit(qpair);
+     if (rc != 0) {
+         return rc;
      }
      
-     return 0;  // Success
+     uint64_t bytes = (uint64_t)lba_count * (ns ? ns->sector_size : 4096);
+     uint16_t status = mock_ns_read(ns, buffer, lba, lba_count);
+     return mock_qpair_submit(qpair, false, bytes, status, cb_fn, cb_arg);
  }
   
  int spdk_nvme_ns_cmd_write(struct spdk_nvme_ns* ns, struct spdk_nvme_qpair* qpair,
@@ -98,20 +458,14 @@
                            void (*cb_fn)(void* cb_arg, const struct spdk_nvme_cpl* cpl),
                            void* cb_arg, uint32_t io_flags) {
      // Mark unused parameters to suppress warnings
-     (void)ns;
-     (void)qpair;
-     (void)buffer;
-     (void)lba;
-     (void)lba_count;
      (void)io_flags;
      
-     // Simulate successful write (no actual operation)
-     
-     // Call the completion callback if provided
-     if (cb_fn) {
-         struct spdk_nvme_cpl cpl = {0};  // Zero-initialized (success)
-         cb_fn(cb_arg, &cpl);
+     int rc = mock_check_submit(qpair);
+     if (rc != 0) {
+         return rc;
      }
      
-     return 0;  // Success
+     uint64_t bytes = (uint64_t)lba_count * (ns ? ns->sector_size : 4096);
+     uint16_t status = mock_ns_write(ns, buffer, lba, lba_count);
+     return mock_qpair_submit(qpair, true, bytes, status, cb_fn, cb_arg);
  }